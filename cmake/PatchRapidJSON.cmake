@@ -0,0 +1,50 @@
+# cmake/PatchRapidJSON.cmake
+
+# Function to point RAPIDJSON_INCLUDE_DIRS at a copy of the RapidJSON headers with thirdparty/patches applied, setting
+# RAPIDJSON_PATCHED once every patch is in
+#
+# The headers found in RAPIDJSON_INCLUDE_DIRS are left untouched, they are copied to the build tree and patched there,
+# so the vendored tree always matches its upstream release. Headers already carrying a patch are used as they are,
+# a patch that no longer applies leaves the headers unpatched with a warning.
+function(patch_rapidjson)
+    file(GLOB PATCHES "${CMAKE_CURRENT_SOURCE_DIR}/thirdparty/patches/rapidjson-*.patch")
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${PATCHES})
+
+    set(RAPIDJSON_PATCHED OFF PARENT_SCOPE)
+    set(SOURCE_DIR "")
+    foreach (dir ${RAPIDJSON_INCLUDE_DIRS})
+        if (NOT SOURCE_DIR AND EXISTS "${dir}/rapidjson/schema.h")
+            set(SOURCE_DIR "${dir}")
+        endif ()
+    endforeach ()
+    find_package(Patch)
+    if (NOT SOURCE_DIR OR NOT Patch_FOUND)
+        message(WARNING "RapidJSON headers or the patch program not found, building against unpatched RapidJSON")
+        return()
+    endif ()
+
+    set(PATCHED_ROOT "${CMAKE_BINARY_DIR}/rapidjson")
+    file(REMOVE_RECURSE "${PATCHED_ROOT}")
+    file(COPY "${SOURCE_DIR}/rapidjson" DESTINATION "${PATCHED_ROOT}/include")
+
+    set(patched ON)
+    foreach (patch_file ${PATCHES})
+        get_filename_component(patch_name "${patch_file}" NAME)
+        execute_process(COMMAND "${Patch_EXECUTABLE}" -p1 -N -s --dry-run -i "${patch_file}"
+                WORKING_DIRECTORY "${PATCHED_ROOT}" RESULT_VARIABLE applies OUTPUT_QUIET ERROR_QUIET)
+        execute_process(COMMAND "${Patch_EXECUTABLE}" -p1 -R -s --dry-run -i "${patch_file}"
+                WORKING_DIRECTORY "${PATCHED_ROOT}" RESULT_VARIABLE present OUTPUT_QUIET ERROR_QUIET)
+        if (applies EQUAL 0)
+            execute_process(COMMAND "${Patch_EXECUTABLE}" -p1 -N -s -i "${patch_file}"
+                    WORKING_DIRECTORY "${PATCHED_ROOT}" OUTPUT_QUIET)
+            message(STATUS "Applied ${patch_name} to RapidJSON")
+        elseif (NOT present EQUAL 0)
+            message(WARNING "${patch_name} does not apply to the RapidJSON headers in ${SOURCE_DIR}")
+            set(patched OFF)
+        endif ()
+    endforeach ()
+
+    set(RAPIDJSON_PATCHED ${patched} PARENT_SCOPE)
+    list(REMOVE_ITEM RAPIDJSON_INCLUDE_DIRS "${SOURCE_DIR}")
+    set(RAPIDJSON_INCLUDE_DIRS "${PATCHED_ROOT}/include" ${RAPIDJSON_INCLUDE_DIRS} PARENT_SCOPE)
+endfunction()
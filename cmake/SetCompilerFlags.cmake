@@ -26,20 +26,12 @@ function(set_compiler_flags target)
     ############################# Compiler-specific settings #############################
     if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
         message(STATUS "Using GNU compiler")
-        if (NOT CMAKE_CROSSCOMPILING)
-            message(STATUS "Using native CPU optimizations")
-            target_compile_options(${target} PRIVATE -march=native)
-        endif ()
         target_compile_options(${target} PRIVATE -Wall -Wextra -Werror -Weffc++ -Wswitch-default -Wfloat-equal -Wconversion -Wsign-conversion)
         if (OASVALIDATOR_BUILD_CXX11 AND CMAKE_CXX_COMPILER_VERSION VERSION_LESS "4.7.0")
             target_compile_options(${target} PRIVATE -std=c++0x)
         endif ()
     elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
         message(STATUS "Using Clang compiler")
-        if (NOT CMAKE_CROSSCOMPILING)
-            message(STATUS "Using native CPU optimizations")
-            target_compile_options(${target} PRIVATE -march=native)
-        endif ()
         target_compile_options(${target} PRIVATE -Wall -Wextra -Werror -Wno-missing-field-initializers -Weffc++ -Wswitch-default -Wfloat-equal -Wconversion -Wimplicit-fallthrough)
     elseif (CMAKE_CXX_COMPILER_ID STREQUAL "MSVC")
         message(STATUS "Using MSVC compiler")
@@ -55,6 +47,14 @@ function(set_compiler_flags target)
         target_compile_options(${target} PRIVATE -qarch=auto)
     endif ()
 
+    # Vector kernels are built once per instruction set and picked at runtime (see include/utils/simd.hpp), so the
+    # library itself targets the generic ISA and runs on any host of the architecture
+    if ((CMAKE_CXX_COMPILER_ID STREQUAL "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang") AND
+            CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|i[3-6]86)$")
+        message(STATUS "Building AVX2 kernels with runtime dispatch")
+        set_source_files_properties(${PROJECT_SOURCE_DIR}/src/utils/simd_avx2.cpp PROPERTIES COMPILE_FLAGS -mavx2)
+    endif ()
+
     # if release build, add extra optimization flags
     if (CMAKE_BUILD_TYPE STREQUAL "Release")
         message(STATUS "Adding extra optimization flags for release build")
@@ -15,7 +15,13 @@ public:
     explicit ArrayDeserializer(const std::string& param_name, char start, bool skip_name, PrimitiveType items_type,
                                char separator, bool has_running_name, bool has_20_separator);
 
-    std::string Deserialize(const char* beg, const char* const end) override;
+    void Deserialize(const char* beg, const char* const end, std::string& ret) const override;
+
+    size_t GetMemoryUsage() const override
+    {
+        return sizeof(*this) + GetHeapSize(param_name_);
+    }
+
     ~ArrayDeserializer() override = default;
 
 private:
@@ -9,7 +9,6 @@
 
 #include "utils/common.hpp"
 
-#include <array>
 #include <cstring>
 #include <stdexcept>
 #include <string>
@@ -36,7 +35,9 @@ class BaseDeserializer
 public:
     explicit BaseDeserializer(const std::string& param_name, char start, bool skip_name);
 
-    virtual std::string Deserialize(const char* beg, const char* const end) = 0;
+    // Replaces the contents of `ret`, keeping its capacity for the next parameter
+    virtual void Deserialize(const char* beg, const char* const end, std::string& ret) const = 0;
+    virtual size_t GetMemoryUsage() const = 0; // Including the object itself
     virtual ~BaseDeserializer() = default;
 
 protected:
@@ -44,8 +45,6 @@ protected:
     const char start_;
     const bool skip_name_;
 
-    static const std::array<char, 256> kHexLookupTable;
-
     // Utilities
 
     inline void CheckNSkipStart(const char*& cursor) const
@@ -141,33 +140,31 @@ protected:
         }
     }
 
+    inline void CheckDecoded(PercentDecodeResult result) const
+    {
+        if (PercentDecodeResult::INCOMPLETE == result) {
+            throw DeserializationException("Incomplete percent encoding for '" + param_name_ + "'");
+        }
+        if (PercentDecodeResult::INVALID_HEX == result) {
+            throw DeserializationException("Invalid HEX character for '" + param_name_ + "'");
+        }
+    }
+
+    // Decoded bytes from `from` to the end of `ret`, escapes may encode any byte
+    inline void CheckUtf8(const std::string& ret, size_t from) const
+    {
+        const char* end = ret.data() + ret.size();
+        if (end != FindInvalidUtf8(ret.data() + from, end)) {
+            throw DeserializationException("Invalid UTF-8 encoding for '" + param_name_ + "'");
+        }
+    }
+
     inline void DeserializeString(const char*& cursor, const char* const end, std::string& ret) const
     {
         ret.push_back('"');
-        while (cursor < end) {
-            char c = *cursor++;
-            switch (c) {
-            case '%': {
-                if (cursor + 1 >= end) {
-                    throw DeserializationException("Incomplete percent encoding for '" + param_name_ + "'");
-                }
-                const char dec1 = kHexLookupTable[static_cast<unsigned char>(*cursor++)];
-                const char dec2 = kHexLookupTable[static_cast<unsigned char>(*cursor++)];
-                if (dec1 < 0 || dec2 < 0) {
-                    throw DeserializationException("Invalid HEX character for '" + param_name_ + "'");
-                }
-                ret.push_back(static_cast<char>((dec1 << 4) | dec2));
-            } break;
-
-            case '+':
-                ret += ' ';
-                break;
-
-            default:
-                ret += c;
-                break;
-            }
-        }
+        const size_t from = ret.size();
+        CheckDecoded(PercentDecode(cursor, end, ret));
+        CheckUtf8(ret, from);
         ret.push_back('"');
     }
 
@@ -175,30 +172,9 @@ protected:
                                   std::string& ret) const
     {
         ret.push_back('"');
-        while (cursor < end && *cursor != terminator) {
-            char c = *cursor++;
-            switch (c) {
-            case '%': {
-                if (cursor + 1 >= end) {
-                    throw DeserializationException("Incomplete percent encoding for '" + param_name_ + "'");
-                }
-                const char dec1 = kHexLookupTable[static_cast<unsigned char>(*cursor++)];
-                const char dec2 = kHexLookupTable[static_cast<unsigned char>(*cursor++)];
-                if (dec1 < 0 || dec2 < 0) {
-                    throw DeserializationException("Invalid HEX character for '" + param_name_ + "'");
-                }
-                ret.push_back(static_cast<char>((dec1 << 4) | dec2));
-            } break;
-
-            case '+':
-                ret += ' ';
-                break;
-
-            default:
-                ret += c;
-                break;
-            }
-        }
+        const size_t from = ret.size();
+        CheckDecoded(PercentDecode(cursor, end, terminator, ret));
+        CheckUtf8(ret, from);
         ret.push_back('"');
     }
 
@@ -13,7 +13,13 @@ class ContentDeserializer final: public BaseDeserializer
 public:
     explicit ContentDeserializer(const std::string& param_name, char start, bool skip_name);
 
-    std::string Deserialize(const char* beg, const char* const end) override;
+    void Deserialize(const char* beg, const char* const end, std::string& ret) const override;
+
+    size_t GetMemoryUsage() const override
+    {
+        return sizeof(*this) + GetHeapSize(param_name_);
+    }
+
     ~ContentDeserializer() override = default;
 };
 
@@ -18,7 +18,8 @@ public:
     explicit ObjectDeserializer(const std::string& param_name, char start, bool skip_name, char kv_separator,
                                 char vk_separator, bool is_deep_obj, const ObjKTMap& kt_map);
 
-    std::string Deserialize(const char* beg, const char* const end) override;
+    void Deserialize(const char* beg, const char* const end, std::string& ret) const override;
+    size_t GetMemoryUsage() const override;
     ~ObjectDeserializer() override = default;
 
 private:
@@ -30,15 +31,11 @@ private:
     inline void DeserializeKey(const char*& cursor, const char* const end, const char terminator,
                                std::string& key) const
     {
+        const char* key_end = FindByte(cursor, end, terminator);
         key.push_back('"');
-        while (cursor < end && *cursor != terminator) {
-            key.push_back(*cursor);
-            ++cursor;
-        }
-        if (cursor < end && *cursor == terminator) {
-            ++cursor;
-        }
+        key.append(cursor, key_end);
         key.push_back('"');
+        cursor = key_end < end ? key_end + 1 : end;
     }
 };
 
@@ -13,7 +13,13 @@ class PrimitiveDeserializer final: public BaseDeserializer
 public:
     explicit PrimitiveDeserializer(const std::string& param_name, char start, bool skip_name, PrimitiveType param_type);
 
-    std::string Deserialize(const char* beg, const char* const end) override;
+    void Deserialize(const char* beg, const char* const end, std::string& ret) const override;
+
+    size_t GetMemoryUsage() const override
+    {
+        return sizeof(*this) + GetHeapSize(param_name_);
+    }
+
     ~PrimitiveDeserializer() override = default;
 
 private:
@@ -15,45 +15,101 @@
 #ifndef OAS_VALIDATOR_HPP
 #define OAS_VALIDATOR_HPP
 
+#include "oas_validator_types.hpp"
+
+#include <cstddef>
 #include <exception>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 class ValidatorInitExc; ///< Forward declaration for the custom exception class.
 class OASValidatorImp; ///< Forward declaration for the implementation class.
+class ShadowValidatorImp; ///< Forward declaration for the implementation of ShadowValidator.
+struct RouteInfo; ///< Forward declaration for the operation resolved by a RouteHandle.
 
 /**
- * @brief Enum class for specifying validation errors.
+ * @brief Forward declarations of the RapidJSON documents bodies are exchanged as, see rapidjson/fwd.h.
  *
- * This enum class is used to categorize different types of validation errors that might
- * occur during the validation process.
+ * Include rapidjson/document.h to use them. The library is built with RapidJSON's default namespace and allocators.
  */
-#ifndef VALIDATION_ERROR
-#define VALIDATION_ERROR
-enum class ValidationError
+namespace rapidjson {
+class CrtAllocator;
+template <typename BaseAllocator>
+class MemoryPoolAllocator;
+template <typename CharType>
+struct UTF8;
+template <typename Encoding, typename Allocator>
+class GenericValue;
+template <typename Encoding, typename Allocator, typename StackAllocator>
+class GenericDocument;
+typedef GenericValue<UTF8<char>, MemoryPoolAllocator<CrtAllocator> > Value;
+typedef GenericDocument<UTF8<char>, MemoryPoolAllocator<CrtAllocator>, CrtAllocator> Document;
+} // namespace rapidjson
+
+/**
+ * @brief Operation of the specification resolved once, for requests already routed by the caller.
+ *
+ * Obtained from OASValidator::GetRoute() or OASValidator::GetRouteByOperationId(). Validating with a handle skips the
+ * method parsing and the route lookup, the concrete path is only used to extract path parameters. A handle is cheap
+ * to copy, can be shared between threads and keeps its compiled operation alive: after OASValidator::ReloadSpecs() it
+ * still validates against the specification it was resolved from, so it should be resolved again.
+ */
+class RouteHandle
 {
-    NONE = 0, ///< No error occurred.
-    INVALID_METHOD = -1, ///< The HTTP method is not valid.
-    INVALID_ROUTE = -2, ///< The HTTP route is not valid.
-    INVALID_PATH_PARAM = -3, ///< The path parameter is not valid.
-    INVALID_QUERY_PARAM = -4, ///< The query parameter is not valid.
-    INVALID_HEADER_PARAM = -5, ///< The header parameter is not valid.
-    INVALID_BODY = -6, ///< The request body is not valid.
-    INVALID_RSP = -7 ///< The response is not valid.
+private:
+    friend class OASValidator;
+    std::shared_ptr<const RouteInfo> route_{}; ///< Resolved operation, null for an invalid handle.
+
+public:
+    /**
+     * @brief Constructs an invalid handle, validation with it fails with ValidationError::INVALID_ROUTE.
+     */
+    RouteHandle() = default;
+
+    /**
+     * @brief Tells whether the handle was resolved.
+     * @return true if the handle refers to an operation.
+     */
+    bool IsValid() const;
+
+    /**
+     * @brief HTTP method the handle was resolved with, in uppercase (e.g., "GET" or a custom verb as "PURGE").
+     * @return The method, empty for an invalid handle.
+     */
+    const std::string& GetMethod() const;
+
+    /**
+     * @brief Path template of the operation as in the specification (e.g., "/pets/{petId}"), e.g. for metrics labels.
+     * @return The path template, empty for an invalid handle.
+     */
+    const std::string& GetPathTemplate() const;
+
+    /**
+     * @brief `operationId` of the operation.
+     * @return The operationId, empty if the operation has none or for an invalid handle.
+     */
+    const std::string& GetOperationId() const;
 };
-#endif
 
 /**
  * @brief Class that provides API for HTTP requests validation against OAS validation.
  *
  * The OASValidator class offers various methods for validating REST requests
  * against a defined OAS (OpenAPI Specification) file.
+ *
+ * The compiled specification is immutable and reference-counted: copies of an OASValidator share it, so copying is
+ * O(1), takes no extra memory for the specification and the copies can be handed to different threads. All validation
+ * methods are thread-safe.
  */
 class OASValidator
 {
 private:
-    OASValidatorImp* impl_; ///< Pointer to the implementation object.
+    friend class ShadowValidator;
+    std::shared_ptr<const OASValidatorImp> impl_; ///< Shared, immutable compiled specification.
 
 public:
     /**
@@ -64,6 +120,9 @@ public:
      *
      * @param method_map An optional unordered_map where each key is an HTTP method and the value is an unordered_set
      * of methods that can be treated as the key method. This allows certain HTTP methods to be treated as others.
+     * Methods are matched in any casing, here as in requests. A key may also be a custom verb, e.g.
+     * {"PURGE", {"POST"}}, which is then accepted and routed to the operations of its methods. The routes of the mapped
+     * methods are merged into the key's routing table when loading, so an aliased request is routed in a single lookup.
      *
      * For example:
      * @code
@@ -74,21 +133,24 @@ public:
      * OASValidator validator(oas_specs, method_map);
      * @endcode
      *
+     * @param options Optional settings of this instance, e.g. the parser used for request bodies.
+     *
      * @note The OAS specification can be provided as a file path or as a JSON string. If the method map is provided,
      * it allows certain HTTP methods to be treated as others. For instance, with the mapping {"HEAD", {"GET"}},
      * a HEAD request can be validated as the GET request, if HEAD method is not defined.
      */
     explicit OASValidator(const std::string& oas_specs,
-                          const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map = {});
+                          const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map = {},
+                          const ValidatorOptions& options = ValidatorOptions());
 
     /**
-     * @brief Copy constructor.
+     * @brief Copy constructor, shares the compiled specification of `other`.
      * @param other The OASValidator object to be copied.
      */
     OASValidator(const OASValidator& other);
 
     /**
-     * @brief Copy assignment operator.
+     * @brief Copy assignment operator, shares the compiled specification of `other`.
      * @param other The OASValidator object to be copied.
      * @return Reference to the copied OASValidator object.
      */
@@ -213,6 +275,28 @@ public:
                                     const std::unordered_map<std::string, std::string>& headers,
                                     std::string& error_msg);
 
+    /**
+     * @brief Validates the HTTP headers of the request, given as a flat list of header fields, against the OpenAPI
+     * specification.
+     *
+     * Same validation sequence as above, but header names are matched case-insensitively, in a single pass over the
+     * list and without allocating: the declared headers of every route are kept in a precomputed perfect-hash table.
+     * Values are deserialized into a buffer kept by the calling thread, which stops allocating once it has held the
+     * longest value. When a header is repeated, every occurrence is validated.
+     *
+     * @param method The HTTP method as a std::string (e.g., "GET", "POST").
+     * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation, see above.
+     *
+     * @note The error_msg argument will be populated with a JSON string in case of a validation error.
+     */
+    ValidationError ValidateHeaders(const std::string& method, const std::string& http_path,
+                                    const HeaderField* headers, size_t header_count, std::string& error_msg);
+
     /**
      * @brief Validates the entire HTTP request against the OpenAPI specification.
      *
@@ -243,12 +327,14 @@ public:
      * @brief Validates the entire HTTP request including JSON body against the OpenAPI specification.
      *
      * This overloaded function performs a comprehensive validation of the entire HTTP request,
-     * including the JSON body, based on the following sequence:
+     * including the JSON body, based on the following sequence with ValidationOrder::CHEAP_FIRST, the default of
+     * ValidatorOptions::validation_order:
      * 1. HTTP method
      * 2. Route
-     * 3. Body schema
-     * 4. Path parameters (if specified in specs)
-     * 5. Query parameters (if specified in specs)
+     * 3. Path parameters (if specified in specs)
+     * 4. Query parameters (if specified in specs)
+     * 5. Body schema
+     * With ValidationOrder::ADAPTIVE, steps 3 to 5 follow the order learned per route.
      *
      * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
      * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
@@ -304,13 +390,15 @@ public:
      * @brief Validates the entire HTTP request, including JSON body and headers, against the OpenAPI specification.
      *
      * This overloaded function performs a comprehensive validation of the entire HTTP request,
-     * including the JSON body and HTTP headers, based on the following sequence:
+     * including the JSON body and HTTP headers, based on the following sequence with ValidationOrder::CHEAP_FIRST,
+     * the default of ValidatorOptions::validation_order:
      * 1. HTTP method
      * 2. Route
-     * 3. Body schema
-     * 4. Path parameters (if specified in specs)
-     * 5. Query parameters (if specified in specs)
-     * 6. Header parameters
+     * 3. Path parameters (if specified in specs)
+     * 4. Query parameters (if specified in specs)
+     * 5. Header parameters
+     * 6. Body schema
+     * With ValidationOrder::ADAPTIVE, steps 3 to 6 follow the order learned per route.
      *
      * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
      * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
@@ -335,7 +423,685 @@ public:
                                     const std::unordered_map<std::string, std::string>& headers,
                                     std::string& error_msg);
 
+    /**
+     * @brief Validates the entire HTTP request, including headers given as a flat list of header fields.
+     *
+     * Same as the overload taking a header map, with headers matched as described for
+     * ValidateHeaders(const std::string&, const std::string&, const HeaderField*, size_t, std::string&).
+     *
+     * @param method The HTTP method as a std::string (e.g., "GET", "DELETE").
+     * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
+                                    const HeaderField* headers, size_t header_count, std::string& error_msg);
+
+    /**
+     * @brief Validates the entire HTTP request, including JSON body and headers given as a flat list of header fields.
+     *
+     * Same as the overload taking a header map, with headers matched as described for
+     * ValidateHeaders(const std::string&, const std::string&, const HeaderField*, size_t, std::string&).
+     *
+     * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
+     * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
+                                    const std::string& json_body, const HeaderField* headers, size_t header_count,
+                                    std::string& error_msg);
+
+    /**
+     * @brief Validates an HTTP/1.x request given as its raw request head.
+     *
+     * The request line and header lines are tokenized in place, e.g.
+     * "GET /api/v1/resource?id=1 HTTP/1.1\r\nHost: example.com\r\n\r\n", and validated as
+     * ValidateRequest(const std::string&, const std::string&, const HeaderField*, size_t, std::string&) does. Anything
+     * after the empty line ending the head is ignored, and absolute-form targets are routed on their path.
+     *
+     * @param head Pointer to the request head, not null-terminated.
+     * @param head_length Length of the request head.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation. A malformed request line is reported as
+     * INVALID_METHOD or INVALID_ROUTE and a malformed header line as INVALID_HEADER_PARAM.
+     *
+     * @note At most 128 header fields are accepted.
+     */
+    ValidationError ValidateHttp1Request(const char* head, size_t head_length, std::string& error_msg);
+
+    /**
+     * @brief Validates an HTTP/1.x request given as its raw request head and JSON body.
+     *
+     * Same as ValidateHttp1Request(const char*, size_t, std::string&), also validating the body.
+     *
+     * @param head Pointer to the request head, not null-terminated.
+     * @param head_length Length of the request head.
+     * @param json_body Pointer to the JSON body, not null-terminated.
+     * @param body_length Length of the JSON body.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateHttp1Request(const char* head, size_t head_length, const char* json_body,
+                                         size_t body_length, std::string& error_msg);
+
+    /**
+     * @brief Validates an HTTP/2 request given as its list of header fields, including pseudo-headers.
+     *
+     * The method and path are taken from the `:method` and `:path` pseudo-headers, which precede the regular fields.
+     * The list is then validated in place as
+     * ValidateRequest(const std::string&, const std::string&, const HeaderField*, size_t, std::string&) does.
+     *
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation. A missing `:method` is reported as
+     * INVALID_METHOD and a missing `:path` as INVALID_ROUTE.
+     */
+    ValidationError ValidateHttp2Request(const HeaderField* headers, size_t header_count, std::string& error_msg);
+
+    /**
+     * @brief Validates an HTTP/2 request given as its list of header fields and JSON body.
+     *
+     * Same as ValidateHttp2Request(const HeaderField*, size_t, std::string&), also validating the body.
+     *
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param json_body Pointer to the JSON body, not null-terminated.
+     * @param body_length Length of the JSON body.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateHttp2Request(const HeaderField* headers, size_t header_count, const char* json_body,
+                                         size_t body_length, std::string& error_msg);
+
+    /**
+     * @brief Resolves an operation by HTTP method and path template, for validating requests routed by the caller.
+     *
+     * @param method The HTTP method as a std::string (e.g., "GET"), in any casing. Methods of the method map are
+     * resolved to the operations they are mapped to.
+     * @param path_template The path as written in the specification (e.g., "/pets/{petId}").
+     * @param route Reference to the RouteHandle receiving the operation, left unchanged on error.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of an error.
+     *
+     * @return ValidationError enum indicating the result.
+     * Possible values include:
+     * - ValidationError::NONE: The operation was resolved.
+     * - ValidationError::INVALID_METHOD: Invalid HTTP method.
+     * - ValidationError::INVALID_ROUTE: No operation for this method and path template.
+     */
+    ValidationError GetRoute(const std::string& method, const std::string& path_template, RouteHandle& route,
+                             std::string& error_msg) const;
+
+    /**
+     * @brief Resolves an operation by its `operationId`.
+     *
+     * @param operation_id The operationId of the operation in the specification.
+     * @param route Reference to the RouteHandle receiving the operation, left unchanged on error.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of an error.
+     *
+     * @return ValidationError::NONE, or ValidationError::INVALID_ROUTE if no operation has this operationId.
+     */
+    ValidationError GetRouteByOperationId(const std::string& operation_id, RouteHandle& route,
+                                          std::string& error_msg) const;
+
+    /**
+     * @brief Validates the JSON body of a request routed to `route`.
+     *
+     * Same as ValidateBody(const std::string&, const std::string&, const std::string&, std::string&) without the
+     * method and route validation.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateBody(const RouteHandle& route, const std::string& json_body, std::string& error_msg);
+
+    /**
+     * @brief Validates the path parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path as a std::string (e.g., "/pets/42"), the query string is ignored. A path that
+     * does not match the path template of `route`, once normalized as set by ValidatorOptions::path_normalization,
+     * fails with ValidationError::INVALID_ROUTE.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidatePathParam(const RouteHandle& route, const std::string& http_path, std::string& error_msg);
+
+    /**
+     * @brief Validates the query parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string (e.g., "/pets?limit=10"). The path itself
+     * is not matched against the path template.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateQueryParam(const RouteHandle& route, const std::string& http_path, std::string& error_msg);
+
+    /**
+     * @brief Validates the header parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param headers An unordered_map containing the headers of the HTTP request.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateHeaders(const RouteHandle& route,
+                                    const std::unordered_map<std::string, std::string>& headers,
+                                    std::string& error_msg);
+
+    /**
+     * @brief Validates the header fields of a request routed to `route`, see
+     * ValidateHeaders(const std::string&, const std::string&, const HeaderField*, size_t, std::string&).
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateHeaders(const RouteHandle& route, const HeaderField* headers, size_t header_count,
+                                    std::string& error_msg);
+
+    /**
+     * @brief Validates the path and query parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string (e.g., "/pets/42?details=true"). A path
+     * that does not match the path template of `route`, once normalized as set by
+     * ValidatorOptions::path_normalization, fails with ValidationError::INVALID_ROUTE.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const RouteHandle& route, const std::string& http_path, std::string& error_msg);
+
+    /**
+     * @brief Validates the body, path and query parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                    const std::string& json_body, std::string& error_msg);
+
+    /**
+     * @brief Validates the path, query and header parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string.
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const RouteHandle& route, const std::string& http_path, const HeaderField* headers,
+                                    size_t header_count, std::string& error_msg);
+
+    /**
+     * @brief Validates the body, path, query and header parameters of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param headers Pointer to the first of `header_count` header fields, in arrival order.
+     * @param header_count Number of header fields.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                    const std::string& json_body, const HeaderField* headers, size_t header_count,
+                                    std::string& error_msg);
+
+    /**
+     * @brief Validates the JSON body of the HTTP request and hands the parsed body over, so that it is parsed once.
+     *
+     * Same as ValidateBody(const std::string&, const std::string&, const std::string&, std::string&), the body is
+     * parsed into `body` instead of a document of the call. With BodyParser::STRUCTURAL_INDEX, the document is built
+     * while the body is validated.
+     *
+     * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
+     * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param body Reference to the rapidjson::Document receiving the parsed body. Its strings are copies, it does not
+     * refer to `json_body`. It is null when the operation declares no JSON body, and should not be used on error.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     *
+     * @note Allocations go to the allocator of `body`, e.g. a rapidjson::MemoryPoolAllocator over a buffer of the
+     * caller.
+     */
+    ValidationError ValidateBody(const std::string& method, const std::string& http_path, const std::string& json_body,
+                                 rapidjson::Document& body, std::string& error_msg);
+
+    /**
+     * @brief Validates a JSON body already parsed by the caller.
+     *
+     * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
+     * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
+     * @param body The parsed body, e.g. a rapidjson::Document.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation. Syntax errors are the caller's, only
+     * schema errors are reported.
+     */
+    ValidationError ValidateBody(const std::string& method, const std::string& http_path, const rapidjson::Value& body,
+                                 std::string& error_msg);
+
+    /**
+     * @brief Validates the JSON body of a request routed to `route` and hands the parsed body over, see
+     * ValidateBody(const std::string&, const std::string&, const std::string&, rapidjson::Document&, std::string&).
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param body Reference to the rapidjson::Document receiving the parsed body.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateBody(const RouteHandle& route, const std::string& json_body, rapidjson::Document& body,
+                                 std::string& error_msg);
+
+    /**
+     * @brief Validates a JSON body, already parsed by the caller, of a request routed to `route`.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param body The parsed body, e.g. a rapidjson::Document.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateBody(const RouteHandle& route, const rapidjson::Value& body, std::string& error_msg);
+
+    /**
+     * @brief Validates the path parameters of the HTTP request and extracts them as typed values.
+     *
+     * Same as ValidatePathParam(const std::string&, const std::string&, std::string&), the values the parameters
+     * are deserialized to while validated are kept in `values` instead of being dropped, so that they need not be
+     * parsed again by the application.
+     *
+     * @param method The HTTP method as a std::string (e.g., "GET", "DELETE").
+     * @param http_path The HTTP path with parameters as a std::string (e.g., "/pets/42").
+     * @param values Reference to the ParamValues receiving the parameters, cleared first. On error it holds the
+     * parameters validated before the invalid one.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     *
+     * @note Values are views into `values`, they do not refer to `http_path`.
+     */
+    ValidationError ValidatePathParam(const std::string& method, const std::string& http_path, ParamValues& values,
+                                      std::string& error_msg);
+
+    /**
+     * @brief Validates the query parameters of the HTTP request and extracts them as typed values, see
+     * ValidatePathParam(const std::string&, const std::string&, ParamValues&, std::string&).
+     *
+     * @param method The HTTP method as a std::string (e.g., "GET", "DELETE").
+     * @param http_path The HTTP path including query parameters as a std::string (e.g., "/pets?limit=10").
+     * @param values Reference to the ParamValues receiving the parameters, cleared first. Optional parameters absent
+     * from the query have a ParamType::MISSING value.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateQueryParam(const std::string& method, const std::string& http_path, ParamValues& values,
+                                       std::string& error_msg);
+
+    /**
+     * @brief Validates the path and query parameters of the HTTP request and extracts them as typed values, path
+     * parameters first, see ValidatePathParam(const std::string&, const std::string&, ParamValues&, std::string&).
+     *
+     * @param method The HTTP method as a std::string (e.g., "GET", "DELETE").
+     * @param http_path The HTTP path with its query string as a std::string (e.g., "/pets/42?details=true").
+     * @param values Reference to the ParamValues receiving the parameters, cleared first.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path, ParamValues& values,
+                                    std::string& error_msg);
+
+    /**
+     * @brief Validates the path parameters of a request routed to `route` and extracts them as typed values.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path as a std::string (e.g., "/pets/42"), the query string is ignored.
+     * @param values Reference to the ParamValues receiving the parameters, cleared first.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidatePathParam(const RouteHandle& route, const std::string& http_path, ParamValues& values,
+                                      std::string& error_msg);
+
+    /**
+     * @brief Validates the query parameters of a request routed to `route` and extracts them as typed values.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string (e.g., "/pets?limit=10").
+     * @param values Reference to the ParamValues receiving the parameters, cleared first.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateQueryParam(const RouteHandle& route, const std::string& http_path, ParamValues& values,
+                                       std::string& error_msg);
+
+    /**
+     * @brief Validates the path and query parameters of a request routed to `route` and extracts them as typed
+     * values, path parameters first.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string (e.g., "/pets/42?details=true").
+     * @param values Reference to the ParamValues receiving the parameters, cleared first.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const RouteHandle& route, const std::string& http_path, ParamValues& values,
+                                    std::string& error_msg);
+
+    /**
+     * @brief Validates the JSON body of the HTTP request within a deadline.
+     *
+     * Same as ValidateBody(const std::string&, const std::string&, const std::string&, std::string&), the validation
+     * stops with ValidationError::TIMEOUT once `deadline` has passed or is cancelled. The deadline is checked while
+     * the body is parsed and while it is validated, every few hundred values.
+     *
+     * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
+     * @param http_path The HTTP path as a std::string (e.g., "/api/v1/resource").
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param deadline Time point and cancellation flag of the validation.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation, ValidationError::TIMEOUT when it was
+     * stopped.
+     *
+     * @note A single value is not interrupted, e.g. a long string matched against a `pattern`.
+     */
+    ValidationError ValidateBody(const std::string& method, const std::string& http_path, const std::string& json_body,
+                                 const ValidationDeadline& deadline, std::string& error_msg);
+
+    /**
+     * @brief Validates the JSON body of a request routed to `route` within a deadline, see
+     * ValidateBody(const std::string&, const std::string&, const std::string&, const ValidationDeadline&,
+     * std::string&).
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param deadline Time point and cancellation flag of the validation.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateBody(const RouteHandle& route, const std::string& json_body,
+                                 const ValidationDeadline& deadline, std::string& error_msg);
+
+    /**
+     * @brief Validates the HTTP request within a deadline.
+     *
+     * Same as ValidateRequest(const std::string&, const std::string&, const std::string&,
+     * const std::unordered_map<std::string, std::string>&, std::string&), the deadline is also checked before each
+     * component of the request is validated.
+     *
+     * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
+     * @param http_path The HTTP path with its query string as a std::string.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param headers The HTTP headers as a std::unordered_map.
+     * @param deadline Time point and cancellation flag of the validation.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation, ValidationError::TIMEOUT when it was
+     * stopped.
+     */
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
+                                    const std::string& json_body,
+                                    const std::unordered_map<std::string, std::string>& headers,
+                                    const ValidationDeadline& deadline, std::string& error_msg);
+
+    /**
+     * @brief Validates the HTTP request, with its header fields, within a deadline, see
+     * ValidateRequest(const std::string&, const std::string&, const std::string&,
+     * const std::unordered_map<std::string, std::string>&, const ValidationDeadline&, std::string&).
+     *
+     * @param method The HTTP method as a std::string (e.g., "POST", "PUT").
+     * @param http_path The HTTP path with its query string as a std::string.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param headers Pointer to `header_count` header fields.
+     * @param header_count Number of header fields.
+     * @param deadline Time point and cancellation flag of the validation.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
+                                    const std::string& json_body, const HeaderField* headers, size_t header_count,
+                                    const ValidationDeadline& deadline, std::string& error_msg);
+
+    /**
+     * @brief Validates a request routed to `route`, with its header fields, within a deadline.
+     *
+     * @param route Operation of the request, an invalid handle fails with ValidationError::INVALID_ROUTE.
+     * @param http_path The HTTP path with its query string as a std::string.
+     * @param json_body The JSON body of the HTTP request as a std::string.
+     * @param headers Pointer to `header_count` header fields.
+     * @param header_count Number of header fields.
+     * @param deadline Time point and cancellation flag of the validation.
+     * @param error_msg Reference to a std::string where the error message will be stored in case of a validation error.
+     *
+     * @return ValidationError enum indicating the result of the validation.
+     */
+    ValidationError ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                    const std::string& json_body, const HeaderField* headers, size_t header_count,
+                                    const ValidationDeadline& deadline, std::string& error_msg);
+
+    /**
+     * @brief Reloads the OpenAPI specification, recompiling only the operations that have changed.
+     *
+     * The new specification is compared with the loaded one per operation (method + path), after all `$ref`
+     * references are resolved, so a change in a shared component is detected in every operation using it. Validators
+     * of unchanged operations are reused as-is, only added or changed operations are compiled, and validators of
+     * removed operations are released.
+     *
+     * @param oas_specs File path to the OAS specification in JSON format or JSON string containing the OAS
+     * specification.
+     *
+     * @throws ValidatorInitExc if the new specification cannot be loaded. In that case the currently loaded
+     * specification remains in use.
+     *
+     * @note Only this object switches to the new specification, copies made before the reload keep validating
+     * against the previous one. Reloading must not run concurrently with validation calls on the same object.
+     * @note The spec references reported in errors are interned in a table shared by the specification and every
+     * specification reloaded from it. Each reload adds the references it has not seen before. Once the table holds
+     * more references of operations no longer loaded than of loaded ones, the reload starts a new table and builds
+     * all the operations again instead of reusing the unchanged ones. A table is released with the last copy or
+     * RouteHandle using it.
+     */
+    void ReloadSpecs(const std::string& oas_specs);
+
+    /**
+     * @brief Reports the memory taken by the loaded specification.
+     *
+     * The report is a JSON object with the following members:
+     * - `totalBytes`: Bytes taken by this specification, shared objects are counted once.
+     * - `routing`: Number of `PathTrie` nodes, bytes of the path tries and of the per-path route maps and filters.
+     * - `routes`: Per route (method + path) the bytes of its validators store, number of validators and bytes of the
+     *   schemas and deserializers it references (which can be shared with other routes).
+     * - `schemas`, `deserializers`: Number of compiled instances, number of references to them, how many are shared
+     *   by more than one validator, how many are duplicates of an identical definition, and their bytes.
+     * - `specRefs`: Number and bytes of interned spec references. The table is shared with the specifications reloaded
+     *   from this one, until a reload starts a new one.
+     *
+     * @return JSON string with the memory report.
+     *
+     * @note Heap bytes of containers are estimated from their sizes and capacities, allocator overhead is not
+     * included. Compiled schemas are measured exactly on glibc.
+     */
+    std::string GetMemoryReport() const;
+
+    /**
+     * @brief Reports the counters of the route cache enabled by ValidatorOptions::route_cache_capacity.
+     *
+     * @return RouteCacheStats with hits, misses, evictions, cached paths and capacity. All zero when the cache is
+     * disabled.
+     *
+     * @note The cache and its counters are shared by the copies of this object, ReloadSpecs() starts a new, empty
+     * cache.
+     */
+    RouteCacheStats GetRouteCacheStats() const;
+
+    /**
+     * @brief Reports the order in which ValidateRequest() validates the components of the requests of each route.
+     *
+     * With ValidationOrder::ADAPTIVE, one request in 8 per thread is sampled until a route has
+     * ValidatorOptions::adaptive_order_samples of them: every component of a sampled request is validated, even after
+     * one is invalid, and timed. The route's order is then fixed, components sorted by time spent per failure.
+     *
+     * @return ValidationOrderStats per operation of the specification. Counters stay zero with
+     * ValidationOrder::CHEAP_FIRST.
+     *
+     * @note The counters and orders are shared by the copies of this object, ReloadSpecs() keeps those of the
+     * operations that did not change.
+     */
+    std::vector<ValidationOrderStats> GetValidationOrderStats() const;
+
+    /**
+     * @brief Reports the bodies sampled per route by ValidatorOptions::body_sampling and
+     * ValidatorOptions::route_body_sampling.
+     *
+     * @return BodySamplingStats per operation with a JSON body schema, with bodies checked and skipped and the time
+     * spent validating those checked. Counters stay zero with BodySamplingMode::ALL.
+     *
+     * @note Only the text bodies of ValidateBody() and ValidateRequest() are sampled, documents returned or given
+     * are always validated. The counters are shared by the copies of this object, ReloadSpecs() keeps those of the
+     * operations that did not change.
+     */
+    std::vector<BodySamplingStats> GetBodySamplingStats() const;
+
     ~OASValidator();
 };
 
+/**
+ * @brief Validates requests in the background, off the request path, e.g. to observe a new API version without
+ * rejecting or delaying any request.
+ *
+ * Enqueue() copies the parts of a request, or takes them over, into a bounded lock-free queue and returns. Each
+ * background thread drains its own queue, validates the requests as OASValidator::ValidateRequest() does and reports
+ * the invalid ones to the failure callback and to the counters of GetStats(). A request finding its queue full is
+ * dropped and counted, Enqueue() never blocks. Copying a request seldom allocates once the buffers of the queue have
+ * grown to the requests sent. Enqueue(), GetStats() and Flush() are thread-safe.
+ */
+class ShadowValidator
+{
+private:
+    std::unique_ptr<ShadowValidatorImp> impl_; ///< Queues and background threads.
+
+public:
+    /**
+     * @brief Callback receiving the invalid requests, called from the background threads.
+     *
+     * It is called concurrently when there are several threads, and must not throw.
+     */
+    using FailureCallback =
+        std::function<void(const ShadowRequest& request, ValidationError error, const std::string& error_msg)>;
+
+    /**
+     * @brief Starts the background threads.
+     *
+     * @param validator Validator whose specification and options the requests are validated with, as loaded now:
+     * a later OASValidator::ReloadSpecs() does not apply to this object.
+     * @param options Threads and queue capacity.
+     * @param on_failure Optional callback receiving the invalid requests.
+     *
+     * @throws ValidatorInitExc If `options` asks for no thread or an empty queue.
+     */
+    explicit ShadowValidator(const OASValidator& validator, const ShadowOptions& options = ShadowOptions(),
+                             FailureCallback on_failure = nullptr);
+
+    ShadowValidator(const ShadowValidator&) = delete;
+    ShadowValidator& operator=(const ShadowValidator&) = delete;
+
+    /**
+     * @brief Copies a request with a body into a queue, to be validated in the background.
+     *
+     * @param method HTTP method of the request.
+     * @param http_path Concrete path of the request, with its query string if any.
+     * @param json_body JSON body of the request, validated even when empty.
+     * @param headers Headers of the request, the bytes are copied.
+     * @param header_count Number of headers.
+     *
+     * @return true if the request is queued, false if it was dropped because the queue was full.
+     */
+    bool Enqueue(const std::string& method, const std::string& http_path, const std::string& json_body,
+                 const HeaderField* headers, size_t header_count);
+
+    /**
+     * @brief Copies a request without a body into a queue, to be validated in the background.
+     *
+     * @param method HTTP method of the request.
+     * @param http_path Concrete path of the request, with its query string if any.
+     * @param headers Headers of the request, the bytes are copied.
+     * @param header_count Number of headers.
+     *
+     * @return true if the request is queued, false if it was dropped because the queue was full.
+     */
+    bool Enqueue(const std::string& method, const std::string& http_path, const HeaderField* headers,
+                 size_t header_count);
+
+    /**
+     * @brief Takes over the parts of a request, to be validated in the background.
+     *
+     * @param request Request whose parts are swapped into a queue, its body validated only if `has_body` is set. When
+     * it is queued, `request` is left empty, holding the string buffers of a slot already validated and cleared, which
+     * can be reused to build the next request without allocating.
+     *
+     * @return true if the request is queued, false if it was dropped because the queue was full and `request` is left
+     * unchanged.
+     */
+    bool Enqueue(ShadowRequest&& request);
+
+    /**
+     * @brief Waits until the requests queued before the call are validated.
+     */
+    void Flush();
+
+    /**
+     * @brief Reports the requests queued, dropped, validated and found invalid so far.
+     * @return ShadowStats of this object.
+     */
+    ShadowStats GetStats() const;
+
+    /**
+     * @brief Validates the requests still queued, then stops the background threads.
+     */
+    ~ShadowValidator();
+};
+
 #endif // OAS_VALIDATOR_HPP
@@ -8,71 +8,249 @@
 #define OAS_VALIDATION_HPP
 
 #include "utils/common.hpp"
+#include "utils/memory_report.hpp"
+#include "utils/path_normalizer.hpp"
 #include "utils/path_trie.hpp"
+#include "utils/route_cache.hpp"
+#include "utils/route_filter.hpp"
+#include "utils/raw_request.hpp"
+#include "utils/spec_ref_table.hpp"
 #include "validators/method_validator.hpp"
 #include "validators/validators_store.hpp"
 
+#include <array>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+// Operation of a RouteHandle. Holds its validators, so that it outlives the OASValidatorImp it was resolved from.
+struct RouteInfo
+{
+    RouteInfo(std::string method_name, std::string path, std::string operation,
+              std::shared_ptr<const ValidatorsStore> store);
+
+    const std::string method;
+    const std::string path_template;
+    const std::string operation_id;
+    const std::shared_ptr<const ValidatorsStore> validators;
+    const std::vector<std::string> segments; // Of the path template split at '/', as PathTrie indexes them
+
+    // Path parameters of the path in [beg, end) by segment index, false if it does not match the template
+    bool MatchPath(const char* beg, const char* end, std::unordered_map<size_t, ParamRange>& param_idxs) const;
+    // Same for a normalized path, literal segments being compared as `normalizer` keys them
+    bool MatchPath(const NormalizedPath& path, const PathNormalizer& normalizer,
+                   std::unordered_map<size_t, ParamRange>& param_idxs) const;
+};
+
+// Compiled specification, immutable after construction so that it can be shared between OASValidator copies and
+// threads. Validation state is created per call.
 class OASValidatorImp
 {
 public:
     explicit OASValidatorImp(const std::string& oas_specs,
-                             const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map = {});
-    ValidationError ValidateRoute(const std::string& method, const std::string& http_path, std::string& error_msg);
+                             const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map = {},
+                             const ValidatorOptions& options = ValidatorOptions());
+    // Incremental reload, shares the validators of unchanged operations and the options with `loaded`
+    OASValidatorImp(const std::string& oas_specs, const OASValidatorImp& loaded);
+    OASValidatorImp(const OASValidatorImp&) = delete;
+    OASValidatorImp& operator=(const OASValidatorImp&) = delete;
+
+    ValidationError ValidateRoute(const std::string& method, const std::string& http_path,
+                                  std::string& error_msg) const;
+    // Bodies and requests given a `deadline` stop with ValidationError::TIMEOUT once it has passed
+    ValidationError ValidateBody(const std::string& method, const std::string& http_path, const std::string& json_body,
+                                 std::string& error_msg, const ValidationDeadline* deadline = nullptr) const;
+    // The parsed body is kept in `body`, owned by the caller
     ValidationError ValidateBody(const std::string& method, const std::string& http_path, const std::string& json_body,
-                                 std::string& error_msg);
-    ValidationError ValidatePathParam(const std::string& method, const std::string& http_path, std::string& error_msg);
-    ValidationError ValidateQueryParam(const std::string& method, const std::string& http_path, std::string& error_msg);
+                                 rapidjson::Document& body, std::string& error_msg) const;
+    ValidationError ValidateBody(const std::string& method, const std::string& http_path,
+                                 const rapidjson::Value& body, std::string& error_msg) const;
+    // Valid path and query parameters are added to `values` when given
+    ValidationError ValidatePathParam(const std::string& method, const std::string& http_path, std::string& error_msg,
+                                      ParamValues* values = nullptr) const;
+    ValidationError ValidateQueryParam(const std::string& method, const std::string& http_path,
+                                       std::string& error_msg, ParamValues* values = nullptr) const;
     ValidationError ValidateHeaders(const std::string& method, const std::string& http_path,
                                     const std::unordered_map<std::string, std::string>& headers,
-                                    std::string& error_msg);
-    ValidationError ValidateRequest(const std::string& method, const std::string& http_path, std::string& error_msg);
+                                    std::string& error_msg) const;
+    ValidationError ValidateHeaders(const std::string& method, const std::string& http_path,
+                                    const HeaderField* headers, size_t header_count, std::string& error_msg) const;
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path, std::string& error_msg,
+                                    ParamValues* values = nullptr) const;
     ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
-                                    const std::string& json_body, std::string& error_msg);
+                                    const std::string& json_body, std::string& error_msg) const;
     ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
                                     const std::unordered_map<std::string, std::string>& headers,
-                                    std::string& error_msg);
+                                    std::string& error_msg) const;
     ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
                                     const std::string& json_body,
                                     const std::unordered_map<std::string, std::string>& headers,
-                                    std::string& error_msg);
-    ~OASValidatorImp();
+                                    std::string& error_msg, const ValidationDeadline* deadline = nullptr) const;
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
+                                    const HeaderField* headers, size_t header_count, std::string& error_msg) const;
+    ValidationError ValidateRequest(const std::string& method, const std::string& http_path,
+                                    const std::string& json_body, const HeaderField* headers, size_t header_count,
+                                    std::string& error_msg, const ValidationDeadline* deadline = nullptr) const;
+    // Raw request heads, `json_body` is not validated when null
+    ValidationError ValidateHttp1Request(const char* head, size_t head_length, const char* json_body,
+                                         size_t body_length, std::string& error_msg) const;
+    ValidationError ValidateHttp2Request(const HeaderField* headers, size_t header_count, const char* json_body,
+                                         size_t body_length, std::string& error_msg) const;
+    ValidationError GetRoute(const std::string& method, const std::string& path_template,
+                             std::shared_ptr<const RouteInfo>& route, std::string& error_msg) const;
+    ValidationError GetRouteByOperationId(const std::string& operation_id, std::shared_ptr<const RouteInfo>& route,
+                                          std::string& error_msg) const;
+    // Pre-routed requests, `route` may come from another OASValidatorImp and is null for an invalid handle
+    ValidationError ValidateBody(const RouteInfo* route, const std::string& json_body, std::string& error_msg,
+                                 const ValidationDeadline* deadline = nullptr) const;
+    ValidationError ValidateBody(const RouteInfo* route, const std::string& json_body, rapidjson::Document& body,
+                                 std::string& error_msg) const;
+    ValidationError ValidateBody(const RouteInfo* route, const rapidjson::Value& body, std::string& error_msg) const;
+    ValidationError ValidatePathParam(const RouteInfo* route, const std::string& http_path, std::string& error_msg,
+                                      ParamValues* values = nullptr) const;
+    ValidationError ValidateQueryParam(const RouteInfo* route, const std::string& http_path, std::string& error_msg,
+                                       ParamValues* values = nullptr) const;
+    ValidationError ValidateHeaders(const RouteInfo* route, const std::unordered_map<std::string, std::string>& headers,
+                                    std::string& error_msg) const;
+    ValidationError ValidateHeaders(const RouteInfo* route, const HeaderField* headers, size_t header_count,
+                                    std::string& error_msg) const;
+    ValidationError ValidateRequest(const RouteInfo* route, const std::string& http_path, std::string& error_msg,
+                                    ParamValues* values = nullptr) const;
+    ValidationError ValidateRequest(const RouteInfo* route, const std::string& http_path,
+                                    const std::string& json_body, std::string& error_msg) const;
+    ValidationError ValidateRequest(const RouteInfo* route, const std::string& http_path, const HeaderField* headers,
+                                    size_t header_count, std::string& error_msg) const;
+    ValidationError ValidateRequest(const RouteInfo* route, const std::string& http_path,
+                                    const std::string& json_body, const HeaderField* headers, size_t header_count,
+                                    std::string& error_msg, const ValidationDeadline* deadline = nullptr) const;
+    std::string GetMemoryReport() const;
+    RouteCacheStats GetRouteCacheStats() const;
+    std::vector<ValidationOrderStats> GetValidationOrderStats() const;
+    std::vector<BodySamplingStats> GetBodySamplingStats() const;
+    ~OASValidatorImp() = default;
 
 private:
-    static const std::unordered_map<std::string, HttpMethod> kStringToMethod;
+    // Resolved operation object, serialized, compared on reload when the digests are equal
+    struct OperationDigest
+    {
+        uint64_t digest;
+        std::string serialized;
+    };
 
     struct PerMethod
     {
-        std::unordered_map<std::string, ValidatorsStore*> per_path_validators{};
+        std::unordered_map<std::string, std::shared_ptr<const ValidatorsStore>> per_path_validators{};
+        std::unordered_map<std::string, OperationDigest> per_path_digests{};
+        std::unordered_map<std::string, std::string> per_path_operation_ids{}; // Operations having an operationId
         PathTrie path_trie{};
+        RouteFilter route_filter{}; // Rejects most unknown paths before path_trie is searched
+        // Static and templated paths by PathNormalizer keys, for paths that only route once normalized. Built when
+        // normalization is enabled.
+        PathTrie normalized_trie{};
+        std::unordered_map<std::string, std::string> folded_paths{}; // Keys of normalized_trie to paths, ignoring case
+    };
+
+    // Components of a request for ValidateRequest(), headers and body are only validated when given
+    struct RequestParts
+    {
+        std::unordered_map<size_t, ParamRange> param_idxs{};
+        std::string query{};
+        bool has_headers = false;
+        const std::unordered_map<std::string, std::string>* header_map = nullptr; // Else header fields
+        const HeaderField* headers = nullptr;
+        size_t header_count = 0;
+        const char* json_body = nullptr; // Null when the body is not validated
+        size_t body_length = 0;
+        const ValidationDeadline* deadline = nullptr; // Checked before each component and while validating the body
+    };
+
+    using PerMethodValidators = std::array<PerMethod, static_cast<size_t>(HttpMethod::COUNT)>;
+
+    // Method map of the constructor. Routing slots 0 to COUNT - 1 are the methods of the specification, custom verbs
+    // follow.
+    struct MethodMap
+    {
+        std::vector<std::string> custom_methods{}; // Lowercase, custom method i has slot COUNT + i
+        std::vector<std::vector<HttpMethod>> aliases{}; // Per slot, methods whose routes it also takes, by priority
     };
 
-    const std::unordered_map<std::string, std::unordered_set<std::string>> method_map_;
-    std::array<PerMethod, static_cast<size_t>(HttpMethod::COUNT)> oas_validators_{};
-    MethodValidator method_validator_{};
+    const MethodMap method_map_;
+    const ValidatorOptions options_;
+    PerMethodValidators oas_validators_{}; // Routes defined by the specification
+    std::vector<PerMethod> aliased_routes_{}; // Routes of the slots with aliases, merged with those of the aliases
+    std::vector<const PerMethod*> routes_{}; // Per slot, into oas_validators_ or aliased_routes_
+    std::unordered_map<std::string, std::pair<HttpMethod, std::string>> operations_{}; // operationId to method, path
+    ValidatorsCache validators_cache_{}; // Only mutated while loading
+    size_t live_spec_refs_ = 0; // Distinct spec references of oas_validators_, the others of the table are dead
+    const MethodValidator method_validator_{};
+    const std::unique_ptr<RouteCache> route_cache_; // Concrete paths to routes, null when disabled. Filled by lookups.
+    PathNormalizer path_normalizer_{}; // Only mutated while loading, with the base paths of the specification
 
-    ValidationError GetValidators(const std::string& method, const std::string& mapped_method,
-                                  const std::string& http_path, ValidatorsStore*& validators, std::string& error_msg,
+    // Routing slot of the method, its routes are routes_[slot]
+    ValidationError GetRoutes(const std::string& method, size_t& slot, std::string& error_msg) const;
+    ValidationError GetValidators(const std::string& method, const std::string& http_path,
+                                  const ValidatorsStore*& validators, std::string& error_msg,
                                   std::unordered_map<size_t, ParamRange>* param_idxs = nullptr,
-                                  std::string* query = nullptr);
-    ValidationError GetValidators(const std::string& method, const std::string& http_path, ValidatorsStore*& validators,
-                                  std::string& error_msg, std::unordered_map<size_t, ParamRange>* param_idxs = nullptr,
-                                  std::string* query = nullptr);
+                                  std::string* query = nullptr) const;
+    // Route of the path in [beg, end), a suffix of `http_path`
+    static bool FindRoute(const PerMethod& routes, const std::string& http_path, const char* beg, const char* end,
+                          const ValidatorsStore*& validators, std::unordered_map<size_t, ParamRange>* param_idxs);
+    static bool FindNormalizedRoute(const PerMethod& routes, const NormalizedPath& path,
+                                    const ValidatorsStore*& validators,
+                                    std::unordered_map<size_t, ParamRange>* param_idxs);
+    static ValidationError GetValidators(const RouteInfo* route, const ValidatorsStore*& validators,
+                                         std::string& error_msg);
+    // The path, normalized as it is routed, is matched against the template only when `param_idxs` is given
+    ValidationError GetValidators(const RouteInfo* route, const std::string& http_path,
+                                  const ValidatorsStore*& validators, std::string& error_msg,
+                                  std::unordered_map<size_t, ParamRange>* param_idxs,
+                                  std::string* query = nullptr) const;
+    bool MatchPath(const RouteInfo& route, const char* beg, const char* end,
+                   std::unordered_map<size_t, ParamRange>& param_idxs) const;
+    // Validates the components of the request in the order of options_.validation_order
+    ValidationError ValidateParts(const ValidatorsStore& validators, RequestParts& parts, std::string& error_msg) const;
+    ValidationError ValidatePart(const ValidatorsStore& validators, RequestCheck check, RequestParts& parts,
+                                 std::string& error_msg) const;
+    ValidationError ValidateRawRequest(const RawRequest& request, const char* json_body, size_t body_length,
+                                       std::string& error_msg) const;
     static std::vector<std::string> Split(const std::string& str);
     static rapidjson::Value* ResolvePath(rapidjson::Document& doc, const std::string& path);
     static void ParseSpecs(const std::string& oas_specs, rapidjson::Document& doc);
-    void ProcessPath(const rapidjson::Value::ConstMemberIterator& path_itr, std::vector<std::string>& ref_keys);
+    void LoadSpecs(const std::string& oas_specs, const PerMethodValidators* reusable);
+    void ProcessPath(const rapidjson::Value::ConstMemberIterator& path_itr, std::vector<std::string>& ref_keys,
+                     const PerMethodValidators* reusable);
     void ProcessMethod(const rapidjson::Value::ConstMemberIterator& method_itr, const std::string& path,
-                       std::vector<std::string>& ref_keys);
-    static void ProcessRequestBody(const rapidjson::Value::ConstMemberIterator& method_itr, const std::string& path,
-                                   std::vector<std::string>& ref_keys,
-                                   std::unordered_map<std::string, ValidatorsStore*>& per_path_validator);
-    static void ProcessParameters(const rapidjson::Value::ConstMemberIterator& method_itr, const std::string& path,
-                                  std::vector<std::string>& ref_keys,
-                                  std::unordered_map<std::string, ValidatorsStore*>& per_path_validator);
+                       std::vector<std::string>& ref_keys, const PerMethodValidators* reusable);
+    static OperationDigest GetDigest(const rapidjson::Value& value);
+    size_t CountLiveSpecRefs() const;
+    std::shared_ptr<ValidatorsStore> ProcessRequestBody(const rapidjson::Value::ConstMemberIterator& method_itr,
+                                                        std::vector<std::string>& ref_keys, const BodyLimits& limits,
+                                                        const BodySampling& sampling);
+    // Those of the route in `options_.route_body_limits`, else the global ones
+    const BodyLimits& GetBodyLimits(HttpMethod method, const std::string& path) const;
+    // That of the route in `options_.route_body_sampling`, else the global one
+    const BodySampling& GetBodySampling(HttpMethod method, const std::string& path) const;
+    bool HasRoute(const std::string& method, const std::string& path) const;
+    // Throws when a route of the per-route options is not in the specification
+    void CheckRouteOptions() const;
+    // Throws when a sampling of the options is invalid, before any is used
+    void CheckBodySamplings() const;
+    static void CheckBodySampling(const BodySampling& sampling, const std::string& context);
+    void ProcessParameters(const rapidjson::Value::ConstMemberIterator& method_itr, const std::string& path,
+                           std::vector<std::string>& ref_keys, ValidatorsStore& validators);
     void ResolveReferences(rapidjson::Value& value, rapidjson::Document& doc,
                            rapidjson::Document::AllocatorType& allocator);
-    static std::unordered_map<std::string, std::unordered_set<std::string>>
-    BuildCaseInsensitiveMap(const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map);
+    // Keys and values in any casing. Values that are not methods of the specification are ignored.
+    static MethodMap BuildMethodMap(const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map);
+    void ResolveAliases();
+    static void BuildRouteFilter(PerMethod& routes);
+    void AddRouting(const PerMethod& routes, size_t route_map_bytes, MemoryReport& report) const;
+    void BuildNormalizedRoutes(PerMethod& routes) const;
+    // Paths of the server URLs, e.g. "/test/api" of "https://host:9000/test/api/"
+    static std::vector<std::string> GetBasePaths(const rapidjson::Value& doc);
+    static void SetInvalidRoute(const std::string& method, const std::string& http_path, std::string& error_msg);
+    static ValidationError SetTimeout(std::string& error_msg);
+    static void CopyOperationId(const PerMethod& from, const std::string& path, PerMethod& to);
 };
 
 #endif // OAS_VALIDATION_HPP
@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+/**
+ * @file oas_validator_types.hpp
+ * @author Muhammad Nawaz
+ * @date 2023
+ * @brief Types of the OASValidator API, shared by the public header and the implementation.
+ *
+ */
+
+#ifndef OAS_VALIDATOR_TYPES_HPP
+#define OAS_VALIDATOR_TYPES_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Enum class for specifying validation errors.
+ *
+ * This enum class is used to categorize different types of validation errors that might
+ * occur during the validation process.
+ */
+enum class ValidationError
+{
+    NONE = 0, ///< No error occurred.
+    INVALID_METHOD = -1, ///< The HTTP method is not valid.
+    INVALID_ROUTE = -2, ///< The HTTP route is not valid.
+    INVALID_PATH_PARAM = -3, ///< The path parameter is not valid.
+    INVALID_QUERY_PARAM = -4, ///< The query parameter is not valid.
+    INVALID_HEADER_PARAM = -5, ///< The header parameter is not valid.
+    INVALID_BODY = -6, ///< The request body is not valid.
+    INVALID_RSP = -7, ///< The response is not valid.
+    TIMEOUT = -8 ///< The validation was stopped at its deadline or cancelled, the request is neither valid nor invalid.
+};
+
+/**
+ * @brief Non-owning view of one HTTP header field (name and value), as received on the wire.
+ *
+ * The viewed characters must stay valid for the duration of the validation call, so it cannot be constructed from
+ * temporary strings. Names are matched case-insensitively.
+ */
+struct HeaderField
+{
+    HeaderField()
+        : HeaderField(nullptr, 0, nullptr, 0)
+    {
+    }
+
+    HeaderField(const char* name, size_t name_length, const char* value, size_t value_length)
+        : name(name)
+        , name_length(name_length)
+        , value(value)
+        , value_length(value_length)
+    {
+    }
+
+    HeaderField(const std::string& name, const std::string& value)
+        : HeaderField(name.data(), name.size(), value.data(), value.size())
+    {
+    }
+
+    // Temporaries would be destroyed before the validation, leaving the field dangling
+    HeaderField(std::string&& name, const std::string& value) = delete;
+    HeaderField(const std::string& name, std::string&& value) = delete;
+    HeaderField(std::string&& name, std::string&& value) = delete;
+
+    const char* name; ///< Header name, not null-terminated.
+    size_t name_length; ///< Length of the header name.
+    const char* value; ///< Header value, not null-terminated.
+    size_t value_length; ///< Length of the header value.
+};
+
+/**
+ * @brief Enum class for selecting the parser of JSON request bodies.
+ */
+enum class BodyParser
+{
+    RAPIDJSON = 0, ///< RapidJSON's reader, the body is parsed into a document which is then validated.
+    STRUCTURAL_INDEX ///< Vectorized structural index driving the schema validator directly. Requires valid UTF-8.
+                     ///< Parser error descriptions and offsets can differ from RapidJSON's.
+};
+
+/**
+ * @brief Normalization of request paths while they are routed, all disabled by default.
+ *
+ * Normalization only selects the route, the path parameters are validated as sent.
+ */
+struct PathNormalization
+{
+    bool strip_base_paths = false; ///< Strips the path of a `servers[].url` of the specification, e.g. `/test/api`.
+    bool collapse_slashes = false; ///< Routes `//pets///42/` as `/pets/42`.
+    bool remove_dot_segments = false; ///< Routes `/pets/./toys/../42` as `/pets/42`.
+    bool decode_unreserved = false; ///< Decodes escaped letters, digits and `-._~`, routing `/%70ets` as `/pets`.
+    bool ignore_case = false; ///< Matches the literal segments of the paths case-insensitively.
+};
+
+/**
+ * @brief Enum class for the order in which ValidateRequest() validates the components of a request.
+ */
+enum class ValidationOrder
+{
+    CHEAP_FIRST = 0, ///< Path parameters, query parameters, headers, then the body.
+    ADAPTIVE ///< Cheap first, until an order is learned per route from sampled failure rates and costs.
+};
+
+/**
+ * @brief Limits of JSON request bodies, enforced while they are parsed. 0 disables a limit, all are disabled by
+ * default.
+ */
+struct BodyLimits
+{
+    size_t max_bytes = 0; ///< Bytes of the body, checked before it is parsed.
+    size_t max_depth = 0; ///< Arrays and objects nested in one another, 1 for `[1, 2]`.
+    size_t max_array_items = 0; ///< Items of any array.
+    size_t max_object_members = 0; ///< Members of any object.
+    size_t max_string_length = 0; ///< Bytes of any string or member name, once unescaped.
+};
+
+/**
+ * @brief Body limits of one route, replacing ValidatorOptions::body_limits for its requests.
+ */
+struct RouteBodyLimits
+{
+    std::string method{}; ///< HTTP method of the route, in any casing.
+    std::string path_template{}; ///< Path template of the route, as in the specification.
+    BodyLimits limits{}; ///< Limits of the bodies of the route.
+};
+
+/**
+ * @brief Enum class for the policy sampling the JSON bodies validated, see BodySampling.
+ */
+enum class BodySamplingMode
+{
+    ALL = 0, ///< Every body is validated, the default.
+    FIXED_RATE, ///< Each body is validated with probability BodySampling::rate.
+    TOKEN_BUCKET, ///< At most BodySampling::bodies_per_second bodies, in bursts of BodySampling::burst.
+    CPU_BUDGET ///< Bodies are validated while their validation time fits BodySampling::budget_ns_per_second.
+};
+
+/**
+ * @brief Sampling of JSON request bodies. The routing and the parameters of every request are validated, bodies
+ * left out of the sample are accepted without being parsed.
+ */
+struct BodySampling
+{
+    BodySamplingMode mode = BodySamplingMode::ALL; ///< Policy of the sample.
+    double rate = 1.0; ///< Share of the bodies validated by FIXED_RATE, from 0 to 1.
+    double bodies_per_second = 0; ///< Bodies validated per second by TOKEN_BUCKET.
+    double burst = 1; ///< Bodies TOKEN_BUCKET validates at once after being idle.
+    uint64_t budget_ns_per_second = 0; ///< Nanoseconds of body validation per second allowed by CPU_BUDGET.
+};
+
+/**
+ * @brief Body sampling of one route, replacing ValidatorOptions::body_sampling for its requests.
+ */
+struct RouteBodySampling
+{
+    std::string method{}; ///< HTTP method of the route, in any casing.
+    std::string path_template{}; ///< Path template of the route, as in the specification.
+    BodySampling sampling{}; ///< Sampling of the bodies of the route.
+};
+
+/**
+ * @brief Settings of an OASValidator instance, kept by its copies and across ReloadSpecs().
+ */
+struct ValidatorOptions
+{
+    BodyParser body_parser = BodyParser::RAPIDJSON; ///< Parser of JSON request bodies.
+    size_t route_cache_capacity = 0; ///< Concrete paths whose routes are cached, 0 disables the route cache.
+    PathNormalization path_normalization{}; ///< Normalization of request paths while routing.
+    ValidationOrder validation_order = ValidationOrder::CHEAP_FIRST; ///< Order of the components of a request.
+    size_t adaptive_order_samples = 1024; ///< Requests sampled per route before ADAPTIVE fixes its order.
+    BodyLimits body_limits{}; ///< Limits of the bodies of every route.
+    std::vector<RouteBodyLimits> route_body_limits{}; ///< Limits of the bodies of some routes, overriding body_limits.
+    BodySampling body_sampling{}; ///< Sampling of the bodies of every route.
+    std::vector<RouteBodySampling> route_body_sampling{}; ///< Sampling of some routes, overriding body_sampling.
+};
+
+/**
+ * @brief Counters of the route cache, see OASValidator::GetRouteCacheStats().
+ */
+struct RouteCacheStats
+{
+    uint64_t hits = 0; ///< Lookups answered by the cache.
+    uint64_t misses = 0; ///< Lookups routed through the routing tables.
+    uint64_t evictions = 0; ///< Cached paths replaced by other paths.
+    size_t entries = 0; ///< Paths currently cached.
+    size_t capacity = 0; ///< Paths the cache can hold, 0 when it is disabled.
+};
+
+/**
+ * @brief Enum class for the components of a request, as ordered by ValidatorOptions::validation_order.
+ */
+enum class RequestCheck
+{
+    PATH_PARAMS = 0, ///< Path parameters.
+    QUERY_PARAMS, ///< Query parameters.
+    HEADERS, ///< Header parameters.
+    BODY, ///< JSON body.
+    COUNT ///< Number of components.
+};
+
+/**
+ * @brief Counters of one component of the requests sampled on a route, see ValidationOrderStats.
+ */
+struct RequestCheckStats
+{
+    uint64_t runs = 0; ///< Sampled requests the component was validated for.
+    uint64_t failures = 0; ///< Sampled requests it was invalid for.
+    uint64_t nanoseconds = 0; ///< Time spent validating it.
+};
+
+/**
+ * @brief Validation order of a route, see OASValidator::GetValidationOrderStats().
+ */
+struct ValidationOrderStats
+{
+    std::string method{}; ///< HTTP method of the route, uppercase.
+    std::string path_template{}; ///< Path template of the route.
+    bool learned = false; ///< Whether `order` is learned, it is CHEAP_FIRST's until then.
+    uint64_t samples = 0; ///< Requests sampled so far.
+    std::array<RequestCheck, static_cast<size_t>(RequestCheck::COUNT)> order{
+        {RequestCheck::PATH_PARAMS, RequestCheck::QUERY_PARAMS, RequestCheck::HEADERS,
+         RequestCheck::BODY}}; ///< Components in the order they are validated.
+    std::array<RequestCheckStats, static_cast<size_t>(RequestCheck::COUNT)> checks{}; ///< Per RequestCheck.
+};
+
+/**
+ * @brief Bodies sampled on a route, see OASValidator::GetBodySamplingStats().
+ */
+struct BodySamplingStats
+{
+    std::string method{}; ///< HTTP method of the route, uppercase.
+    std::string path_template{}; ///< Path template of the route.
+    BodySamplingMode mode = BodySamplingMode::ALL; ///< Policy of the route, whose counters stay zero when ALL.
+    uint64_t checked = 0; ///< Bodies validated.
+    uint64_t skipped = 0; ///< Bodies accepted without being validated.
+    uint64_t nanoseconds = 0; ///< Time spent validating the checked bodies.
+};
+
+/**
+ * @brief Enum class for the type of a validated parameter value, see ParamValue.
+ */
+enum class ParamType
+{
+    MISSING = 0, ///< Optional parameter absent from the request, or member or item not found.
+    NULL_VALUE, ///< JSON null, only from parameters with a `content` definition.
+    BOOLEAN, ///< Value in ParamValue::boolean.
+    INTEGER, ///< Value in ParamValue::integer, also converted to ParamValue::number.
+    NUMBER, ///< Value in ParamValue::number.
+    STRING, ///< Percent-decoded bytes in ParamValue::string, ParamValue::length of them.
+    ARRAY, ///< ParamValue::length items in ParamValue::items.
+    OBJECT ///< ParamValue::length members in ParamValue::items, each named.
+};
+
+/**
+ * @brief Typed value of a validated parameter, or of an item or a member of it.
+ *
+ * Values are views into the ParamValues they were extracted to, they stay valid until it is cleared or destroyed.
+ */
+struct ParamValue
+{
+    ParamType type = ParamType::MISSING; ///< Type of the value.
+    const char* name = nullptr; ///< Name of the parameter or of the object member, not null-terminated.
+    size_t name_length = 0; ///< Length of the name.
+    bool boolean = false; ///< Value of a BOOLEAN.
+    int64_t integer = 0; ///< Value of an INTEGER.
+    double number = 0; ///< Value of a NUMBER or an INTEGER.
+    const char* string = nullptr; ///< Bytes of a STRING, not null-terminated.
+    size_t length = 0; ///< Bytes of a STRING, items of an ARRAY or members of an OBJECT.
+    const ParamValue* items = nullptr; ///< Items of an ARRAY or members of an OBJECT.
+
+    /**
+     * @brief Item of an ARRAY or member of an OBJECT by position.
+     * @param idx Position of the item.
+     * @return The item, a MISSING value when out of range or not an ARRAY nor an OBJECT.
+     */
+    const ParamValue& GetItem(size_t idx) const;
+
+    /**
+     * @brief Member of an OBJECT by name.
+     * @param member_name Name of the member.
+     * @return The member, a MISSING value when not found or not an OBJECT.
+     */
+    const ParamValue& GetMember(const std::string& member_name) const;
+};
+
+/**
+ * @brief Per-request arena receiving the path and query parameters of a request once they are validated.
+ *
+ * The parameters are kept in the order they are validated: path parameters, then query parameters, each in the
+ * order of the specification. An optional query parameter absent from the request has a MISSING value, so a
+ * parameter of an operation always has the same index. Strings, items and members are allocated from blocks that
+ * are kept by Clear(), so a ParamValues reused from request to request stops allocating once it has grown to the
+ * largest request. It is not thread-safe, use one per thread or per request.
+ */
+class ParamValues
+{
+public:
+    ParamValues() = default;
+    ParamValues(const ParamValues&) = delete;
+    ParamValues& operator=(const ParamValues&) = delete;
+
+    /**
+     * @brief Drops the values, keeping the memory for the next request. Validation calls taking a ParamValues clear
+     * it first.
+     */
+    void Clear();
+
+    /**
+     * @brief Number of parameters extracted.
+     * @return The number of parameters, MISSING ones included.
+     */
+    size_t GetCount() const;
+
+    /**
+     * @brief Parameter by index, in validation order.
+     * @param idx Index of the parameter.
+     * @return The parameter, a MISSING value when out of range.
+     */
+    const ParamValue& Get(size_t idx) const;
+
+    /**
+     * @brief Parameter by name. Path and query parameters of the same name are told apart by their index only.
+     * @param name Name of the parameter as in the specification.
+     * @return The first parameter of that name, a MISSING value when not found.
+     */
+    const ParamValue& Get(const std::string& name) const;
+
+    /**
+     * @brief Bytes allocated by the arena.
+     * @return The heap bytes, kept across Clear().
+     */
+    size_t GetMemoryUsage() const;
+
+private:
+    friend class ParamValuesBuilder; ///< Extracts the validated values.
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data{};
+        size_t size = 0;
+    };
+
+    std::vector<ParamValue> params_{}; ///< Parameters in validation order.
+    std::vector<Block> blocks_{}; ///< Strings, items and members.
+    size_t block_ = 0; ///< Block being filled.
+    size_t used_ = 0; ///< Bytes used in that block.
+};
+
+/**
+ * @brief Deadline and cancellation of a validation, checked while it runs.
+ *
+ * A validation past its deadline, or whose `cancelled` flag is set, stops with ValidationError::TIMEOUT. Bodies are
+ * checked every few hundred values while they are parsed and validated, requests also between their components.
+ */
+struct ValidationDeadline
+{
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::time_point::max(); ///< None by default.
+    const std::atomic<bool>* cancelled = nullptr; ///< Cancels the validation once true, when given.
+};
+
+/**
+ * @brief Parts of a request validated in the background by ShadowValidator.
+ */
+struct ShadowRequest
+{
+    std::string method{}; ///< HTTP method, in any casing.
+    std::string http_path{}; ///< Concrete path, with its query string if any.
+    std::string json_body{}; ///< JSON body.
+    std::vector<std::pair<std::string, std::string>> headers{}; ///< Header names and values.
+    bool has_body = false; ///< Whether the request carries `json_body`, validated even when empty.
+};
+
+/**
+ * @brief Settings of a ShadowValidator.
+ */
+struct ShadowOptions
+{
+    size_t threads = 1; ///< Background threads validating the requests, each with its own queue.
+    size_t queue_capacity = 1024; ///< Requests each queue holds, rounded up to a power of two, at least 2.
+};
+
+/**
+ * @brief Counters of a ShadowValidator, see ShadowValidator::GetStats().
+ */
+struct ShadowStats
+{
+    uint64_t enqueued = 0; ///< Requests accepted into a queue.
+    uint64_t dropped = 0; ///< Requests dropped because their queue was full.
+    uint64_t validated = 0; ///< Requests validated by the background threads.
+    uint64_t failed = 0; ///< Requests validated and found invalid.
+};
+
+#endif // OAS_VALIDATOR_TYPES_HPP
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SHADOW_VALIDATOR_IMP_HPP
+#define SHADOW_VALIDATOR_IMP_HPP
+
+#include "oas_validator_imp.hpp"
+#include "utils/shadow_queue.hpp"
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using ShadowCallback =
+    std::function<void(const ShadowRequest& request, ValidationError error, const std::string& error_msg)>;
+
+// Background validation of ShadowValidator. Each worker thread drains its own queue, producers spread their requests
+// over the queues, so that a queue has a single consumer and the producers of a thread mostly hit the same one.
+class ShadowValidatorImp
+{
+public:
+    ShadowValidatorImp(std::shared_ptr<const OASValidatorImp> validator, const ShadowOptions& options,
+                       ShadowCallback on_failure);
+    ShadowValidatorImp(const ShadowValidatorImp&) = delete;
+    ShadowValidatorImp& operator=(const ShadowValidatorImp&) = delete;
+
+    // `json_body` is null for a request without a body
+    bool Enqueue(const std::string& method, const std::string& http_path, const std::string* json_body,
+                 const HeaderField* headers, size_t header_count);
+    bool Enqueue(ShadowRequest&& request);
+    void Flush() const;
+    ShadowStats GetStats() const;
+    // Validates what is still queued, then joins the threads
+    ~ShadowValidatorImp();
+
+private:
+    struct Worker
+    {
+        explicit Worker(size_t capacity)
+            : queue(capacity)
+        {
+        }
+
+        ShadowQueue queue;
+        std::thread thread{};
+        std::atomic<uint64_t> validated{0}; // Written by the worker only
+        std::atomic<uint64_t> failed{0};
+    };
+
+    std::shared_ptr<const OASValidatorImp> validator_;
+    ShadowCallback on_failure_;
+    std::vector<std::unique_ptr<Worker>> workers_{};
+    std::atomic<bool> stopping_{false};
+
+    ShadowQueue& PickQueue();
+    void Run(Worker& worker);
+    void Validate(Worker& worker, const ShadowRequest& request, std::vector<HeaderField>& fields,
+                  std::string& error_msg) const;
+    void Stop();
+};
+
+#endif // SHADOW_VALIDATOR_IMP_HPP
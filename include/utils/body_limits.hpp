@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef BODY_LIMITS_HPP
+#define BODY_LIMITS_HPP
+
+#include "utils/common.hpp"
+
+#include <rapidjson/rapidjson.h>
+#include <vector>
+
+enum class BodyLimit
+{
+    NONE = 0,
+    BYTES,
+    DEPTH,
+    ARRAY_ITEMS,
+    OBJECT_MEMBERS,
+    STRING_LENGTH,
+    DEADLINE // Not a limit of the body, the validation ran out of time
+};
+
+inline bool HasParseLimits(const BodyLimits& limits)
+{
+    return limits.max_depth || limits.max_array_items || limits.max_object_members || limits.max_string_length;
+}
+
+inline bool HasExpired(const ValidationDeadline& deadline)
+{
+    return (deadline.cancelled && deadline.cancelled->load(std::memory_order_relaxed)) ||
+           std::chrono::steady_clock::now() >= deadline.time;
+}
+
+// Sends the SAX events of a parse to `handler` until one exceeds the limits or the deadline has passed, the parse then
+// stops with kParseErrorTermination and GetExceeded() tells which limit it was. The deadline is checked every
+// kDeadlineInterval values, reading the clock costs more than validating a value.
+template <typename Handler>
+class BodyLimiter
+{
+public:
+    static constexpr uint32_t kDeadlineInterval = 256;
+
+    BodyLimiter(Handler& handler, const BodyLimits& limits, const ValidationDeadline* deadline = nullptr)
+        : handler_(handler)
+        , limits_(limits)
+        , counting_(0 != limits.max_array_items || 0 != limits.max_object_members)
+        , deadline_(deadline)
+    {
+    }
+
+    BodyLimiter(const BodyLimiter&) = delete;
+    BodyLimiter& operator=(const BodyLimiter&) = delete;
+
+    BodyLimit GetExceeded() const
+    {
+        return exceeded_;
+    }
+
+    bool Null()
+    {
+        return AddValue() && handler_.Null();
+    }
+
+    bool Bool(bool b)
+    {
+        return AddValue() && handler_.Bool(b);
+    }
+
+    bool Int(int i)
+    {
+        return AddValue() && handler_.Int(i);
+    }
+
+    bool Uint(unsigned u)
+    {
+        return AddValue() && handler_.Uint(u);
+    }
+
+    bool Int64(int64_t i)
+    {
+        return AddValue() && handler_.Int64(i);
+    }
+
+    bool Uint64(uint64_t u)
+    {
+        return AddValue() && handler_.Uint64(u);
+    }
+
+    bool Double(double d)
+    {
+        return AddValue() && handler_.Double(d);
+    }
+
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        return AddValue() && handler_.RawNumber(str, length, copy);
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        return CheckString(length) && AddValue() && handler_.String(str, length, copy);
+    }
+
+    bool StartObject()
+    {
+        return AddValue() && Open(true) && handler_.StartObject();
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (!CheckString(length)) {
+            return false;
+        }
+        if (counting_ && limits_.max_object_members && ++frames_.back().count > limits_.max_object_members) {
+            return Exceed(BodyLimit::OBJECT_MEMBERS);
+        }
+        return handler_.Key(str, length, copy);
+    }
+
+    bool EndObject(rapidjson::SizeType member_count)
+    {
+        Close();
+        return handler_.EndObject(member_count);
+    }
+
+    bool StartArray()
+    {
+        return AddValue() && Open(false) && handler_.StartArray();
+    }
+
+    bool EndArray(rapidjson::SizeType element_count)
+    {
+        Close();
+        return handler_.EndArray(element_count);
+    }
+
+private:
+    struct Frame
+    {
+        bool is_object;
+        size_t count;
+    };
+
+    Handler& handler_;
+    const BodyLimits& limits_;
+    const bool counting_; // Items and members are counted, on a stack of the open arrays and objects
+    const ValidationDeadline* const deadline_; // Null without one
+    uint32_t until_deadline_check_ = 1; // The first value checks it
+    size_t depth_ = 0;
+    std::vector<Frame> frames_{};
+    BodyLimit exceeded_ = BodyLimit::NONE;
+
+    bool Exceed(BodyLimit limit)
+    {
+        exceeded_ = limit;
+        return false;
+    }
+
+    // Counts an item of the innermost array, members are counted by their names
+    bool AddValue()
+    {
+        if (deadline_ && 0 == --until_deadline_check_) {
+            until_deadline_check_ = kDeadlineInterval;
+            if (HasExpired(*deadline_)) {
+                return Exceed(BodyLimit::DEADLINE);
+            }
+        }
+        if (counting_ && limits_.max_array_items && !frames_.empty() && !frames_.back().is_object &&
+            ++frames_.back().count > limits_.max_array_items) {
+            return Exceed(BodyLimit::ARRAY_ITEMS);
+        }
+        return true;
+    }
+
+    bool Open(bool is_object)
+    {
+        if (limits_.max_depth && depth_ == limits_.max_depth) {
+            return Exceed(BodyLimit::DEPTH);
+        }
+        ++depth_;
+        if (counting_) {
+            frames_.push_back(Frame{is_object, 0});
+        }
+        return true;
+    }
+
+    void Close()
+    {
+        --depth_;
+        if (counting_) {
+            frames_.pop_back();
+        }
+    }
+
+    bool CheckString(rapidjson::SizeType length)
+    {
+        return !limits_.max_string_length || length <= limits_.max_string_length || Exceed(BodyLimit::STRING_LENGTH);
+    }
+};
+
+// Sends the SAX events of `root` to `handler` as GenericValue::Accept() does, without recursion so that deep documents
+// can't overflow the thread's stack. The first containers are tracked on the stack, deeper ones on the heap.
+template <typename Document, typename Handler>
+bool AcceptIteratively(const Document& root, Handler& handler)
+{
+    using Value = typename Document::ValueType; // The value type of a document is its base class
+    struct Frame
+    {
+        const Value* container;
+        rapidjson::SizeType next; // Index of the next item or member
+    };
+    constexpr size_t kInlineFrames = 32;
+    Frame inline_frames[kInlineFrames];
+    std::vector<Frame> deep_frames;
+    size_t depth = 0;
+
+    const Value* value = &root;
+    for (;;) {
+        bool accepted;
+        switch (value->GetType()) {
+        case rapidjson::kNullType:
+            accepted = handler.Null();
+            break;
+        case rapidjson::kFalseType:
+            accepted = handler.Bool(false);
+            break;
+        case rapidjson::kTrueType:
+            accepted = handler.Bool(true);
+            break;
+        case rapidjson::kObjectType:
+        case rapidjson::kArrayType:
+            if (!(value->IsObject() ? handler.StartObject() : handler.StartArray())) {
+                return false;
+            }
+            if (depth < kInlineFrames) {
+                inline_frames[depth] = Frame{value, 0};
+            } else {
+                deep_frames.push_back(Frame{value, 0});
+            }
+            ++depth;
+            accepted = true;
+            break;
+        case rapidjson::kStringType:
+            accepted = handler.String(value->GetString(), value->GetStringLength(), true);
+            break;
+        case rapidjson::kNumberType:
+        default:
+            if (value->IsDouble()) {
+                accepted = handler.Double(value->GetDouble());
+            } else if (value->IsInt()) {
+                accepted = handler.Int(value->GetInt());
+            } else if (value->IsUint()) {
+                accepted = handler.Uint(value->GetUint());
+            } else if (value->IsInt64()) {
+                accepted = handler.Int64(value->GetInt64());
+            } else {
+                accepted = handler.Uint64(value->GetUint64());
+            }
+            break;
+        }
+        if (!accepted) {
+            return false;
+        }
+
+        // The next value, once the containers completed by this one are ended
+        for (value = nullptr; !value;) {
+            if (0 == depth) {
+                return true;
+            }
+            auto& frame = depth <= kInlineFrames ? inline_frames[depth - 1] : deep_frames.back();
+            const Value& container = *frame.container;
+            if (container.IsObject() && frame.next < container.MemberCount()) {
+                const auto& member = container.MemberBegin()[frame.next++];
+                if (!handler.Key(member.name.GetString(), member.name.GetStringLength(), true)) {
+                    return false;
+                }
+                value = &member.value;
+            } else if (container.IsArray() && frame.next < container.Size()) {
+                value = &container[frame.next++];
+            } else {
+                if (depth-- > kInlineFrames) {
+                    deep_frames.pop_back();
+                }
+                if (!(container.IsObject() ? handler.EndObject(container.MemberCount())
+                                           : handler.EndArray(container.Size()))) {
+                    return false;
+                }
+            }
+        }
+    }
+}
+
+#endif // BODY_LIMITS_HPP
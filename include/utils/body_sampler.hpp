@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef BODY_SAMPLER_HPP
+#define BODY_SAMPLER_HPP
+
+#include "utils/common.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+// Selects the bodies of a route that are validated, per BodySampling. Lock-free, shared by the threads validating
+// the route.
+//
+// FIXED_RATE draws from a per-thread generator. TOKEN_BUCKET is a generic cell rate algorithm: `horizon_` is the
+// theoretical arrival time of the next body, a body is validated when advancing it by one interval keeps it within
+// `burst` intervals of now. CPU_BUDGET advances `horizon_` by the time each validated body is worth in the budget,
+// e.g. by 10 ms for a body validated in 1 ms with a budget of 100 ms per second, and skips bodies while it is more
+// than kBudgetWindow ahead of now. Validation time per second then converges to the budget under overload, bursts
+// short of kBudgetWindow are validated in full.
+class BodySampler
+{
+public:
+    static constexpr int64_t kBudgetWindow = 100000000; // Nanoseconds
+
+    BodySampler() = default;
+    explicit BodySampler(const BodySampling& sampling);
+    BodySampler(const BodySampler&) = delete;
+    BodySampler& operator=(const BodySampler&) = delete;
+
+    BodySamplingMode GetMode() const;
+    // Whether the next body is validated, it is counted as skipped otherwise. Always true for ALL.
+    bool Sample();
+    // Counts a body validated in `nanoseconds`, not needed for ALL
+    void Record(uint64_t nanoseconds);
+    // All but the method and the path template
+    void GetStats(BodySamplingStats& stats) const;
+    // Nanoseconds on the steady clock
+    static int64_t Now();
+
+private:
+    BodySamplingMode mode_ = BodySamplingMode::ALL;
+    uint64_t threshold_ = 0; // FIXED_RATE validates when a 32-bit draw is below it
+    int64_t interval_ = 0; // Nanoseconds between two bodies of TOKEN_BUCKET
+    int64_t tolerance_ = 0; // How far ahead of now `horizon_` may be after validating a body
+    double weight_ = 0; // Nanoseconds of `horizon_` per nanosecond of validation for CPU_BUDGET
+    std::atomic<int64_t> horizon_{0};
+    std::atomic<uint64_t> checked_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<uint64_t> nanoseconds_{0};
+
+    bool Skip();
+};
+
+#endif // BODY_SAMPLER_HPP
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef CHECK_ORDER_HPP
+#define CHECK_ORDER_HPP
+
+#include "utils/common.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+// Order in which the components of the requests of a route are validated by ValidationOrder::ADAPTIVE.
+//
+// Until the order is learned, components are validated cheap first and one request in kSampleInterval per thread is
+// sampled: all of its components are validated and timed, so that the failure rate of a component does not depend
+// on those validated before it. After the last sample, the components are sorted by time spent per failure, which
+// minimizes the expected time to reject a request when failures are independent, and the order no longer changes.
+// Only sampled requests write to the counters.
+class CheckOrder
+{
+public:
+    static constexpr size_t kChecks = static_cast<size_t>(RequestCheck::COUNT);
+    static constexpr uint32_t kSampleInterval = 8;
+
+    CheckOrder() = default;
+    CheckOrder(const CheckOrder&) = delete;
+    CheckOrder& operator=(const CheckOrder&) = delete;
+
+    // Components by rank
+    void GetOrder(RequestCheck (&order)[kChecks]) const;
+    // Whether the calling request is to be sampled, never once the order is learned
+    bool Sample() const;
+    void Record(RequestCheck check, uint64_t nanoseconds, bool failed);
+    // Ends a sampled request, the order is learned when it is the `samples`th
+    void EndSample(uint64_t samples);
+    // All but the method and the path template
+    void GetStats(ValidationOrderStats& stats) const;
+
+private:
+    static constexpr uint32_t kCheapFirst = 0x03020100; // Component of rank i in byte i
+
+    struct Counters
+    {
+        std::atomic<uint64_t> runs{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> nanoseconds{0};
+    };
+
+    Counters counters_[kChecks];
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint32_t> order_{kCheapFirst};
+    std::atomic<bool> learned_{false};
+
+    void Learn();
+};
+
+#endif // CHECK_ORDER_HPP
@@ -7,7 +7,12 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
+#include "oas_validator_types.hpp"
+#include "utils/simd.hpp"
+
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 class ValidatorInitExc: public std::exception
@@ -38,21 +43,6 @@ struct ParamRange
     const char* end;
 };
 
-#ifndef VALIDATION_ERROR
-#define VALIDATION_ERROR
-enum class ValidationError
-{
-    NONE = 0,
-    INVALID_METHOD = -1,
-    INVALID_ROUTE = -2,
-    INVALID_PATH_PARAM = -3,
-    INVALID_QUERY_PARAM = -4,
-    INVALID_HEADER_PARAM = -5,
-    INVALID_BODY = -6,
-    INVALID_RSP = -7
-};
-#endif
-
 enum class HttpMethod
 {
     GET = 0,
@@ -67,6 +57,101 @@ enum class HttpMethod
     COUNT
 };
 
+// Case-insensitive comparison with a lowercase letter string
+inline bool EqualsLowerLetters(const char* str, const char* lower, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if ((str[i] | 0x20) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Any casing, HttpMethod::COUNT when not a method of the specification. The length and first letter tell the
+// candidate apart, so at most one comparison is made.
+inline HttpMethod ParseHttpMethod(const char* method, size_t length)
+{
+    if (0 == length) {
+        return HttpMethod::COUNT;
+    }
+    HttpMethod candidate = HttpMethod::COUNT;
+    const char* lower = nullptr;
+    switch (length << 8 | static_cast<uint8_t>(method[0] | 0x20)) {
+    case 3 << 8 | 'g':
+        candidate = HttpMethod::GET;
+        lower = "get";
+        break;
+    case 3 << 8 | 'p':
+        candidate = HttpMethod::PUT;
+        lower = "put";
+        break;
+    case 4 << 8 | 'p':
+        candidate = HttpMethod::POST;
+        lower = "post";
+        break;
+    case 4 << 8 | 'h':
+        candidate = HttpMethod::HEAD;
+        lower = "head";
+        break;
+    case 5 << 8 | 'p':
+        candidate = HttpMethod::PATCH;
+        lower = "patch";
+        break;
+    case 5 << 8 | 't':
+        candidate = HttpMethod::TRACE;
+        lower = "trace";
+        break;
+    case 6 << 8 | 'd':
+        candidate = HttpMethod::DELETE;
+        lower = "delete";
+        break;
+    case 7 << 8 | 'o':
+        candidate = HttpMethod::OPTIONS;
+        lower = "options";
+        break;
+    case 7 << 8 | 'c':
+        candidate = HttpMethod::CONNECT;
+        lower = "connect";
+        break;
+    default:
+        return HttpMethod::COUNT;
+    }
+    return EqualsLowerLetters(method + 1, lower + 1, length - 1) ? candidate : HttpMethod::COUNT;
+}
+
+inline HttpMethod ParseHttpMethod(const std::string& method)
+{
+    return ParseHttpMethod(method.data(), method.size());
+}
+
+// Uppercase name, as in the request line
+inline const char* GetHttpMethodName(HttpMethod method)
+{
+    switch (method) {
+    case HttpMethod::GET:
+        return "GET";
+    case HttpMethod::POST:
+        return "POST";
+    case HttpMethod::PUT:
+        return "PUT";
+    case HttpMethod::DELETE:
+        return "DELETE";
+    case HttpMethod::HEAD:
+        return "HEAD";
+    case HttpMethod::OPTIONS:
+        return "OPTIONS";
+    case HttpMethod::PATCH:
+        return "PATCH";
+    case HttpMethod::CONNECT:
+        return "CONNECT";
+    case HttpMethod::TRACE:
+        return "TRACE";
+    default:
+        return "";
+    }
+}
+
 enum class ParamStyle
 {
     SIMPLE, // Path, query, header
@@ -107,12 +192,29 @@ enum class SecurityType
     OIDC
 };
 
+inline char ToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline char ToUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
 inline const char* Seek(const char* beg, const char* end, const char c)
 {
-    while (beg < end && *beg != c) {
-        ++beg;
+    return FindByte(beg, end, c);
+}
+
+// 64-bit FNV-1a, used for content digests of spec fragments
+inline uint64_t HashBytes(const char* beg, const char* const end, uint64_t hash = 14695981039346656037ULL)
+{
+    while (beg < end) {
+        hash ^= static_cast<unsigned char>(*beg++);
+        hash *= 1099511628211ULL;
     }
-    return beg;
+    return hash;
 }
 
 inline std::string EscapeSlash(const std::string& str)
@@ -128,6 +230,20 @@ inline std::string EscapeSlash(const std::string& str)
     return escaped_str;
 }
 
+// Heap bytes owned by a string, zero when it fits in the small string buffer
+inline size_t GetHeapSize(const std::string& str)
+{
+    const auto* obj = reinterpret_cast<const char*>(&str);
+    return (str.data() >= obj && str.data() < obj + sizeof(str)) ? 0 : str.capacity() + 1;
+}
+
+// Approximate heap bytes of a node based hash container (buckets and nodes), excluding the heap owned by elements
+template <typename HashMap>
+inline size_t GetHashMapHeapSize(const HashMap& map)
+{
+    return map.bucket_count() * sizeof(void*) + map.size() * (sizeof(typename HashMap::value_type) + 2 * sizeof(void*));
+}
+
 inline std::string JoinReference(const std::vector<std::string>& ref_keys)
 {
     std::string reference = "#";
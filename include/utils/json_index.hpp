@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef JSON_INDEX_HPP
+#define JSON_INDEX_HPP
+
+#include "utils/simd.hpp"
+
+#include <cstdint>
+#include <rapidjson/reader.h>
+#include <string>
+#include <vector>
+
+// JSON reader in two stages. The first classifies the text 64 bytes at a time with the vector kernels of
+// utils/simd.hpp and records the offsets of the brackets, colons and commas outside strings, of the quotes delimiting
+// strings and of the first character of every other value. The second walks these offsets and sends the handler the
+// same SAX events as rapidjson::Reader, so whitespace is skipped in bulk and no DOM is built. The stages alternate
+// every few KiB of text, keeping the index small and in cache whatever the size of the document. Unlike rapidjson's
+// default flags the text must be well-formed UTF-8. Errors use rapidjson's codes, kParseErrorTermination when the
+// handler stopped the parse, but the code and offset reported for a malformed text can differ from rapidjson's, as
+// the index finds some errors (e.g. misspelt literals) at other positions.
+class JsonIndexReader
+{
+public:
+    JsonIndexReader() = default;
+    JsonIndexReader(const JsonIndexReader&) = delete;
+    JsonIndexReader& operator=(const JsonIndexReader&) = delete;
+
+    // `json` need not be null-terminated, `length` must be below 4 GiB
+    template <typename Handler>
+    bool Parse(const char* json, size_t length, Handler& handler);
+
+    bool HasParseError() const;
+    rapidjson::ParseErrorCode GetParseErrorCode() const;
+    size_t GetErrorOffset() const;
+
+private:
+    enum class State
+    {
+        VALUE,
+        KEY,
+        NEXT // A value was completed
+    };
+
+    struct Frame
+    {
+        bool is_object;
+        rapidjson::SizeType count;
+    };
+
+    static constexpr size_t kChunkBlocks = 64; // Text indexed per refill, in blocks of kJsonBlockSize
+
+    const char* json_ = nullptr;
+    size_t length_ = 0;
+    std::vector<uint32_t> tokens_{}; // Offsets of the last indexed chunk, `length_` once the text is exhausted
+    size_t token_count_ = 0;
+    size_t next_token_ = 0;
+    size_t indexed_ = 0; // Bytes of text indexed so far
+    uint64_t escaped_carry_ = 0; // 1 when the next block starts with an escaped character
+    uint64_t in_string_carry_ = 0; // All ones when the next block starts inside a string
+    uint64_t scalar_carry_ = 0; // 1 when the next block continues a number or literal
+    size_t utf8_checked_ = 0;
+    std::vector<Frame> frames_{};
+    std::string buffer_{}; // Unescaped string, or number text handed to rapidjson
+    rapidjson::ParseErrorCode error_code_ = rapidjson::kParseErrorNone;
+    size_t error_offset_ = 0;
+
+    bool NextToken(size_t& pos)
+    {
+        if (next_token_ == token_count_ && !IndexChunk()) {
+            return false;
+        }
+        pos = tokens_[next_token_++];
+        return true;
+    }
+
+    bool PeekToken(size_t& pos)
+    {
+        if (next_token_ == token_count_ && !IndexChunk()) {
+            return false;
+        }
+        pos = tokens_[next_token_];
+        return true;
+    }
+
+    // Refills the tokens from the next chunk of text, or with the end of the text
+    bool IndexChunk();
+    bool CheckUtf8(size_t end);
+    // From the opening to past the closing quote, unescaped into `buffer_`
+    bool ParseString(size_t& pos);
+    bool Unescape(const char* cursor, const char* end);
+    bool ParseHex4(const char*& cursor, const char* end, size_t escape_offset, unsigned& code_unit);
+    bool ParseLiteral(size_t& pos, const char* literal, size_t literal_length);
+    // Integers that fit 64 bits are converted here, anything else is left to rapidjson
+    bool ScanNumber(size_t& pos, bool& minus, uint64_t& magnitude, bool& is_integer);
+    template <typename Handler>
+    bool ParseNumber(size_t& pos, Handler& handler);
+    template <typename Handler>
+    bool ParseDouble(size_t beg, size_t end, Handler& handler);
+    // A number or literal must be followed by whitespace, a structural character or the end
+    bool CheckValueEnd(size_t pos);
+    rapidjson::ParseErrorCode MissingSeparator() const;
+    bool Fail(rapidjson::ParseErrorCode code, size_t offset);
+
+    char At(size_t pos) const
+    {
+        return pos < length_ ? json_[pos] : '\0';
+    }
+};
+
+template <typename Handler>
+bool JsonIndexReader::Parse(const char* json, size_t length, Handler& handler)
+{
+    json_ = json;
+    length_ = length;
+    tokens_.resize(kChunkBlocks * kJsonBlockSize);
+    token_count_ = 0;
+    next_token_ = 0;
+    indexed_ = 0;
+    escaped_carry_ = 0;
+    in_string_carry_ = 0;
+    scalar_carry_ = 0;
+    utf8_checked_ = 0;
+    frames_.clear();
+    error_code_ = rapidjson::kParseErrorNone;
+    error_offset_ = 0;
+
+    size_t pos;
+    if (!PeekToken(pos)) {
+        return false;
+    }
+    if (length_ == pos) {
+        return Fail(rapidjson::kParseErrorDocumentEmpty, length_);
+    }
+
+    State state = State::VALUE;
+    for (;;) {
+        size_t next;
+        if (!NextToken(pos)) {
+            return false;
+        }
+        switch (state) {
+        case State::VALUE:
+            switch (At(pos)) {
+            case '{':
+                if (!handler.StartObject()) {
+                    return Fail(rapidjson::kParseErrorTermination, pos);
+                }
+                if (!PeekToken(next)) {
+                    return false;
+                }
+                if ('}' == At(next)) {
+                    ++next_token_;
+                    if (!handler.EndObject(0)) {
+                        return Fail(rapidjson::kParseErrorTermination, next);
+                    }
+                    state = State::NEXT;
+                } else {
+                    frames_.push_back(Frame{true, 0});
+                    state = State::KEY;
+                }
+                break;
+            case '[':
+                if (!handler.StartArray()) {
+                    return Fail(rapidjson::kParseErrorTermination, pos);
+                }
+                if (!PeekToken(next)) {
+                    return false;
+                }
+                if (']' == At(next)) {
+                    ++next_token_;
+                    if (!handler.EndArray(0)) {
+                        return Fail(rapidjson::kParseErrorTermination, next);
+                    }
+                    state = State::NEXT;
+                } else {
+                    frames_.push_back(Frame{false, 0});
+                }
+                break;
+            case '"':
+                next = pos;
+                if (!ParseString(pos)) {
+                    return false;
+                }
+                if (!handler.String(buffer_.data(), static_cast<rapidjson::SizeType>(buffer_.size()), true)) {
+                    return Fail(rapidjson::kParseErrorTermination, next);
+                }
+                state = State::NEXT;
+                break;
+            case 't':
+                if (!ParseLiteral(pos, "true", 4)) {
+                    return false;
+                }
+                if (!handler.Bool(true)) {
+                    return Fail(rapidjson::kParseErrorTermination, pos - 4);
+                }
+                state = State::NEXT;
+                break;
+            case 'f':
+                if (!ParseLiteral(pos, "false", 5)) {
+                    return false;
+                }
+                if (!handler.Bool(false)) {
+                    return Fail(rapidjson::kParseErrorTermination, pos - 5);
+                }
+                state = State::NEXT;
+                break;
+            case 'n':
+                if (!ParseLiteral(pos, "null", 4)) {
+                    return false;
+                }
+                if (!handler.Null()) {
+                    return Fail(rapidjson::kParseErrorTermination, pos - 4);
+                }
+                state = State::NEXT;
+                break;
+            default:
+                if (!ParseNumber(pos, handler)) {
+                    return false;
+                }
+                state = State::NEXT;
+                break;
+            }
+            break;
+        case State::KEY:
+            if ('"' != At(pos)) {
+                return Fail(rapidjson::kParseErrorObjectMissName, pos);
+            }
+            next = pos;
+            if (!ParseString(pos)) {
+                return false;
+            }
+            if (!handler.Key(buffer_.data(), static_cast<rapidjson::SizeType>(buffer_.size()), true)) {
+                return Fail(rapidjson::kParseErrorTermination, next);
+            }
+            if (!NextToken(next)) {
+                return false;
+            }
+            if (':' != At(next)) {
+                return Fail(rapidjson::kParseErrorObjectMissColon, next);
+            }
+            state = State::VALUE;
+            break;
+        case State::NEXT:
+            if (frames_.empty()) {
+                return length_ == pos || Fail(rapidjson::kParseErrorDocumentRootNotSingular, pos);
+            }
+            ++frames_.back().count;
+            if (',' == At(pos)) {
+                state = frames_.back().is_object ? State::KEY : State::VALUE;
+            } else if (frames_.back().is_object && '}' == At(pos)) {
+                const auto count = frames_.back().count;
+                frames_.pop_back();
+                if (!handler.EndObject(count)) {
+                    return Fail(rapidjson::kParseErrorTermination, pos);
+                }
+            } else if (!frames_.back().is_object && ']' == At(pos)) {
+                const auto count = frames_.back().count;
+                frames_.pop_back();
+                if (!handler.EndArray(count)) {
+                    return Fail(rapidjson::kParseErrorTermination, pos);
+                }
+            } else {
+                return Fail(MissingSeparator(), pos);
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+}
+
+template <typename Handler>
+bool JsonIndexReader::ParseNumber(size_t& pos, Handler& handler)
+{
+    const size_t beg = pos;
+    bool minus;
+    uint64_t magnitude;
+    bool is_integer;
+    if (!ScanNumber(pos, minus, magnitude, is_integer) || !CheckValueEnd(pos)) {
+        return false;
+    }
+
+    // Same events as rapidjson::Reader for the same range
+    bool accepted;
+    if (is_integer && !minus) {
+        accepted = magnitude <= UINT32_MAX ? handler.Uint(static_cast<unsigned>(magnitude)) : handler.Uint64(magnitude);
+    } else if (is_integer && magnitude <= uint64_t(1) << 31) {
+        accepted = handler.Int(static_cast<int>(static_cast<uint32_t>(~magnitude + 1)));
+    } else if (is_integer && magnitude <= uint64_t(1) << 63) {
+        accepted = handler.Int64(static_cast<int64_t>(~magnitude + 1));
+    } else {
+        return ParseDouble(beg, pos, handler);
+    }
+    return accepted || Fail(rapidjson::kParseErrorTermination, beg);
+}
+
+template <typename Handler>
+bool JsonIndexReader::ParseDouble(size_t beg, size_t end, Handler& handler)
+{
+    // Rare enough to reuse rapidjson's conversion, which keeps the results bit-identical to the default parser
+    buffer_.assign(json_ + beg, end - beg);
+    rapidjson::StringStream stream(buffer_.c_str());
+    rapidjson::Reader reader;
+    if (reader.Parse(stream, handler).IsError()) {
+        return Fail(reader.GetParseErrorCode(), beg + reader.GetErrorOffset());
+    }
+    return true;
+}
+
+#endif // JSON_INDEX_HPP
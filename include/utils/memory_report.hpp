@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef MEMORY_REPORT_HPP
+#define MEMORY_REPORT_HPP
+
+#include "utils/common.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Collects the memory footprint of a loaded specification. Shared objects (compiled schemas and deserializers) are
+// counted once however many validators reference them, and are attributed to the route being collected.
+class MemoryReport
+{
+public:
+    void AddRouting(size_t trie_nodes, size_t trie_bytes, size_t route_map_bytes);
+    void AddSchema(const void* instance, uint64_t digest, size_t bytes);
+    void AddDeserializer(const void* instance, size_t bytes);
+    // Closes a route, schemas and deserializers added since the previous route are attributed to it
+    void AddRoute(const std::string& method, const std::string& path, size_t store_bytes, size_t validators);
+    void AddOther(size_t bytes);
+    void SetSpecRefs(size_t count, size_t bytes);
+    std::string ToJson() const;
+
+private:
+    struct Route
+    {
+        std::string method;
+        std::string path;
+        size_t bytes;
+        size_t validators;
+        size_t schema_bytes;
+        size_t deserializer_bytes;
+    };
+
+    struct Shared
+    {
+        uint64_t digest;
+        size_t bytes;
+        size_t references;
+    };
+
+    static void AppendShared(const std::unordered_map<const void*, Shared>& instances, std::string& json);
+    static void AppendEscaped(const std::string& str, std::string& json);
+
+    size_t trie_nodes_ = 0;
+    size_t trie_bytes_ = 0;
+    size_t route_map_bytes_ = 0;
+    size_t other_bytes_ = 0;
+    size_t spec_ref_count_ = 0;
+    size_t spec_ref_bytes_ = 0;
+    size_t pending_schema_bytes_ = 0;
+    size_t pending_deserializer_bytes_ = 0;
+    std::vector<Route> routes_{};
+    std::unordered_map<const void*, Shared> schemas_{};
+    std::unordered_map<const void*, Shared> deserializers_{};
+};
+
+#endif // MEMORY_REPORT_HPP
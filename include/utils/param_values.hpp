@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef PARAM_VALUES_HPP
+#define PARAM_VALUES_HPP
+
+#include "utils/common.hpp"
+
+#include <rapidjson/document.h>
+#include <string>
+
+// Fills a ParamValues from the documents of validated parameters. Strings and names are copied into the arena, the
+// documents only live for the validation call.
+class ParamValuesBuilder
+{
+public:
+    static void Add(ParamValues& values, const std::string& name, const rapidjson::Value& value);
+    static void AddMissing(ParamValues& values, const std::string& name);
+
+private:
+    static constexpr size_t kMinBlockSize = 4096;
+
+    static void Convert(ParamValues& values, const rapidjson::Value& value, ParamValue& param);
+    static const char* Copy(ParamValues& values, const char* str, size_t length);
+    static void* Allocate(ParamValues& values, size_t size);
+};
+
+#endif // PARAM_VALUES_HPP
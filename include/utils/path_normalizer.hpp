@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef PATH_NORMALIZER_HPP
+#define PATH_NORMALIZER_HPP
+
+#include "utils/common.hpp"
+
+#include <string>
+#include <vector>
+
+// Segments of a request path once normalized, as ranges of the path itself. Segment 0 is the empty one before the
+// leading '/', as PathTrie indexes them.
+class NormalizedPath
+{
+public:
+    static constexpr size_t kMaxSegments = 32;
+
+    NormalizedPath() = default;
+    NormalizedPath(const NormalizedPath&) = delete;
+    NormalizedPath& operator=(const NormalizedPath&) = delete;
+
+    size_t GetSegmentCount() const;
+    const ParamRange& GetSegment(size_t idx) const; // Bytes of the segment as sent
+    // Segment as the normalized routing tables key it
+    void GetKey(size_t idx, std::string& key) const;
+
+private:
+    friend class PathNormalizer;
+
+    ParamRange segments_[kMaxSegments];
+    size_t count_ = 0;
+    bool decode_ = false;
+    bool ignore_case_ = false;
+};
+
+// Normalizes request paths as set by PathNormalization. Nothing is copied: most paths are only checked to route as
+// they are, the others are split into segments that are ranges of the path, escapes and case being only resolved when
+// a segment is looked up.
+class PathNormalizer
+{
+public:
+    PathNormalizer() = default;
+    // `base_paths` are the paths of the server URLs, e.g. "/test/api"
+    PathNormalizer(const PathNormalization& options, const std::vector<std::string>& base_paths);
+
+    bool IsEnabled() const;
+    bool IgnoresCase() const;
+
+    // Part of the path, without its query string, that routes as is once a base path or a trailing slash is removed.
+    // False when the path has to be normalized.
+    bool GetCanonicalRange(const char* beg, const char* end, const char*& range_beg, const char*& range_end) const;
+    // Path without its query string. False when it has more than NormalizedPath::kMaxSegments segments.
+    bool Normalize(const char* beg, const char* end, NormalizedPath& path) const;
+    // Path of the specification as keyed in the normalized routing tables
+    std::string GetKey(const std::string& path) const;
+    size_t GetMemoryUsage() const; // Heap bytes
+
+private:
+    PathNormalization options_{};
+    bool enabled_ = false;
+    std::vector<std::vector<std::string>> base_paths_{}; // Segments after the leading '/', longest paths first
+
+    void StripBasePath(NormalizedPath& path) const;
+    const char* StripBasePath(const char* beg, const char* end) const;
+};
+
+#endif // PATH_NORMALIZER_HPP
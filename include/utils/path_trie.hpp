@@ -8,6 +8,7 @@
 #define PATH_TRIE_HPP
 
 #include "utils/common.hpp"
+#include "utils/path_normalizer.hpp"
 #include <string>
 #include <unordered_map>
 
@@ -20,9 +21,15 @@ public:
     ~PathTrie();
 
     void Insert(const std::string& path);
-    bool Search(const char* beg, const char* end, std::string& oas_path);
+    bool Search(const char* beg, const char* end, std::string& oas_path) const;
     bool Search(const char* beg, const char* end, std::string& oas_path,
-                std::unordered_map<size_t, ParamRange>& param_idxs);
+                std::unordered_map<size_t, ParamRange>& param_idxs) const;
+    // Segments looked up by their keys, for a trie of keys given by PathNormalizer::GetKey(). Static paths are found
+    // too when they were inserted. `param_idxs` may be null.
+    bool Search(const NormalizedPath& path, std::string& oas_path,
+                std::unordered_map<size_t, ParamRange>* param_idxs) const;
+    size_t GetNodeCount() const;
+    size_t GetMemoryUsage() const; // Heap bytes of all nodes
 
 private:
     struct Node
@@ -36,6 +43,8 @@ private:
 
     void DeleteNode(Node* node);
     void CopyNode(Node*& this_node, Node* other_node);
+    static size_t GetNodeCount(const Node* node);
+    static size_t GetMemoryUsage(const Node* node);
 
     Node* root_;
 };
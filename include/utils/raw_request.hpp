@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef RAW_REQUEST_HPP
+#define RAW_REQUEST_HPP
+
+#include "utils/common.hpp"
+
+#include <array>
+#include <string>
+
+// Request head tokenized in place. Header fields point into the caller's buffer, which must outlive the object; only
+// the method and request path are copied, as routing takes them as strings.
+class RawRequest
+{
+public:
+    static constexpr size_t kMaxHeaders = 128;
+
+    RawRequest() = default;
+    RawRequest(const RawRequest&) = delete;
+    RawRequest& operator=(const RawRequest&) = delete;
+
+    // HTTP/1.x request line and header lines up to the empty line, e.g. "GET /a?b=1 HTTP/1.1\r\nHost: x\r\n\r\n".
+    // Anything after the empty line is ignored. Bare LF line endings are accepted.
+    ValidationError ParseHttp1(const char* head, size_t length, std::string& error_msg);
+    // HTTP/2 style field list, ':method' and ':path' are taken from the pseudo-headers and the list is used as is for
+    // header validation, as pseudo-header names never match a header parameter.
+    ValidationError ParseHttp2(const HeaderField* fields, size_t count, std::string& error_msg);
+
+    const std::string& GetMethod() const;
+    const std::string& GetPath() const;
+    const HeaderField* GetHeaders() const;
+    size_t GetHeaderCount() const;
+
+private:
+    std::string method_{};
+    std::string path_{};
+    std::array<HeaderField, kMaxHeaders> fields_{};
+    const HeaderField* headers_ = nullptr;
+    size_t header_count_ = 0;
+
+    static ValidationError Malformed(ValidationError code, const char* description, std::string& error_msg);
+};
+
+#endif // RAW_REQUEST_HPP
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef ROUTE_CACHE_HPP
+#define ROUTE_CACHE_HPP
+
+#include "utils/common.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+class ValidatorsStore;
+
+// Bounded cache of resolved routes, keyed by routing slot and concrete path without its query string. Holds the
+// validators of the route and the offsets of its path parameters.
+//
+// The entries are split into shards, and within a shard into sets of kWays entries. Lookups take no lock: each entry
+// is guarded by a sequence number that writers make odd while they update it, a reader that sees it change treats
+// the lookup as a miss. Insertions lock their shard only. An entry has a small access frequency, raised by hits. A
+// path missing from a full set takes the place of an entry whose frequency is 0, otherwise the lowest frequency of
+// the set is lowered and the path is not cached. Paths requested once, e.g. by a scan, thus do not evict the paths
+// requested often.
+class RouteCache
+{
+public:
+    static constexpr size_t kMaxPathLength = 96; // Longer paths are not cached
+    static constexpr size_t kMaxParams = 4; // Paths with more path parameters are not cached
+
+    // `capacity` is rounded up to a whole number of sets per shard, a power of two
+    explicit RouteCache(size_t capacity);
+    RouteCache(const RouteCache&) = delete;
+    RouteCache& operator=(const RouteCache&) = delete;
+
+    // Validators and, when given, path parameters of the route cached for the path in [beg, end)
+    bool Find(size_t slot, const char* beg, const char* end, const ValidatorsStore*& validators,
+              std::unordered_map<size_t, ParamRange>* param_idxs) const;
+    // `param_idxs` are ranges within [beg, end)
+    void Insert(size_t slot, const char* beg, const char* end, const ValidatorsStore* validators,
+                const std::unordered_map<size_t, ParamRange>& param_idxs);
+    RouteCacheStats GetStats() const;
+    size_t GetMemoryUsage() const; // Heap bytes
+
+private:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kWays = 4;
+    static constexpr size_t kKeyWords = kMaxPathLength / 8;
+    static constexpr uint8_t kMaxFrequency = 3;
+    static constexpr size_t kCounterStripes = 16;
+
+    // Every field is atomic so that readers racing with a writer are well-defined, the sequence number tells them
+    // whether what they read is consistent
+    struct Entry
+    {
+        std::atomic<uint64_t> sequence{0}; // Odd while written
+        std::atomic<uint64_t> hash{0};
+        std::atomic<const ValidatorsStore*> validators{nullptr}; // Null for an empty entry
+        std::atomic<uint64_t> shape{0}; // Path length, slot and parameter count
+        std::atomic<uint64_t> params[kMaxParams]; // Segment index, begin and end offsets
+        std::atomic<uint64_t> key[kKeyWords]; // Path, zero padded
+        std::atomic<uint8_t> frequency{0};
+    };
+
+    struct Shard
+    {
+        std::unique_ptr<Entry[]> entries{};
+        std::mutex mutex{}; // Held by writers only
+        size_t size = 0;
+        uint64_t evictions = 0;
+    };
+
+    // Hit and miss counts, striped by thread to keep hits on different threads from sharing a cache line
+    struct CounterStripe
+    {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        char padding[128 - 2 * sizeof(std::atomic<uint64_t>)];
+    };
+
+    size_t set_mask_; // Sets per shard - 1
+    std::unique_ptr<Shard[]> shards_;
+    std::unique_ptr<CounterStripe[]> counters_;
+
+    CounterStripe& GetCounters() const;
+    Entry* GetSet(uint64_t hash) const;
+};
+
+#endif // ROUTE_CACHE_HPP
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef ROUTE_FILTER_HPP
+#define ROUTE_FILTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Pre-filter of a routing table, rejecting paths that no route can match before the route maps are searched. Paths
+// are split into segments as PathTrie does. A path is rejected when its segment count is outside the bounds of the
+// routes, when its first segment is not the literal first segment of any route, or when its longest prefix that is
+// literal in every route of that first segment is not in a bloom filter of these prefixes. Routes whose first segment
+// is a parameter disable the last two checks. Never rejects a path that a route matches.
+class RouteFilter
+{
+public:
+    RouteFilter() = default;
+
+    // Replaces the filter by one for `paths`, the static paths and templates of the table
+    void Build(const std::vector<std::string>& paths);
+    // Path without its query string
+    bool MayMatch(const char* beg, const char* end) const;
+    size_t GetMemoryUsage() const; // Heap bytes
+
+private:
+    static constexpr size_t kProbes = 3;
+
+    // Open addressing by the hash of the first segment, routes whose first segments collide share the entry
+    struct FirstSegment
+    {
+        uint64_t hash;
+        size_t literal_depth; // Fewest leading segments, the empty one before the first '/' included, that are
+                              // literal in all routes of the first segment. 0 for an empty entry.
+    };
+
+    size_t min_segments_ = 1;
+    size_t max_segments_ = 0; // Below min_segments_ when there are no routes
+    bool any_first_segment_ = false; // A route starts with a parameter
+    std::vector<FirstSegment> first_segments_{};
+    uint64_t first_segments_mask_ = 0;
+    std::vector<uint64_t> bloom_{}; // Literal prefixes of three segments or more, from the start of the path
+    uint64_t bloom_mask_ = 0; // Bit count - 1, a power of two
+
+    // Segment count, literal depth and first segment of a route
+    static size_t Split(const char* beg, const char* end, size_t& literal_depth, const char*& first_beg,
+                        const char*& first_end);
+    const FirstSegment* FindFirstSegment(uint64_t hash) const;
+    void AddToBloom(uint64_t hash);
+    bool InBloom(uint64_t hash) const;
+};
+
+#endif // ROUTE_FILTER_HPP
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SCHEMA_BOUNDS_HPP
+#define SCHEMA_BOUNDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rapidjson/document.h>
+
+// Upper bounds of the sizes of the inputs a schema accepts, derived when the specification is loaded so that oversized
+// inputs are rejected before they are deserialized or parsed. The bounds are conservative, an input longer than the
+// bound of its schema is never valid. They come from `maxLength`, `maxItems` and `maxProperties`, `minimum` and
+// `maximum` of integers, `enum` and `const`, booleans and nulls. A schema bounding none of its values is unbounded.
+class SchemaBounds
+{
+public:
+    static constexpr size_t kUnbounded = SIZE_MAX;
+
+    // Bytes of a JSON document valid against `schema`, whitespace between tokens excluded: a code point of a string
+    // takes up to 12 bytes, as a pair of \u escapes
+    static size_t GetJsonBytes(const rapidjson::Value& schema);
+    // Bytes of a parameter valid against its definition `param`, as received: percent-encoded, with its name for the
+    // styles repeating it. Parameters with a `content` definition are unbounded.
+    static size_t GetParamBytes(const rapidjson::Value& param);
+    // Bytes of the text that are not JSON whitespace, counting stops once `limit` is exceeded
+    static size_t CountSignificantBytes(const char* json, size_t length, size_t limit);
+
+private:
+    static constexpr int kMaxDepth = 32; // Deeper schemas, e.g. recursive ones, are unbounded
+
+    static size_t GetJsonBytes(const rapidjson::Value& schema, int depth);
+    static size_t GetTypeBytes(const rapidjson::Value& schema, const char* type, int depth);
+    static size_t GetObjectBytes(const rapidjson::Value& schema, int depth);
+    // Value of a primitive parameter, percent-encoded
+    static size_t GetRawBytes(const rapidjson::Value& schema);
+    // Of a `const` or an `enum` item. Numbers are unbounded, they have many spellings.
+    static size_t GetValueBytes(const rapidjson::Value& value, size_t escaped_byte);
+    static size_t GetEnumBytes(const rapidjson::Value& schema, size_t escaped_byte);
+    // Characters of the integers between `minimum` and `maximum`, unbounded without both
+    static size_t GetIntegerBytes(const rapidjson::Value& schema);
+    static size_t Add(size_t lhs, size_t rhs);
+    static size_t Multiply(size_t lhs, size_t rhs);
+};
+
+#endif // SCHEMA_BOUNDS_HPP
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SHADOW_QUEUE_HPP
+#define SHADOW_QUEUE_HPP
+
+#include "utils/common.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue of requests, many producers and a single consumer.
+//
+// A ring of slots, each with a sequence number telling whose turn it is: a producer claims the slot at the tail by
+// advancing it with a compare-and-swap once the sequence shows the slot free, fills it and publishes it by bumping
+// the sequence. The consumer owns the head, reads the slot in place, clears it and frees it for the next lap. Slots
+// keep the capacity of their strings across laps, so that copying a request into one seldom allocates, but never the
+// content of a request, which could otherwise be handed to another caller swapping its request in.
+class ShadowQueue
+{
+public:
+    explicit ShadowQueue(size_t capacity);
+    ShadowQueue(const ShadowQueue&) = delete;
+    ShadowQueue& operator=(const ShadowQueue&) = delete;
+
+    // Fills the tail slot with `fill(ShadowRequest&)`, false without calling it when the queue is full
+    template <typename Fill>
+    bool Push(Fill&& fill)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (sequence < pos) { // Not yet freed by the consumer since the previous lap
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        fill(slot->request);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: passes the head request to `consume(ShadowRequest&)` then clears and frees its slot, false when
+    // empty
+    template <typename Consume>
+    bool Pop(Consume&& consume)
+    {
+        Slot& slot = slots_[head_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+        consume(slot.request);
+        Clear(slot.request);
+        slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        popped_.store(++head_, std::memory_order_release);
+        return true;
+    }
+
+    // Requests claimed by producers so far
+    size_t GetPushed() const;
+    // Requests consumed so far
+    size_t GetPopped() const;
+    // Requests rejected because the queue was full
+    uint64_t GetDropped() const;
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        ShadowRequest request{};
+    };
+
+    static void Clear(ShadowRequest& request);
+
+    std::unique_ptr<Slot[]> slots_;
+    const size_t mask_;
+    // Producers and consumer on separate cache lines
+    char pad0_[kCacheLine]{};
+    std::atomic<size_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+    char pad1_[kCacheLine]{};
+    size_t head_ = 0;
+    std::atomic<size_t> popped_{0}; // Copy of head_ for other threads
+    char pad2_[kCacheLine]{};
+};
+
+#endif // SHADOW_QUEUE_HPP
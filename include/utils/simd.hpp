@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scanning and percent-decoding kernels for paths, query strings and parameter values, and the classification and
+// UTF-8 kernels of the JSON body parser. Finders return `end` when nothing is found. Each kernel is built for several
+// instruction sets and the best one the CPU supports is picked at runtime, so a portable build still runs vectorized.
+
+enum class SimdLevel
+{
+    SCALAR = 0,
+    SSE2, // 16 bytes per step
+    AVX2 // 32 bytes per step
+};
+
+// Best level supported by both the build and the CPU
+SimdLevel GetMaxSimdLevel();
+SimdLevel GetSimdLevel();
+// Forces a lower level, e.g. to compare the variants in benchmarks. Levels above GetMaxSimdLevel() are clamped. Not
+// meant to be called while other threads are validating.
+void SetSimdLevel(SimdLevel level);
+const char* GetSimdLevelName(SimdLevel level);
+
+const char* FindByte(const char* beg, const char* end, char c);
+const char* FindEitherByte(const char* beg, const char* end, char c1, char c2);
+const char* FindAnyByte(const char* beg, const char* end, char c1, char c2, char c3);
+
+enum class PercentDecodeResult
+{
+    OK,
+    INCOMPLETE, // '%' not followed by two characters
+    INVALID_HEX
+};
+
+// Appends [cursor, end) to `out` with "%XX" decoded and '+' as space, advancing `cursor` to where decoding stopped.
+// Unescaped runs are copied in bulk.
+PercentDecodeResult PercentDecode(const char*& cursor, const char* end, std::string& out);
+// Same, stopping at the first unescaped `terminator`, which is not consumed
+PercentDecodeResult PercentDecode(const char*& cursor, const char* end, char terminator, std::string& out);
+
+// Bit i of each mask is set for byte i of a 64 byte block
+struct JsonBlockMasks
+{
+    uint64_t backslash;
+    uint64_t quote;
+    uint64_t op; // One of {}[]:,
+    uint64_t space; // JSON whitespace
+    uint64_t control; // Below 0x20, including whitespace
+    uint64_t non_ascii;
+};
+
+constexpr size_t kJsonBlockSize = 64;
+
+// Classifies `count` consecutive blocks of kJsonBlockSize bytes
+void ClassifyJsonBlocks(const char* blocks, size_t count, JsonBlockMasks* masks);
+// First byte of [beg, end) that starts an invalid, overlong, surrogate or truncated UTF-8 sequence
+const char* FindInvalidUtf8(const char* beg, const char* end);
+
+#endif // SIMD_HPP
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SIMD_KERNELS_HPP
+#define SIMD_KERNELS_HPP
+
+// Building blocks of the kernels in utils/simd.hpp, shared by the per-ISA translation units. Each unit is compiled for
+// its own instruction set, so everything here has internal linkage: an out-of-line copy built with AVX2 must never be
+// picked by the linker for a caller running on a host without it. Only include from the kernel units.
+
+#include "utils/simd.hpp"
+
+#include <cstdint>
+
+// One variant of every kernel, selected once per process from the CPU features
+struct SimdKernels
+{
+    const char* (*find_any)(const char* beg, const char* end, char c1, char c2, char c3);
+    // Decodes [cursor, limit) into `dst`, escapes are checked against `end`
+    PercentDecodeResult (*percent_decode)(const char*& cursor, const char* limit, const char* end, char*& dst);
+    void (*classify_json)(const char* blocks, size_t count, JsonBlockMasks* masks);
+    const char* (*find_invalid_utf8)(const char* beg, const char* end);
+};
+
+namespace {
+inline int HexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// Length of the well-formed UTF-8 sequence at `src`, 0 when it is invalid, overlong, a surrogate or truncated
+inline ptrdiff_t Utf8SequenceLength(const char* src, const char* const end)
+{
+    const auto lead = static_cast<uint8_t>(src[0]);
+    if (lead < 0x80) {
+        return 1;
+    }
+    ptrdiff_t length;
+    uint8_t min = 0x80; // Range of the second byte, narrower after some leads
+    uint8_t max = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        min = 0xE0 == lead ? 0xA0 : min;
+        max = 0xED == lead ? 0x9F : max;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        min = 0xF0 == lead ? 0x90 : min;
+        max = 0xF4 == lead ? 0x8F : max;
+    } else {
+        return 0;
+    }
+    if (end - src < length) {
+        return 0;
+    }
+    const auto second = static_cast<uint8_t>(src[1]);
+    if (second < min || second > max) {
+        return 0;
+    }
+    for (ptrdiff_t i = 2; i < length; ++i) {
+        if (0x80 != (static_cast<uint8_t>(src[i]) & 0xC0)) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+struct ScalarIsa
+{
+    static const char* FindAny(const char* beg, const char* const end, char c1, char c2, char c3)
+    {
+        while (beg < end && c1 != *beg && c2 != *beg && c3 != *beg) {
+            ++beg;
+        }
+        return beg;
+    }
+
+    static void CopyUntilAny(const char*& src, const char* const end, char*& dst, char c1, char c2)
+    {
+        while (src < end && c1 != *src && c2 != *src) {
+            *dst++ = *src++;
+        }
+    }
+
+    static void ClassifyJson(const char* blocks, size_t count, JsonBlockMasks* masks)
+    {
+        for (size_t i = 0; i < count; ++i, blocks += kJsonBlockSize) {
+            JsonBlockMasks block = {0, 0, 0, 0, 0, 0};
+            for (size_t j = 0; j < kJsonBlockSize; ++j) {
+                const auto c = static_cast<uint8_t>(blocks[j]);
+                const uint64_t bit = uint64_t(1) << j;
+                switch (c) {
+                case '\\':
+                    block.backslash |= bit;
+                    break;
+                case '"':
+                    block.quote |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    block.op |= bit;
+                    break;
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    block.space |= bit;
+                    break;
+                default:
+                    break;
+                }
+                block.control |= c < 0x20 ? bit : 0;
+                block.non_ascii |= c >= 0x80 ? bit : 0;
+            }
+            masks[i] = block;
+        }
+    }
+
+    static const char* FindInvalidUtf8(const char* beg, const char* const end)
+    {
+        while (beg < end) {
+            const ptrdiff_t length = Utf8SequenceLength(beg, end);
+            if (0 == length) {
+                return beg;
+            }
+            beg += length;
+        }
+        return end;
+    }
+};
+
+// `Isa` provides Vector, kWidth, Load, Store, Splat, Matches (a bit mask of the bytes equal to the needle), Controls
+// (of the bytes below 0x20) and NonAscii
+template <class Isa>
+struct VectorIsa
+{
+    static const char* FindAny(const char* beg, const char* const end, char c1, char c2, char c3)
+    {
+        const typename Isa::Vector needle1 = Isa::Splat(c1);
+        const typename Isa::Vector needle2 = Isa::Splat(c2);
+        const typename Isa::Vector needle3 = Isa::Splat(c3);
+        while (end - beg >= Isa::kWidth) {
+            const typename Isa::Vector chunk = Isa::Load(beg);
+            const uint32_t mask =
+                Isa::Matches(chunk, needle1) | Isa::Matches(chunk, needle2) | Isa::Matches(chunk, needle3);
+            if (0 != mask) {
+                return beg + __builtin_ctz(mask);
+            }
+            beg += Isa::kWidth;
+        }
+        return ScalarIsa::FindAny(beg, end, c1, c2, c3);
+    }
+
+    // Whole vectors are stored past the match, which stays within the output as long as it never gets ahead of the
+    // input
+    static void CopyUntilAny(const char*& src, const char* const end, char*& dst, char c1, char c2)
+    {
+        const typename Isa::Vector needle1 = Isa::Splat(c1);
+        const typename Isa::Vector needle2 = Isa::Splat(c2);
+        while (end - src >= Isa::kWidth) {
+            const typename Isa::Vector chunk = Isa::Load(src);
+            Isa::Store(dst, chunk);
+            const uint32_t mask = Isa::Matches(chunk, needle1) | Isa::Matches(chunk, needle2);
+            if (0 != mask) {
+                const auto pos = __builtin_ctz(mask);
+                src += pos;
+                dst += pos;
+                return;
+            }
+            src += Isa::kWidth;
+            dst += Isa::kWidth;
+        }
+        ScalarIsa::CopyUntilAny(src, end, dst, c1, c2);
+    }
+
+    static void ClassifyJson(const char* blocks, size_t count, JsonBlockMasks* masks)
+    {
+        const typename Isa::Vector backslash = Isa::Splat('\\');
+        const typename Isa::Vector quote = Isa::Splat('"');
+        const typename Isa::Vector ops[] = {Isa::Splat('{'), Isa::Splat('}'), Isa::Splat('['),
+                                            Isa::Splat(']'), Isa::Splat(':'), Isa::Splat(',')};
+        const typename Isa::Vector spaces[] = {Isa::Splat(' '), Isa::Splat('\t'), Isa::Splat('\n'), Isa::Splat('\r')};
+        for (size_t i = 0; i < count; ++i, blocks += kJsonBlockSize) {
+            JsonBlockMasks block = {0, 0, 0, 0, 0, 0};
+            for (size_t shift = 0; shift < kJsonBlockSize; shift += static_cast<size_t>(Isa::kWidth)) {
+                const typename Isa::Vector chunk = Isa::Load(blocks + shift);
+                uint32_t op = 0;
+                for (const auto& needle : ops) {
+                    op |= Isa::Matches(chunk, needle);
+                }
+                uint32_t space = 0;
+                for (const auto& needle : spaces) {
+                    space |= Isa::Matches(chunk, needle);
+                }
+                block.backslash |= uint64_t(Isa::Matches(chunk, backslash)) << shift;
+                block.quote |= uint64_t(Isa::Matches(chunk, quote)) << shift;
+                block.op |= uint64_t(op) << shift;
+                block.space |= uint64_t(space) << shift;
+                block.control |= uint64_t(Isa::Controls(chunk)) << shift;
+                block.non_ascii |= uint64_t(Isa::NonAscii(chunk)) << shift;
+            }
+            masks[i] = block;
+        }
+    }
+
+    // Skips ASCII a vector at a time, the sequences of a vector with non-ASCII bytes are checked one by one
+    static const char* FindInvalidUtf8(const char* beg, const char* const end)
+    {
+        while (end - beg >= Isa::kWidth) {
+            const uint32_t mask = Isa::NonAscii(Isa::Load(beg));
+            if (0 == mask) {
+                beg += Isa::kWidth;
+                continue;
+            }
+            const char* vector_end = beg + Isa::kWidth;
+            for (beg += __builtin_ctz(mask); beg < vector_end;) {
+                const ptrdiff_t length = Utf8SequenceLength(beg, end);
+                if (0 == length) {
+                    return beg;
+                }
+                beg += length;
+            }
+        }
+        return ScalarIsa::FindInvalidUtf8(beg, end);
+    }
+};
+
+template <class Kernels>
+PercentDecodeResult DecodePercent(const char*& cursor, const char* const limit, const char* const end, char*& dst)
+{
+    while (cursor < limit) {
+        Kernels::CopyUntilAny(cursor, limit, dst, '%', '+');
+        if (cursor == limit) {
+            break;
+        }
+        if ('+' == *cursor) {
+            *dst++ = ' ';
+            ++cursor;
+            continue;
+        }
+        if (end - cursor < 3) {
+            return PercentDecodeResult::INCOMPLETE;
+        }
+        const int dec1 = HexValue(cursor[1]);
+        const int dec2 = HexValue(cursor[2]);
+        if (dec1 < 0 || dec2 < 0) {
+            return PercentDecodeResult::INVALID_HEX;
+        }
+        *dst++ = static_cast<char>((dec1 << 4) | dec2);
+        cursor += 3;
+    }
+    return PercentDecodeResult::OK;
+}
+} // namespace
+
+// Variants built in their own translation units, null when the compiler could not target the ISA
+const SimdKernels* GetAvx2Kernels();
+
+#endif // SIMD_KERNELS_HPP
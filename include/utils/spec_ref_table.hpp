@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SPEC_REF_TABLE_HPP
+#define SPEC_REF_TABLE_HPP
+
+#include "utils/common.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Append-only table of interned spec references (e.g. "#/paths/%2Fpets/get/parameters/0"). Validators keep a 32-bit
+// id and the reference text is only rendered when an error is reported. A loaded specification has its own table, in
+// its ValidatorsCache, shared with the specifications reloaded from it and kept alive by every ValidatorsStore using
+// it. A reload replaces the table once most of its references are dead, see OASValidatorImp. Strings are packed into
+// large blocks that never move, so ids handed out stay valid for the lifetime of the table and can be read without
+// locking from any thread that obtained them.
+class SpecRefTable
+{
+public:
+    using Id = uint32_t;
+    static constexpr Id kNone = UINT32_MAX;
+
+    // Of the validators built without a ValidatorsCache, e.g. in tests
+    static SpecRefTable& Default();
+
+    SpecRefTable() = default;
+    SpecRefTable(const SpecRefTable&) = delete;
+    SpecRefTable& operator=(const SpecRefTable&) = delete;
+
+    Id Intern(const std::string& spec_ref);
+    void Append(Id id, std::string& out) const;
+    std::string Get(Id id) const;
+    size_t GetCount() const;
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Entry
+    {
+        const char* data;
+        uint32_t size;
+    };
+
+    struct EntryHash
+    {
+        size_t operator()(const Entry& entry) const
+        {
+            return static_cast<size_t>(HashBytes(entry.data, entry.data + entry.size));
+        }
+    };
+
+    struct EntryEqual
+    {
+        bool operator()(const Entry& lhs, const Entry& rhs) const;
+    };
+
+    static constexpr size_t kPageBits = 12;
+    static constexpr size_t kPageSize = size_t(1) << kPageBits; // Entries per page
+    static constexpr size_t kMaxPages = 1024; // Up to 4M distinct references per table
+    static constexpr size_t kBlockSize = 64 * 1024; // Bytes per string block
+
+    const Entry& GetEntry(Id id) const;
+
+    mutable std::mutex mutex_{};
+    std::array<std::unique_ptr<Entry[]>, kMaxPages> pages_{};
+    std::vector<std::unique_ptr<char[]>> blocks_{};
+    size_t block_used_ = 0;
+    size_t block_capacity_ = 0;
+    size_t block_bytes_ = 0; // Total bytes of all blocks
+    std::unordered_map<Entry, Id, EntryHash, EntryEqual> index_{};
+    size_t count_ = 0;
+};
+
+#endif // SPEC_REF_TABLE_HPP
@@ -8,6 +8,7 @@
 #define VALIDATOR_HPP
 
 #include "utils/common.hpp"
+#include "utils/spec_ref_table.hpp"
 
 #include <string>
 #include <unordered_map>
@@ -16,15 +17,25 @@ class BaseValidator
 {
 public:
     explicit BaseValidator(ValidationError err_code);
-    explicit BaseValidator(const std::vector<std::string>& ref_keys, ValidationError err_code);
-
-    virtual ValidationError Validate(const std::string& content, std::string& err_msg) = 0;
-    std::string GetErrHeader() const;
+    // The reference is interned into `spec_refs`, SpecRefTable::Default() when null
+    explicit BaseValidator(const std::vector<std::string>& ref_keys, ValidationError err_code,
+                           SpecRefTable* spec_refs = nullptr);
+    BaseValidator(const BaseValidator&) = delete;
+    BaseValidator& operator=(const BaseValidator&) = delete;
+
+    virtual ValidationError Validate(const std::string& content, std::string& err_msg) const = 0;
+    std::string GetErrHeader() const; // Rendered on demand, only needed when reporting an error
+    SpecRefTable::Id GetSpecRef() const;
     virtual ~BaseValidator() = default;
 
 protected:
+    void AppendErrHeader(std::string& err_msg) const;
+    // Header of another error than code_on_error_, with the spec reference of this validator
+    void AppendErrHeader(ValidationError code, std::string& err_msg) const;
+
     ValidationError code_on_error_;
-    std::string err_header_;
+    const SpecRefTable* spec_refs_; // Owned by the ValidatorsStore of the validator
+    SpecRefTable::Id spec_ref_; // Interned spec reference, SpecRefTable::kNone if not applicable
 
 private:
     static const std::unordered_map<ValidationError, std::string> kErrHeaders;
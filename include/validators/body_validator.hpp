@@ -12,10 +12,38 @@
 class BodyValidator: public JsonValidator
 {
 public:
-    explicit BodyValidator(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys)
-        : JsonValidator(schema_val, ref_keys, ValidationError::INVALID_BODY)
+    explicit BodyValidator(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys,
+                           const BodyLimits& limits = BodyLimits(), SpecRefTable* spec_refs = nullptr)
+        : JsonValidator(schema_val, ref_keys, ValidationError::INVALID_BODY, spec_refs)
+        , limits_(limits)
     {
     }
+
+    explicit BodyValidator(std::shared_ptr<const CompiledSchema> schema,
+                           const std::vector<std::string>& ref_keys, const BodyLimits& limits = BodyLimits(),
+                           SpecRefTable* spec_refs = nullptr)
+        : JsonValidator(std::move(schema), ref_keys, ValidationError::INVALID_BODY, spec_refs)
+        , limits_(limits)
+    {
+    }
+
+    using JsonValidator::Validate;
+
+    // Within the limits of the route
+    ValidationError Validate(const char* json, size_t length, BodyParser parser, std::string& error_msg,
+                             const ValidationDeadline* deadline = nullptr) const
+    {
+        return JsonValidator::Validate(json, length, parser, limits_, error_msg, deadline);
+    }
+
+    ValidationError Validate(const char* json, size_t length, BodyParser parser, rapidjson::Document& doc,
+                             std::string& error_msg, const ValidationDeadline* deadline = nullptr) const
+    {
+        return JsonValidator::Validate(json, length, parser, limits_, doc, error_msg, deadline);
+    }
+
+private:
+    const BodyLimits limits_;
 };
 
 #endif // BODY_VALIDATOR_HPP
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef COMPILED_SCHEMA_HPP
+#define COMPILED_SCHEMA_HPP
+
+#include "utils/common.hpp"
+#include "utils/schema_bounds.hpp"
+
+#include <cstddef>
+#include <rapidjson/schema.h>
+
+// Heap allocator of compiled schemas. While a schema is being compiled, the bytes it allocates on this thread are
+// accounted, so that the footprint of every compiled schema is known without a global heap profiler.
+class SchemaAllocator
+{
+public:
+    static const bool kNeedFree = true;
+
+    // Accounts the allocations of this thread for as long as it is alive
+    class Scope
+    {
+    public:
+        Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+        size_t bytes = 0;
+
+    private:
+        size_t* outer_;
+    };
+
+    void* Malloc(size_t size);
+    void* Realloc(void* original_ptr, size_t original_size, size_t new_size);
+    static void Free(void* ptr) noexcept;
+
+    bool operator==(const SchemaAllocator&) const noexcept
+    {
+        return true;
+    }
+
+    bool operator!=(const SchemaAllocator&) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static size_t GetSize(void* ptr, size_t requested);
+    static thread_local size_t* counter_;
+};
+
+using SchemaDocument = rapidjson::GenericSchemaDocument<rapidjson::Value, SchemaAllocator>;
+
+// Compiled schema with the digest of its definition, the number of bytes it takes and the bound of the documents it
+// accepts
+class CompiledSchema: public SchemaDocument
+{
+public:
+    explicit CompiledSchema(const rapidjson::Value& schema_val, uint64_t digest = 0);
+    CompiledSchema(const CompiledSchema&) = delete;
+    CompiledSchema& operator=(const CompiledSchema&) = delete;
+
+    uint64_t GetDigest() const
+    {
+        return digest_;
+    }
+
+    size_t GetMemoryUsage() const
+    {
+        return bytes_;
+    }
+
+    // Bytes of a valid document, whitespace excluded, SchemaBounds::kUnbounded when the schema does not bound them
+    size_t GetMaxBytes() const
+    {
+        return max_bytes_;
+    }
+
+private:
+    CompiledSchema(const rapidjson::Value& schema_val, uint64_t digest, SchemaAllocator::Scope&& scope);
+
+    const uint64_t digest_;
+    const size_t bytes_;
+    const size_t max_bytes_;
+};
+
+#endif // COMPILED_SCHEMA_HPP
@@ -7,32 +7,74 @@
 #ifndef JSON_VALIDATOR_HPP
 #define JSON_VALIDATOR_HPP
 
+#include "utils/body_limits.hpp"
+#include "utils/memory_report.hpp"
 #include "validators/base_validator.hpp"
+#include "validators/compiled_schema.hpp"
 
-#include <mutex>
-#include <rapidjson/schema.h>
+#include <memory>
 
+// Compiled schema is immutable after construction, validation state lives on the stack of each call
 class JsonValidator: public BaseValidator
 {
 private:
-    rapidjson::SchemaDocument* schema_;
-    rapidjson::SchemaValidator* validator_;
-    std::mutex mutex_{};
+    // State of a single validation, allocated from a stack buffer and spilling to heap only for large documents
+    using StateAllocator = rapidjson::MemoryPoolAllocator<>;
+    using Document = rapidjson::GenericDocument<rapidjson::UTF8<>, StateAllocator, StateAllocator>;
+    using SchemaValidator = rapidjson::GenericSchemaValidator<
+        SchemaDocument, rapidjson::BaseReaderHandler<rapidjson::UTF8<>, void>, StateAllocator>;
+    using ErrorValue = SchemaValidator::ValueType;
+    static constexpr size_t kStateBufferSize = 4096;
+    static constexpr size_t kDocumentBufferSize = 2048;
+    static constexpr size_t kParseStackBufferSize = 1024;
 
-    void CreateErrorMessages(const rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>& errors,
-                             const std::string& context, std::string& error_msg, bool recursive = false);
-    void HandleError(const char* error_name,
-                     const rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>& error,
-                     const std::string& context, std::string& error_msg, bool recursive);
-    static std::string GetString(const rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>& val);
+    std::shared_ptr<const CompiledSchema> schema_; // Possibly shared with identical definitions
+
+    // The document is added to `values` under `name` once valid
+    ValidationError ParseAndValidate(const char* json, size_t length, const BodyLimits& limits,
+                                     const ValidationDeadline* deadline, std::string& error_msg,
+                                     const std::string* name = nullptr, ParamValues* values = nullptr) const;
+    ValidationError ValidateIndexed(const char* json, size_t length, const BodyLimits& limits,
+                                    const ValidationDeadline* deadline, std::string& error_msg) const;
+    // Whether the body is longer than any document valid against the schema
+    bool ExceedsBound(const char* json, size_t length) const;
+    ValidationError SizeError(std::string& error_msg) const;
+    ValidationError LimitError(BodyLimit limit, const BodyLimits& limits, size_t offset, std::string& error_msg) const;
+    ValidationError TimeoutError(std::string& error_msg) const;
+    ValidationError ParserError(rapidjson::ParseErrorCode code, size_t offset, std::string& error_msg) const;
+    ValidationError SchemaError(const SchemaValidator& validator, std::string& error_msg) const;
+    static void CreateErrorMessages(const ErrorValue& errors, const std::string& context, std::string& error_msg,
+                                    bool recursive = false);
+    static void HandleError(const char* error_name, const ErrorValue& error, const std::string& context,
+                            std::string& error_msg, bool recursive);
+    static std::string GetString(const ErrorValue& val);
 
 public:
     JsonValidator(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys,
-                  ValidationError err_code);
+                  ValidationError err_code, SpecRefTable* spec_refs = nullptr);
+    JsonValidator(std::shared_ptr<const CompiledSchema> schema, const std::vector<std::string>& ref_keys,
+                  ValidationError err_code, SpecRefTable* spec_refs = nullptr);
     JsonValidator(const JsonValidator&) = delete;
     JsonValidator& operator=(const JsonValidator&) = delete;
-    ValidationError Validate(const std::string& json_str, std::string& error_msg) override;
-    ~JsonValidator() override;
+    ValidationError Validate(const std::string& json_str, std::string& error_msg) const override;
+    // `json` need not be null-terminated
+    ValidationError Validate(const char* json, size_t length, std::string& error_msg) const;
+    // Bodies, rejected without being parsed when longer than the schema allows, and as soon as they exceed `limits`.
+    // Stopped with ValidationError::TIMEOUT once `deadline`, when given, has passed.
+    ValidationError Validate(const char* json, size_t length, BodyParser parser, const BodyLimits& limits,
+                             std::string& error_msg, const ValidationDeadline* deadline = nullptr) const;
+    // Parses into `doc`, owned by the caller, which keeps the document once valid
+    ValidationError Validate(const char* json, size_t length, BodyParser parser, const BodyLimits& limits,
+                             rapidjson::Document& doc, std::string& error_msg,
+                             const ValidationDeadline* deadline = nullptr) const;
+    // Document already parsed by the caller
+    ValidationError Validate(const rapidjson::Value& json, std::string& error_msg) const;
+    // Adds the document, once valid, to `values` as the typed value of `name`
+    ValidationError Validate(const char* json, size_t length, const std::string& name, ParamValues& values,
+                             std::string& error_msg) const;
+    // Heap bytes owned beyond the object itself, the compiled schema is added to `report`
+    size_t GetMemoryUsage(MemoryReport& report) const;
+    ~JsonValidator() override = default;
 };
 
 #endif // JSON_VALIDATOR_HPP
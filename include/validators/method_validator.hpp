@@ -9,16 +9,14 @@
 
 #include "validators/base_validator.hpp"
 
-#include <unordered_set>
-
+// Accepts the methods of the specification in any casing
 class MethodValidator: public BaseValidator
 {
 public:
     MethodValidator();
-    ValidationError Validate(const std::string& method, std::string& err_msg) override;
-
-private:
-    static const std::unordered_set<std::string> kValidMethods;
+    ValidationError Validate(const std::string& method, std::string& err_msg) const override;
+    // Also gives the parsed method, so that it is not parsed again for routing
+    ValidationError Validate(const std::string& method, HttpMethod& parsed, std::string& err_msg) const;
 };
 
 #endif // METHOD_VALIDATOR_HPP
@@ -9,6 +9,7 @@
 
 #include "deserializers/base_deserializer.hpp"
 #include "validators/json_validator.hpp"
+#include "validators/validators_cache.hpp"
 #include <rapidjson/schema.h>
 #include <unordered_map>
 #include <utility>
@@ -20,8 +21,10 @@ private:
     {
         std::string name;
         bool required;
-        BaseDeserializer* deserializer;
-        const rapidjson::Value& schema;
+        std::shared_ptr<const BaseDeserializer> deserializer;
+        std::shared_ptr<const CompiledSchema> schema;
+        size_t max_bytes; // Of the raw value, see SchemaBounds::GetParamBytes()
+        SpecRefTable* spec_refs; // Of the cache, null without one
     };
 
 public:
@@ -29,26 +32,32 @@ public:
     ParamValidator(const ParamValidator&) = delete;
     ParamValidator& operator=(const ParamValidator&) = delete;
 
-    ValidationError ValidateParam(const char* beg, const char* end, std::string& error_msg);
+    // The value, once valid, is added to `values` when given. A value longer than its schema allows is rejected before
+    // it is deserialized.
+    ValidationError ValidateParam(const char* beg, const char* end, std::string& error_msg,
+                                  ParamValues* values = nullptr) const;
     bool IsRequired() const;
     ValidationError ErrorOnMissing(std::string& error_msg) const;
+    size_t GetMemoryUsage(MemoryReport& report) const;
     ~ParamValidator() override = default;
 
 protected:
     static ParamInfo GetParamInfo(const rapidjson::Value& param_val, const std::string& default_style,
                                   bool default_explode, bool default_required,
-                                  const std::vector<std::string>& ref_keys);
+                                  const std::vector<std::string>& ref_keys, ValidatorsCache* cache);
 
 private:
     const std::string name_;
     const bool required_;
-    BaseDeserializer* deserializer_;
+    const size_t max_bytes_;
+    std::shared_ptr<const BaseDeserializer> deserializer_; // Possibly shared with identical definitions
 };
 
 class PathParamValidator final: public ParamValidator
 {
 public:
-    explicit PathParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& keys);
+    explicit PathParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& keys,
+                                   ValidatorsCache* cache = nullptr);
     PathParamValidator(const PathParamValidator&) = delete;
     PathParamValidator& operator=(const PathParamValidator&) = delete;
     ~PathParamValidator() override = default;
@@ -57,7 +66,8 @@ public:
 class QueryParamValidator final: public ParamValidator
 {
 public:
-    explicit QueryParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& keys);
+    explicit QueryParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& keys,
+                                    ValidatorsCache* cache = nullptr);
     QueryParamValidator(const QueryParamValidator&) = delete;
     QueryParamValidator& operator=(const QueryParamValidator&) = delete;
     bool IsEmptyAllowed() const;
@@ -70,7 +80,8 @@ private:
 class HeaderParamValidator final: public ParamValidator
 {
 public:
-    explicit HeaderParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& keys);
+    explicit HeaderParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& keys,
+                                     ValidatorsCache* cache = nullptr);
     HeaderParamValidator(const HeaderParamValidator&) = delete;
     HeaderParamValidator& operator=(const HeaderParamValidator&) = delete;
     ~HeaderParamValidator() override = default;
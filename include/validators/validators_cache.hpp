@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef VALIDATORS_CACHE_HPP
+#define VALIDATORS_CACHE_HPP
+
+#include "deserializers/base_deserializer.hpp"
+#include "utils/spec_ref_table.hpp"
+#include "validators/compiled_schema.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Interns compiled schemas and deserializers by their (reference resolved) definition, so that identical definitions
+// repeated across operations share one compiled instance. Entries are weak, the cache never keeps a compiled instance
+// alive on its own. Also holds the spec references of the validators built with it, copies share them.
+class ValidatorsCache
+{
+public:
+    // Hashed by digest, equal only when the serialized definitions are
+    struct Key
+    {
+        uint64_t digest;
+        std::string source;
+
+        bool operator==(const Key& other) const
+        {
+            return digest == other.digest && source == other.source;
+        }
+    };
+
+    static Key GetKey(const rapidjson::Value& val);
+
+    std::shared_ptr<const CompiledSchema> GetSchema(const rapidjson::Value& schema_val);
+    std::shared_ptr<const BaseDeserializer> FindDeserializer(const Key& key) const;
+    void AddDeserializer(const Key& key, const std::shared_ptr<const BaseDeserializer>& deserializer);
+    const std::shared_ptr<SpecRefTable>& GetSpecRefs() const;
+    // Validators built from now on intern into a new table, the current one lives on with the validators using it
+    void ResetSpecRefs();
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return static_cast<size_t>(key.digest);
+        }
+    };
+
+    std::unordered_map<Key, std::weak_ptr<const CompiledSchema>, KeyHash> schemas_{};
+    std::unordered_map<Key, std::weak_ptr<const BaseDeserializer>, KeyHash> deserializers_{};
+    std::shared_ptr<SpecRefTable> spec_refs_{std::make_shared<SpecRefTable>()};
+};
+
+#endif // VALIDATORS_CACHE_HPP
@@ -7,10 +7,13 @@
 #ifndef OAS_VALIDATORS_HPP
 #define OAS_VALIDATORS_HPP
 
+#include "utils/body_sampler.hpp"
+#include "utils/check_order.hpp"
 #include "utils/common.hpp"
 #include "utils/path_trie.hpp"
 #include "validators/body_validator.hpp"
 #include "validators/param_validators.hpp"
+#include "validators/validators_cache.hpp"
 
 #include <utility>
 #include <vector>
@@ -18,16 +21,41 @@ class ValidatorsStore
 {
 public:
     ValidatorsStore() = default;
-    explicit ValidatorsStore(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys);
+    explicit ValidatorsStore(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys,
+                             const BodyLimits& limits, const BodySampling& sampling,
+                             ValidatorsCache* cache = nullptr);
     ValidatorsStore(const ValidatorsStore&) = delete;
     ValidatorsStore& operator=(const ValidatorsStore&) = delete;
     void AddParamValidators(const std::string& path, const rapidjson::Value& params,
-                            std::vector<std::string>& ref_keys);
-    ValidationError ValidateBody(const std::string& json_body, std::string& error_msg);
-    ValidationError ValidatePathParams(std::unordered_map<size_t, ParamRange>& param_idxs, std::string& error_msg);
-    ValidationError ValidateQueryParams(const std::string& query, std::string& error_msg);
+                            std::vector<std::string>& ref_keys, ValidatorsCache* cache = nullptr);
+    ValidationError ValidateBody(const std::string& json_body, BodyParser parser, std::string& error_msg) const;
+    // Bodies left out of the sample are accepted unparsed. Stopped with ValidationError::TIMEOUT once `deadline`,
+    // when given, has passed.
+    ValidationError ValidateBody(const char* json_body, size_t length, BodyParser parser, std::string& error_msg,
+                                 const ValidationDeadline* deadline = nullptr) const;
+    // `doc` receives the parsed body, it is null when the operation has no body schema
+    ValidationError ValidateBody(const char* json_body, size_t length, BodyParser parser, rapidjson::Document& doc,
+                                 std::string& error_msg, const ValidationDeadline* deadline = nullptr) const;
+    ValidationError ValidateBody(const rapidjson::Value& json_body, std::string& error_msg) const;
+    // Valid parameters are added to `values` when given, absent optional ones as ParamType::MISSING
+    ValidationError ValidatePathParams(std::unordered_map<size_t, ParamRange>& param_idxs, std::string& error_msg,
+                                       ParamValues* values = nullptr) const;
+    ValidationError ValidateQueryParams(const std::string& query, std::string& error_msg,
+                                        ParamValues* values = nullptr) const;
     ValidationError ValidateHeaderParams(const std::unordered_map<std::string, std::string>& headers,
-                                         std::string& error_msg);
+                                         std::string& error_msg) const;
+    // Matches header names case-insensitively, in one pass and without allocating. Every occurrence of a repeated
+    // header is validated.
+    ValidationError ValidateHeaderParams(const HeaderField* headers, size_t count, std::string& error_msg) const;
+    size_t GetValidatorCount() const;
+    // Spec references of the validators, ids into the table of the cache the store was built with
+    void AppendSpecRefs(std::vector<SpecRefTable::Id>& ids) const;
+    // Validation order of the route's requests, learned while validating them
+    CheckOrder& GetCheckOrder() const;
+    // Sampling of the route's bodies, null when the operation has no JSON body
+    const BodySampler* GetBodySampler() const;
+    // Bytes of the store and its validators, shared schemas and deserializers are added to `report`
+    size_t GetMemoryUsage(MemoryReport& report) const;
     ~ValidatorsStore();
 
 private:
@@ -83,10 +111,47 @@ private:
         }
     };
 
+    struct HeaderParamValidatorInfo
+    {
+        HeaderParamValidatorInfo(std::string name, HeaderParamValidator* validator)
+            : name(std::move(name))
+            , validator(validator)
+        {
+        }
+
+        HeaderParamValidatorInfo(const HeaderParamValidatorInfo& other) = default;
+
+        HeaderParamValidatorInfo& operator=(const HeaderParamValidatorInfo& other)
+        {
+            if (this == &other) {
+                return *this;
+            }
+            name = other.name;
+            validator = other.validator;
+            return *this;
+        }
+
+        std::string name{}; // Lower case
+        HeaderParamValidator* validator = nullptr;
+    };
+
+    static constexpr uint64_t kMaxHeaderSeeds = 64;
+
+    std::shared_ptr<const SpecRefTable> spec_refs_{}; // Of the validators below, null when built without a cache
     BodyValidator* body_validator_ = nullptr;
     std::vector<PathParamValidatorInfo> path_param_validators_{};
     std::vector<QueryParamValidatorInfo> query_param_validators_{};
     std::unordered_map<std::string, HeaderParamValidator*> header_param_validators_{};
+    std::vector<HeaderParamValidatorInfo> header_params_{}; // In declaration order
+    std::vector<uint32_t> header_slots_{}; // Perfect hash table of header_params_ index + 1, 0 for an empty slot
+    uint64_t header_seed_ = 0;
+    mutable CheckOrder check_order_{}; // Only its atomic counters change after loading
+    mutable BodySampler body_sampler_{}; // Likewise
+
+    void BuildHeaderTable();
+    size_t FindHeaderParam(const char* name, size_t length) const;
+    static uint64_t HashHeaderName(const char* beg, const char* end, uint64_t seed);
+    static bool EqualsIgnoreCase(const char* lhs, size_t lhs_length, const std::string& lower);
 
     static std::unordered_map<std::string, size_t> GetPathParamIndices(const std::string& path);
 };
@@ -17,7 +17,7 @@ ArrayDeserializer::ArrayDeserializer(const std::string& param_name, char start,
 {
 }
 
-std::string ArrayDeserializer::Deserialize(const char* beg, const char* const end)
+void ArrayDeserializer::Deserialize(const char* beg, const char* const end, std::string& ret) const
 {
     const char* cursor = beg;
 
@@ -30,7 +30,7 @@ std::string ArrayDeserializer::Deserialize(const char* beg, const char* const en
 
     CheckData(cursor, end);
 
-    std::string ret;
+    ret.clear();
     ret.reserve(static_cast<size_t>(end - beg + 64));
     ret.push_back('[');
 
@@ -62,6 +62,4 @@ std::string ArrayDeserializer::Deserialize(const char* beg, const char* const en
     } else {
         ret.push_back(']');
     }
-
-    return ret;
 }
@@ -11,7 +11,7 @@ ContentDeserializer::ContentDeserializer(const std::string& param_name, char sta
 {
 }
 
-std::string ContentDeserializer::Deserialize(const char* beg, const char* const end)
+void ContentDeserializer::Deserialize(const char* beg, const char* const end, std::string& ret) const
 {
     const char* cursor = beg;
 
@@ -21,34 +21,10 @@ std::string ContentDeserializer::Deserialize(const char* beg, const char* const
         CheckNSkipChar(cursor, end, '=');
     }
 
-    std::string ret;
+    ret.clear();
     ret.reserve(static_cast<std::string::size_type>(end - cursor));
 
-    while (cursor < end) {
-        char c = *cursor++;
-        switch (c) {
-        case '%': {
-            if (cursor + 1 >= end) {
-                throw DeserializationException("Incomplete percent encoding for '" + param_name_ + "'");
-            }
-            const char dec1 = kHexLookupTable[static_cast<unsigned char>(*cursor++)];
-            const char dec2 = kHexLookupTable[static_cast<unsigned char>(*cursor++)];
-            if (dec1 < 0 || dec2 < 0) {
-                throw DeserializationException("Invalid HEX character for '" + param_name_ + "'");
-            }
-            ret.push_back(static_cast<char>((dec1 << 4) | dec2));
-        } break;
-
-        case '+':
-            ret += ' ';
-            break;
-
-        default:
-            ret += c;
-            break;
-        }
-    }
-
+    CheckDecoded(PercentDecode(cursor, end, ret));
+    CheckUtf8(ret, 0);
     CheckEnd(cursor, end);
-    return ret;
 }
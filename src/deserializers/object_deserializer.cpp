@@ -16,7 +16,7 @@ ObjectDeserializer::ObjectDeserializer(const std::string& param_name, char start
 {
 }
 
-std::string ObjectDeserializer::Deserialize(const char* beg, const char* const end)
+void ObjectDeserializer::Deserialize(const char* beg, const char* const end, std::string& ret) const
 {
     const char* cursor = beg;
 
@@ -29,12 +29,12 @@ std::string ObjectDeserializer::Deserialize(const char* beg, const char* const e
 
     CheckData(cursor, end);
 
-    std::string ret;
+    ret.clear();
     ret.reserve(static_cast<size_t>(end - beg + 128));
 
     ret.push_back('{');
 
-    std::string key;
+    thread_local std::string key; // Kept with its capacity across calls, like `ret`
     key.reserve(128);
 
     if (is_deep_obj_) {
@@ -115,5 +115,13 @@ std::string ObjectDeserializer::Deserialize(const char* beg, const char* const e
     CheckEnd(cursor, end);
 
     ret.push_back('}');
-    return ret;
+}
+
+size_t ObjectDeserializer::GetMemoryUsage() const
+{
+    size_t bytes = sizeof(*this) + GetHeapSize(param_name_) + GetHashMapHeapSize(kt_map_);
+    for (const auto& kt : kt_map_) {
+        bytes += GetHeapSize(kt.first);
+    }
+    return bytes;
 }
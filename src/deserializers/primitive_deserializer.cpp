@@ -12,7 +12,7 @@ PrimitiveDeserializer::PrimitiveDeserializer(const std::string& param_name, char
     , param_type_(param_type)
 {
 }
-std::string PrimitiveDeserializer::Deserialize(const char* beg, const char* const end)
+void PrimitiveDeserializer::Deserialize(const char* beg, const char* const end, std::string& ret) const
 {
     const char* cursor = beg;
 
@@ -25,7 +25,7 @@ std::string PrimitiveDeserializer::Deserialize(const char* beg, const char* cons
 
     CheckData(cursor, end);
 
-    std::string ret;
+    ret.clear();
     ret.reserve(static_cast<size_t>(end - beg + 2));
 
     switch (param_type_) {
@@ -49,6 +49,4 @@ std::string PrimitiveDeserializer::Deserialize(const char* beg, const char* cons
     }
 
     CheckEnd(cursor, end);
-
-    return ret;
 }
@@ -8,28 +8,41 @@
 
 #include "oas_validator_imp.hpp"
 
-OASValidator::OASValidator(const std::string& oas_specs,
-                           const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map)
-    : impl_(new OASValidatorImp(oas_specs, method_map))
+namespace {
+const std::string kNoValue;
+} // namespace
+
+bool RouteHandle::IsValid() const
+{
+    return nullptr != route_;
+}
+
+const std::string& RouteHandle::GetMethod() const
 {
+    return route_ ? route_->method : kNoValue;
 }
 
-OASValidator::OASValidator(const OASValidator& other)
-    : impl_(new OASValidatorImp(*other.impl_))
+const std::string& RouteHandle::GetPathTemplate() const
 {
+    return route_ ? route_->path_template : kNoValue;
 }
 
-OASValidator& OASValidator::operator=(const OASValidator& other)
+const std::string& RouteHandle::GetOperationId() const
 {
-    if (this == &other) {
-        return *this;
-    }
+    return route_ ? route_->operation_id : kNoValue;
+}
 
-    delete impl_;
-    impl_ = new OASValidatorImp(*other.impl_);
-    return *this;
+OASValidator::OASValidator(const std::string& oas_specs,
+                           const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map,
+                           const ValidatorOptions& options)
+    : impl_(std::make_shared<const OASValidatorImp>(oas_specs, method_map, options))
+{
 }
 
+OASValidator::OASValidator(const OASValidator& other) = default;
+
+OASValidator& OASValidator::operator=(const OASValidator& other) = default;
+
 ValidationError OASValidator::ValidateRoute(const std::string& method, const std::string& http_path,
                                             std::string& error_msg)
 {
@@ -87,7 +100,247 @@ ValidationError OASValidator::ValidateRequest(const std::string& method, const s
     return impl_->ValidateRequest(method, http_path, json_body, headers, error_msg);
 }
 
-OASValidator::~OASValidator()
+ValidationError OASValidator::ValidateHeaders(const std::string& method, const std::string& http_path,
+                                              const HeaderField* headers, size_t header_count,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateHeaders(method, http_path, headers, header_count, error_msg);
+}
+
+ValidationError OASValidator::ValidateRequest(const std::string& method, const std::string& http_path,
+                                              const HeaderField* headers, size_t header_count,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateRequest(method, http_path, headers, header_count, error_msg);
+}
+
+ValidationError OASValidator::ValidateRequest(const std::string& method, const std::string& http_path,
+                                              const std::string& json_body, const HeaderField* headers,
+                                              size_t header_count, std::string& error_msg)
+{
+    return impl_->ValidateRequest(method, http_path, json_body, headers, header_count, error_msg);
+}
+
+ValidationError OASValidator::ValidateHttp1Request(const char* head, size_t head_length, std::string& error_msg)
+{
+    return impl_->ValidateHttp1Request(head, head_length, nullptr, 0, error_msg);
+}
+
+ValidationError OASValidator::ValidateHttp1Request(const char* head, size_t head_length, const char* json_body,
+                                                   size_t body_length, std::string& error_msg)
+{
+    return impl_->ValidateHttp1Request(head, head_length, json_body ? json_body : "", body_length, error_msg);
+}
+
+ValidationError OASValidator::ValidateHttp2Request(const HeaderField* headers, size_t header_count,
+                                                   std::string& error_msg)
+{
+    return impl_->ValidateHttp2Request(headers, header_count, nullptr, 0, error_msg);
+}
+
+ValidationError OASValidator::ValidateHttp2Request(const HeaderField* headers, size_t header_count,
+                                                   const char* json_body, size_t body_length, std::string& error_msg)
+{
+    return impl_->ValidateHttp2Request(headers, header_count, json_body ? json_body : "", body_length, error_msg);
+}
+
+ValidationError OASValidator::GetRoute(const std::string& method, const std::string& path_template,
+                                       RouteHandle& route, std::string& error_msg) const
+{
+    return impl_->GetRoute(method, path_template, route.route_, error_msg);
+}
+
+ValidationError OASValidator::GetRouteByOperationId(const std::string& operation_id, RouteHandle& route,
+                                                    std::string& error_msg) const
+{
+    return impl_->GetRouteByOperationId(operation_id, route.route_, error_msg);
+}
+
+ValidationError OASValidator::ValidateBody(const RouteHandle& route, const std::string& json_body,
+                                           std::string& error_msg)
 {
-    delete impl_;
-};
\ No newline at end of file
+    return impl_->ValidateBody(route.route_.get(), json_body, error_msg);
+}
+
+ValidationError OASValidator::ValidatePathParam(const RouteHandle& route, const std::string& http_path,
+                                                std::string& error_msg)
+{
+    return impl_->ValidatePathParam(route.route_.get(), http_path, error_msg);
+}
+
+ValidationError OASValidator::ValidateQueryParam(const RouteHandle& route, const std::string& http_path,
+                                                 std::string& error_msg)
+{
+    return impl_->ValidateQueryParam(route.route_.get(), http_path, error_msg);
+}
+
+ValidationError OASValidator::ValidateHeaders(const RouteHandle& route,
+                                              const std::unordered_map<std::string, std::string>& headers,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateHeaders(route.route_.get(), headers, error_msg);
+}
+
+ValidationError OASValidator::ValidateHeaders(const RouteHandle& route, const HeaderField* headers,
+                                              size_t header_count, std::string& error_msg)
+{
+    return impl_->ValidateHeaders(route.route_.get(), headers, header_count, error_msg);
+}
+
+ValidationError OASValidator::ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateRequest(route.route_.get(), http_path, error_msg);
+}
+
+ValidationError OASValidator::ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                              const std::string& json_body, std::string& error_msg)
+{
+    return impl_->ValidateRequest(route.route_.get(), http_path, json_body, error_msg);
+}
+
+ValidationError OASValidator::ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                              const HeaderField* headers, size_t header_count,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateRequest(route.route_.get(), http_path, headers, header_count, error_msg);
+}
+
+ValidationError OASValidator::ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                              const std::string& json_body, const HeaderField* headers,
+                                              size_t header_count, std::string& error_msg)
+{
+    return impl_->ValidateRequest(route.route_.get(), http_path, json_body, headers, header_count, error_msg);
+}
+
+ValidationError OASValidator::ValidateBody(const std::string& method, const std::string& http_path,
+                                           const std::string& json_body, rapidjson::Document& body,
+                                           std::string& error_msg)
+{
+    return impl_->ValidateBody(method, http_path, json_body, body, error_msg);
+}
+
+ValidationError OASValidator::ValidateBody(const std::string& method, const std::string& http_path,
+                                           const rapidjson::Value& body, std::string& error_msg)
+{
+    return impl_->ValidateBody(method, http_path, body, error_msg);
+}
+
+ValidationError OASValidator::ValidateBody(const RouteHandle& route, const std::string& json_body,
+                                           rapidjson::Document& body, std::string& error_msg)
+{
+    return impl_->ValidateBody(route.route_.get(), json_body, body, error_msg);
+}
+
+ValidationError OASValidator::ValidateBody(const RouteHandle& route, const rapidjson::Value& body,
+                                           std::string& error_msg)
+{
+    return impl_->ValidateBody(route.route_.get(), body, error_msg);
+}
+
+ValidationError OASValidator::ValidatePathParam(const std::string& method, const std::string& http_path,
+                                                ParamValues& values, std::string& error_msg)
+{
+    values.Clear();
+    return impl_->ValidatePathParam(method, http_path, error_msg, &values);
+}
+
+ValidationError OASValidator::ValidateQueryParam(const std::string& method, const std::string& http_path,
+                                                 ParamValues& values, std::string& error_msg)
+{
+    values.Clear();
+    return impl_->ValidateQueryParam(method, http_path, error_msg, &values);
+}
+
+ValidationError OASValidator::ValidateRequest(const std::string& method, const std::string& http_path,
+                                              ParamValues& values, std::string& error_msg)
+{
+    values.Clear();
+    return impl_->ValidateRequest(method, http_path, error_msg, &values);
+}
+
+ValidationError OASValidator::ValidatePathParam(const RouteHandle& route, const std::string& http_path,
+                                                ParamValues& values, std::string& error_msg)
+{
+    values.Clear();
+    return impl_->ValidatePathParam(route.route_.get(), http_path, error_msg, &values);
+}
+
+ValidationError OASValidator::ValidateQueryParam(const RouteHandle& route, const std::string& http_path,
+                                                 ParamValues& values, std::string& error_msg)
+{
+    values.Clear();
+    return impl_->ValidateQueryParam(route.route_.get(), http_path, error_msg, &values);
+}
+
+ValidationError OASValidator::ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                              ParamValues& values, std::string& error_msg)
+{
+    values.Clear();
+    return impl_->ValidateRequest(route.route_.get(), http_path, error_msg, &values);
+}
+
+ValidationError OASValidator::ValidateBody(const std::string& method, const std::string& http_path,
+                                           const std::string& json_body, const ValidationDeadline& deadline,
+                                           std::string& error_msg)
+{
+    return impl_->ValidateBody(method, http_path, json_body, error_msg, &deadline);
+}
+
+ValidationError OASValidator::ValidateBody(const RouteHandle& route, const std::string& json_body,
+                                           const ValidationDeadline& deadline, std::string& error_msg)
+{
+    return impl_->ValidateBody(route.route_.get(), json_body, error_msg, &deadline);
+}
+
+ValidationError OASValidator::ValidateRequest(const std::string& method, const std::string& http_path,
+                                              const std::string& json_body,
+                                              const std::unordered_map<std::string, std::string>& headers,
+                                              const ValidationDeadline& deadline, std::string& error_msg)
+{
+    return impl_->ValidateRequest(method, http_path, json_body, headers, error_msg, &deadline);
+}
+
+ValidationError OASValidator::ValidateRequest(const std::string& method, const std::string& http_path,
+                                              const std::string& json_body, const HeaderField* headers,
+                                              size_t header_count, const ValidationDeadline& deadline,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateRequest(method, http_path, json_body, headers, header_count, error_msg, &deadline);
+}
+
+ValidationError OASValidator::ValidateRequest(const RouteHandle& route, const std::string& http_path,
+                                              const std::string& json_body, const HeaderField* headers,
+                                              size_t header_count, const ValidationDeadline& deadline,
+                                              std::string& error_msg)
+{
+    return impl_->ValidateRequest(route.route_.get(), http_path, json_body, headers, header_count, error_msg,
+                                  &deadline);
+}
+
+std::string OASValidator::GetMemoryReport() const
+{
+    return impl_->GetMemoryReport();
+}
+
+RouteCacheStats OASValidator::GetRouteCacheStats() const
+{
+    return impl_->GetRouteCacheStats();
+}
+
+std::vector<ValidationOrderStats> OASValidator::GetValidationOrderStats() const
+{
+    return impl_->GetValidationOrderStats();
+}
+
+std::vector<BodySamplingStats> OASValidator::GetBodySamplingStats() const
+{
+    return impl_->GetBodySamplingStats();
+}
+
+void OASValidator::ReloadSpecs(const std::string& oas_specs)
+{
+    impl_ = std::make_shared<const OASValidatorImp>(oas_specs, *impl_);
+}
+
+OASValidator::~OASValidator() = default;
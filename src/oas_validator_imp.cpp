@@ -6,74 +6,181 @@
 
 #include "oas_validator_imp.hpp"
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <rapidjson/istreamwrapper.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <sstream>
 
-OASValidatorImp::OASValidatorImp(const std::string& oas_specs,
-                                 const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map)
-    : method_map_(BuildCaseInsensitiveMap(method_map))
+namespace {
+// Same segments as PathTrie, the leading '/' gives an empty first segment and a trailing one is ignored
+std::vector<std::string> SplitSegments(const std::string& path)
 {
-    rapidjson::Document doc;
-    ParseSpecs(oas_specs, doc);
-    ResolveReferences(doc, doc, doc.GetAllocator());
+    std::vector<std::string> segments;
+    const char* beg = path.c_str();
+    const char* const end = beg + path.size();
+    while (beg < end) {
+        const char* segment_end = Seek(beg, end, '/');
+        segments.emplace_back(beg, segment_end);
+        beg = segment_end + 1; // skip '/'
+    }
+    return segments;
+}
+} // namespace
+
+RouteInfo::RouteInfo(std::string method_name, std::string path, std::string operation,
+                     std::shared_ptr<const ValidatorsStore> store)
+    : method(std::move(method_name))
+    , path_template(std::move(path))
+    , operation_id(std::move(operation))
+    , validators(std::move(store))
+    , segments(SplitSegments(path_template))
+{
+}
 
-    const rapidjson::Value& paths = doc["paths"];
-    std::vector<std::string> ref_keys;
-    ref_keys.emplace_back("paths");
+bool RouteInfo::MatchPath(const char* beg, const char* const end,
+                          std::unordered_map<size_t, ParamRange>& param_idxs) const
+{
+    size_t idx = 0;
+    while (beg < end) {
+        const char* segment_end = Seek(beg, end, '/');
+        if (segments.size() == idx) {
+            return false;
+        }
+        const auto& segment = segments[idx];
+        if (!segment.empty() && '{' == segment[0]) {
+            param_idxs.emplace(idx, ParamRange{beg, segment_end});
+        } else if (segment.size() != static_cast<size_t>(segment_end - beg) ||
+                   !std::equal(beg, segment_end, segment.begin())) {
+            return false;
+        }
+        ++idx;
+        beg = segment_end + 1; // skip '/'
+    }
+    return segments.size() == idx;
+}
 
-    for (auto path_itr = paths.MemberBegin(); path_itr != paths.MemberEnd(); ++path_itr) {
-        ProcessPath(path_itr, ref_keys);
+bool RouteInfo::MatchPath(const NormalizedPath& path, const PathNormalizer& normalizer,
+                          std::unordered_map<size_t, ParamRange>& param_idxs) const
+{
+    if (segments.size() != path.GetSegmentCount()) {
+        return false;
+    }
+    std::string key;
+    for (size_t idx = 0; idx < segments.size(); ++idx) {
+        const auto& segment = segments[idx];
+        if (!segment.empty() && '{' == segment[0]) {
+            param_idxs.emplace(idx, path.GetSegment(idx));
+            continue;
+        }
+        path.GetKey(idx, key);
+        if (key != normalizer.GetKey(segment)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OASValidatorImp::OASValidatorImp(const std::string& oas_specs,
+                                 const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map,
+                                 const ValidatorOptions& options)
+    : method_map_(BuildMethodMap(method_map))
+    , options_(options)
+    , route_cache_(options.route_cache_capacity ? new RouteCache(options.route_cache_capacity) : nullptr)
+{
+    LoadSpecs(oas_specs, nullptr);
+    ResolveAliases();
+}
+
+OASValidatorImp::OASValidatorImp(const std::string& oas_specs, const OASValidatorImp& loaded)
+    : method_map_(loaded.method_map_)
+    , options_(loaded.options_)
+    , validators_cache_(loaded.validators_cache_)
+    , route_cache_(options_.route_cache_capacity ? new RouteCache(options_.route_cache_capacity) : nullptr)
+{
+    // The shared table only grows, it is replaced once most of its references are of operations no longer loaded.
+    // Operations are then all built again, as the validators of `loaded` keep ids into the old table.
+    const PerMethodValidators* reusable = &loaded.oas_validators_;
+    if (validators_cache_.GetSpecRefs()->GetCount() > 2 * loaded.live_spec_refs_) {
+        validators_cache_.ResetSpecRefs();
+        reusable = nullptr;
     }
+    LoadSpecs(oas_specs, reusable);
+    ResolveAliases();
 }
 
 ValidationError OASValidatorImp::ValidateRoute(const std::string& method, const std::string& http_path,
-                                               std::string& error_msg)
+                                               std::string& error_msg) const
 {
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
     return GetValidators(method, http_path, validators, error_msg);
 }
 
 ValidationError OASValidatorImp::ValidateBody(const std::string& method, const std::string& http_path,
-                                              const std::string& json_body, std::string& error_msg)
+                                              const std::string& json_body, std::string& error_msg,
+                                              const ValidationDeadline* deadline) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(method, http_path, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateBody(json_body.data(), json_body.size(), options_.body_parser, error_msg, deadline);
+}
+
+ValidationError OASValidatorImp::ValidateBody(const std::string& method, const std::string& http_path,
+                                              const std::string& json_body, rapidjson::Document& body,
+                                              std::string& error_msg) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(method, http_path, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateBody(json_body.data(), json_body.size(), options_.body_parser, body, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateBody(const std::string& method, const std::string& http_path,
+                                              const rapidjson::Value& body, std::string& error_msg) const
 {
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
     auto err_code = GetValidators(method, http_path, validators, error_msg);
     CHECK_ERROR(err_code)
 
-    return validators->ValidateBody(json_body, error_msg);
+    return validators->ValidateBody(body, error_msg);
 }
 
 ValidationError OASValidatorImp::ValidatePathParam(const std::string& method, const std::string& http_path,
-                                                   std::string& error_msg)
+                                                   std::string& error_msg, ParamValues* values) const
 {
     std::unordered_map<size_t, ParamRange> param_idxs;
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
     auto err_code = GetValidators(method, http_path, validators, error_msg, &param_idxs);
     CHECK_ERROR(err_code)
 
-    return validators->ValidatePathParams(param_idxs, error_msg);
+    return validators->ValidatePathParams(param_idxs, error_msg, values);
 }
 
 ValidationError OASValidatorImp::ValidateQueryParam(const std::string& method, const std::string& http_path,
-                                                    std::string& error_msg)
+                                                    std::string& error_msg, ParamValues* values) const
 {
     std::string query;
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
     auto err_code = GetValidators(method, http_path, validators, error_msg, nullptr, &query);
     CHECK_ERROR(err_code)
 
-    return validators->ValidateQueryParams(query, error_msg);
+    return validators->ValidateQueryParams(query, error_msg, values);
 }
 
 ValidationError OASValidatorImp::ValidateHeaders(const std::string& method, const std::string& http_path,
                                                  const std::unordered_map<std::string, std::string>& headers,
-                                                 std::string& error_msg)
+                                                 std::string& error_msg) const
 {
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
     auto err_code = GetValidators(method, http_path, validators, error_msg);
     CHECK_ERROR(err_code)
@@ -81,163 +188,713 @@ ValidationError OASValidatorImp::ValidateHeaders(const std::string& method, cons
     return validators->ValidateHeaderParams(headers, error_msg);
 }
 
+ValidationError OASValidatorImp::ValidateHeaders(const std::string& method, const std::string& http_path,
+                                                 const HeaderField* headers, size_t header_count,
+                                                 std::string& error_msg) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(method, http_path, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateHeaderParams(headers, header_count, error_msg);
+}
+
 ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
-                                                 std::string& error_msg)
+                                                 std::string& error_msg, ParamValues* values) const
 {
     std::unordered_map<size_t, ParamRange> param_idxs;
     std::string query;
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
     auto err_code = GetValidators(method, http_path, validators, error_msg, &param_idxs, &query);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidatePathParams(param_idxs, error_msg);
+    err_code = validators->ValidatePathParams(param_idxs, error_msg, values);
     CHECK_ERROR(err_code)
 
-    return validators->ValidateQueryParams(query, error_msg);
+    return validators->ValidateQueryParams(query, error_msg, values);
 }
 
 ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
-                                                 const std::string& json_body, std::string& error_msg)
+                                                 const std::string& json_body, std::string& error_msg) const
 {
-    std::unordered_map<size_t, ParamRange> param_idxs;
-    std::string query;
-    ValidatorsStore* validators;
+    RequestParts parts;
+    const ValidatorsStore* validators;
 
-    auto err_code = GetValidators(method, http_path, validators, error_msg, &param_idxs, &query);
+    auto err_code = GetValidators(method, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidateBody(json_body, error_msg);
-    CHECK_ERROR(err_code)
+    parts.json_body = json_body.data();
+    parts.body_length = json_body.size();
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
+                                                 const std::unordered_map<std::string, std::string>& headers,
+                                                 std::string& error_msg) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
 
-    err_code = validators->ValidatePathParams(param_idxs, error_msg);
+    auto err_code = GetValidators(method, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
     CHECK_ERROR(err_code)
 
-    return validators->ValidateQueryParams(query, error_msg);
+    parts.has_headers = true;
+    parts.header_map = &headers;
+    return ValidateParts(*validators, parts, error_msg);
 }
 
 ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
+                                                 const std::string& json_body,
                                                  const std::unordered_map<std::string, std::string>& headers,
-                                                 std::string& error_msg)
+                                                 std::string& error_msg, const ValidationDeadline* deadline) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(method, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
+    CHECK_ERROR(err_code)
+
+    parts.has_headers = true;
+    parts.header_map = &headers;
+    parts.json_body = json_body.data();
+    parts.body_length = json_body.size();
+    parts.deadline = deadline;
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
+                                                 const HeaderField* headers, size_t header_count,
+                                                 std::string& error_msg) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(method, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
+    CHECK_ERROR(err_code)
+
+    parts.has_headers = true;
+    parts.headers = headers;
+    parts.header_count = header_count;
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
+                                                 const std::string& json_body, const HeaderField* headers,
+                                                 size_t header_count, std::string& error_msg,
+                                                 const ValidationDeadline* deadline) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(method, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
+    CHECK_ERROR(err_code)
+
+    parts.has_headers = true;
+    parts.headers = headers;
+    parts.header_count = header_count;
+    parts.json_body = json_body.data();
+    parts.body_length = json_body.size();
+    parts.deadline = deadline;
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateHttp1Request(const char* head, size_t head_length, const char* json_body,
+                                                      size_t body_length, std::string& error_msg) const
+{
+    RawRequest request;
+    auto err_code = request.ParseHttp1(head, head_length, error_msg);
+    CHECK_ERROR(err_code)
+
+    return ValidateRawRequest(request, json_body, body_length, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateHttp2Request(const HeaderField* headers, size_t header_count,
+                                                      const char* json_body, size_t body_length,
+                                                      std::string& error_msg) const
+{
+    RawRequest request;
+    auto err_code = request.ParseHttp2(headers, header_count, error_msg);
+    CHECK_ERROR(err_code)
+
+    return ValidateRawRequest(request, json_body, body_length, error_msg);
+}
+
+ValidationError OASValidatorImp::GetRoute(const std::string& method, const std::string& path_template,
+                                          std::shared_ptr<const RouteInfo>& route, std::string& error_msg) const
+{
+    size_t slot;
+    auto err_code = GetRoutes(method, slot, error_msg);
+    CHECK_ERROR(err_code)
+    const PerMethod* routes = routes_[slot];
+
+    auto route_itr = routes->per_path_validators.find(path_template);
+    if (route_itr == routes->per_path_validators.end()) {
+        error_msg = R"({"errorCode":"INVALID_ROUTE","details":{"description": "Invalid HTTP method ')" + method +
+                    "' or path template: '" + path_template + R"('"}})";
+        return ValidationError::INVALID_ROUTE;
+    }
+    auto operation_itr = routes->per_path_operation_ids.find(path_template);
+    std::string method_name(method);
+    std::transform(method_name.begin(), method_name.end(), method_name.begin(), ToUpper);
+    route = std::make_shared<const RouteInfo>(
+        std::move(method_name), path_template,
+        operation_itr == routes->per_path_operation_ids.end() ? std::string() : operation_itr->second,
+        route_itr->second);
+    return ValidationError::NONE;
+}
+
+ValidationError OASValidatorImp::GetRouteByOperationId(const std::string& operation_id,
+                                                       std::shared_ptr<const RouteInfo>& route,
+                                                       std::string& error_msg) const
+{
+    auto operation_itr = operations_.find(operation_id);
+    if (operation_itr == operations_.end()) {
+        error_msg = R"({"errorCode":"INVALID_ROUTE","details":{"description": "Unknown operationId ')" + operation_id +
+                    R"('"}})";
+        return ValidationError::INVALID_ROUTE;
+    }
+    const auto method = operation_itr->second.first;
+    const auto& path = operation_itr->second.second;
+    const auto& routes = oas_validators_[static_cast<size_t>(method)];
+    route = std::make_shared<const RouteInfo>(GetHttpMethodName(method), path, operation_id,
+                                              routes.per_path_validators.at(path));
+    return ValidationError::NONE;
+}
+
+ValidationError OASValidatorImp::ValidateBody(const RouteInfo* route, const std::string& json_body,
+                                              std::string& error_msg, const ValidationDeadline* deadline) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateBody(json_body.data(), json_body.size(), options_.body_parser, error_msg, deadline);
+}
+
+ValidationError OASValidatorImp::ValidateBody(const RouteInfo* route, const std::string& json_body,
+                                              rapidjson::Document& body, std::string& error_msg) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateBody(json_body.data(), json_body.size(), options_.body_parser, body, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateBody(const RouteInfo* route, const rapidjson::Value& body,
+                                              std::string& error_msg) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateBody(body, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidatePathParam(const RouteInfo* route, const std::string& http_path,
+                                                   std::string& error_msg, ParamValues* values) const
 {
     std::unordered_map<size_t, ParamRange> param_idxs;
-    std::string query;
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
-    auto err_code = GetValidators(method, http_path, validators, error_msg, &param_idxs, &query);
+    auto err_code = GetValidators(route, http_path, validators, error_msg, &param_idxs);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidatePathParams(param_idxs, error_msg);
+    return validators->ValidatePathParams(param_idxs, error_msg, values);
+}
+
+ValidationError OASValidatorImp::ValidateQueryParam(const RouteInfo* route, const std::string& http_path,
+                                                    std::string& error_msg, ParamValues* values) const
+{
+    std::string query;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, http_path, validators, error_msg, nullptr, &query);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidateQueryParams(query, error_msg);
+    return validators->ValidateQueryParams(query, error_msg, values);
+}
+
+ValidationError OASValidatorImp::ValidateHeaders(const RouteInfo* route,
+                                                 const std::unordered_map<std::string, std::string>& headers,
+                                                 std::string& error_msg) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, validators, error_msg);
     CHECK_ERROR(err_code)
 
     return validators->ValidateHeaderParams(headers, error_msg);
 }
 
-ValidationError OASValidatorImp::ValidateRequest(const std::string& method, const std::string& http_path,
-                                                 const std::string& json_body,
-                                                 const std::unordered_map<std::string, std::string>& headers,
-                                                 std::string& error_msg)
+ValidationError OASValidatorImp::ValidateHeaders(const RouteInfo* route, const HeaderField* headers,
+                                                 size_t header_count, std::string& error_msg) const
+{
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    return validators->ValidateHeaderParams(headers, header_count, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const RouteInfo* route, const std::string& http_path,
+                                                 std::string& error_msg, ParamValues* values) const
 {
     std::unordered_map<size_t, ParamRange> param_idxs;
     std::string query;
-    ValidatorsStore* validators;
+    const ValidatorsStore* validators;
 
-    auto err_code = GetValidators(method, http_path, validators, error_msg, &param_idxs, &query);
+    auto err_code = GetValidators(route, http_path, validators, error_msg, &param_idxs, &query);
+    CHECK_ERROR(err_code)
+
+    err_code = validators->ValidatePathParams(param_idxs, error_msg, values);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidateBody(json_body, error_msg);
+    return validators->ValidateQueryParams(query, error_msg, values);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const RouteInfo* route, const std::string& http_path,
+                                                 const std::string& json_body, std::string& error_msg) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidatePathParams(param_idxs, error_msg);
+    parts.json_body = json_body.data();
+    parts.body_length = json_body.size();
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const RouteInfo* route, const std::string& http_path,
+                                                 const HeaderField* headers, size_t header_count,
+                                                 std::string& error_msg) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
     CHECK_ERROR(err_code)
 
-    err_code = validators->ValidateQueryParams(query, error_msg);
+    parts.has_headers = true;
+    parts.headers = headers;
+    parts.header_count = header_count;
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateRequest(const RouteInfo* route, const std::string& http_path,
+                                                 const std::string& json_body, const HeaderField* headers,
+                                                 size_t header_count, std::string& error_msg,
+                                                 const ValidationDeadline* deadline) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(route, http_path, validators, error_msg, &parts.param_idxs, &parts.query);
     CHECK_ERROR(err_code)
 
-    return validators->ValidateHeaderParams(headers, error_msg);
+    parts.has_headers = true;
+    parts.headers = headers;
+    parts.header_count = header_count;
+    parts.json_body = json_body.data();
+    parts.body_length = json_body.size();
+    parts.deadline = deadline;
+    return ValidateParts(*validators, parts, error_msg);
 }
 
-OASValidatorImp::~OASValidatorImp()
+std::string OASValidatorImp::GetMemoryReport() const
 {
-#ifndef LUA_OAS_VALIDATOR // LUA manages garbage collection itself
-    for (auto& per_method_validator : oas_validators_) {
-        for (auto& per_path_validator : per_method_validator.per_path_validators) {
-            delete per_path_validator.second;
+    MemoryReport report;
+    for (size_t method_idx = 0; method_idx < oas_validators_.size(); ++method_idx) {
+        const auto& per_method = oas_validators_[method_idx];
+        size_t route_map_bytes =
+            GetHashMapHeapSize(per_method.per_path_validators) + GetHashMapHeapSize(per_method.per_path_digests);
+        for (const auto& route : per_method.per_path_validators) {
+            route_map_bytes += 2 * GetHeapSize(route.first); // Key of both maps
+            route_map_bytes += GetHeapSize(per_method.per_path_digests.at(route.first).serialized);
+            report.AddRoute(GetHttpMethodName(static_cast<HttpMethod>(method_idx)), route.first,
+                            route.second->GetMemoryUsage(report), route.second->GetValidatorCount());
+        }
+        route_map_bytes += GetHashMapHeapSize(per_method.per_path_operation_ids);
+        for (const auto& operation : per_method.per_path_operation_ids) {
+            route_map_bytes += GetHeapSize(operation.first) + GetHeapSize(operation.second);
         }
+        AddRouting(per_method, route_map_bytes, report);
+    }
+
+    for (const auto& merged : aliased_routes_) { // Routes shared with the methods, only the tables are counted
+        AddRouting(merged,
+                   GetHashMapHeapSize(merged.per_path_validators) + GetHashMapHeapSize(merged.per_path_operation_ids),
+                   report);
+    }
+
+    size_t other_bytes = sizeof(*this) + aliased_routes_.capacity() * sizeof(PerMethod) +
+                         routes_.capacity() * sizeof(const PerMethod*);
+    for (const auto& custom_method : method_map_.custom_methods) {
+        other_bytes += sizeof(custom_method) + GetHeapSize(custom_method);
     }
-#endif
+    for (const auto& aliases : method_map_.aliases) {
+        other_bytes += sizeof(aliases) + aliases.capacity() * sizeof(HttpMethod);
+    }
+    other_bytes += GetHashMapHeapSize(operations_);
+    for (const auto& operation : operations_) {
+        other_bytes += GetHeapSize(operation.first) + GetHeapSize(operation.second.second);
+    }
+    other_bytes += path_normalizer_.GetMemoryUsage();
+    if (route_cache_) {
+        other_bytes += route_cache_->GetMemoryUsage();
+    }
+    report.AddOther(other_bytes);
+
+    const auto& spec_refs = *validators_cache_.GetSpecRefs();
+    report.SetSpecRefs(spec_refs.GetCount(), spec_refs.GetMemoryUsage());
+    return report.ToJson();
 }
 
-ValidationError OASValidatorImp::GetValidators(const std::string& method, const std::string& http_path,
-                                               ValidatorsStore*& validators, std::string& error_msg,
-                                               std::unordered_map<size_t, ParamRange>* param_idxs, std::string* query)
+// Tries, filter and normalized routes of a routing table, with `route_map_bytes` of its maps
+void OASValidatorImp::AddRouting(const PerMethod& routes, size_t route_map_bytes, MemoryReport& report) const
 {
-    auto err_code = method_validator_.Validate(method, error_msg);
-    CHECK_ERROR(err_code)
+    size_t trie_nodes = routes.path_trie.GetNodeCount();
+    size_t trie_bytes = routes.path_trie.GetMemoryUsage();
+    route_map_bytes += routes.route_filter.GetMemoryUsage();
+    if (path_normalizer_.IsEnabled()) {
+        trie_nodes += routes.normalized_trie.GetNodeCount();
+        trie_bytes += routes.normalized_trie.GetMemoryUsage();
+        route_map_bytes += GetHashMapHeapSize(routes.folded_paths);
+        for (const auto& folded : routes.folded_paths) {
+            route_map_bytes += GetHeapSize(folded.first) + GetHeapSize(folded.second);
+        }
+    }
+    report.AddRouting(trie_nodes, trie_bytes, route_map_bytes);
+}
 
-    err_code = GetValidators(method, method, http_path, validators, error_msg, param_idxs, query);
-    if (ValidationError::INVALID_ROUTE == err_code) {
-        try {
-            auto mapped_methods = method_map_.at(method);
-            for (const auto& mapped_method : mapped_methods) {
-                err_code = GetValidators(method, mapped_method, http_path, validators, error_msg, param_idxs, query);
-                if (ValidationError::NONE == err_code) {
-                    return err_code;
-                }
-            }
-        } catch (const std::out_of_range&) {
-            return err_code;
+RouteCacheStats OASValidatorImp::GetRouteCacheStats() const
+{
+    return route_cache_ ? route_cache_->GetStats() : RouteCacheStats();
+}
+
+std::vector<ValidationOrderStats> OASValidatorImp::GetValidationOrderStats() const
+{
+    std::vector<ValidationOrderStats> routes;
+    for (size_t method_idx = 0; method_idx < oas_validators_.size(); ++method_idx) {
+        for (const auto& route : oas_validators_[method_idx].per_path_validators) {
+            routes.emplace_back();
+            routes.back().method = GetHttpMethodName(static_cast<HttpMethod>(method_idx));
+            routes.back().path_template = route.first;
+            route.second->GetCheckOrder().GetStats(routes.back());
         }
     }
+    std::sort(routes.begin(), routes.end(), [](const ValidationOrderStats& lhs, const ValidationOrderStats& rhs) {
+        return lhs.path_template != rhs.path_template ? lhs.path_template < rhs.path_template
+                                                      : lhs.method < rhs.method;
+    });
+    return routes;
+}
 
-    return err_code;
+std::vector<BodySamplingStats> OASValidatorImp::GetBodySamplingStats() const
+{
+    std::vector<BodySamplingStats> routes;
+    for (size_t method_idx = 0; method_idx < oas_validators_.size(); ++method_idx) {
+        for (const auto& route : oas_validators_[method_idx].per_path_validators) {
+            const auto* sampler = route.second->GetBodySampler();
+            if (!sampler) {
+                continue;
+            }
+            routes.emplace_back();
+            routes.back().method = GetHttpMethodName(static_cast<HttpMethod>(method_idx));
+            routes.back().path_template = route.first;
+            sampler->GetStats(routes.back());
+        }
+    }
+    std::sort(routes.begin(), routes.end(), [](const BodySamplingStats& lhs, const BodySamplingStats& rhs) {
+        return lhs.path_template != rhs.path_template ? lhs.path_template < rhs.path_template
+                                                      : lhs.method < rhs.method;
+    });
+    return routes;
 }
 
-ValidationError OASValidatorImp::GetValidators(const std::string& method, const std::string& mapped_method,
-                                               const std::string& http_path, ValidatorsStore*& validators,
-                                               std::string& error_msg,
-                                               std::unordered_map<size_t, ParamRange>* param_idxs, std::string* query)
+ValidationError OASValidatorImp::GetValidators(const std::string& method, const std::string& http_path,
+                                               const ValidatorsStore*& validators, std::string& error_msg,
+                                               std::unordered_map<size_t, ParamRange>* param_idxs,
+                                               std::string* query) const
 {
-    auto enum_method = kStringToMethod.at(mapped_method);
+    size_t slot;
+    auto err_code = GetRoutes(method, slot, error_msg);
+    CHECK_ERROR(err_code)
+    const PerMethod& routes = *routes_[slot];
 
     auto query_pos = http_path.find('?');
     if (std::string::npos != query_pos && query) {
         *query = http_path.substr(query_pos);
     }
 
-    try {
-        // 1st. try, no path params
-        validators = oas_validators_[static_cast<size_t>(enum_method)].per_path_validators.at(
-            std::string::npos == query_pos ? http_path : http_path.substr(0, query_pos));
-    } catch (const std::out_of_range&) {
+    const char* beg = http_path.c_str();
+    const char* const end = http_path.c_str() + (std::string::npos == query_pos ? http_path.length() : query_pos);
+    if (route_cache_ && route_cache_->Find(slot, beg, end, validators, param_idxs)) {
+        return ValidationError::NONE;
+    }
+
+    // The cache needs the path params even if the caller does not
+    std::unordered_map<size_t, ParamRange> route_params;
+    auto* found_params = param_idxs ? param_idxs : (route_cache_ ? &route_params : nullptr);
+    const char* route_beg;
+    const char* route_end;
+    bool found;
+    if (!path_normalizer_.IsEnabled()) {
+        found = FindRoute(routes, http_path, beg, end, validators, found_params);
+    } else if (path_normalizer_.GetCanonicalRange(beg, end, route_beg, route_end)) {
+        found = FindRoute(routes, http_path, route_beg, route_end, validators, found_params);
+        if (!found && path_normalizer_.IgnoresCase()) { // Literal segments not as written in the specification
+            if (found_params) {
+                found_params->clear();
+            }
+            NormalizedPath normalized;
+            found = path_normalizer_.Normalize(beg, end, normalized) &&
+                    FindNormalizedRoute(routes, normalized, validators, found_params);
+        }
+    } else {
+        NormalizedPath normalized;
+        found = path_normalizer_.Normalize(beg, end, normalized)
+                    ? FindNormalizedRoute(routes, normalized, validators, found_params)
+                    : FindRoute(routes, http_path, beg, end, validators, found_params);
+    }
+    if (!found) {
+        SetInvalidRoute(method, http_path, error_msg);
+        return ValidationError::INVALID_ROUTE;
+    }
+
+    if (route_cache_) {
+        route_cache_->Insert(slot, beg, end, validators, *found_params);
+    }
+    return ValidationError::NONE;
+}
+
+bool OASValidatorImp::FindRoute(const PerMethod& routes, const std::string& http_path, const char* beg,
+                                const char* end, const ValidatorsStore*& validators,
+                                std::unordered_map<size_t, ParamRange>* param_idxs)
+{
+    if (!routes.route_filter.MayMatch(beg, end)) { // Typically scanners probing for unknown paths
+        return false;
+    }
+
+    // 1st. try, no path params
+    const bool is_whole = http_path.c_str() == beg && http_path.c_str() + http_path.size() == end;
+    auto route_itr = routes.per_path_validators.find(is_whole ? http_path : std::string(beg, end));
+    if (route_itr == routes.per_path_validators.end()) {
         // 2nd try, if path has dynamic path parameters
         std::string map_key;
         map_key.reserve(http_path.length() + 32);
-        const char* beg = http_path.c_str();
-        const char* const end = http_path.c_str() + (std::string::npos == query_pos ? http_path.length() : query_pos);
-        bool found = param_idxs ? oas_validators_[static_cast<size_t>(enum_method)].path_trie.Search(beg, end, map_key,
-                                                                                                     *param_idxs)
-                                : oas_validators_[static_cast<size_t>(enum_method)].path_trie.Search(beg, end, map_key);
+        bool found = param_idxs ? routes.path_trie.Search(beg, end, map_key, *param_idxs)
+                                : routes.path_trie.Search(beg, end, map_key);
         if (found) {
-            try {
-                validators = oas_validators_[static_cast<size_t>(enum_method)].per_path_validators.at(map_key);
-            } catch (const std::out_of_range&) {
-                error_msg = R"({"errorCode":"INVALID_ROUTE","details":{"description": "Invalid HTTP method ')" +
-                            method + "' or path: '" + http_path + R"('"}})";
-                return ValidationError::INVALID_ROUTE;
+            route_itr = routes.per_path_validators.find(map_key);
+        }
+        if (route_itr == routes.per_path_validators.end()) {
+            return false;
+        }
+    }
+    validators = route_itr->second.get();
+    return true;
+}
+
+bool OASValidatorImp::FindNormalizedRoute(const PerMethod& routes, const NormalizedPath& path,
+                                          const ValidatorsStore*& validators,
+                                          std::unordered_map<size_t, ParamRange>* param_idxs)
+{
+    std::string map_key;
+    if (!routes.normalized_trie.Search(path, map_key, param_idxs)) {
+        return false;
+    }
+    if (!routes.folded_paths.empty()) {
+        auto folded_itr = routes.folded_paths.find(map_key);
+        if (folded_itr == routes.folded_paths.end()) {
+            return false;
+        }
+        map_key = folded_itr->second;
+    }
+    auto route_itr = routes.per_path_validators.find(map_key);
+    if (route_itr == routes.per_path_validators.end()) {
+        return false;
+    }
+    validators = route_itr->second.get();
+    return true;
+}
+
+// Methods of the specification are parsed, custom verbs of the method map are compared in turn
+ValidationError OASValidatorImp::GetRoutes(const std::string& method, size_t& slot, std::string& error_msg) const
+{
+    const auto enum_method = ParseHttpMethod(method);
+    if (HttpMethod::COUNT != enum_method) {
+        slot = static_cast<size_t>(enum_method);
+        return ValidationError::NONE;
+    }
+    for (size_t i = 0; i < method_map_.custom_methods.size(); ++i) {
+        const auto& custom_method = method_map_.custom_methods[i];
+        if (custom_method.size() == method.size() &&
+            std::equal(method.begin(), method.end(), custom_method.begin(),
+                       [](char c, char lower) { return ToLower(c) == lower; })) {
+            slot = static_cast<size_t>(HttpMethod::COUNT) + i;
+            return ValidationError::NONE;
+        }
+    }
+    return method_validator_.Validate(method, error_msg);
+}
+
+ValidationError OASValidatorImp::GetValidators(const RouteInfo* route, const ValidatorsStore*& validators,
+                                               std::string& error_msg)
+{
+    if (!route) {
+        error_msg = R"({"errorCode":"INVALID_ROUTE","details":{"description": "Invalid route handle"}})";
+        return ValidationError::INVALID_ROUTE;
+    }
+    validators = route->validators.get();
+    return ValidationError::NONE;
+}
+
+ValidationError OASValidatorImp::GetValidators(const RouteInfo* route, const std::string& http_path,
+                                               const ValidatorsStore*& validators, std::string& error_msg,
+                                               std::unordered_map<size_t, ParamRange>* param_idxs,
+                                               std::string* query) const
+{
+    auto err_code = GetValidators(route, validators, error_msg);
+    CHECK_ERROR(err_code)
+
+    auto query_pos = http_path.find('?');
+    if (std::string::npos != query_pos && query) {
+        *query = http_path.substr(query_pos);
+    }
+    const char* const end = http_path.c_str() + (std::string::npos == query_pos ? http_path.length() : query_pos);
+    if (param_idxs && !MatchPath(*route, http_path.c_str(), end, *param_idxs)) {
+        error_msg = R"({"errorCode":"INVALID_ROUTE","details":{"description": "Path ')" + http_path +
+                    "' does not match route '" + route->method + " " + route->path_template + R"('"}})";
+        return ValidationError::INVALID_ROUTE;
+    }
+    return ValidationError::NONE;
+}
+
+// Same fallbacks as GetValidators() routing a path
+bool OASValidatorImp::MatchPath(const RouteInfo& route, const char* beg, const char* end,
+                                std::unordered_map<size_t, ParamRange>& param_idxs) const
+{
+    const char* route_beg;
+    const char* route_end;
+    if (!path_normalizer_.IsEnabled()) {
+        return route.MatchPath(beg, end, param_idxs);
+    }
+    NormalizedPath normalized;
+    if (path_normalizer_.GetCanonicalRange(beg, end, route_beg, route_end)) {
+        if (route.MatchPath(route_beg, route_end, param_idxs)) {
+            return true;
+        }
+        if (!path_normalizer_.IgnoresCase()) {
+            return false;
+        }
+        param_idxs.clear(); // Literal segments not as written in the specification
+        return path_normalizer_.Normalize(beg, end, normalized) &&
+               route.MatchPath(normalized, path_normalizer_, param_idxs);
+    }
+    return path_normalizer_.Normalize(beg, end, normalized) ? route.MatchPath(normalized, path_normalizer_, param_idxs)
+                                                             : route.MatchPath(beg, end, param_idxs);
+}
+
+ValidationError OASValidatorImp::ValidateRawRequest(const RawRequest& request, const char* json_body,
+                                                    size_t body_length, std::string& error_msg) const
+{
+    RequestParts parts;
+    const ValidatorsStore* validators;
+
+    auto err_code = GetValidators(request.GetMethod(), request.GetPath(), validators, error_msg, &parts.param_idxs,
+                                  &parts.query);
+    CHECK_ERROR(err_code)
+
+    parts.has_headers = true;
+    parts.headers = request.GetHeaders();
+    parts.header_count = request.GetHeaderCount();
+    parts.json_body = json_body;
+    parts.body_length = body_length;
+    return ValidateParts(*validators, parts, error_msg);
+}
+
+ValidationError OASValidatorImp::ValidateParts(const ValidatorsStore& validators, RequestParts& parts,
+                                               std::string& error_msg) const
+{
+    constexpr size_t kChecks = CheckOrder::kChecks;
+    const bool given[kChecks] = {true, true, parts.has_headers, nullptr != parts.json_body};
+    RequestCheck order[kChecks] = {RequestCheck::PATH_PARAMS, RequestCheck::QUERY_PARAMS, RequestCheck::HEADERS,
+                                   RequestCheck::BODY};
+    if (ValidationOrder::ADAPTIVE == options_.validation_order) {
+        auto& check_order = validators.GetCheckOrder();
+        check_order.GetOrder(order);
+        if (check_order.Sample()) {
+            // Every component is validated and timed, the result is still the one of the first invalid component
+            auto result = ValidationError::NONE;
+            std::string later_error;
+            for (auto check : order) {
+                if (!given[static_cast<size_t>(check)]) {
+                    continue;
+                }
+                if (parts.deadline && HasExpired(*parts.deadline)) {
+                    if (ValidationError::NONE == result) {
+                        result = SetTimeout(error_msg);
+                    }
+                    break;
+                }
+                const auto start = std::chrono::steady_clock::now();
+                auto err_code =
+                    ValidatePart(validators, check, parts, ValidationError::NONE == result ? error_msg : later_error);
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                check_order.Record(check,
+                                   static_cast<uint64_t>(
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                                   ValidationError::NONE != err_code && ValidationError::TIMEOUT != err_code);
+                if (ValidationError::NONE == result) {
+                    result = err_code;
+                }
+            }
+            check_order.EndSample(options_.adaptive_order_samples);
+            return result;
+        }
+    }
+
+    for (auto check : order) {
+        if (given[static_cast<size_t>(check)]) {
+            if (parts.deadline && HasExpired(*parts.deadline)) {
+                return SetTimeout(error_msg);
             }
-        } else {
-            error_msg = R"({"errorCode":"INVALID_ROUTE","details":{"description": "Invalid HTTP method ')" + method +
-                        "' or path: '" + http_path + R"('"}})";
-            return ValidationError::INVALID_ROUTE;
+            auto err_code = ValidatePart(validators, check, parts, error_msg);
+            CHECK_ERROR(err_code)
         }
     }
     return ValidationError::NONE;
 }
 
+ValidationError OASValidatorImp::ValidatePart(const ValidatorsStore& validators, RequestCheck check,
+                                              RequestParts& parts, std::string& error_msg) const
+{
+    switch (check) {
+    case RequestCheck::PATH_PARAMS:
+        return validators.ValidatePathParams(parts.param_idxs, error_msg);
+    case RequestCheck::QUERY_PARAMS:
+        return validators.ValidateQueryParams(parts.query, error_msg);
+    case RequestCheck::HEADERS:
+        return parts.header_map ? validators.ValidateHeaderParams(*parts.header_map, error_msg)
+                                : validators.ValidateHeaderParams(parts.headers, parts.header_count, error_msg);
+    case RequestCheck::BODY:
+        return validators.ValidateBody(parts.json_body, parts.body_length, options_.body_parser, error_msg,
+                                       parts.deadline);
+    case RequestCheck::COUNT:
+    default:
+        return ValidationError::NONE;
+    }
+}
+
 std::vector<std::string> OASValidatorImp::Split(const std::string& str)
 {
     std::vector<std::string> tokens;
@@ -282,30 +939,80 @@ void OASValidatorImp::ParseSpecs(const std::string& oas_specs, rapidjson::Docume
     }
 }
 
+void OASValidatorImp::LoadSpecs(const std::string& oas_specs, const PerMethodValidators* reusable)
+{
+    CheckBodySamplings();
+    rapidjson::Document doc;
+    ParseSpecs(oas_specs, doc);
+    ResolveReferences(doc, doc, doc.GetAllocator());
+
+    path_normalizer_ = PathNormalizer(options_.path_normalization, GetBasePaths(doc));
+
+    const rapidjson::Value& paths = doc["paths"];
+    std::vector<std::string> ref_keys;
+    ref_keys.emplace_back("paths");
+
+    for (auto path_itr = paths.MemberBegin(); path_itr != paths.MemberEnd(); ++path_itr) {
+        ProcessPath(path_itr, ref_keys, reusable);
+    }
+    CheckRouteOptions();
+    live_spec_refs_ = CountLiveSpecRefs();
+}
+
 void OASValidatorImp::ProcessPath(const rapidjson::Value::ConstMemberIterator& path_itr,
-                                  std::vector<std::string>& ref_keys)
+                                  std::vector<std::string>& ref_keys, const PerMethodValidators* reusable)
 {
     std::string path(path_itr->name.GetString());
     ref_keys.emplace_back(EscapeSlash(path));
     const rapidjson::Value& methods = path_itr->value;
 
     for (auto method_itr = methods.MemberBegin(); method_itr != methods.MemberEnd(); ++method_itr) {
-        ProcessMethod(method_itr, path, ref_keys);
+        ProcessMethod(method_itr, path, ref_keys, reusable);
     }
 
     ref_keys.pop_back(); // Pop the path key
 }
 
 void OASValidatorImp::ProcessMethod(const rapidjson::Value::ConstMemberIterator& method_itr, const std::string& path,
-                                    std::vector<std::string>& ref_keys)
+                                    std::vector<std::string>& ref_keys, const PerMethodValidators* reusable)
 {
+    const auto enum_method = ParseHttpMethod(method_itr->name.GetString(), method_itr->name.GetStringLength());
+    if (HttpMethod::COUNT == enum_method) { // Other path item fields, e.g. "summary" or "servers"
+        return;
+    }
     ref_keys.emplace_back(method_itr->name.GetString());
-    auto method(kStringToMethod.at(method_itr->name.GetString()));
-    auto& per_method_validator = oas_validators_[static_cast<size_t>(method)];
-    auto& per_path_validator = per_method_validator.per_path_validators;
+    auto method_idx(static_cast<size_t>(enum_method));
+    auto& per_method_validator = oas_validators_[method_idx];
+
+    // References are already inlined, so the digest also covers every component used by the operation
+    auto digest = GetDigest(method_itr->value);
+    std::shared_ptr<const ValidatorsStore> validators;
+    if (reusable) {
+        const auto& loaded = (*reusable)[method_idx];
+        auto digest_itr = loaded.per_path_digests.find(path);
+        if (digest_itr != loaded.per_path_digests.end() && digest_itr->second.digest == digest.digest &&
+            digest_itr->second.serialized == digest.serialized) {
+            validators = loaded.per_path_validators.at(path);
+        }
+    }
 
-    ProcessRequestBody(method_itr, path, ref_keys, per_path_validator);
-    ProcessParameters(method_itr, path, ref_keys, per_path_validator);
+    if (!validators) {
+        auto new_validators = ProcessRequestBody(method_itr, ref_keys, GetBodyLimits(enum_method, path),
+                                                 GetBodySampling(enum_method, path));
+        ProcessParameters(method_itr, path, ref_keys, *new_validators);
+        validators = std::move(new_validators);
+    }
+    per_method_validator.per_path_validators.emplace(path, std::move(validators));
+    per_method_validator.per_path_digests.emplace(path, std::move(digest));
+
+    auto operation_itr = method_itr->value.FindMember("operationId");
+    if (operation_itr != method_itr->value.MemberEnd() && operation_itr->value.IsString()) {
+        std::string operation_id(operation_itr->value.GetString(), operation_itr->value.GetStringLength());
+        if (!operations_.emplace(operation_id, std::make_pair(enum_method, path)).second) {
+            throw ValidatorInitExc("Duplicate operationId '" + operation_id + "'");
+        }
+        per_method_validator.per_path_operation_ids.emplace(path, std::move(operation_id));
+    }
 
     if (std::string::npos != path.find('{') && std::string::npos != path.find('}')) { // has path params
         per_method_validator.path_trie.Insert(path);
@@ -314,31 +1021,129 @@ void OASValidatorImp::ProcessMethod(const rapidjson::Value::ConstMemberIterator&
     ref_keys.pop_back(); // Pop the method key
 }
 
-void OASValidatorImp::ProcessRequestBody(const rapidjson::Value::ConstMemberIterator& method_itr,
-                                         const std::string& path, std::vector<std::string>& ref_keys,
-                                         std::unordered_map<std::string, ValidatorsStore*>& per_path_validator)
+OASValidatorImp::OperationDigest OASValidatorImp::GetDigest(const rapidjson::Value& value)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return {HashBytes(buffer.GetString(), buffer.GetString() + buffer.GetSize()),
+            std::string(buffer.GetString(), buffer.GetSize())};
+}
+
+size_t OASValidatorImp::CountLiveSpecRefs() const
+{
+    std::vector<SpecRefTable::Id> ids;
+    for (const auto& per_method : oas_validators_) {
+        for (const auto& route : per_method.per_path_validators) {
+            route.second->AppendSpecRefs(ids);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return static_cast<size_t>(std::unique(ids.begin(), ids.end()) - ids.begin());
+}
+
+std::shared_ptr<ValidatorsStore>
+OASValidatorImp::ProcessRequestBody(const rapidjson::Value::ConstMemberIterator& method_itr,
+                                    std::vector<std::string>& ref_keys, const BodyLimits& limits,
+                                    const BodySampling& sampling)
 {
     if ((method_itr->value.HasMember("requestBody")) && (method_itr->value["requestBody"].HasMember("content")) &&
         (method_itr->value["requestBody"]["content"].HasMember("application/json")) &&
         (method_itr->value["requestBody"]["content"]["application/json"].HasMember(
             "schema"))) { //  if "method+path" has json body
         ref_keys.emplace_back("requestBody/content/application%2Fjson/schema");
-        per_path_validator.emplace(
-            path,
-            new ValidatorsStore(method_itr->value["requestBody"]["content"]["application/json"]["schema"], ref_keys));
+        auto validators = std::make_shared<ValidatorsStore>(
+            method_itr->value["requestBody"]["content"]["application/json"]["schema"], ref_keys, limits,
+            sampling, &validators_cache_);
         ref_keys.pop_back(); // pop body ref
-    } else { // Otherwise validators without body
-        per_path_validator.emplace(path, new ValidatorsStore());
+        return validators;
+    }
+    return std::make_shared<ValidatorsStore>(); // Otherwise validators without body
+}
+
+const BodyLimits& OASValidatorImp::GetBodyLimits(HttpMethod method, const std::string& path) const
+{
+    for (const auto& route : options_.route_body_limits) {
+        if (method == ParseHttpMethod(route.method) && path == route.path_template) {
+            return route.limits;
+        }
+    }
+    return options_.body_limits;
+}
+
+const BodySampling& OASValidatorImp::GetBodySampling(HttpMethod method, const std::string& path) const
+{
+    for (const auto& route : options_.route_body_sampling) {
+        if (method == ParseHttpMethod(route.method) && path == route.path_template) {
+            return route.sampling;
+        }
+    }
+    return options_.body_sampling;
+}
+
+bool OASValidatorImp::HasRoute(const std::string& method, const std::string& path) const
+{
+    const auto enum_method = ParseHttpMethod(method);
+    return HttpMethod::COUNT != enum_method &&
+           oas_validators_[static_cast<size_t>(enum_method)].per_path_validators.count(path);
+}
+
+void OASValidatorImp::CheckRouteOptions() const
+{
+    for (const auto& route : options_.route_body_limits) {
+        if (!HasRoute(route.method, route.path_template)) {
+            throw ValidatorInitExc("Body limits of unknown route '" + route.method + " " + route.path_template + "'");
+        }
+    }
+    for (const auto& route : options_.route_body_sampling) {
+        if (!HasRoute(route.method, route.path_template)) {
+            throw ValidatorInitExc("Body sampling of unknown route '" + route.method + " " + route.path_template +
+                                   "'");
+        }
+    }
+}
+
+void OASValidatorImp::CheckBodySamplings() const
+{
+    CheckBodySampling(options_.body_sampling, "Body sampling");
+    for (const auto& route : options_.route_body_sampling) {
+        CheckBodySampling(route.sampling,
+                          "Body sampling of route '" + route.method + " " + route.path_template + "'");
+    }
+}
+
+void OASValidatorImp::CheckBodySampling(const BodySampling& sampling, const std::string& context)
+{
+    switch (sampling.mode) {
+    case BodySamplingMode::ALL:
+        break;
+    case BodySamplingMode::FIXED_RATE:
+        if (!(sampling.rate >= 0 && sampling.rate <= 1)) {
+            throw ValidatorInitExc(context + ": rate must be from 0 to 1");
+        }
+        break;
+    case BodySamplingMode::TOKEN_BUCKET:
+        if (!(sampling.bodies_per_second > 0) || !(sampling.burst >= 1)) {
+            throw ValidatorInitExc(context + ": bodies_per_second must be positive and burst at least 1");
+        }
+        break;
+    case BodySamplingMode::CPU_BUDGET:
+        if (0 == sampling.budget_ns_per_second) {
+            throw ValidatorInitExc(context + ": budget_ns_per_second must be positive");
+        }
+        break;
+    default:
+        throw ValidatorInitExc(context + ": unknown mode");
     }
 }
 
 void OASValidatorImp::ProcessParameters(const rapidjson::Value::ConstMemberIterator& method_itr,
                                         const std::string& path, std::vector<std::string>& ref_keys,
-                                        std::unordered_map<std::string, ValidatorsStore*>& per_path_validator)
+                                        ValidatorsStore& validators)
 {
     if (method_itr->value.HasMember("parameters")) { //  if "method+path" has parameters
         ref_keys.emplace_back("parameters");
-        per_path_validator.at(path)->AddParamValidators(path, method_itr->value["parameters"], ref_keys);
+        validators.AddParamValidators(path, method_itr->value["parameters"], ref_keys, &validators_cache_);
         ref_keys.pop_back();
     }
 }
@@ -375,28 +1180,202 @@ void OASValidatorImp::ResolveReferences(rapidjson::Value& value, rapidjson::Docu
     }
 }
 
-std::unordered_map<std::string, std::unordered_set<std::string>> OASValidatorImp::BuildCaseInsensitiveMap(
-    const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map)
+OASValidatorImp::MethodMap
+OASValidatorImp::BuildMethodMap(const std::unordered_map<std::string, std::unordered_set<std::string>>& method_map)
+{
+    MethodMap mapped_methods;
+    mapped_methods.aliases.resize(static_cast<size_t>(HttpMethod::COUNT));
+    for (const auto& entry : method_map) {
+        const auto method = ParseHttpMethod(entry.first);
+        size_t slot = static_cast<size_t>(method);
+        if (HttpMethod::COUNT == method) {
+            std::string custom_method(entry.first);
+            std::transform(custom_method.begin(), custom_method.end(), custom_method.begin(), ToLower);
+            auto custom_itr =
+                std::find(mapped_methods.custom_methods.begin(), mapped_methods.custom_methods.end(), custom_method);
+            slot = static_cast<size_t>(HttpMethod::COUNT) +
+                   static_cast<size_t>(custom_itr - mapped_methods.custom_methods.begin());
+            if (custom_itr == mapped_methods.custom_methods.end()) {
+                mapped_methods.custom_methods.push_back(std::move(custom_method));
+                mapped_methods.aliases.emplace_back();
+            }
+        }
+        auto& aliases = mapped_methods.aliases[slot];
+        for (const auto& mapped_name : entry.second) {
+            const auto mapped_method = ParseHttpMethod(mapped_name);
+            if (HttpMethod::COUNT != mapped_method && mapped_method != method &&
+                std::find(aliases.begin(), aliases.end(), mapped_method) == aliases.end()) {
+                aliases.push_back(mapped_method);
+            }
+        }
+    }
+    return mapped_methods;
+}
+
+// A route of an alias is taken when the slot has no route of its own for the path. A static path of an alias is left
+// out when an earlier templated path matches it, as it would never be reached trying the methods in turn. Templated
+// paths of different methods overlapping each other are matched as within one method.
+void OASValidatorImp::ResolveAliases()
 {
+    const auto& aliases = method_map_.aliases;
+    size_t aliased_count = 0;
+    for (size_t slot = 0; slot < aliases.size(); ++slot) {
+        if (!aliases[slot].empty() || slot >= oas_validators_.size()) {
+            ++aliased_count;
+        }
+    }
+    aliased_routes_.reserve(aliased_count); // Pointed to by routes_
+
+    routes_.assign(aliases.size(), nullptr);
+    for (size_t slot = 0; slot < aliases.size(); ++slot) {
+        const bool is_custom = slot >= oas_validators_.size();
+        if (aliases[slot].empty() && !is_custom) {
+            routes_[slot] = &oas_validators_[slot];
+            continue;
+        }
+        aliased_routes_.emplace_back();
+        auto& merged = aliased_routes_.back();
+        if (!is_custom) {
+            merged.per_path_validators = oas_validators_[slot].per_path_validators;
+            merged.per_path_operation_ids = oas_validators_[slot].per_path_operation_ids;
+            merged.path_trie = oas_validators_[slot].path_trie;
+        }
+        std::string map_key;
+        for (auto alias : aliases[slot]) {
+            const auto& alias_method = oas_validators_[static_cast<size_t>(alias)];
+            const auto& alias_routes = alias_method.per_path_validators;
+            std::vector<const std::string*> templated_paths;
+            for (const auto& route : alias_routes) {
+                const auto& path = route.first;
+                if (std::string::npos != path.find('{') && std::string::npos != path.find('}')) {
+                    templated_paths.push_back(&path);
+                } else if (!merged.path_trie.Search(path.c_str(), path.c_str() + path.size(), map_key) &&
+                           merged.per_path_validators.emplace(path, route.second).second) {
+                    CopyOperationId(alias_method, path, merged);
+                }
+            }
+            for (const auto* path : templated_paths) {
+                if (merged.per_path_validators.emplace(*path, alias_routes.at(*path)).second) {
+                    merged.path_trie.Insert(*path);
+                    CopyOperationId(alias_method, *path, merged);
+                }
+            }
+        }
+        routes_[slot] = &merged;
+    }
 
-    std::unordered_map<std::string, std::unordered_set<std::string>> case_insensitive_map;
+    for (auto& per_method : oas_validators_) {
+        BuildRouteFilter(per_method);
+        BuildNormalizedRoutes(per_method);
+    }
+    for (auto& merged : aliased_routes_) {
+        BuildRouteFilter(merged);
+        BuildNormalizedRoutes(merged);
+    }
+}
 
-    for (const auto& entry : method_map) {
-        std::string lower_key(entry.first);
-        std::transform(lower_key.begin(), lower_key.end(), lower_key.begin(), ::tolower);
-        std::string upper_key(entry.first);
-        std::transform(upper_key.begin(), upper_key.end(), upper_key.begin(), ::toupper);
-        case_insensitive_map[lower_key] = entry.second;
-        case_insensitive_map[upper_key] = entry.second;
+void OASValidatorImp::BuildRouteFilter(PerMethod& routes)
+{
+    std::vector<std::string> paths;
+    paths.reserve(routes.per_path_validators.size());
+    for (const auto& route : routes.per_path_validators) {
+        paths.push_back(route.first);
     }
+    routes.route_filter.Build(paths);
+}
 
-    return case_insensitive_map;
+// Paths differing only by case are ambiguous when ignoring case
+void OASValidatorImp::BuildNormalizedRoutes(PerMethod& routes) const
+{
+    if (!path_normalizer_.IsEnabled()) {
+        return;
+    }
+    for (const auto& route : routes.per_path_validators) {
+        const auto key = path_normalizer_.GetKey(route.first);
+        routes.normalized_trie.Insert(key);
+        if (!path_normalizer_.IgnoresCase()) {
+            continue;
+        }
+        auto folded = routes.folded_paths.emplace(key, route.first);
+        if (!folded.second) {
+            throw ValidatorInitExc("Paths '" + folded.first->second + "' and '" + route.first +
+                                   "' differ only by case, they cannot be matched case-insensitively");
+        }
+    }
 }
 
-const std::unordered_map<std::string, HttpMethod> OASValidatorImp::kStringToMethod = {
-    {"GET", HttpMethod::GET},       {"POST", HttpMethod::POST},       {"PUT", HttpMethod::PUT},
-    {"DELETE", HttpMethod::DELETE}, {"HEAD", HttpMethod::HEAD},       {"OPTIONS", HttpMethod::OPTIONS},
-    {"PATCH", HttpMethod::PATCH},   {"CONNECT", HttpMethod::CONNECT}, {"TRACE", HttpMethod::TRACE},
-    {"get", HttpMethod::GET},       {"post", HttpMethod::POST},       {"put", HttpMethod::PUT},
-    {"delete", HttpMethod::DELETE}, {"head", HttpMethod::HEAD},       {"options", HttpMethod::OPTIONS},
-    {"patch", HttpMethod::PATCH},   {"connect", HttpMethod::CONNECT}, {"trace", HttpMethod::TRACE}};
+std::vector<std::string> OASValidatorImp::GetBasePaths(const rapidjson::Value& doc)
+{
+    std::vector<std::string> base_paths;
+    auto servers_itr = doc.FindMember("servers");
+    if (servers_itr == doc.MemberEnd() || !servers_itr->value.IsArray()) {
+        return base_paths;
+    }
+    for (const auto& server : servers_itr->value.GetArray()) {
+        auto url_itr = server.IsObject() ? server.FindMember("url") : server.MemberEnd();
+        if (!server.IsObject() || url_itr == server.MemberEnd() || !url_itr->value.IsString()) {
+            continue;
+        }
+        std::string url(url_itr->value.GetString(), url_itr->value.GetStringLength());
+
+        // Server variables take their default values
+        auto variables_itr = server.FindMember("variables");
+        for (size_t open = url.find('{'); std::string::npos != open; open = url.find('{', open)) {
+            const size_t close = url.find('}', open);
+            if (std::string::npos == close) {
+                break;
+            }
+            const std::string name(url, open + 1, close - open - 1);
+            std::string value;
+            if (variables_itr != server.MemberEnd() && variables_itr->value.IsObject()) {
+                auto variable_itr = variables_itr->value.FindMember(name.c_str());
+                if (variable_itr != variables_itr->value.MemberEnd() && variable_itr->value.IsObject() &&
+                    variable_itr->value.HasMember("default") && variable_itr->value["default"].IsString()) {
+                    value = variable_itr->value["default"].GetString();
+                }
+            }
+            url.replace(open, close - open + 1, value);
+            open += value.size();
+        }
+
+        // Path of absolute URLs follows the authority
+        size_t path_pos = 0;
+        const size_t scheme_pos = url.find("://");
+        if (std::string::npos != scheme_pos) {
+            path_pos = url.find('/', scheme_pos + 3);
+        }
+        if (std::string::npos == path_pos || '/' != url[path_pos]) {
+            continue;
+        }
+        std::string path = url.substr(path_pos, url.find_first_of("?#", path_pos) - path_pos);
+        while (!path.empty() && '/' == path.back()) {
+            path.pop_back();
+        }
+        if (!path.empty()) {
+            base_paths.push_back(std::move(path));
+        }
+    }
+    return base_paths;
+}
+
+// Appended to the caller's buffer, which usually has the capacity already
+void OASValidatorImp::SetInvalidRoute(const std::string& method, const std::string& http_path, std::string& error_msg)
+{
+    error_msg.assign(R"({"errorCode":"INVALID_ROUTE","details":{"description": "Invalid HTTP method ')");
+    error_msg.append(method).append("' or path: '").append(http_path).append(R"('"}})");
+}
+
+ValidationError OASValidatorImp::SetTimeout(std::string& error_msg)
+{
+    error_msg.assign(
+        R"({"errorCode":"TIMEOUT","details":{"description":"Request validation stopped at its deadline"}})");
+    return ValidationError::TIMEOUT;
+}
+
+void OASValidatorImp::CopyOperationId(const PerMethod& from, const std::string& path, PerMethod& to)
+{
+    auto operation_itr = from.per_path_operation_ids.find(path);
+    if (operation_itr != from.per_path_operation_ids.end()) {
+        to.per_path_operation_ids.emplace(path, operation_itr->second);
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+
+#include "shadow_validator_imp.hpp"
+
+#include <utility>
+
+ShadowValidator::ShadowValidator(const OASValidator& validator, const ShadowOptions& options,
+                                 FailureCallback on_failure)
+    : impl_(new ShadowValidatorImp(validator.impl_, options, std::move(on_failure)))
+{
+}
+
+bool ShadowValidator::Enqueue(const std::string& method, const std::string& http_path, const std::string& json_body,
+                              const HeaderField* headers, size_t header_count)
+{
+    return impl_->Enqueue(method, http_path, &json_body, headers, header_count);
+}
+
+bool ShadowValidator::Enqueue(const std::string& method, const std::string& http_path, const HeaderField* headers,
+                              size_t header_count)
+{
+    return impl_->Enqueue(method, http_path, nullptr, headers, header_count);
+}
+
+bool ShadowValidator::Enqueue(ShadowRequest&& request)
+{
+    return impl_->Enqueue(std::move(request));
+}
+
+void ShadowValidator::Flush()
+{
+    impl_->Flush();
+}
+
+ShadowStats ShadowValidator::GetStats() const
+{
+    return impl_->GetStats();
+}
+
+ShadowValidator::~ShadowValidator() = default;
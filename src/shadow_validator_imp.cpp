@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "shadow_validator_imp.hpp"
+
+#include <chrono>
+#include <utility>
+
+namespace {
+// An idle worker yields a few times, then polls its queue at this interval
+const uint32_t kIdleSpins = 64;
+const auto kIdleSleep = std::chrono::microseconds(200);
+} // namespace
+
+ShadowValidatorImp::ShadowValidatorImp(std::shared_ptr<const OASValidatorImp> validator, const ShadowOptions& options,
+                                       ShadowCallback on_failure)
+    : validator_(std::move(validator))
+    , on_failure_(std::move(on_failure))
+{
+    if (0 == options.threads || 0 == options.queue_capacity) {
+        throw ValidatorInitExc("Shadow validation needs at least one thread and a queue capacity");
+    }
+    for (size_t idx = 0; idx < options.threads; ++idx) {
+        workers_.emplace_back(new Worker(options.queue_capacity));
+    }
+    try {
+        for (auto& worker : workers_) {
+            worker->thread = std::thread(&ShadowValidatorImp::Run, this, std::ref(*worker));
+        }
+    } catch (...) {
+        Stop();
+        throw;
+    }
+}
+
+bool ShadowValidatorImp::Enqueue(const std::string& method, const std::string& http_path,
+                                 const std::string* json_body, const HeaderField* headers, size_t header_count)
+{
+    return PickQueue().Push([&](ShadowRequest& slot) {
+        slot.method.assign(method);
+        slot.http_path.assign(http_path);
+        if (json_body) {
+            slot.json_body.assign(*json_body);
+        }
+        slot.has_body = nullptr != json_body;
+        slot.headers.resize(header_count);
+        for (size_t idx = 0; idx < header_count; ++idx) {
+            slot.headers[idx].first.assign(headers[idx].name, headers[idx].name_length);
+            slot.headers[idx].second.assign(headers[idx].value, headers[idx].value_length);
+        }
+    });
+}
+
+bool ShadowValidatorImp::Enqueue(ShadowRequest&& request)
+{
+    return PickQueue().Push([&request](ShadowRequest& slot) { std::swap(slot, request); });
+}
+
+void ShadowValidatorImp::Flush() const
+{
+    for (const auto& worker : workers_) {
+        const size_t pushed = worker->queue.GetPushed();
+        while (worker->queue.GetPopped() < pushed) {
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+}
+
+ShadowStats ShadowValidatorImp::GetStats() const
+{
+    ShadowStats stats;
+    for (const auto& worker : workers_) {
+        stats.enqueued += worker->queue.GetPushed();
+        stats.dropped += worker->queue.GetDropped();
+        stats.validated += worker->validated.load(std::memory_order_relaxed);
+        stats.failed += worker->failed.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+ShadowValidatorImp::~ShadowValidatorImp()
+{
+    Stop();
+}
+
+ShadowQueue& ShadowValidatorImp::PickQueue()
+{
+    // Round robin per thread, from a different queue for each thread
+    thread_local size_t next = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return workers_[next++ % workers_.size()]->queue;
+}
+
+void ShadowValidatorImp::Run(Worker& worker)
+{
+    std::vector<HeaderField> fields;
+    std::string error_msg;
+    auto validate = [&](const ShadowRequest& request) { Validate(worker, request, fields, error_msg); };
+    uint32_t idle = 0;
+    for (;;) {
+        if (worker.queue.Pop(validate)) {
+            idle = 0;
+        } else if (stopping_.load(std::memory_order_acquire)) {
+            while (worker.queue.Pop(validate)) {
+            }
+            return;
+        } else if (++idle < kIdleSpins) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+}
+
+void ShadowValidatorImp::Validate(Worker& worker, const ShadowRequest& request, std::vector<HeaderField>& fields,
+                                  std::string& error_msg) const
+{
+    fields.clear();
+    for (const auto& header : request.headers) {
+        fields.emplace_back(header.first.data(), header.first.size(), header.second.data(), header.second.size());
+    }
+    const auto err_code =
+        request.has_body
+            ? validator_->ValidateRequest(request.method, request.http_path, request.json_body, fields.data(),
+                                          fields.size(), error_msg)
+            : validator_->ValidateRequest(request.method, request.http_path, fields.data(), fields.size(), error_msg);
+    if (ValidationError::NONE != err_code) {
+        worker.failed.fetch_add(1, std::memory_order_relaxed);
+        if (on_failure_) {
+            on_failure_(request, err_code, error_msg);
+        }
+    }
+    worker.validated.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ShadowValidatorImp::Stop()
+{
+    stopping_.store(true, std::memory_order_release);
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
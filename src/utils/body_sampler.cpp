@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/body_sampler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+namespace {
+uint64_t SplitMix(uint64_t seed)
+{
+    seed += 0x9E3779B97F4A7C15ULL;
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+    return seed ^ (seed >> 31);
+}
+
+// xorshift64*, upper 32 bits
+uint64_t Draw()
+{
+    thread_local uint64_t state = SplitMix(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (state * 0x2545F4914F6CDD1DULL) >> 32;
+}
+} // namespace
+
+BodySampler::BodySampler(const BodySampling& sampling)
+    : mode_(sampling.mode)
+{
+    switch (mode_) {
+    case BodySamplingMode::FIXED_RATE:
+        threshold_ = static_cast<uint64_t>(std::ldexp(std::min(std::max(sampling.rate, 0.0), 1.0), 32));
+        break;
+    case BodySamplingMode::TOKEN_BUCKET:
+        interval_ = std::max<int64_t>(static_cast<int64_t>(1e9 / sampling.bodies_per_second), 1);
+        tolerance_ = static_cast<int64_t>(std::max(sampling.burst, 1.0) * static_cast<double>(interval_));
+        break;
+    case BodySamplingMode::CPU_BUDGET:
+        weight_ = 1e9 / static_cast<double>(sampling.budget_ns_per_second);
+        tolerance_ = kBudgetWindow;
+        break;
+    case BodySamplingMode::ALL:
+    default:
+        break;
+    }
+}
+
+BodySamplingMode BodySampler::GetMode() const
+{
+    return mode_;
+}
+
+bool BodySampler::Sample()
+{
+    if (BodySamplingMode::ALL == mode_) {
+        return true;
+    }
+    if (Skip()) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool BodySampler::Skip()
+{
+    switch (mode_) {
+    case BodySamplingMode::FIXED_RATE:
+        return Draw() >= threshold_;
+    case BodySamplingMode::TOKEN_BUCKET: {
+        const int64_t now = Now();
+        int64_t horizon = horizon_.load(std::memory_order_relaxed);
+        int64_t next;
+        do {
+            next = std::max(horizon, now) + interval_;
+            if (next - now > tolerance_) {
+                return true;
+            }
+        } while (!horizon_.compare_exchange_weak(horizon, next, std::memory_order_relaxed));
+        return false;
+    }
+    case BodySamplingMode::CPU_BUDGET:
+        return horizon_.load(std::memory_order_relaxed) - Now() > tolerance_;
+    case BodySamplingMode::ALL:
+    default:
+        return false;
+    }
+}
+
+void BodySampler::Record(uint64_t nanoseconds)
+{
+    checked_.fetch_add(1, std::memory_order_relaxed);
+    nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (BodySamplingMode::CPU_BUDGET == mode_) {
+        const auto cost = static_cast<int64_t>(static_cast<double>(nanoseconds) * weight_);
+        const int64_t now = Now();
+        int64_t horizon = horizon_.load(std::memory_order_relaxed);
+        while (!horizon_.compare_exchange_weak(horizon, std::max(horizon, now) + cost, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+void BodySampler::GetStats(BodySamplingStats& stats) const
+{
+    stats.mode = mode_;
+    stats.checked = checked_.load(std::memory_order_relaxed);
+    stats.skipped = skipped_.load(std::memory_order_relaxed);
+    stats.nanoseconds = nanoseconds_.load(std::memory_order_relaxed);
+}
+
+int64_t BodySampler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
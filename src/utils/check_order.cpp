@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/check_order.hpp"
+
+#include <algorithm>
+
+namespace {
+thread_local uint32_t sample_tick = 0;
+} // namespace
+
+void CheckOrder::GetOrder(RequestCheck (&order)[kChecks]) const
+{
+    const uint32_t packed = order_.load(std::memory_order_acquire);
+    for (size_t rank = 0; rank < kChecks; ++rank) {
+        order[rank] = static_cast<RequestCheck>((packed >> (8 * rank)) & 0xFF);
+    }
+}
+
+bool CheckOrder::Sample() const
+{
+    return 0 == ++sample_tick % kSampleInterval && !learned_.load(std::memory_order_relaxed);
+}
+
+void CheckOrder::Record(RequestCheck check, uint64_t nanoseconds, bool failed)
+{
+    auto& counters = counters_[static_cast<size_t>(check)];
+    counters.runs.fetch_add(1, std::memory_order_relaxed);
+    counters.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (failed) {
+        counters.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CheckOrder::EndSample(uint64_t samples)
+{
+    if (samples_.fetch_add(1, std::memory_order_relaxed) + 1 == std::max<uint64_t>(samples, 1)) {
+        Learn();
+    }
+}
+
+void CheckOrder::GetStats(ValidationOrderStats& stats) const
+{
+    stats.learned = learned_.load(std::memory_order_acquire);
+    stats.samples = samples_.load(std::memory_order_relaxed);
+    RequestCheck order[kChecks];
+    GetOrder(order);
+    std::copy(order, order + kChecks, stats.order.begin());
+    for (size_t idx = 0; idx < kChecks; ++idx) {
+        stats.checks[idx].runs = counters_[idx].runs.load(std::memory_order_relaxed);
+        stats.checks[idx].failures = counters_[idx].failures.load(std::memory_order_relaxed);
+        stats.checks[idx].nanoseconds = counters_[idx].nanoseconds.load(std::memory_order_relaxed);
+    }
+}
+
+void CheckOrder::Learn()
+{
+    // Components that failed by time per failure, then those that never did by time per run, then those never
+    // validated. Ties keep the cheap first order, so that the same counters always give the same order.
+    struct Rank
+    {
+        int group;
+        double cost;
+    };
+    Rank ranks[kChecks];
+    for (size_t idx = 0; idx < kChecks; ++idx) {
+        const auto runs = counters_[idx].runs.load(std::memory_order_relaxed);
+        const auto failures = counters_[idx].failures.load(std::memory_order_relaxed);
+        const auto nanoseconds = static_cast<double>(counters_[idx].nanoseconds.load(std::memory_order_relaxed));
+        if (0 == runs) {
+            ranks[idx] = {2, 0};
+        } else if (0 == failures) {
+            ranks[idx] = {1, nanoseconds / static_cast<double>(runs)};
+        } else {
+            ranks[idx] = {0, nanoseconds / static_cast<double>(failures)};
+        }
+    }
+
+    uint32_t order[kChecks] = {0, 1, 2, 3};
+    std::stable_sort(order, order + kChecks, [&ranks](uint32_t lhs, uint32_t rhs) {
+        return ranks[lhs].group != ranks[rhs].group ? ranks[lhs].group < ranks[rhs].group
+                                                    : ranks[lhs].cost < ranks[rhs].cost;
+    });
+    uint32_t packed = 0;
+    for (size_t rank = 0; rank < kChecks; ++rank) {
+        packed |= order[rank] << (8 * rank);
+    }
+    order_.store(packed, std::memory_order_release);
+    learned_.store(true, std::memory_order_release);
+}
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/json_index.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+inline bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool IsValueEnd(char c)
+{
+    switch (c) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+    case '"':
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Bit i is set when an odd number of quotes precede or are at position i
+inline uint64_t PrefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Characters preceded by an odd run of backslashes, found by adding the runs that start on odd positions to the
+// backslashes so that the carry flips the parity at their ends. `carry` is 1 when the next block starts escaped.
+inline uint64_t FindEscaped(uint64_t backslash, uint64_t& carry)
+{
+    constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+    backslash &= ~carry;
+    const uint64_t follows_escape = (backslash << 1) | carry;
+    const uint64_t odd_starts = backslash & ~kEvenBits & ~follows_escape;
+    uint64_t even_runs;
+    carry = __builtin_add_overflow(odd_starts, backslash, &even_runs) ? 1 : 0;
+    return (kEvenBits ^ (even_runs << 1)) & follows_escape;
+}
+
+void EncodeUtf8(unsigned codepoint, std::string& out)
+{
+    if (codepoint < 0x80) {
+        out.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+}
+} // namespace
+
+bool JsonIndexReader::HasParseError() const
+{
+    return rapidjson::kParseErrorNone != error_code_;
+}
+
+rapidjson::ParseErrorCode JsonIndexReader::GetParseErrorCode() const
+{
+    return error_code_;
+}
+
+size_t JsonIndexReader::GetErrorOffset() const
+{
+    return error_offset_;
+}
+
+bool JsonIndexReader::IndexChunk()
+{
+    next_token_ = 0;
+    token_count_ = 0;
+    JsonBlockMasks masks[kChunkBlocks];
+    while (0 == token_count_) { // A chunk inside a long string has none
+        if (length_ == indexed_) {
+            if (0 != in_string_carry_) {
+                return Fail(rapidjson::kParseErrorStringMissQuotationMark, length_);
+            }
+            tokens_[0] = static_cast<uint32_t>(length_);
+            token_count_ = 1;
+            return true;
+        }
+
+        const size_t chunk = indexed_;
+        const size_t chunk_length = std::min(length_ - chunk, kChunkBlocks * kJsonBlockSize);
+        size_t block_count = chunk_length / kJsonBlockSize;
+        ClassifyJsonBlocks(json_ + chunk, block_count, masks);
+        if (0 != chunk_length % kJsonBlockSize) { // The last block is padded with whitespace
+            char tail[kJsonBlockSize];
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, json_ + chunk + block_count * kJsonBlockSize, chunk_length % kJsonBlockSize);
+            ClassifyJsonBlocks(tail, 1, masks + block_count);
+            ++block_count;
+        }
+
+        uint32_t* out = tokens_.data();
+        uint64_t non_ascii = 0;
+        for (size_t i = 0; i < block_count; ++i) {
+            const JsonBlockMasks& block = masks[i];
+            const auto base = static_cast<uint32_t>(chunk + i * kJsonBlockSize);
+            const uint64_t quote = block.quote & ~FindEscaped(block.backslash, escaped_carry_);
+            const uint64_t in_string = PrefixXor(quote) ^ in_string_carry_; // Opening quotes in, closing ones out
+            in_string_carry_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+            if (0 != (block.control & in_string)) {
+                return Fail(rapidjson::kParseErrorStringInvalidEncoding,
+                            base + static_cast<uint32_t>(__builtin_ctzll(block.control & in_string)));
+            }
+
+            // Numbers and literals are indexed by their first character
+            const uint64_t scalar = ~(block.op | block.space | block.quote | in_string);
+            uint64_t structural = (block.op & ~in_string) | quote | (scalar & ~(scalar << 1 | scalar_carry_));
+            scalar_carry_ = scalar >> 63;
+            non_ascii |= block.non_ascii;
+            for (; 0 != structural; structural &= structural - 1) {
+                *out++ = base + static_cast<uint32_t>(__builtin_ctzll(structural));
+            }
+        }
+        indexed_ += chunk_length;
+        token_count_ = static_cast<size_t>(out - tokens_.data());
+        if (0 == non_ascii && chunk == utf8_checked_) {
+            utf8_checked_ = indexed_;
+        } else if (!CheckUtf8(indexed_)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A sequence cut by the end of the chunk is checked again with the next one
+bool JsonIndexReader::CheckUtf8(size_t end)
+{
+    const char* invalid = FindInvalidUtf8(json_ + utf8_checked_, json_ + end);
+    if (json_ + end != invalid && (length_ == end || json_ + end - invalid >= 4)) {
+        return Fail(rapidjson::kParseErrorStringInvalidEncoding, static_cast<size_t>(invalid - json_));
+    }
+    utf8_checked_ = static_cast<size_t>(invalid - json_);
+    return true;
+}
+
+bool JsonIndexReader::ParseString(size_t& pos)
+{
+    const size_t opening = pos;
+    if (!NextToken(pos)) { // The closing quote, the index has nothing inside strings
+        return false;
+    }
+    const char* beg = json_ + opening + 1;
+    const char* end = json_ + pos;
+    ++pos;
+
+    const char* escape = FindByte(beg, end, '\\');
+    buffer_.assign(beg, escape);
+    return end == escape || Unescape(escape, end);
+}
+
+// Neither the text nor the escapes are checked against the end of the string, the closing quote is never escaped
+bool JsonIndexReader::Unescape(const char* cursor, const char* const end)
+{
+    while (cursor < end) {
+        if ('\\' != *cursor) {
+            const char* escape = FindByte(cursor, end, '\\');
+            buffer_.append(cursor, escape);
+            cursor = escape;
+            continue;
+        }
+
+        const auto escape_offset = static_cast<size_t>(cursor - json_);
+        const char escaped = cursor[1];
+        cursor += 2;
+        switch (escaped) {
+        case '"':
+        case '\\':
+        case '/':
+            buffer_.push_back(escaped);
+            break;
+        case 'b':
+            buffer_.push_back('\b');
+            break;
+        case 'f':
+            buffer_.push_back('\f');
+            break;
+        case 'n':
+            buffer_.push_back('\n');
+            break;
+        case 'r':
+            buffer_.push_back('\r');
+            break;
+        case 't':
+            buffer_.push_back('\t');
+            break;
+        case 'u': {
+            unsigned codepoint;
+            if (!ParseHex4(cursor, end, escape_offset, codepoint)) {
+                return false;
+            }
+            if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+                unsigned low;
+                if (codepoint > 0xDBFF || end - cursor < 2 || '\\' != cursor[0] || 'u' != cursor[1]) {
+                    return Fail(rapidjson::kParseErrorStringUnicodeSurrogateInvalid, escape_offset);
+                }
+                cursor += 2;
+                if (!ParseHex4(cursor, end, escape_offset, low)) {
+                    return false;
+                }
+                if (low < 0xDC00 || low > 0xDFFF) {
+                    return Fail(rapidjson::kParseErrorStringUnicodeSurrogateInvalid, escape_offset);
+                }
+                codepoint = (((codepoint - 0xD800) << 10) | (low - 0xDC00)) + 0x10000;
+            }
+            EncodeUtf8(codepoint, buffer_);
+            break;
+        }
+        default:
+            return Fail(rapidjson::kParseErrorStringEscapeInvalid, escape_offset);
+        }
+    }
+    return true;
+}
+
+bool JsonIndexReader::ParseHex4(const char*& cursor, const char* const end, size_t escape_offset,
+                                unsigned& code_unit)
+{
+    code_unit = 0;
+    for (int i = 0; i < 4; ++i, ++cursor) {
+        const char c = cursor < end ? *cursor : '\0';
+        unsigned digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<unsigned>(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<unsigned>(c - 'A' + 10);
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<unsigned>(c - 'a' + 10);
+        } else {
+            return Fail(rapidjson::kParseErrorStringUnicodeEscapeInvalidHex, escape_offset);
+        }
+        code_unit = (code_unit << 4) | digit;
+    }
+    return true;
+}
+
+bool JsonIndexReader::ParseLiteral(size_t& pos, const char* literal, size_t literal_length)
+{
+    if (length_ - pos < literal_length || 0 != std::memcmp(json_ + pos, literal, literal_length)) {
+        return Fail(rapidjson::kParseErrorValueInvalid, pos);
+    }
+    pos += literal_length;
+    return CheckValueEnd(pos);
+}
+
+bool JsonIndexReader::ScanNumber(size_t& pos, bool& minus, uint64_t& magnitude, bool& is_integer)
+{
+    minus = '-' == At(pos);
+    pos += minus ? 1 : 0;
+    magnitude = 0;
+    is_integer = true;
+    if ('0' == At(pos)) {
+        ++pos;
+    } else if (IsDigit(At(pos))) {
+        for (; IsDigit(At(pos)); ++pos) {
+            const auto digit = static_cast<uint64_t>(At(pos) - '0');
+            if (magnitude > (UINT64_MAX - digit) / 10) {
+                is_integer = false; // Too large, left to rapidjson
+            }
+            magnitude = magnitude * 10 + digit;
+        }
+    } else {
+        return Fail(rapidjson::kParseErrorValueInvalid, pos);
+    }
+
+    if ('.' == At(pos)) {
+        is_integer = false;
+        if (!IsDigit(At(++pos))) {
+            return Fail(rapidjson::kParseErrorNumberMissFraction, pos);
+        }
+        while (IsDigit(At(pos))) {
+            ++pos;
+        }
+    }
+    if ('e' == At(pos) || 'E' == At(pos)) {
+        is_integer = false;
+        ++pos;
+        if ('+' == At(pos) || '-' == At(pos)) {
+            ++pos;
+        }
+        if (!IsDigit(At(pos))) {
+            return Fail(rapidjson::kParseErrorNumberMissExponent, pos);
+        }
+        while (IsDigit(At(pos))) {
+            ++pos;
+        }
+    }
+    return true;
+}
+
+bool JsonIndexReader::CheckValueEnd(size_t pos)
+{
+    return pos == length_ || IsValueEnd(json_[pos]) || Fail(MissingSeparator(), pos);
+}
+
+rapidjson::ParseErrorCode JsonIndexReader::MissingSeparator() const
+{
+    if (frames_.empty()) {
+        return rapidjson::kParseErrorDocumentRootNotSingular;
+    }
+    return frames_.back().is_object ? rapidjson::kParseErrorObjectMissCommaOrCurlyBracket
+                                    : rapidjson::kParseErrorArrayMissCommaOrSquareBracket;
+}
+
+bool JsonIndexReader::Fail(rapidjson::ParseErrorCode code, size_t offset)
+{
+    error_code_ = code;
+    error_offset_ = offset;
+    return false;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/memory_report.hpp"
+
+#include <unordered_set>
+
+void MemoryReport::AddRouting(size_t trie_nodes, size_t trie_bytes, size_t route_map_bytes)
+{
+    trie_nodes_ += trie_nodes;
+    trie_bytes_ += trie_bytes;
+    route_map_bytes_ += route_map_bytes;
+}
+
+void MemoryReport::AddSchema(const void* instance, uint64_t digest, size_t bytes)
+{
+    auto& schema = schemas_.emplace(instance, Shared{digest, bytes, 0}).first->second;
+    ++schema.references;
+    pending_schema_bytes_ += bytes;
+}
+
+void MemoryReport::AddDeserializer(const void* instance, size_t bytes)
+{
+    auto& deserializer = deserializers_.emplace(instance, Shared{0, bytes, 0}).first->second;
+    ++deserializer.references;
+    pending_deserializer_bytes_ += bytes;
+}
+
+void MemoryReport::AddRoute(const std::string& method, const std::string& path, size_t store_bytes,
+                            size_t validators)
+{
+    routes_.push_back({method, path, store_bytes, validators, pending_schema_bytes_, pending_deserializer_bytes_});
+    pending_schema_bytes_ = 0;
+    pending_deserializer_bytes_ = 0;
+}
+
+void MemoryReport::AddOther(size_t bytes)
+{
+    other_bytes_ += bytes;
+}
+
+void MemoryReport::SetSpecRefs(size_t count, size_t bytes)
+{
+    spec_ref_count_ = count;
+    spec_ref_bytes_ = bytes;
+}
+
+std::string MemoryReport::ToJson() const
+{
+    size_t routes_bytes = 0;
+    for (const auto& route : routes_) {
+        routes_bytes += route.bytes;
+    }
+    size_t total_bytes = trie_bytes_ + route_map_bytes_ + routes_bytes + spec_ref_bytes_ + other_bytes_;
+    for (const auto& schema : schemas_) {
+        total_bytes += schema.second.bytes;
+    }
+    for (const auto& deserializer : deserializers_) {
+        total_bytes += deserializer.second.bytes;
+    }
+
+    std::string json;
+    json.reserve(256 + routes_.size() * 128);
+    json += R"({"totalBytes":)" + std::to_string(total_bytes);
+    json += R"(,"routing":{"pathTrieNodes":)" + std::to_string(trie_nodes_);
+    json += R"(,"pathTrieBytes":)" + std::to_string(trie_bytes_);
+    json += R"(,"routeMapBytes":)" + std::to_string(route_map_bytes_) + "}";
+    json += R"(,"routes":{"count":)" + std::to_string(routes_.size());
+    json += R"(,"bytes":)" + std::to_string(routes_bytes) + R"(,"items":[)";
+    for (const auto& route : routes_) {
+        json += R"({"method":")" + route.method + R"(","path":")";
+        AppendEscaped(route.path, json);
+        json += R"(","bytes":)" + std::to_string(route.bytes);
+        json += R"(,"validators":)" + std::to_string(route.validators);
+        json += R"(,"schemaBytes":)" + std::to_string(route.schema_bytes);
+        json += R"(,"deserializerBytes":)" + std::to_string(route.deserializer_bytes) + "},";
+    }
+    if (!routes_.empty()) {
+        json.pop_back();
+    }
+    json += R"(]},"schemas":)";
+    AppendShared(schemas_, json);
+    json += R"(,"deserializers":)";
+    AppendShared(deserializers_, json);
+    json += R"(,"specRefs":{"count":)" + std::to_string(spec_ref_count_);
+    json += R"(,"bytes":)" + std::to_string(spec_ref_bytes_) + "}";
+    json += R"(,"otherBytes":)" + std::to_string(other_bytes_) + "}";
+    return json;
+}
+
+void MemoryReport::AppendShared(const std::unordered_map<const void*, Shared>& instances, std::string& json)
+{
+    size_t references = 0;
+    size_t shared = 0;
+    size_t duplicated = 0;
+    size_t bytes = 0;
+    std::unordered_set<uint64_t> digests;
+    for (const auto& instance : instances) {
+        references += instance.second.references;
+        shared += instance.second.references > 1 ? 1 : 0;
+        bytes += instance.second.bytes;
+        // Digest 0 means unknown, e.g. compiled outside of a ValidatorsCache
+        if (instance.second.digest && !digests.insert(instance.second.digest).second) {
+            ++duplicated;
+        }
+    }
+    json += R"({"compiled":)" + std::to_string(instances.size());
+    json += R"(,"references":)" + std::to_string(references);
+    json += R"(,"shared":)" + std::to_string(shared);
+    json += R"(,"duplicated":)" + std::to_string(duplicated);
+    json += R"(,"bytes":)" + std::to_string(bytes) + "}";
+}
+
+void MemoryReport::AppendEscaped(const std::string& str, std::string& json)
+{
+    for (auto c : str) {
+        if ('"' == c || '\\' == c) {
+            json.push_back('\\');
+        }
+        json.push_back(c);
+    }
+}
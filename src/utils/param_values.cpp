@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/param_values.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+const ParamValue kMissing{};
+
+inline bool NameEquals(const ParamValue& param, const std::string& name)
+{
+    return param.name_length == name.size() && 0 == std::memcmp(param.name, name.data(), name.size());
+}
+} // namespace
+
+const ParamValue& ParamValue::GetItem(size_t idx) const
+{
+    if ((ParamType::ARRAY != type && ParamType::OBJECT != type) || idx >= length) {
+        return kMissing;
+    }
+    return items[idx];
+}
+
+const ParamValue& ParamValue::GetMember(const std::string& member_name) const
+{
+    if (ParamType::OBJECT != type) {
+        return kMissing;
+    }
+    for (size_t idx = 0; idx < length; ++idx) {
+        if (NameEquals(items[idx], member_name)) {
+            return items[idx];
+        }
+    }
+    return kMissing;
+}
+
+void ParamValues::Clear()
+{
+    params_.clear();
+    block_ = 0;
+    used_ = 0;
+}
+
+size_t ParamValues::GetCount() const
+{
+    return params_.size();
+}
+
+const ParamValue& ParamValues::Get(size_t idx) const
+{
+    return idx < params_.size() ? params_[idx] : kMissing;
+}
+
+const ParamValue& ParamValues::Get(const std::string& name) const
+{
+    for (const auto& param : params_) {
+        if (NameEquals(param, name)) {
+            return param;
+        }
+    }
+    return kMissing;
+}
+
+size_t ParamValues::GetMemoryUsage() const
+{
+    size_t bytes = params_.capacity() * sizeof(ParamValue) + blocks_.capacity() * sizeof(Block);
+    for (const auto& block : blocks_) {
+        bytes += block.size;
+    }
+    return bytes;
+}
+
+void ParamValuesBuilder::Add(ParamValues& values, const std::string& name, const rapidjson::Value& value)
+{
+    values.params_.emplace_back();
+    auto& param = values.params_.back();
+    param.name = Copy(values, name.data(), name.size());
+    param.name_length = name.size();
+    Convert(values, value, param);
+}
+
+void ParamValuesBuilder::AddMissing(ParamValues& values, const std::string& name)
+{
+    values.params_.emplace_back();
+    auto& param = values.params_.back();
+    param.name = Copy(values, name.data(), name.size());
+    param.name_length = name.size();
+}
+
+void ParamValuesBuilder::Convert(ParamValues& values, const rapidjson::Value& value, ParamValue& param)
+{
+    if (value.IsNull()) {
+        param.type = ParamType::NULL_VALUE;
+    } else if (value.IsBool()) {
+        param.type = ParamType::BOOLEAN;
+        param.boolean = value.GetBool();
+    } else if (value.IsInt64()) {
+        param.type = ParamType::INTEGER;
+        param.integer = value.GetInt64();
+        param.number = static_cast<double>(param.integer);
+    } else if (value.IsNumber()) { // Fractions and integers beyond int64_t
+        param.type = ParamType::NUMBER;
+        param.number = value.GetDouble();
+    } else if (value.IsString()) {
+        param.type = ParamType::STRING;
+        param.length = value.GetStringLength();
+        param.string = Copy(values, value.GetString(), param.length);
+    } else if (value.IsArray()) {
+        param.type = ParamType::ARRAY;
+        param.length = value.Size();
+        auto* items = static_cast<ParamValue*>(Allocate(values, param.length * sizeof(ParamValue)));
+        for (size_t idx = 0; idx < param.length; ++idx) {
+            Convert(values, value[static_cast<rapidjson::SizeType>(idx)], *new (items + idx) ParamValue());
+        }
+        param.items = items;
+    } else {
+        param.type = ParamType::OBJECT;
+        param.length = value.MemberCount();
+        auto* members = static_cast<ParamValue*>(Allocate(values, param.length * sizeof(ParamValue)));
+        auto* member = members;
+        for (const auto& member_val : value.GetObject()) {
+            new (member) ParamValue();
+            member->name_length = member_val.name.GetStringLength();
+            member->name = Copy(values, member_val.name.GetString(), member->name_length);
+            Convert(values, member_val.value, *member);
+            ++member;
+        }
+        param.items = members;
+    }
+}
+
+const char* ParamValuesBuilder::Copy(ParamValues& values, const char* str, size_t length)
+{
+    if (0 == length) {
+        return "";
+    }
+    auto* copy = static_cast<char*>(Allocate(values, length));
+    std::memcpy(copy, str, length);
+    return copy;
+}
+
+// Blocks are never moved nor freed before the ParamValues, values point into them
+void* ParamValuesBuilder::Allocate(ParamValues& values, size_t size)
+{
+    if (0 == size) {
+        return nullptr;
+    }
+    size = (size + alignof(ParamValue) - 1) & ~(alignof(ParamValue) - 1);
+    for (; values.block_ < values.blocks_.size(); ++values.block_, values.used_ = 0) {
+        auto& block = values.blocks_[values.block_];
+        if (values.used_ + size <= block.size) {
+            void* ptr = block.data.get() + values.used_;
+            values.used_ += size;
+            return ptr;
+        }
+    }
+    const size_t block_size =
+        std::max({kMinBlockSize, size, values.blocks_.empty() ? 0 : 2 * values.blocks_.back().size});
+    ParamValues::Block block;
+    block.data.reset(new char[block_size]);
+    block.size = block_size;
+    values.blocks_.push_back(std::move(block));
+    values.block_ = values.blocks_.size() - 1;
+    values.used_ = size;
+    return values.blocks_.back().data.get();
+}
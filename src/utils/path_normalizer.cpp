@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/path_normalizer.hpp"
+
+#include <algorithm>
+
+namespace {
+inline int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+inline bool IsUnreserved(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || '-' == c || '.' == c ||
+           '_' == c || '~' == c;
+}
+
+// Unreserved character escaped at `cursor`, 0 if none
+inline char GetUnreservedEscape(const char* cursor, const char* end)
+{
+    if ('%' != *cursor || end - cursor < 3) {
+        return 0;
+    }
+    const int high = HexDigit(cursor[1]);
+    const int low = HexDigit(cursor[2]);
+    if (high < 0 || low < 0) {
+        return 0;
+    }
+    const auto decoded = static_cast<char>(high * 16 + low);
+    return IsUnreserved(decoded) ? decoded : 0;
+}
+
+// Byte at `cursor` as routed, `cursor` is moved past it
+inline char NextByte(const char*& cursor, const char* end, bool decode, bool ignore_case)
+{
+    char c = *cursor;
+    const char decoded = decode ? GetUnreservedEscape(cursor, end) : 0;
+    if (0 != decoded) {
+        c = decoded;
+        cursor += 3;
+    } else {
+        ++cursor;
+    }
+    return ignore_case ? ToLower(c) : c;
+}
+
+// Scalar, segments are short
+inline const char* SegmentEnd(const char* beg, const char* end)
+{
+    while (beg < end && '/' != *beg) {
+        ++beg;
+    }
+    return beg;
+}
+
+// "." or ".."
+inline bool IsDotSegment(const char* beg, const char* end)
+{
+    return (1 == end - beg && '.' == beg[0]) || (2 == end - beg && '.' == beg[0] && '.' == beg[1]);
+}
+
+// `literal` is already keyed
+bool SegmentEquals(const ParamRange& segment, const std::string& literal, bool decode, bool ignore_case)
+{
+    const char* cursor = segment.beg;
+    for (const char c : literal) {
+        if (cursor == segment.end || NextByte(cursor, segment.end, decode, ignore_case) != c) {
+            return false;
+        }
+    }
+    return cursor == segment.end;
+}
+} // namespace
+
+size_t NormalizedPath::GetSegmentCount() const
+{
+    return count_;
+}
+
+const ParamRange& NormalizedPath::GetSegment(size_t idx) const
+{
+    return segments_[idx];
+}
+
+void NormalizedPath::GetKey(size_t idx, std::string& key) const
+{
+    key.clear();
+    const auto& segment = segments_[idx];
+    for (const char* cursor = segment.beg; cursor < segment.end;) {
+        key.push_back(NextByte(cursor, segment.end, decode_, ignore_case_));
+    }
+}
+
+PathNormalizer::PathNormalizer(const PathNormalization& options, const std::vector<std::string>& base_paths)
+    : options_(options)
+    , enabled_(options.strip_base_paths || options.collapse_slashes || options.remove_dot_segments ||
+               options.decode_unreserved || options.ignore_case)
+{
+    if (!options.strip_base_paths) {
+        return;
+    }
+    for (const auto& base_path : base_paths) {
+        std::vector<std::string> segments;
+        const std::string key = GetKey(base_path);
+        for (size_t pos = 1; pos <= key.size();) { // Segments after the leading '/'
+            const size_t segment_end = std::min(key.find('/', pos), key.size());
+            if (segment_end > pos) {
+                segments.emplace_back(key, pos, segment_end - pos);
+            }
+            pos = segment_end + 1;
+        }
+        if (!segments.empty() && base_paths_.end() == std::find(base_paths_.begin(), base_paths_.end(), segments)) {
+            base_paths_.push_back(std::move(segments));
+        }
+    }
+    std::stable_sort(base_paths_.begin(), base_paths_.end(),
+                     [](const std::vector<std::string>& a, const std::vector<std::string>& b) {
+                         return a.size() > b.size();
+                     });
+}
+
+bool PathNormalizer::IsEnabled() const
+{
+    return enabled_;
+}
+
+bool PathNormalizer::IgnoresCase() const
+{
+    return options_.ignore_case;
+}
+
+// Paths are scanned once, only '/' and '%' are looked at. A raw path that routes as is is mostly the case.
+bool PathNormalizer::GetCanonicalRange(const char* beg, const char* end, const char*& range_beg,
+                                       const char*& range_end) const
+{
+    range_beg = options_.strip_base_paths ? StripBasePath(beg, end) : beg;
+    range_end = end;
+    if (range_beg == end) {
+        return false; // Only the base path, routed as "/"
+    }
+    for (const char* cursor = range_beg; cursor < end; ++cursor) {
+        if ('/' == *cursor) {
+            const char* const next = cursor + 1;
+            if (next == end) {
+                if (options_.collapse_slashes && cursor != range_beg) {
+                    range_end = cursor; // Static paths are matched without it
+                }
+            } else if ('/' == *next) {
+                if (options_.collapse_slashes) {
+                    return false;
+                }
+            } else if (options_.remove_dot_segments && IsDotSegment(next, SegmentEnd(next, end))) {
+                return false;
+            }
+        } else if ('%' == *cursor && options_.decode_unreserved && 0 != GetUnreservedEscape(cursor, end)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Segments are split as PathTrie does, a trailing slash ends the path
+bool PathNormalizer::Normalize(const char* beg, const char* end, NormalizedPath& path) const
+{
+    path.count_ = 0;
+    path.decode_ = options_.decode_unreserved;
+    path.ignore_case_ = options_.ignore_case;
+
+    for (const char* segment_beg = beg;;) {
+        const char* segment_end = SegmentEnd(segment_beg, end);
+        const bool is_last = segment_end == end;
+        bool keep = true;
+        if (segment_beg == beg) {
+            // The one before the leading '/', kept as is
+        } else if (segment_beg == segment_end) {
+            keep = !is_last && !options_.collapse_slashes;
+        } else if (options_.remove_dot_segments && IsDotSegment(segment_beg, segment_end)) {
+            keep = false;
+            if (2 == segment_end - segment_beg && path.count_ > 1) {
+                --path.count_;
+            }
+        }
+
+        if (keep) {
+            if (NormalizedPath::kMaxSegments == path.count_) {
+                return false;
+            }
+            path.segments_[path.count_++] = ParamRange{segment_beg, segment_end};
+        }
+        if (is_last) {
+            break;
+        }
+        segment_beg = segment_end + 1; // skip '/'
+    }
+
+    if (options_.strip_base_paths) {
+        StripBasePath(path);
+    }
+    return true;
+}
+
+std::string PathNormalizer::GetKey(const std::string& path) const
+{
+    std::string key;
+    key.reserve(path.size());
+    const char* const end = path.c_str() + path.size();
+    for (const char* cursor = path.c_str(); cursor < end;) {
+        key.push_back(NextByte(cursor, end, options_.decode_unreserved, options_.ignore_case));
+    }
+    return key;
+}
+
+size_t PathNormalizer::GetMemoryUsage() const
+{
+    size_t bytes = base_paths_.capacity() * sizeof(std::vector<std::string>);
+    for (const auto& segments : base_paths_) {
+        bytes += segments.capacity() * sizeof(std::string);
+        for (const auto& segment : segments) {
+            bytes += GetHeapSize(segment);
+        }
+    }
+    return bytes;
+}
+
+// The longest base path the path starts with is removed, segment 0 is moved to the '/' following it
+void PathNormalizer::StripBasePath(NormalizedPath& path) const
+{
+    for (const auto& base_path : base_paths_) {
+        const size_t base_count = base_path.size();
+        if (path.count_ <= base_count) {
+            continue;
+        }
+        size_t idx = 0;
+        while (idx < base_count && SegmentEquals(path.segments_[idx + 1], base_path[idx], options_.decode_unreserved,
+                                                 options_.ignore_case)) {
+            ++idx;
+        }
+        if (idx == base_count) {
+            const char* const base_end = path.segments_[base_count].end;
+            path.segments_[0] = ParamRange{base_end, base_end};
+            std::copy(path.segments_ + base_count + 1, path.segments_ + path.count_, path.segments_ + 1);
+            path.count_ -= base_count;
+            return;
+        }
+    }
+}
+
+// Start of the path after the longest base path it starts with
+const char* PathNormalizer::StripBasePath(const char* beg, const char* end) const
+{
+    for (const auto& base_path : base_paths_) {
+        const char* cursor = beg;
+        for (const auto& base_segment : base_path) {
+            if (cursor == end || '/' != *cursor) {
+                cursor = nullptr;
+                break;
+            }
+            const char* const segment_end = SegmentEnd(cursor + 1, end);
+            if (!SegmentEquals(ParamRange{cursor + 1, segment_end}, base_segment, options_.decode_unreserved,
+                               options_.ignore_case)) {
+                cursor = nullptr;
+                break;
+            }
+            cursor = segment_end;
+        }
+        if (cursor) {
+            return cursor;
+        }
+    }
+    return beg;
+}
@@ -76,7 +76,7 @@ void PathTrie::Insert(const std::string& path)
     }
 }
 
-bool PathTrie::Search(const char* beg, const char* const end, std::string& oas_path)
+bool PathTrie::Search(const char* beg, const char* const end, std::string& oas_path) const
 {
     auto* node = root_;
     const char* dir_end;
@@ -111,7 +111,7 @@ bool PathTrie::Search(const char* beg, const char* const end, std::string& oas_p
 }
 
 bool PathTrie::Search(const char* beg, const char* const end, std::string& oas_path,
-                      std::unordered_map<size_t, ParamRange>& param_idxs)
+                      std::unordered_map<size_t, ParamRange>& param_idxs) const
 {
     auto* node = root_;
     const char* dir_end;
@@ -146,6 +146,41 @@ bool PathTrie::Search(const char* beg, const char* const end, std::string& oas_p
     return true;
 }
 
+bool PathTrie::Search(const NormalizedPath& path, std::string& oas_path,
+                      std::unordered_map<size_t, ParamRange>* param_idxs) const
+{
+    auto* node = root_;
+    std::string key;
+    oas_path.clear();
+
+    for (size_t idx = 0; idx < path.GetSegmentCount(); ++idx) {
+        path.GetKey(idx, key);
+        auto it = node->children.find(key);
+
+        if (it == node->children.end()) {
+            if (!node->is_param) {
+                oas_path.clear();
+                return false;
+            }
+            it = node->children.find(node->dir); // Not the first child, static paths share the node
+            if (param_idxs) {
+                param_idxs->emplace(node->frag_idx, path.GetSegment(idx));
+            }
+        }
+        if (0 != idx) {
+            oas_path += '/';
+        }
+        oas_path += it->first;
+        node = it->second;
+    }
+
+    if (oas_path.empty()) {
+        oas_path = "/";
+    }
+
+    return true;
+}
+
 PathTrie::~PathTrie()
 {
 #ifndef LUA_OAS_VALIDATOR // LUA manages garbage collection itself
@@ -162,3 +197,31 @@ void PathTrie::DeleteNode(Node* node)
     delete node;
 #endif // LUA_OAS_VALIDATOR
 }
+
+size_t PathTrie::GetNodeCount() const
+{
+    return GetNodeCount(root_);
+}
+
+size_t PathTrie::GetMemoryUsage() const
+{
+    return GetMemoryUsage(root_);
+}
+
+size_t PathTrie::GetNodeCount(const Node* node)
+{
+    size_t count = 1;
+    for (const auto& pair : node->children) {
+        count += GetNodeCount(pair.second);
+    }
+    return count;
+}
+
+size_t PathTrie::GetMemoryUsage(const Node* node)
+{
+    size_t bytes = sizeof(Node) + GetHeapSize(node->dir) + GetHashMapHeapSize(node->children);
+    for (const auto& pair : node->children) {
+        bytes += GetHeapSize(pair.first) + GetMemoryUsage(pair.second);
+    }
+    return bytes;
+}
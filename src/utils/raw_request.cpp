@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/raw_request.hpp"
+
+#include <cstring>
+
+namespace {
+bool IsWhitespace(char c)
+{
+    return ' ' == c || '\t' == c;
+}
+
+bool Equals(const HeaderField& field, const char* name, size_t length)
+{
+    return field.name_length == length && 0 == memcmp(field.name, name, length);
+}
+} // namespace
+
+ValidationError RawRequest::ParseHttp1(const char* head, size_t length, std::string& error_msg)
+{
+    const char* const end = head + length;
+
+    // Request line: method SP request-target SP HTTP-version
+    const char* method_end = FindEitherByte(head, end, ' ', '\n');
+    if (method_end == end || ' ' != *method_end || method_end == head) {
+        return Malformed(ValidationError::INVALID_METHOD, "Malformed request line", error_msg);
+    }
+    const char* target = method_end + 1;
+    const char* target_end = FindEitherByte(target, end, ' ', '\n');
+    if (target_end == end || ' ' != *target_end || target_end == target) {
+        return Malformed(ValidationError::INVALID_ROUTE, "Malformed request line", error_msg);
+    }
+    const char* line_end = FindByte(target_end, end, '\n');
+    if (line_end == end || line_end - target_end <= 5 || 0 != memcmp(target_end + 1, "HTTP/", 5)) {
+        return Malformed(ValidationError::INVALID_ROUTE, "Malformed request line", error_msg);
+    }
+
+    // Absolute-form targets ("http://host/path") are routed on their path
+    if ('/' != *target) {
+        const char* scheme_end = FindByte(target, target_end, ':');
+        if (target_end - scheme_end > 3 && '/' == scheme_end[1] && '/' == scheme_end[2]) {
+            target = FindEitherByte(scheme_end + 3, target_end, '/', '?');
+        }
+    }
+    method_.assign(head, method_end);
+    path_.assign(target, target_end);
+    if (path_.empty() || '/' != path_[0]) {
+        path_.insert(path_.begin(), '/');
+    }
+
+    // Header lines: field-name ":" OWS field-value OWS, up to the empty line
+    header_count_ = 0;
+    const char* line = line_end + 1;
+    while (line < end) {
+        if ('\n' == *line || ('\r' == *line && line + 1 < end && '\n' == line[1])) {
+            break;
+        }
+        if (IsWhitespace(*line)) {
+            return Malformed(ValidationError::INVALID_HEADER_PARAM, "Obsolete line folding is not supported",
+                             error_msg);
+        }
+        const char* colon = FindEitherByte(line, end, ':', '\n');
+        if (colon == end || ':' != *colon || colon == line || IsWhitespace(colon[-1])) {
+            return Malformed(ValidationError::INVALID_HEADER_PARAM, "Malformed header field", error_msg);
+        }
+        line_end = FindByte(colon, end, '\n');
+        const char* next = line_end == end ? end : line_end + 1;
+        const char* value = colon + 1;
+        const char* value_end = line_end;
+        while (value < value_end && IsWhitespace(*value)) {
+            ++value;
+        }
+        while (value_end > value && (IsWhitespace(value_end[-1]) || '\r' == value_end[-1])) {
+            --value_end;
+        }
+        if (kMaxHeaders == header_count_) {
+            return Malformed(ValidationError::INVALID_HEADER_PARAM, "Too many header fields", error_msg);
+        }
+        fields_[header_count_++] = HeaderField(line, static_cast<size_t>(colon - line), value,
+                                               static_cast<size_t>(value_end - value));
+        line = next;
+    }
+    headers_ = fields_.data();
+
+    return ValidationError::NONE;
+}
+
+ValidationError RawRequest::ParseHttp2(const HeaderField* fields, size_t count, std::string& error_msg)
+{
+    const HeaderField* method = nullptr;
+    const HeaderField* path = nullptr;
+    // Pseudo-headers precede the regular fields
+    for (size_t i = 0; i < count && 0 != fields[i].name_length && ':' == *fields[i].name; ++i) {
+        if (Equals(fields[i], ":method", 7)) {
+            method = &fields[i];
+        } else if (Equals(fields[i], ":path", 5)) {
+            path = &fields[i];
+        }
+    }
+    if (!method || 0 == method->value_length) {
+        return Malformed(ValidationError::INVALID_METHOD, "Missing ':method' pseudo-header", error_msg);
+    }
+    if (!path || 0 == path->value_length) {
+        return Malformed(ValidationError::INVALID_ROUTE, "Missing ':path' pseudo-header", error_msg);
+    }
+
+    method_.assign(method->value, method->value_length);
+    path_.assign(path->value, path->value_length);
+    headers_ = fields;
+    header_count_ = count;
+
+    return ValidationError::NONE;
+}
+
+const std::string& RawRequest::GetMethod() const
+{
+    return method_;
+}
+
+const std::string& RawRequest::GetPath() const
+{
+    return path_;
+}
+
+const HeaderField* RawRequest::GetHeaders() const
+{
+    return headers_;
+}
+
+size_t RawRequest::GetHeaderCount() const
+{
+    return header_count_;
+}
+
+ValidationError RawRequest::Malformed(ValidationError code, const char* description, std::string& error_msg)
+{
+    const char* error_code;
+    switch (code) {
+    case ValidationError::INVALID_METHOD:
+        error_code = "INVALID_METHOD";
+        break;
+    case ValidationError::INVALID_ROUTE:
+        error_code = "INVALID_ROUTE";
+        break;
+    default:
+        error_code = "INVALID_HEADER_PARAM";
+        break;
+    }
+    error_msg = std::string(R"({"errorCode":")") + error_code + R"(","details":{"description": ")" + description +
+                R"("}})";
+    return code;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/route_cache.hpp"
+
+#include <cstring>
+
+namespace {
+constexpr uint64_t kParamBits = 16;
+constexpr uint64_t kParamMask = (uint64_t(1) << kParamBits) - 1;
+
+// Multiply-xorshift over the zero padded words of the path, seeded with the slot
+inline uint64_t HashPath(size_t slot, const uint64_t* words, size_t word_count)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ slot;
+    for (size_t i = 0; i < word_count; ++i) {
+        hash = (hash ^ words[i]) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+inline uint64_t GetShape(size_t slot, size_t length, size_t param_count)
+{
+    return length | (uint64_t(slot) << 16) | (uint64_t(param_count) << 48);
+}
+} // namespace
+
+RouteCache::RouteCache(size_t capacity)
+    : set_mask_(0)
+    , shards_(new Shard[kShards])
+    , counters_(new CounterStripe[kCounterStripes])
+{
+    size_t sets = 1;
+    while (sets * kShards * kWays < capacity) {
+        sets *= 2;
+    }
+    set_mask_ = sets - 1;
+    for (size_t i = 0; i < kShards; ++i) {
+        shards_[i].entries.reset(new Entry[sets * kWays]()); // Value-initialized, zeroing the keys
+    }
+}
+
+bool RouteCache::Find(size_t slot, const char* beg, const char* end, const ValidatorsStore*& validators,
+                      std::unordered_map<size_t, ParamRange>* param_idxs) const
+{
+    auto& counters = GetCounters();
+    const auto length = static_cast<size_t>(end - beg);
+    if (length > kMaxPathLength) {
+        counters.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uint64_t words[kKeyWords] = {};
+    std::memcpy(words, beg, length);
+    const size_t word_count = (length + 7) / 8;
+    const uint64_t hash = HashPath(slot, words, word_count);
+
+    Entry* set = GetSet(hash);
+    for (size_t way = 0; way < kWays; ++way) {
+        Entry& entry = set[way];
+        if (entry.hash.load(std::memory_order_relaxed) != hash) {
+            continue;
+        }
+        const uint64_t sequence = entry.sequence.load(std::memory_order_acquire);
+        if (0 != (sequence & 1)) {
+            continue;
+        }
+        const uint64_t shape = entry.shape.load(std::memory_order_relaxed);
+        const auto param_count = static_cast<size_t>(shape >> 48);
+        bool same = GetShape(slot, length, 0) == (shape & ~(uint64_t(0xFFFF) << 48));
+        for (size_t i = 0; same && i < word_count; ++i) {
+            same = entry.key[i].load(std::memory_order_relaxed) == words[i];
+        }
+        uint64_t params[kMaxParams];
+        for (size_t i = 0; same && i < param_count && i < kMaxParams; ++i) {
+            params[i] = entry.params[i].load(std::memory_order_relaxed);
+        }
+        const auto* cached = entry.validators.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!same || !cached || entry.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        validators = cached;
+        if (param_idxs) {
+            for (size_t i = 0; i < param_count; ++i) {
+                param_idxs->emplace(static_cast<size_t>(params[i] >> (2 * kParamBits)),
+                                    ParamRange{beg + ((params[i] >> kParamBits) & kParamMask),
+                                               beg + (params[i] & kParamMask)});
+            }
+        }
+        const auto frequency = entry.frequency.load(std::memory_order_relaxed);
+        if (frequency < kMaxFrequency) { // Racing hits may lose an increment
+            entry.frequency.store(static_cast<uint8_t>(frequency + 1), std::memory_order_relaxed);
+        }
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    counters.misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void RouteCache::Insert(size_t slot, const char* beg, const char* end, const ValidatorsStore* validators,
+                        const std::unordered_map<size_t, ParamRange>& param_idxs)
+{
+    const auto length = static_cast<size_t>(end - beg);
+    if (length > kMaxPathLength || param_idxs.size() > kMaxParams || !validators) {
+        return;
+    }
+    uint64_t words[kKeyWords] = {};
+    std::memcpy(words, beg, length);
+    const uint64_t hash = HashPath(slot, words, (length + 7) / 8);
+    const uint64_t shape = GetShape(slot, length, param_idxs.size());
+    uint64_t params[kMaxParams] = {};
+    size_t param_count = 0;
+    for (const auto& param : param_idxs) {
+        params[param_count++] = (uint64_t(param.first) << (2 * kParamBits)) |
+                                (static_cast<uint64_t>(param.second.beg - beg) << kParamBits) |
+                                static_cast<uint64_t>(param.second.end - beg);
+    }
+
+    auto& shard = shards_[hash >> 60];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Entry* set = GetSet(hash);
+    Entry* victim = nullptr;
+    for (size_t way = 0; way < kWays; ++way) {
+        Entry& entry = set[way];
+        if (!entry.validators.load(std::memory_order_relaxed)) {
+            victim = victim && !victim->validators.load(std::memory_order_relaxed) ? victim : &entry;
+            continue;
+        }
+        if (entry.hash.load(std::memory_order_relaxed) == hash &&
+            entry.shape.load(std::memory_order_relaxed) == shape) {
+            return; // Inserted by another thread
+        }
+        if (!victim || (victim->validators.load(std::memory_order_relaxed) &&
+                        entry.frequency.load(std::memory_order_relaxed) <
+                            victim->frequency.load(std::memory_order_relaxed))) {
+            victim = &entry;
+        }
+    }
+
+    if (victim->validators.load(std::memory_order_relaxed)) {
+        const auto frequency = victim->frequency.load(std::memory_order_relaxed);
+        if (0 != frequency) { // Aged instead, it is replaced once no longer requested
+            victim->frequency.store(static_cast<uint8_t>(frequency - 1), std::memory_order_relaxed);
+            return;
+        }
+        ++shard.evictions;
+    } else {
+        ++shard.size;
+    }
+
+    const uint64_t sequence = victim->sequence.load(std::memory_order_relaxed);
+    victim->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    victim->hash.store(hash, std::memory_order_relaxed);
+    victim->shape.store(shape, std::memory_order_relaxed);
+    victim->validators.store(validators, std::memory_order_relaxed);
+    for (size_t i = 0; i < kMaxParams; ++i) {
+        victim->params[i].store(params[i], std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kKeyWords; ++i) {
+        victim->key[i].store(words[i], std::memory_order_relaxed);
+    }
+    victim->frequency.store(0, std::memory_order_relaxed);
+    victim->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+RouteCacheStats RouteCache::GetStats() const
+{
+    RouteCacheStats stats;
+    for (size_t i = 0; i < kCounterStripes; ++i) {
+        stats.hits += counters_[i].hits.load(std::memory_order_relaxed);
+        stats.misses += counters_[i].misses.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kShards; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        stats.evictions += shards_[i].evictions;
+        stats.entries += shards_[i].size;
+    }
+    stats.capacity = kShards * (set_mask_ + 1) * kWays;
+    return stats;
+}
+
+size_t RouteCache::GetMemoryUsage() const
+{
+    return kShards * (sizeof(Shard) + (set_mask_ + 1) * kWays * sizeof(Entry)) +
+           kCounterStripes * sizeof(CounterStripe);
+}
+
+// Threads are given stripes in turn
+RouteCache::CounterStripe& RouteCache::GetCounters() const
+{
+    static std::atomic<size_t> next_stripe{0};
+    thread_local const size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % kCounterStripes;
+    return counters_[stripe];
+}
+
+RouteCache::Entry* RouteCache::GetSet(uint64_t hash) const
+{
+    return &shards_[hash >> 60].entries[(hash & set_mask_) * kWays];
+}
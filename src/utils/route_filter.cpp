@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/route_filter.hpp"
+#include "utils/common.hpp"
+
+#include <algorithm>
+
+namespace {
+// Segments are a few bytes long, a byte loop is faster here than the vector kernels of Seek()
+inline const char* SegmentEnd(const char* beg, const char* const end)
+{
+    while (beg < end && '/' != *beg) {
+        ++beg;
+    }
+    return beg;
+}
+} // namespace
+
+void RouteFilter::Build(const std::vector<std::string>& paths)
+{
+    min_segments_ = paths.empty() ? 1 : SIZE_MAX;
+    max_segments_ = 0;
+    any_first_segment_ = false;
+    std::vector<FirstSegment> first_segments;
+    std::vector<uint64_t> prefixes;
+    for (const auto& path : paths) {
+        const char* const path_beg = path.c_str();
+        const char* const end = path_beg + path.size();
+        size_t literal_depth;
+        const char* first_beg;
+        const char* first_end;
+        const size_t segment_count = Split(path_beg, end, literal_depth, first_beg, first_end);
+        min_segments_ = std::min(min_segments_, segment_count);
+        max_segments_ = std::max(max_segments_, segment_count);
+        if (segment_count < 2) { // Only matched by paths without a first segment either
+            continue;
+        }
+        if (literal_depth < 2) {
+            any_first_segment_ = true;
+            continue;
+        }
+        first_segments.push_back(FirstSegment{HashBytes(first_beg, first_end), literal_depth});
+
+        const char* beg = first_end + 1;
+        for (size_t depth = 3; depth <= literal_depth; ++depth) {
+            const char* segment_end = SegmentEnd(beg, end);
+            prefixes.push_back(HashBytes(path_beg, segment_end));
+            beg = segment_end + 1;
+        }
+    }
+
+    size_t slots = 8;
+    while (slots < 2 * first_segments.size()) {
+        slots *= 2;
+    }
+    first_segments_.assign(slots, FirstSegment{0, 0});
+    first_segments_mask_ = slots - 1;
+    for (const auto& first_segment : first_segments) {
+        auto idx = first_segment.hash & first_segments_mask_;
+        while (0 != first_segments_[idx].literal_depth && first_segments_[idx].hash != first_segment.hash) {
+            idx = (idx + 1) & first_segments_mask_;
+        }
+        auto& slot = first_segments_[idx];
+        slot.literal_depth = 0 == slot.literal_depth ? first_segment.literal_depth
+                                                     : std::min(slot.literal_depth, first_segment.literal_depth);
+        slot.hash = first_segment.hash;
+    }
+
+    size_t bits = 64;
+    while (bits < 16 * prefixes.size()) { // About 0.3% false positives with 3 probes
+        bits *= 2;
+    }
+    bloom_.assign(bits / 64, 0);
+    bloom_mask_ = bits - 1;
+    for (auto prefix : prefixes) {
+        AddToBloom(prefix);
+    }
+}
+
+bool RouteFilter::MayMatch(const char* beg, const char* const end) const
+{
+    const char* const path_beg = beg;
+    const char* prefix_end = path_beg;
+    size_t segment_count = 0;
+    size_t literal_depth = 0; // Of the routes having the first segment of the path, 0 when not checked
+    while (beg < end) {
+        const char* segment_end = SegmentEnd(beg, end);
+        if (++segment_count > max_segments_) {
+            return false;
+        }
+        if (2 == segment_count && !any_first_segment_) {
+            const auto* first_segment = FindFirstSegment(HashBytes(beg, segment_end));
+            if (!first_segment) {
+                return false;
+            }
+            literal_depth = first_segment->literal_depth;
+        } else if (segment_count <= literal_depth) {
+            prefix_end = segment_end;
+        }
+        beg = segment_end + 1; // skip '/'
+    }
+    if (segment_count < min_segments_) {
+        return false;
+    }
+    return std::min(literal_depth, segment_count) < 3 || InBloom(HashBytes(path_beg, prefix_end));
+}
+
+size_t RouteFilter::GetMemoryUsage() const
+{
+    return first_segments_.capacity() * sizeof(FirstSegment) + bloom_.capacity() * sizeof(uint64_t);
+}
+
+size_t RouteFilter::Split(const char* beg, const char* const end, size_t& literal_depth, const char*& first_beg,
+                          const char*& first_end)
+{
+    size_t segment_count = 0;
+    literal_depth = SIZE_MAX;
+    first_beg = first_end = end;
+    while (beg < end) {
+        const char* segment_end = SegmentEnd(beg, end);
+        if (SIZE_MAX == literal_depth && beg < segment_end && '{' == *beg) {
+            literal_depth = segment_count;
+        }
+        if (1 == segment_count) {
+            first_beg = beg;
+            first_end = segment_end;
+        }
+        ++segment_count;
+        beg = segment_end + 1; // skip '/'
+    }
+    literal_depth = std::min(literal_depth, segment_count);
+    return segment_count;
+}
+
+const RouteFilter::FirstSegment* RouteFilter::FindFirstSegment(uint64_t hash) const
+{
+    for (auto idx = hash & first_segments_mask_; 0 != first_segments_[idx].literal_depth;
+         idx = (idx + 1) & first_segments_mask_) {
+        if (first_segments_[idx].hash == hash) {
+            return &first_segments_[idx];
+        }
+    }
+    return nullptr;
+}
+
+// Double hashing, the probes step by the high half of the hash
+void RouteFilter::AddToBloom(uint64_t hash)
+{
+    const uint64_t step = (hash >> 32) | 1;
+    for (size_t i = 0; i < kProbes; ++i, hash += step) {
+        const uint64_t bit = hash & bloom_mask_;
+        bloom_[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+}
+
+bool RouteFilter::InBloom(uint64_t hash) const
+{
+    const uint64_t step = (hash >> 32) | 1;
+    for (size_t i = 0; i < kProbes; ++i, hash += step) {
+        const uint64_t bit = hash & bloom_mask_;
+        if (0 == ((bloom_[bit >> 6] >> (bit & 63)) & 1)) {
+            return false;
+        }
+    }
+    return true;
+}
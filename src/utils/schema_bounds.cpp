@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/schema_bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr size_t kCodePointBytes = 4; // Of UTF-8
+constexpr size_t kJsonEscapedByte = 6; // A byte of a string escaped as \u00XX
+constexpr size_t kPercentEncodedByte = 3;
+
+const rapidjson::Value* FindMember(const rapidjson::Value& value, const char* name)
+{
+    auto itr = value.FindMember(name);
+    return itr == value.MemberEnd() ? nullptr : &itr->value;
+}
+
+bool GetCount(const rapidjson::Value& schema, const char* name, size_t& count)
+{
+    const auto* value = FindMember(schema, name);
+    if (!value || !value->IsUint64()) {
+        return false;
+    }
+    count = static_cast<size_t>(value->GetUint64());
+    return true;
+}
+} // namespace
+
+size_t SchemaBounds::GetJsonBytes(const rapidjson::Value& schema)
+{
+    return GetJsonBytes(schema, 0);
+}
+
+size_t SchemaBounds::GetParamBytes(const rapidjson::Value& param)
+{
+    const rapidjson::Value* schema = param.IsObject() ? FindMember(param, "schema") : nullptr;
+    const rapidjson::Value* name = param.IsObject() ? FindMember(param, "name") : nullptr;
+    if (!schema || !schema->IsObject() || !name || !name->IsString()) {
+        return kUnbounded;
+    }
+    // Start character, name and '='
+    const size_t prefix = name->GetStringLength() + 2;
+    const auto* type = FindMember(*schema, "type");
+    if (type && type->IsString() && 0 == std::strcmp("array", type->GetString())) {
+        size_t max_items;
+        const auto* items = FindMember(*schema, "items");
+        if (!GetCount(*schema, "maxItems", max_items) || !items || !items->IsObject()) {
+            return kUnbounded;
+        }
+        // An item, its separator (up to "%20") and, exploded, the name repeated with '='
+        const size_t item = Add(Add(GetRawBytes(*items), prefix), kPercentEncodedByte);
+        return Add(prefix, Multiply(max_items, item));
+    }
+    if (type && type->IsString() && 0 == std::strcmp("object", type->GetString())) {
+        return kUnbounded;
+    }
+    return Add(prefix, GetRawBytes(*schema));
+}
+
+size_t SchemaBounds::CountSignificantBytes(const char* json, size_t length, size_t limit)
+{
+    size_t count = 0;
+    for (const char* const end = json + length; json < end && count <= limit; ++json) {
+        if (' ' != *json && '\n' != *json && '\r' != *json && '\t' != *json) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+size_t SchemaBounds::GetJsonBytes(const rapidjson::Value& schema, int depth)
+{
+    // The siblings of a reference are ignored
+    if (!schema.IsObject() || depth > kMaxDepth || FindMember(schema, "$ref")) {
+        return kUnbounded;
+    }
+    size_t bytes = kUnbounded;
+    if (const auto* type = FindMember(schema, "type")) {
+        if (type->IsString()) {
+            bytes = GetTypeBytes(schema, type->GetString(), depth);
+        } else if (type->IsArray()) {
+            bytes = 0;
+            for (const auto& item : type->GetArray()) {
+                bytes = std::max(bytes, item.IsString() ? GetTypeBytes(schema, item.GetString(), depth) : kUnbounded);
+            }
+        }
+        const auto* nullable = FindMember(schema, "nullable");
+        if (nullable && nullable->IsTrue()) {
+            bytes = std::max<size_t>(bytes, sizeof("null") - 1);
+        }
+    }
+    if (const auto* value = FindMember(schema, "const")) {
+        bytes = std::min(bytes, GetValueBytes(*value, kJsonEscapedByte));
+    }
+    bytes = std::min(bytes, GetEnumBytes(schema, kJsonEscapedByte));
+
+    const auto* all_of = FindMember(schema, "allOf");
+    if (all_of && all_of->IsArray()) {
+        for (const auto& sub_schema : all_of->GetArray()) {
+            bytes = std::min(bytes, GetJsonBytes(sub_schema, depth + 1));
+        }
+    }
+    for (const char* keyword : {"anyOf", "oneOf"}) {
+        const auto* branches = FindMember(schema, keyword);
+        if (branches && branches->IsArray()) {
+            size_t branch_bytes = 0;
+            for (const auto& sub_schema : branches->GetArray()) {
+                branch_bytes = std::max(branch_bytes, GetJsonBytes(sub_schema, depth + 1));
+            }
+            bytes = std::min(bytes, branch_bytes);
+        }
+    }
+    return bytes;
+}
+
+size_t SchemaBounds::GetTypeBytes(const rapidjson::Value& schema, const char* type, int depth)
+{
+    size_t count;
+    if (0 == std::strcmp("null", type)) {
+        return sizeof("null") - 1;
+    } else if (0 == std::strcmp("boolean", type)) {
+        return sizeof("false") - 1;
+    } else if (0 == std::strcmp("integer", type)) {
+        return GetIntegerBytes(schema);
+    } else if (0 == std::strcmp("string", type)) {
+        // Quotes, and the code points, each escaped as a pair of \uXXXX
+        return GetCount(schema, "maxLength", count) ? Add(2, Multiply(count, 2 * kJsonEscapedByte)) : kUnbounded;
+    } else if (0 == std::strcmp("array", type)) {
+        const auto* items = FindMember(schema, "items");
+        if (!GetCount(schema, "maxItems", count) || !items) {
+            return kUnbounded;
+        }
+        // Brackets, the items and a comma after each
+        return Add(2, Multiply(count, Add(GetJsonBytes(*items, depth + 1), 1)));
+    } else if (0 == std::strcmp("object", type)) {
+        return GetObjectBytes(schema, depth);
+    }
+    return kUnbounded; // "number", any spelling of a value in range is valid
+}
+
+size_t SchemaBounds::GetObjectBytes(const rapidjson::Value& schema, int depth)
+{
+    // Without additional properties, a member is one of the properties. Names may repeat, so the members are only
+    // bounded by maxProperties.
+    size_t max_properties;
+    const auto* additional = FindMember(schema, "additionalProperties");
+    if (!additional || !additional->IsFalse() || FindMember(schema, "patternProperties") ||
+        !GetCount(schema, "maxProperties", max_properties)) {
+        return kUnbounded;
+    }
+    size_t member = 0;
+    const auto* properties = FindMember(schema, "properties");
+    if (properties && properties->IsObject()) {
+        for (const auto& property : properties->GetObject()) {
+            // Quoted name, colon, value and comma
+            const size_t name = Add(2, Multiply(property.name.GetStringLength(), kJsonEscapedByte));
+            member = std::max(member, Add(Add(name, 2), GetJsonBytes(property.value, depth + 1)));
+        }
+    }
+    return Add(2, Multiply(max_properties, member));
+}
+
+size_t SchemaBounds::GetRawBytes(const rapidjson::Value& schema)
+{
+    size_t bytes = kUnbounded;
+    size_t count;
+    const auto* type = FindMember(schema, "type");
+    if (FindMember(schema, "$ref")) {
+        return kUnbounded;
+    } else if (type && type->IsString()) {
+        if (0 == std::strcmp("boolean", type->GetString())) {
+            bytes = sizeof("false") - 1;
+        } else if (0 == std::strcmp("integer", type->GetString())) {
+            bytes = GetIntegerBytes(schema);
+        } else if (0 == std::strcmp("string", type->GetString()) && GetCount(schema, "maxLength", count)) {
+            bytes = Multiply(count, kCodePointBytes * kPercentEncodedByte);
+        }
+    }
+    return std::min(bytes, GetEnumBytes(schema, kPercentEncodedByte));
+}
+
+size_t SchemaBounds::GetValueBytes(const rapidjson::Value& value, size_t escaped_byte)
+{
+    switch (value.GetType()) {
+    case rapidjson::kNullType:
+    case rapidjson::kTrueType:
+        return sizeof("true") - 1;
+    case rapidjson::kFalseType:
+        return sizeof("false") - 1;
+    case rapidjson::kStringType:
+        return Add(2, Multiply(value.GetStringLength(), escaped_byte));
+    case rapidjson::kArrayType: {
+        size_t bytes = 2;
+        for (const auto& item : value.GetArray()) {
+            bytes = Add(bytes, Add(GetValueBytes(item, escaped_byte), 1));
+        }
+        return bytes;
+    }
+    case rapidjson::kObjectType: {
+        size_t bytes = 2;
+        for (const auto& member : value.GetObject()) {
+            bytes = Add(bytes, Add(Add(GetValueBytes(member.name, escaped_byte), 2),
+                                   GetValueBytes(member.value, escaped_byte)));
+        }
+        return bytes;
+    }
+    case rapidjson::kNumberType:
+    default:
+        return kUnbounded;
+    }
+}
+
+size_t SchemaBounds::GetEnumBytes(const rapidjson::Value& schema, size_t escaped_byte)
+{
+    const auto* values = FindMember(schema, "enum");
+    if (!values || !values->IsArray() || values->Empty()) {
+        return kUnbounded;
+    }
+    size_t bytes = 0;
+    for (const auto& value : values->GetArray()) {
+        bytes = std::max(bytes, GetValueBytes(value, escaped_byte));
+    }
+    return bytes;
+}
+
+size_t SchemaBounds::GetIntegerBytes(const rapidjson::Value& schema)
+{
+    const auto* minimum = FindMember(schema, "minimum");
+    const auto* maximum = FindMember(schema, "maximum");
+    if (!minimum || !maximum || !minimum->IsNumber() || !maximum->IsNumber()) {
+        return kUnbounded;
+    }
+    const double magnitude = std::max(std::fabs(minimum->GetDouble()), std::fabs(maximum->GetDouble()));
+    if (!(magnitude < 1e18)) {
+        return kUnbounded;
+    }
+    // A sign, even "-0" is valid, and the digits of the largest magnitude
+    size_t bytes = 2;
+    for (auto value = static_cast<uint64_t>(magnitude); value >= 10; value /= 10) {
+        ++bytes;
+    }
+    return bytes;
+}
+
+size_t SchemaBounds::Add(size_t lhs, size_t rhs)
+{
+    return lhs > kUnbounded - rhs ? kUnbounded : lhs + rhs;
+}
+
+size_t SchemaBounds::Multiply(size_t lhs, size_t rhs)
+{
+    return 0 != lhs && rhs > kUnbounded / lhs ? kUnbounded : lhs * rhs;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/shadow_queue.hpp"
+
+namespace {
+// At least 2, a single slot would read as free again once published
+size_t RoundUpToPowerOfTwo(size_t value)
+{
+    size_t power = 2;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+} // namespace
+
+ShadowQueue::ShadowQueue(size_t capacity)
+    : slots_(new Slot[RoundUpToPowerOfTwo(capacity)])
+    , mask_(RoundUpToPowerOfTwo(capacity) - 1)
+{
+    for (size_t idx = 0; idx <= mask_; ++idx) {
+        slots_[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+}
+
+size_t ShadowQueue::GetPushed() const
+{
+    return tail_.load(std::memory_order_relaxed);
+}
+
+size_t ShadowQueue::GetPopped() const
+{
+    return popped_.load(std::memory_order_acquire);
+}
+
+uint64_t ShadowQueue::GetDropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void ShadowQueue::Clear(ShadowRequest& request)
+{
+    request.method.clear();
+    request.http_path.clear();
+    request.json_body.clear();
+    request.headers.clear();
+    request.has_body = false;
+}
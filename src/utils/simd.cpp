@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/simd.hpp"
+#include "utils/simd_kernels.hpp"
+
+#include <atomic>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define OAS_SIMD_SSE2
+#endif
+
+namespace {
+#if defined(OAS_SIMD_SSE2)
+// Part of the x86-64 baseline, so built with the default flags. SSE4.2 string instructions (PCMPESTRI) are slower
+// than compare-equal for up to three needles, so there is no separate SSE4.2 variant.
+struct Sse2
+{
+    using Vector = __m128i;
+    static constexpr ptrdiff_t kWidth = 16;
+
+    static Vector Load(const char* src)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    }
+
+    static void Store(char* dst, Vector chunk)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), chunk);
+    }
+
+    static Vector Splat(char c)
+    {
+        return _mm_set1_epi8(c);
+    }
+
+    static uint32_t Matches(Vector chunk, Vector needle)
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+    }
+    static uint32_t Controls(Vector chunk)
+    {
+        const Vector max_control = _mm_set1_epi8(0x1F);
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, max_control), max_control)));
+    }
+
+    static uint32_t NonAscii(Vector chunk)
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+    }
+};
+
+const SimdKernels kSse2Kernels = {&VectorIsa<Sse2>::FindAny, &DecodePercent<VectorIsa<Sse2>>,
+                                  &VectorIsa<Sse2>::ClassifyJson, &VectorIsa<Sse2>::FindInvalidUtf8};
+#endif
+
+const SimdKernels kScalarKernels = {&ScalarIsa::FindAny, &DecodePercent<ScalarIsa>, &ScalarIsa::ClassifyJson,
+                                    &ScalarIsa::FindInvalidUtf8};
+
+const SimdKernels* GetKernels(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::AVX2:
+        return GetAvx2Kernels();
+    case SimdLevel::SSE2:
+#if defined(OAS_SIMD_SSE2)
+        return &kSse2Kernels;
+#else
+        return nullptr;
+#endif
+    case SimdLevel::SCALAR:
+        return &kScalarKernels;
+    default:
+        return nullptr;
+    }
+}
+
+bool IsSupportedByCpu(SimdLevel level)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    switch (level) {
+    case SimdLevel::AVX2:
+        return __builtin_cpu_supports("avx2"); // Also checks that the OS saves the AVX registers
+    case SimdLevel::SSE2:
+        return __builtin_cpu_supports("sse2");
+    default:
+        return true;
+    }
+#else
+    return SimdLevel::SCALAR == level;
+#endif
+}
+
+SimdLevel DetectMaxSimdLevel()
+{
+    for (auto level : {SimdLevel::AVX2, SimdLevel::SSE2}) {
+        if (GetKernels(level) && IsSupportedByCpu(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::SCALAR;
+}
+
+// Resolved on first use rather than during static initialization, which may not have run yet for callers in other
+// translation units
+std::atomic<SimdLevel> active_level{SimdLevel::SCALAR};
+std::atomic<const SimdKernels*> active_kernels{nullptr};
+
+const SimdKernels& Kernels()
+{
+    const SimdKernels* kernels = active_kernels.load(std::memory_order_acquire);
+    if (!kernels) {
+        const auto level = GetMaxSimdLevel();
+        kernels = GetKernels(level);
+        active_level.store(level, std::memory_order_relaxed);
+        active_kernels.store(kernels, std::memory_order_release);
+    }
+    return *kernels;
+}
+
+// Decodes [cursor, limit) into `out`. The output is sized for the worst case up front and trimmed at the end, decoding
+// only ever shrinks it.
+PercentDecodeResult Decode(const char*& cursor, const char* const limit, const char* const end, std::string& out)
+{
+    const size_t out_size = out.size();
+    out.resize(out_size + static_cast<size_t>(limit - cursor));
+    char* dst = &out[out_size];
+    const auto result = Kernels().percent_decode(cursor, limit, end, dst);
+    out.resize(static_cast<size_t>(dst - out.data()));
+    return result;
+}
+} // namespace
+
+SimdLevel GetMaxSimdLevel()
+{
+    static const SimdLevel max_level = DetectMaxSimdLevel();
+    return max_level;
+}
+
+SimdLevel GetSimdLevel()
+{
+    Kernels();
+    return active_level.load(std::memory_order_relaxed);
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+    if (static_cast<int>(level) > static_cast<int>(GetMaxSimdLevel())) {
+        level = GetMaxSimdLevel();
+    }
+    while (!GetKernels(level)) { // Levels between scalar and the maximum that were not built
+        level = static_cast<SimdLevel>(static_cast<int>(level) - 1);
+    }
+    active_level.store(level, std::memory_order_relaxed);
+    active_kernels.store(GetKernels(level), std::memory_order_release);
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::AVX2:
+        return "avx2";
+    case SimdLevel::SSE2:
+        return "sse2";
+    case SimdLevel::SCALAR:
+        return "scalar";
+    default:
+        return "unknown";
+    }
+}
+
+const char* FindByte(const char* beg, const char* end, char c)
+{
+    return Kernels().find_any(beg, end, c, c, c);
+}
+
+const char* FindEitherByte(const char* beg, const char* end, char c1, char c2)
+{
+    return Kernels().find_any(beg, end, c1, c2, c2);
+}
+
+const char* FindAnyByte(const char* beg, const char* end, char c1, char c2, char c3)
+{
+    return Kernels().find_any(beg, end, c1, c2, c3);
+}
+
+PercentDecodeResult PercentDecode(const char*& cursor, const char* end, std::string& out)
+{
+    return Decode(cursor, end, end, out);
+}
+
+PercentDecodeResult PercentDecode(const char*& cursor, const char* end, char terminator, std::string& out)
+{
+    // The terminator is never part of an escape, so the first one found ends the value. Escapes are still checked
+    // against `end`, so one cut short by the terminator is reported as invalid rather than incomplete.
+    return Decode(cursor, FindByte(cursor, end, terminator), end, out);
+}
+
+void ClassifyJsonBlocks(const char* blocks, size_t count, JsonBlockMasks* masks)
+{
+    Kernels().classify_json(blocks, count, masks);
+}
+
+const char* FindInvalidUtf8(const char* beg, const char* end)
+{
+    return Kernels().find_invalid_utf8(beg, end);
+}
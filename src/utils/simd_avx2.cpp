@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+// Compiled with -mavx2 (see cmake/SetCompilerFlags.cmake), only reached after the CPU is checked for AVX2
+
+#include "utils/simd_kernels.hpp"
+
+#if defined(__GNUC__) && defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+struct Avx2
+{
+    using Vector = __m256i;
+    static constexpr ptrdiff_t kWidth = 32;
+
+    static Vector Load(const char* src)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    }
+
+    static void Store(char* dst, Vector chunk)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), chunk);
+    }
+
+    static Vector Splat(char c)
+    {
+        return _mm256_set1_epi8(c);
+    }
+
+    static uint32_t Matches(Vector chunk, Vector needle)
+    {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+    }
+    static uint32_t Controls(Vector chunk)
+    {
+        const Vector max_control = _mm256_set1_epi8(0x1F);
+        return static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, max_control), max_control)));
+    }
+
+    static uint32_t NonAscii(Vector chunk)
+    {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+    }
+};
+
+// UTF-8 validation by table lookups (Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte").
+// Each byte is checked with the one before it: the high and low nibbles of the first and the high nibble of the second
+// each index a table of the errors they allow, and a pair is wrong when all three agree on one. The third and fourth
+// bytes of a sequence are checked to be continuations separately.
+enum Utf8Error : uint8_t
+{
+    TOO_SHORT = 1 << 0, // Lead not followed by a continuation
+    TOO_LONG = 1 << 1, // Continuation after ASCII
+    OVERLONG_3 = 1 << 2,
+    TOO_LARGE = 1 << 3, // Above U+10FFFF
+    SURROGATE = 1 << 4,
+    OVERLONG_2 = 1 << 5,
+    TOO_LARGE_1000 = 1 << 6, // Also OVERLONG_4, told apart by the low nibble of the lead
+    TWO_CONTS = 1 << 7, // Continuation after a continuation, unless required by a longer lead
+    OVERLONG_4 = 1 << 6,
+    CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS // Errors that do not depend on the low nibble of the first byte
+};
+
+alignas(16) const uint8_t kFirstHigh[16] = {
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, // ASCII
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, // Continuation
+    TOO_SHORT | OVERLONG_2, // C0-CF
+    TOO_SHORT, // D0-DF
+    TOO_SHORT | OVERLONG_3 | SURROGATE, // E0-EF
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4 // F0-FF
+};
+
+alignas(16) const uint8_t kFirstLow[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, // C0, E0, F0
+    CARRY | OVERLONG_2, // C1
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE, // F4
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, // ED
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+alignas(16) const uint8_t kSecondHigh[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, // ASCII
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4, // 80-8F
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE, // 90-9F
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, // A0-AF
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, // B0-BF
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT // Lead
+};
+
+// Bytes above these in the last three positions start a sequence that the next vector must complete
+alignas(32) const uint8_t kIncompleteTail[32] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                                 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                                 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+__m256i LoadTable(const uint8_t* table)
+{
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+// `input` with the last N bytes of `prev` shifted in
+template <int N>
+__m256i Prev(__m256i input, __m256i prev)
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+__m256i HighNibbles(__m256i bytes)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Once a vector has an error, its sequences are checked one by one from the last lead before it, which finds the
+// first invalid byte. So does the tail shorter than a vector.
+const char* FindInvalidUtf8ByLookup(const char* beg, const char* const end)
+{
+    const __m256i first_high = LoadTable(kFirstHigh);
+    const __m256i first_low = LoadTable(kFirstLow);
+    const __m256i second_high = LoadTable(kSecondHigh);
+    const __m256i incomplete_tail = _mm256_load_si256(reinterpret_cast<const __m256i*>(kIncompleteTail));
+    const char* cursor = beg;
+    __m256i prev = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    while (end - cursor >= Avx2::kWidth) {
+        const __m256i input = Avx2::Load(cursor);
+        __m256i error = prev_incomplete;
+        if (0 != Avx2::NonAscii(input)) {
+            const __m256i prev1 = Prev<1>(input, prev);
+            const __m256i special = _mm256_and_si256(
+                _mm256_and_si256(_mm256_shuffle_epi8(first_high, HighNibbles(prev1)),
+                                 _mm256_shuffle_epi8(first_low, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)))),
+                _mm256_shuffle_epi8(second_high, HighNibbles(input)));
+            // Only third bytes (after E0-FF) and fourth bytes (after F0-FF) end up with the high bit set
+            const __m256i third = _mm256_subs_epu8(Prev<2>(input, prev), _mm256_set1_epi8(0xE0 - 0x80));
+            const __m256i fourth = _mm256_subs_epu8(Prev<3>(input, prev), _mm256_set1_epi8(0xF0 - 0x80));
+            const __m256i must_continue =
+                _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+            error = _mm256_xor_si256(must_continue, special);
+        }
+        if (!_mm256_testz_si256(error, error)) {
+            break;
+        }
+        prev_incomplete = _mm256_subs_epu8(input, incomplete_tail);
+        prev = input;
+        cursor += Avx2::kWidth;
+    }
+
+    for (int back = 1; back <= 3 && cursor - back >= beg; ++back) {
+        if (static_cast<uint8_t>(cursor[-back]) >= 0xC0) { // Lead of a sequence possibly cut by the vector
+            cursor -= back;
+            break;
+        }
+    }
+    return ScalarIsa::FindInvalidUtf8(cursor, end);
+}
+} // namespace
+
+const SimdKernels* GetAvx2Kernels()
+{
+    static const SimdKernels kKernels = {&VectorIsa<Avx2>::FindAny, &DecodePercent<VectorIsa<Avx2>>,
+                                         &VectorIsa<Avx2>::ClassifyJson, &FindInvalidUtf8ByLookup};
+    return &kKernels;
+}
+#else
+const SimdKernels* GetAvx2Kernels()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/spec_ref_table.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr SpecRefTable::Id SpecRefTable::kNone;
+
+SpecRefTable& SpecRefTable::Default()
+{
+    static SpecRefTable table;
+    return table;
+}
+
+bool SpecRefTable::EntryEqual::operator()(const Entry& lhs, const Entry& rhs) const
+{
+    return lhs.size == rhs.size && 0 == std::memcmp(lhs.data, rhs.data, lhs.size);
+}
+
+SpecRefTable::Id SpecRefTable::Intern(const std::string& spec_ref)
+{
+    if (spec_ref.size() > UINT32_MAX) {
+        throw ValidatorInitExc("Spec reference is too long: " + spec_ref.substr(0, 64) + "...");
+    }
+    const Entry probe{spec_ref.data(), static_cast<uint32_t>(spec_ref.size())};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto itr = index_.find(probe);
+    if (itr != index_.end()) {
+        return itr->second;
+    }
+    if (count_ == kMaxPages * kPageSize) {
+        throw ValidatorInitExc("Too many spec references, cannot intern: " + spec_ref);
+    }
+
+    if (block_capacity_ - block_used_ < spec_ref.size()) {
+        block_capacity_ = std::max(kBlockSize, spec_ref.size());
+        blocks_.emplace_back(new char[block_capacity_]);
+        block_used_ = 0;
+        block_bytes_ += block_capacity_;
+    }
+    char* data = blocks_.back().get() + block_used_;
+    std::memcpy(data, spec_ref.data(), spec_ref.size());
+    block_used_ += spec_ref.size();
+
+    auto& page = pages_[count_ >> kPageBits];
+    if (!page) {
+        page.reset(new Entry[kPageSize]);
+    }
+    const Entry entry{data, probe.size};
+    page[count_ & (kPageSize - 1)] = entry;
+    auto id = static_cast<Id>(count_++);
+    index_.emplace(entry, id);
+    return id;
+}
+
+const SpecRefTable::Entry& SpecRefTable::GetEntry(Id id) const
+{
+    return pages_[id >> kPageBits][id & (kPageSize - 1)];
+}
+
+void SpecRefTable::Append(Id id, std::string& out) const
+{
+    const auto& entry = GetEntry(id);
+    out.append(entry.data, entry.size);
+}
+
+std::string SpecRefTable::Get(Id id) const
+{
+    const auto& entry = GetEntry(id);
+    return {entry.data, entry.size};
+}
+
+size_t SpecRefTable::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+size_t SpecRefTable::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t pages = (count_ + kPageSize - 1) >> kPageBits;
+    return sizeof(*this) + block_bytes_ + blocks_.capacity() * sizeof(blocks_[0]) +
+           pages * kPageSize * sizeof(Entry) + index_.size() * (sizeof(Entry) + sizeof(Id) + 2 * sizeof(void*)) +
+           index_.bucket_count() * sizeof(void*);
+}
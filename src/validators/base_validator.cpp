@@ -8,20 +8,44 @@
 
 BaseValidator::BaseValidator(ValidationError err_code)
     : code_on_error_(err_code)
-    , err_header_(kErrHeaders.at(err_code))
+    , spec_refs_(nullptr)
+    , spec_ref_(SpecRefTable::kNone)
 {
 }
 
-BaseValidator::BaseValidator(const std::vector<std::string>& ref_keys, ValidationError err_code)
+BaseValidator::BaseValidator(const std::vector<std::string>& ref_keys, ValidationError err_code,
+                             SpecRefTable* spec_refs)
     : code_on_error_(err_code)
-    , err_header_(kErrHeaders.at(err_code))
+    , spec_refs_(spec_refs ? spec_refs : &SpecRefTable::Default())
+    , spec_ref_((spec_refs ? *spec_refs : SpecRefTable::Default()).Intern(JoinReference(ref_keys)))
 {
-    err_header_ += R"("specRef":")" + JoinReference(ref_keys) + R"(",)";
+}
+
+SpecRefTable::Id BaseValidator::GetSpecRef() const
+{
+    return spec_ref_;
 }
 
 std::string BaseValidator::GetErrHeader() const
 {
-    return err_header_;
+    std::string err_header;
+    AppendErrHeader(err_header);
+    return err_header;
+}
+
+void BaseValidator::AppendErrHeader(std::string& err_msg) const
+{
+    AppendErrHeader(code_on_error_, err_msg);
+}
+
+void BaseValidator::AppendErrHeader(ValidationError code, std::string& err_msg) const
+{
+    err_msg += kErrHeaders.at(code);
+    if (SpecRefTable::kNone != spec_ref_) {
+        err_msg += R"("specRef":")";
+        spec_refs_->Append(spec_ref_, err_msg);
+        err_msg += R"(",)";
+    }
 }
 
 const std::unordered_map<ValidationError, std::string> BaseValidator::kErrHeaders = {
@@ -32,4 +56,5 @@ const std::unordered_map<ValidationError, std::string> BaseValidator::kErrHeader
     {ValidationError::INVALID_QUERY_PARAM, R"({"errorCode":"INVALID_QUERY_PARAM","details":{)"},
     {ValidationError::INVALID_HEADER_PARAM, R"({"errorCode":"INVALID_HEADER_PARAM","details":{)"},
     {ValidationError::INVALID_BODY, R"({"errorCode":"INVALID_BODY","details":{)"},
-    {ValidationError::INVALID_RSP, R"({"errorCode":"INVALID_RSP","details":{)"}};
+    {ValidationError::INVALID_RSP, R"({"errorCode":"INVALID_RSP","details":{)"},
+    {ValidationError::TIMEOUT, R"({"errorCode":"TIMEOUT","details":{)"}};
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "validators/compiled_schema.hpp"
+
+#include <cstdlib>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+thread_local size_t* SchemaAllocator::counter_ = nullptr;
+
+SchemaAllocator::Scope::Scope()
+    : outer_(counter_)
+{
+    counter_ = &bytes;
+}
+
+SchemaAllocator::Scope::~Scope()
+{
+    counter_ = outer_;
+}
+
+size_t SchemaAllocator::GetSize(void* ptr, size_t requested)
+{
+#ifdef __GLIBC__
+    (void)requested;
+    return malloc_usable_size(ptr);
+#else
+    return requested; // Frees can't be accounted without the glibc, the total is then an upper bound
+#endif
+}
+
+void* SchemaAllocator::Malloc(size_t size)
+{
+    if (!size) {
+        return nullptr;
+    }
+    void* ptr = std::malloc(size);
+    if (ptr && counter_) {
+        *counter_ += GetSize(ptr, size);
+    }
+    return ptr;
+}
+
+void* SchemaAllocator::Realloc(void* original_ptr, size_t original_size, size_t new_size)
+{
+    if (!new_size) {
+        Free(original_ptr);
+        return nullptr;
+    }
+    if (original_ptr && counter_) {
+        *counter_ -= GetSize(original_ptr, original_size);
+    }
+    void* ptr = std::realloc(original_ptr, new_size);
+    if (ptr && counter_) {
+        *counter_ += GetSize(ptr, new_size);
+    }
+    return ptr;
+}
+
+void SchemaAllocator::Free(void* ptr) noexcept
+{
+    if (ptr && counter_) {
+        *counter_ -= GetSize(ptr, 0);
+    }
+    std::free(ptr);
+}
+
+CompiledSchema::CompiledSchema(const rapidjson::Value& schema_val, uint64_t digest)
+    : CompiledSchema(schema_val, digest, SchemaAllocator::Scope())
+{
+}
+
+CompiledSchema::CompiledSchema(const rapidjson::Value& schema_val, uint64_t digest, SchemaAllocator::Scope&& scope)
+    : SchemaDocument(schema_val)
+    , digest_(digest)
+    , bytes_(sizeof(CompiledSchema) + scope.bytes)
+    , max_bytes_(SchemaBounds::GetJsonBytes(schema_val))
+{
+}
@@ -5,50 +5,420 @@
 // [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
 
 #include "validators/json_validator.hpp"
+#include "utils/json_index.hpp"
+#include "utils/param_values.hpp"
+#include "utils/simd.hpp"
+
+#include <rapidjson/encodedstream.h>
+#include <rapidjson/memorystream.h>
+
+namespace {
+// Bodies nest arrays and objects as deep as their senders like, the iterative parser keeps its state on the heap
+constexpr unsigned kParseFlags = rapidjson::kParseDefaultFlags | rapidjson::kParseIterativeFlag;
+
+const BodyLimits kNoLimits{};
+
+// Parses `json` into `doc` within `limits` and the deadline if any, `exceeded` tells which one stopped the parse
+template <typename Doc, typename StackAllocator>
+rapidjson::ParseResult ParseIteratively(const char* json, size_t length, const BodyLimits& limits,
+                                        const ValidationDeadline* deadline, StackAllocator& stack_allocator, Doc& doc,
+                                        BodyLimit& exceeded)
+{
+    rapidjson::MemoryStream stream(json, length);
+    rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream> input(stream);
+    rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, StackAllocator> reader(&stack_allocator);
+    rapidjson::ParseResult result;
+    auto generator = [&](Doc& handler) {
+        if (HasParseLimits(limits) || deadline) {
+            BodyLimiter<Doc> limiter(handler, limits, deadline);
+            result = reader.template Parse<kParseFlags>(input, limiter);
+            exceeded = limiter.GetExceeded();
+        } else {
+            result = reader.template Parse<kParseFlags>(input, handler);
+        }
+        return !result.IsError();
+    };
+    doc.Populate(generator);
+    return result;
+}
+
+// Sends `doc` to `validator` until the deadline if any, `expired` tells whether it stopped there
+template <typename Doc, typename Validator>
+bool AcceptWithin(const Doc& doc, Validator& validator, const ValidationDeadline* deadline, bool& expired)
+{
+    if (!deadline) {
+        return AcceptIteratively(doc, validator);
+    }
+    BodyLimiter<Validator> limiter(validator, kNoLimits, deadline);
+    const bool accepted = AcceptIteratively(doc, limiter);
+    expired = BodyLimit::DEADLINE == limiter.GetExceeded();
+    return accepted;
+}
+
+// Sends the SAX events of a parse to the schema validator and to the document being built, the parse stops as soon as
+// the document is invalid
+template <typename Validator>
+class ValidatingHandler
+{
+public:
+    ValidatingHandler(Validator& validator, rapidjson::Document& doc)
+        : validator_(validator)
+        , doc_(doc)
+    {
+    }
+
+    ValidatingHandler(const ValidatingHandler&) = delete;
+    ValidatingHandler& operator=(const ValidatingHandler&) = delete;
+
+    bool Null()
+    {
+        return validator_.Null() && doc_.Null();
+    }
+
+    bool Bool(bool b)
+    {
+        return validator_.Bool(b) && doc_.Bool(b);
+    }
+
+    bool Int(int i)
+    {
+        return validator_.Int(i) && doc_.Int(i);
+    }
+
+    bool Uint(unsigned u)
+    {
+        return validator_.Uint(u) && doc_.Uint(u);
+    }
+
+    bool Int64(int64_t i)
+    {
+        return validator_.Int64(i) && doc_.Int64(i);
+    }
+
+    bool Uint64(uint64_t u)
+    {
+        return validator_.Uint64(u) && doc_.Uint64(u);
+    }
+
+    bool Double(double d)
+    {
+        return validator_.Double(d) && doc_.Double(d);
+    }
+
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        return validator_.RawNumber(str, length, copy) && doc_.RawNumber(str, length, copy);
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        return validator_.String(str, length, copy) && doc_.String(str, length, copy);
+    }
+
+    bool StartObject()
+    {
+        return validator_.StartObject() && doc_.StartObject();
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        return validator_.Key(str, length, copy) && doc_.Key(str, length, copy);
+    }
+
+    bool EndObject(rapidjson::SizeType member_count)
+    {
+        return validator_.EndObject(member_count) && doc_.EndObject(member_count);
+    }
+
+    bool StartArray()
+    {
+        return validator_.StartArray() && doc_.StartArray();
+    }
+
+    bool EndArray(rapidjson::SizeType element_count)
+    {
+        return validator_.EndArray(element_count) && doc_.EndArray(element_count);
+    }
+
+private:
+    Validator& validator_;
+    rapidjson::Document& doc_;
+};
+} // namespace
 
 JsonValidator::JsonValidator(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys,
-                             ValidationError err_code)
-    : BaseValidator(ref_keys, err_code)
-    , schema_(new rapidjson::SchemaDocument(schema_val))
-    , validator_(new rapidjson::SchemaValidator(*schema_))
+                             ValidationError err_code, SpecRefTable* spec_refs)
+    : BaseValidator(ref_keys, err_code, spec_refs)
+    , schema_(std::make_shared<const CompiledSchema>(schema_val))
 {
 }
 
-ValidationError JsonValidator::Validate(const std::string& json_str, std::string& error_msg)
+JsonValidator::JsonValidator(std::shared_ptr<const CompiledSchema> schema,
+                             const std::vector<std::string>& ref_keys, ValidationError err_code,
+                             SpecRefTable* spec_refs)
+    : BaseValidator(ref_keys, err_code, spec_refs)
+    , schema_(std::move(schema))
 {
-    rapidjson::Document doc;
-    doc.Parse(json_str.c_str());
+}
 
-    if (doc.HasParseError()) {
-        error_msg = err_header_ + R"("code":"parserError","description":")" +
-                    rapidjson::GetParseError_En(doc.GetParseError()) + R"(","offset":)" +
-                    std::to_string(doc.GetErrorOffset()) + "}}";
-        return code_on_error_;
+ValidationError JsonValidator::Validate(const std::string& json_str, std::string& error_msg) const
+{
+    return Validate(json_str.data(), json_str.size(), error_msg);
+}
+
+ValidationError JsonValidator::Validate(const char* json, size_t length, std::string& error_msg) const
+{
+    return ParseAndValidate(json, length, kNoLimits, nullptr, error_msg);
+}
+
+ValidationError JsonValidator::Validate(const char* json, size_t length, BodyParser parser, const BodyLimits& limits,
+                                        std::string& error_msg, const ValidationDeadline* deadline) const
+{
+    if (limits.max_bytes && length > limits.max_bytes) {
+        return LimitError(BodyLimit::BYTES, limits, limits.max_bytes, error_msg);
     }
+    if (ExceedsBound(json, length)) {
+        return SizeError(error_msg);
+    }
+    if (BodyParser::STRUCTURAL_INDEX == parser && length < UINT32_MAX) {
+        return ValidateIndexed(json, length, limits, deadline, error_msg); // Checks the encoding while indexing
+    }
+    // RapidJSON's own encoding check (kParseValidateEncodingFlag) decodes every character, a separate vectorized pass
+    // costs far less than the parse
+    const char* invalid = FindInvalidUtf8(json, json + length);
+    if (json + length != invalid) {
+        return ParserError(rapidjson::kParseErrorStringInvalidEncoding, static_cast<size_t>(invalid - json), error_msg);
+    }
+    return ParseAndValidate(json, length, limits, deadline, error_msg);
+}
+
+ValidationError JsonValidator::Validate(const char* json, size_t length, const std::string& name,
+                                        ParamValues& values, std::string& error_msg) const
+{
+    return ParseAndValidate(json, length, kNoLimits, nullptr, error_msg, &name, &values);
+}
 
-    if (!validator_) {
+ValidationError JsonValidator::Validate(const char* json, size_t length, BodyParser parser, const BodyLimits& limits,
+                                        rapidjson::Document& doc, std::string& error_msg,
+                                        const ValidationDeadline* deadline) const
+{
+    doc.SetNull();
+    if (limits.max_bytes && length > limits.max_bytes) {
+        return LimitError(BodyLimit::BYTES, limits, limits.max_bytes, error_msg);
+    }
+    if (ExceedsBound(json, length)) {
+        return SizeError(error_msg);
+    }
+    char state_buffer[kStateBufferSize];
+    StateAllocator state_allocator(state_buffer, sizeof(state_buffer), kStateBufferSize);
+    SchemaValidator validator(*schema_, &state_allocator);
+    BodyLimit exceeded = BodyLimit::NONE;
+
+    if (BodyParser::STRUCTURAL_INDEX == parser && length < UINT32_MAX) {
+        // The document is built while the schema validator is fed, as the text is indexed
+        JsonIndexReader reader;
+        bool parsed = false;
+        auto generator = [&](rapidjson::Document& handler) {
+            ValidatingHandler<SchemaValidator> validating_handler(validator, handler);
+            if (HasParseLimits(limits) || deadline) {
+                BodyLimiter<ValidatingHandler<SchemaValidator>> limiter(validating_handler, limits, deadline);
+                parsed = reader.Parse(json, length, limiter);
+                exceeded = limiter.GetExceeded();
+            } else {
+                parsed = reader.Parse(json, length, validating_handler);
+            }
+            return parsed;
+        };
+        doc.Populate(generator);
+        if (parsed && validator.IsValid()) {
+            return ValidationError::NONE;
+        }
+        if (BodyLimit::NONE != exceeded) {
+            return LimitError(exceeded, limits, reader.GetErrorOffset(), error_msg);
+        }
+        if (reader.HasParseError() && rapidjson::kParseErrorTermination != reader.GetParseErrorCode()) {
+            return ParserError(reader.GetParseErrorCode(), reader.GetErrorOffset(), error_msg);
+        }
+        return SchemaError(validator, error_msg);
+    }
+
+    const char* invalid = FindInvalidUtf8(json, json + length);
+    if (json + length != invalid) {
+        return ParserError(rapidjson::kParseErrorStringInvalidEncoding, static_cast<size_t>(invalid - json), error_msg);
+    }
+    char parse_stack_buffer[kParseStackBufferSize];
+    StateAllocator parse_stack_allocator(parse_stack_buffer, sizeof(parse_stack_buffer), kParseStackBufferSize);
+    const auto result = ParseIteratively(json, length, limits, deadline, parse_stack_allocator, doc, exceeded);
+    if (BodyLimit::NONE != exceeded) {
+        return LimitError(exceeded, limits, result.Offset(), error_msg);
+    }
+    if (result.IsError()) {
+        return ParserError(result.Code(), result.Offset(), error_msg);
+    }
+    bool expired = false;
+    if (AcceptWithin(doc, validator, deadline, expired)) {
         return ValidationError::NONE;
     }
+    return expired ? TimeoutError(error_msg) : SchemaError(validator, error_msg);
+}
 
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (doc.Accept(*this->validator_)) {
-        validator_->Reset();
-        lock.unlock();
+ValidationError JsonValidator::Validate(const rapidjson::Value& json, std::string& error_msg) const
+{
+    char state_buffer[kStateBufferSize];
+    StateAllocator state_allocator(state_buffer, sizeof(state_buffer), kStateBufferSize);
+    SchemaValidator validator(*schema_, &state_allocator);
+    if (AcceptIteratively(json, validator)) {
+        return ValidationError::NONE;
+    }
+    return SchemaError(validator, error_msg);
+}
+
+ValidationError JsonValidator::ParseAndValidate(const char* json, size_t length, const BodyLimits& limits,
+                                                const ValidationDeadline* deadline, std::string& error_msg,
+                                                const std::string* name, ParamValues* values) const
+{
+    char document_buffer[kDocumentBufferSize];
+    char parse_stack_buffer[kParseStackBufferSize];
+    StateAllocator document_allocator(document_buffer, sizeof(document_buffer), kDocumentBufferSize);
+    StateAllocator parse_stack_allocator(parse_stack_buffer, sizeof(parse_stack_buffer), kParseStackBufferSize);
+    Document doc(&document_allocator, kParseStackBufferSize / 4, &parse_stack_allocator);
+    BodyLimit exceeded = BodyLimit::NONE;
+    const auto result = ParseIteratively(json, length, limits, deadline, parse_stack_allocator, doc, exceeded);
+    if (BodyLimit::NONE != exceeded) {
+        return LimitError(exceeded, limits, result.Offset(), error_msg);
+    }
+    if (result.IsError()) {
+        return ParserError(result.Code(), result.Offset(), error_msg);
+    }
+
+    char state_buffer[kStateBufferSize];
+    StateAllocator state_allocator(state_buffer, sizeof(state_buffer), kStateBufferSize);
+    SchemaValidator validator(*schema_, &state_allocator);
+    bool expired = false;
+    if (!AcceptWithin(doc, validator, deadline, expired)) {
+        return expired ? TimeoutError(error_msg) : SchemaError(validator, error_msg);
+    }
+    if (values) {
+        ParamValuesBuilder::Add(*values, *name, doc);
+    }
+    return ValidationError::NONE;
+}
+
+// The schema validator is fed while parsing, so a body that is both malformed and invalid is reported by whichever
+// comes first
+ValidationError JsonValidator::ValidateIndexed(const char* json, size_t length, const BodyLimits& limits,
+                                               const ValidationDeadline* deadline, std::string& error_msg) const
+{
+    char state_buffer[kStateBufferSize];
+    StateAllocator state_allocator(state_buffer, sizeof(state_buffer), kStateBufferSize);
+    SchemaValidator validator(*schema_, &state_allocator);
+    JsonIndexReader reader;
+    bool parsed;
+    BodyLimit exceeded = BodyLimit::NONE;
+    if (HasParseLimits(limits) || deadline) {
+        BodyLimiter<SchemaValidator> limiter(validator, limits, deadline);
+        parsed = reader.Parse(json, length, limiter);
+        exceeded = limiter.GetExceeded();
+    } else {
+        parsed = reader.Parse(json, length, validator);
+    }
+    if (parsed && validator.IsValid()) {
         return ValidationError::NONE;
     }
+    if (BodyLimit::NONE != exceeded) {
+        return LimitError(exceeded, limits, reader.GetErrorOffset(), error_msg);
+    }
+    if (reader.HasParseError() && rapidjson::kParseErrorTermination != reader.GetParseErrorCode()) {
+        return ParserError(reader.GetParseErrorCode(), reader.GetErrorOffset(), error_msg);
+    }
+    return SchemaError(validator, error_msg);
+}
+
+// Whitespace is unbounded, so only the other bytes are counted, and no further than the bound
+bool JsonValidator::ExceedsBound(const char* json, size_t length) const
+{
+    const size_t max_bytes = schema_->GetMaxBytes();
+    return length > max_bytes && SchemaBounds::CountSignificantBytes(json, length, max_bytes) > max_bytes;
+}
+
+ValidationError JsonValidator::SizeError(std::string& error_msg) const
+{
+    error_msg = GetErrHeader() + R"("code":"sizeError","description":"Body is longer than the )" +
+                std::to_string(schema_->GetMaxBytes()) + R"( bytes its schema allows, whitespace excluded"}})";
+    return code_on_error_;
+}
+
+ValidationError JsonValidator::LimitError(BodyLimit limit, const BodyLimits& limits, size_t offset,
+                                          std::string& error_msg) const
+{
+    const char* code;
+    std::string description;
+    switch (limit) {
+    case BodyLimit::BYTES:
+        code = "bytesLimit";
+        description = "Body is larger than the limit of " + std::to_string(limits.max_bytes) + " bytes";
+        break;
+    case BodyLimit::DEPTH:
+        code = "depthLimit";
+        description = "Arrays and objects are nested deeper than the limit of " + std::to_string(limits.max_depth);
+        break;
+    case BodyLimit::ARRAY_ITEMS:
+        code = "arrayItemsLimit";
+        description = "Array has more items than the limit of " + std::to_string(limits.max_array_items);
+        break;
+    case BodyLimit::OBJECT_MEMBERS:
+        code = "objectMembersLimit";
+        description = "Object has more members than the limit of " + std::to_string(limits.max_object_members);
+        break;
+    case BodyLimit::STRING_LENGTH:
+        code = "stringLengthLimit";
+        description = "String is longer than the limit of " + std::to_string(limits.max_string_length) + " bytes";
+        break;
+    case BodyLimit::DEADLINE:
+        return TimeoutError(error_msg);
+    case BodyLimit::NONE:
+    default:
+        return ParserError(rapidjson::kParseErrorTermination, offset, error_msg);
+    }
+    error_msg = GetErrHeader() + R"("code":")" + code + R"(","description":")" + description + R"(","offset":)" +
+                std::to_string(offset) + "}}";
+    return code_on_error_;
+}
 
+ValidationError JsonValidator::TimeoutError(std::string& error_msg) const
+{
+    error_msg.clear();
+    AppendErrHeader(ValidationError::TIMEOUT, error_msg);
+    error_msg += R"("description":"Body validation stopped at its deadline"}})";
+    return ValidationError::TIMEOUT;
+}
+
+ValidationError JsonValidator::ParserError(rapidjson::ParseErrorCode code, size_t offset, std::string& error_msg) const
+{
+    error_msg = GetErrHeader() + R"("code":"parserError","description":")" + rapidjson::GetParseError_En(code) +
+                R"(","offset":)" + std::to_string(offset) + "}}";
+    return code_on_error_;
+}
+
+ValidationError JsonValidator::SchemaError(const SchemaValidator& validator, std::string& error_msg) const
+{
+    error_msg.clear();
     error_msg.reserve(1024);
-    error_msg = err_header_;
-    CreateErrorMessages(validator_->GetError(), std::string(), error_msg);
+    AppendErrHeader(error_msg);
+    CreateErrorMessages(validator.GetError(), std::string(), error_msg);
     error_msg.append("}}");
-    validator_->Reset();
 
     return code_on_error_;
 }
 
-void JsonValidator::CreateErrorMessages(
-    const rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>& errors, const std::string& context,
-    std::string& error_msg, bool recursive)
+size_t JsonValidator::GetMemoryUsage(MemoryReport& report) const
+{
+    report.AddSchema(schema_.get(), schema_->GetDigest(), schema_->GetMemoryUsage());
+    return 0;
+}
+
+void JsonValidator::CreateErrorMessages(const ErrorValue& errors, const std::string& context, std::string& error_msg,
+                                        bool recursive)
 {
     for (const auto& error_type : errors.GetObject()) {
         const char* error_name = error_type.name.GetString();
@@ -64,9 +434,8 @@ void JsonValidator::CreateErrorMessages(
     }
 }
 
-void JsonValidator::HandleError(const char* error_name,
-                                const rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>& error,
-                                const std::string& context, std::string& error_msg, bool recursive)
+void JsonValidator::HandleError(const char* error_name, const ErrorValue& error, const std::string& context,
+                                std::string& error_msg, bool recursive)
 {
     if (!error.ObjectEmpty()) {
         int code = error["errorCode"].GetInt();
@@ -134,7 +503,7 @@ void JsonValidator::HandleError(const char* error_name,
     }
 }
 
-std::string JsonValidator::GetString(const rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>& val)
+std::string JsonValidator::GetString(const ErrorValue& val)
 {
     if (val.IsString()) {
         return val.GetString();
@@ -163,11 +532,3 @@ std::string JsonValidator::GetString(const rapidjson::GenericValue<rapidjson::UT
 
     return "";
 }
-
-JsonValidator::~JsonValidator()
-{
-#ifndef LUA_OAS_VALIDATOR // LUA manages garbage collection itself
-    delete validator_;
-    delete schema_;
-#endif
-}
@@ -11,17 +11,18 @@ MethodValidator::MethodValidator()
 {
 }
 
-ValidationError MethodValidator::Validate(const std::string& method, std::string& err_msg)
+ValidationError MethodValidator::Validate(const std::string& method, std::string& err_msg) const
 {
-    if (kValidMethods.find(method) == kValidMethods.end()) {
-        err_msg += err_header_ + R"("description": "Invalid HTTP method ')" + method + "'" + R"("}})";
+    HttpMethod parsed;
+    return Validate(method, parsed, err_msg);
+}
+
+ValidationError MethodValidator::Validate(const std::string& method, HttpMethod& parsed, std::string& err_msg) const
+{
+    parsed = ParseHttpMethod(method);
+    if (HttpMethod::COUNT == parsed) {
+        err_msg = GetErrHeader() + R"("description": "Invalid HTTP method ')" + method + "'" + R"("}})";
         return ValidationError::INVALID_METHOD;
     }
     return ValidationError::NONE;
 }
-
-const std::unordered_set<std::string> MethodValidator::kValidMethods = {"GET",     "POST",    "PUT",     "DELETE",
-                                                                        "HEAD",    "OPTIONS", "PATCH",   "CONNECT",
-                                                                        "TRACE",   "get",     "post",    "put",
-                                                                        "delete",  "head",    "options", "patch",
-                                                                        "connect", "trace"};
\ No newline at end of file
@@ -211,20 +211,32 @@ BaseDeserializer* GetDeserializer(const rapidjson::Value& param_val, const std::
 
 ParamValidator::ParamValidator(const ParamInfo& param_info, const std::vector<std::string>& ref_keys,
                                ValidationError err_code)
-    : JsonValidator(param_info.schema, ref_keys, err_code)
+    : JsonValidator(param_info.schema, ref_keys, err_code, param_info.spec_refs)
     , name_(param_info.name)
     , required_(param_info.required)
+    , max_bytes_(param_info.max_bytes)
     , deserializer_(param_info.deserializer)
 {
 }
 
-ValidationError ParamValidator::ValidateParam(const char* beg, const char* end, std::string& error_msg)
+ValidationError ParamValidator::ValidateParam(const char* beg, const char* end, std::string& error_msg,
+                                             ParamValues* values) const
 {
+    if (static_cast<size_t>(end - beg) > max_bytes_) {
+        error_msg = GetErrHeader() + R"("description":"Parameter ')" + name_ + R"(' is longer than the )" +
+                    std::to_string(max_bytes_) + R"( bytes its schema allows"}})";
+        return code_on_error_;
+    }
     try {
-        auto ret = deserializer_->Deserialize(beg, end);
-        return JsonValidator::Validate(ret, error_msg);
+        // Reused by every parameter validated on this thread, allocating only when a longer value shows up
+        thread_local std::string json;
+        deserializer_->Deserialize(beg, end, json);
+        if (values) {
+            return JsonValidator::Validate(json.data(), json.size(), name_, *values, error_msg);
+        }
+        return JsonValidator::Validate(json, error_msg);
     } catch (const DeserializationException& exc) {
-        error_msg = err_header_ + exc.what() + "}}";
+        error_msg = GetErrHeader() + exc.what() + "}}";
         return code_on_error_;
     }
 }
@@ -236,37 +248,66 @@ bool ParamValidator::IsRequired() const
 
 ValidationError ParamValidator::ErrorOnMissing(std::string& error_msg) const
 {
-    error_msg = err_header_ + R"("description":"Missing required parameter ')" + name_ + R"('"}})";
+    error_msg = GetErrHeader() + R"("description":"Missing required parameter ')" + name_ + R"('"}})";
     return code_on_error_;
 }
 
+size_t ParamValidator::GetMemoryUsage(MemoryReport& report) const
+{
+    report.AddDeserializer(deserializer_.get(), deserializer_->GetMemoryUsage());
+    return JsonValidator::GetMemoryUsage(report) + GetHeapSize(name_);
+}
+
 ParamValidator::ParamInfo ParamValidator::GetParamInfo(const rapidjson::Value& param_val,
                                                        const std::string& default_style, bool default_explode,
-                                                       bool default_required, const std::vector<std::string>& ref_keys)
+                                                       bool default_required, const std::vector<std::string>& ref_keys,
+                                                       ValidatorsCache* cache)
 {
     std::string name(param_val["name"].GetString());
     auto required(param_val.HasMember("required") ? param_val["required"].GetBool() : default_required);
 
+    const rapidjson::Value* schema_val;
     if (param_val.HasMember("schema")) {
-        return {name, required, GetDeserializer(param_val, default_style, default_explode, ref_keys),
-                param_val["schema"]};
+        schema_val = &param_val["schema"];
     } else if (param_val.HasMember("content") && param_val["content"].HasMember("application/json") &&
                param_val["content"]["application/json"].HasMember("schema")) {
-        return {name, required, GetDeserializer(param_val, default_style, default_explode, ref_keys),
-                param_val["content"]["application/json"]["schema"]};
+        schema_val = &param_val["content"]["application/json"]["schema"];
     } else {
         throw ValidatorInitExc("Cannot generate deserializer for parameter: " + JoinReference(ref_keys));
     }
+
+    if (!cache) {
+        return {name, required,
+                std::shared_ptr<const BaseDeserializer>(
+                    GetDeserializer(param_val, default_style, default_explode, ref_keys)),
+                std::make_shared<const CompiledSchema>(*schema_val), SchemaBounds::GetParamBytes(param_val), nullptr};
+    }
+
+    // The deserializer depends on the whole parameter definition (name, location, style, explode and types)
+    auto key = ValidatorsCache::GetKey(param_val);
+    auto deserializer = cache->FindDeserializer(key);
+    if (!deserializer) {
+        deserializer.reset(GetDeserializer(param_val, default_style, default_explode, ref_keys));
+        cache->AddDeserializer(key, deserializer);
+    }
+    return {name,
+            required,
+            deserializer,
+            cache->GetSchema(*schema_val),
+            SchemaBounds::GetParamBytes(param_val),
+            cache->GetSpecRefs().get()};
 }
 
-PathParamValidator::PathParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& ref_keys)
-    : ParamValidator(ParamValidator::GetParamInfo(param_val, "simple", false, true, ref_keys), ref_keys,
+PathParamValidator::PathParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& ref_keys,
+                                        ValidatorsCache* cache)
+    : ParamValidator(ParamValidator::GetParamInfo(param_val, "simple", false, true, ref_keys, cache), ref_keys,
                      ValidationError::INVALID_PATH_PARAM)
 {
 }
 
-QueryParamValidator::QueryParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& ref_keys)
-    : ParamValidator(ParamValidator::GetParamInfo(param_val, "form", true, false, ref_keys), ref_keys,
+QueryParamValidator::QueryParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& ref_keys,
+                                          ValidatorsCache* cache)
+    : ParamValidator(ParamValidator::GetParamInfo(param_val, "form", true, false, ref_keys, cache), ref_keys,
                      ValidationError::INVALID_QUERY_PARAM)
     , empty_allowed_(param_val.HasMember("allowEmptyValue") && param_val["allowEmptyValue"].GetBool())
 {
@@ -277,8 +318,9 @@ bool QueryParamValidator::IsEmptyAllowed() const
     return empty_allowed_;
 }
 
-HeaderParamValidator::HeaderParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& ref_keys)
-    : ParamValidator(ParamValidator::GetParamInfo(param_val, "simple", false, false, ref_keys), ref_keys,
+HeaderParamValidator::HeaderParamValidator(const rapidjson::Value& param_val, const std::vector<std::string>& ref_keys,
+                                            ValidatorsCache* cache)
+    : ParamValidator(ParamValidator::GetParamInfo(param_val, "simple", false, false, ref_keys, cache), ref_keys,
                      ValidationError::INVALID_HEADER_PARAM)
 {
-}
\ No newline at end of file
+}
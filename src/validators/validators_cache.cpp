@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "validators/validators_cache.hpp"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+ValidatorsCache::Key ValidatorsCache::GetKey(const rapidjson::Value& val)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    val.Accept(writer);
+    return {HashBytes(buffer.GetString(), buffer.GetString() + buffer.GetSize()),
+            std::string(buffer.GetString(), buffer.GetSize())};
+}
+
+std::shared_ptr<const CompiledSchema> ValidatorsCache::GetSchema(const rapidjson::Value& schema_val)
+{
+    auto key = GetKey(schema_val);
+    auto& entry = schemas_[key];
+    auto schema = entry.lock();
+    if (!schema) {
+        schema = std::make_shared<const CompiledSchema>(schema_val, key.digest);
+        entry = schema;
+    }
+    return schema;
+}
+
+std::shared_ptr<const BaseDeserializer> ValidatorsCache::FindDeserializer(const Key& key) const
+{
+    auto itr = deserializers_.find(key);
+    return itr == deserializers_.end() ? nullptr : itr->second.lock();
+}
+
+void ValidatorsCache::AddDeserializer(const Key& key, const std::shared_ptr<const BaseDeserializer>& deserializer)
+{
+    deserializers_[key] = deserializer;
+}
+
+const std::shared_ptr<SpecRefTable>& ValidatorsCache::GetSpecRefs() const
+{
+    return spec_refs_;
+}
+
+void ValidatorsCache::ResetSpecRefs()
+{
+    spec_refs_ = std::make_shared<SpecRefTable>();
+}
@@ -5,17 +5,27 @@
 // [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
 
 #include "validators/validators_store.hpp"
+#include "utils/param_values.hpp"
 
+#include <algorithm>
 #include <set>
 
-ValidatorsStore::ValidatorsStore(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys)
-    : body_validator_(new BodyValidator(schema_val, ref_keys))
+ValidatorsStore::ValidatorsStore(const rapidjson::Value& schema_val, const std::vector<std::string>& ref_keys,
+                                 const BodyLimits& limits, const BodySampling& sampling, ValidatorsCache* cache)
+    : spec_refs_(cache ? cache->GetSpecRefs() : nullptr)
+    , body_validator_(cache ? new BodyValidator(cache->GetSchema(schema_val), ref_keys, limits,
+                                                cache->GetSpecRefs().get())
+                            : new BodyValidator(schema_val, ref_keys, limits))
+    , body_sampler_(sampling)
 {
 }
 
 void ValidatorsStore::AddParamValidators(const std::string& path, const rapidjson::Value& params,
-                                         std::vector<std::string>& ref_keys)
+                                         std::vector<std::string>& ref_keys, ValidatorsCache* cache)
 {
+    if (cache) {
+        spec_refs_ = cache->GetSpecRefs();
+    }
     auto path_param_idxs = GetPathParamIndices(path);
     for (const auto& param_val : params.GetArray()) {
         std::string in(param_val["in"].GetString());
@@ -23,20 +33,139 @@ void ValidatorsStore::AddParamValidators(const std::string& path, const rapidjso
         ref_keys.emplace_back(name);
         if ("path" == in) {
             path_param_validators_.emplace_back(
-                PathParamValidatorInfo{path_param_idxs.at(name), new PathParamValidator(param_val, ref_keys)});
+                PathParamValidatorInfo{path_param_idxs.at(name), new PathParamValidator(param_val, ref_keys, cache)});
         } else if ("query" == in) {
             query_param_validators_.emplace_back(
-                QueryParamValidatorInfo{name, new QueryParamValidator(param_val, ref_keys)});
+                QueryParamValidatorInfo{name, new QueryParamValidator(param_val, ref_keys, cache)});
         } else if ("header" == in) {
-            header_param_validators_.emplace(name, new HeaderParamValidator(param_val, ref_keys));
+            auto* validator = new HeaderParamValidator(param_val, ref_keys, cache);
+            if (!header_param_validators_.emplace(name, validator).second) {
+                delete validator;
+                throw ValidatorInitExc("Duplicate header parameter '" + name + "'");
+            }
+            std::string lower_name(name);
+            std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ToLower);
+            header_params_.emplace_back(HeaderParamValidatorInfo{lower_name, validator});
         } else {
             throw ValidatorInitExc("Invalid 'in' value '" + in + "' for parameter '" + name + "'");
         }
         ref_keys.pop_back();
     }
+    BuildHeaderTable();
+}
+
+void ValidatorsStore::BuildHeaderTable()
+{
+    header_slots_.clear();
+    if (header_params_.empty()) {
+        return;
+    }
+    for (size_t idx = 1; idx < header_params_.size(); ++idx) {
+        for (size_t other = 0; other < idx; ++other) {
+            if (header_params_[idx].name == header_params_[other].name) {
+                throw ValidatorInitExc("Duplicate header parameter '" + header_params_[idx].name +
+                                       "', header names are case-insensitive");
+            }
+        }
+    }
+
+    size_t size = 1;
+    while (size < header_params_.size()) {
+        size <<= 1;
+    }
+    for (; size <= header_params_.size() * 64; size <<= 1) {
+        for (uint64_t seed = 0; seed < kMaxHeaderSeeds; ++seed) {
+            std::vector<uint32_t> slots(size, 0);
+            bool perfect = true;
+            for (size_t idx = 0; idx < header_params_.size() && perfect; ++idx) {
+                const auto& name = header_params_[idx].name;
+                auto& slot = slots[HashHeaderName(name.data(), name.data() + name.size(), seed) & (size - 1)];
+                perfect = (0 == slot);
+                slot = static_cast<uint32_t>(idx + 1);
+            }
+            if (perfect) {
+                header_slots_.swap(slots);
+                header_seed_ = seed;
+                return;
+            }
+        }
+    }
+    throw ValidatorInitExc("Unable to build the header table of " + std::to_string(header_params_.size()) +
+                           " header parameters");
 }
 
-ValidationError ValidatorsStore::ValidateBody(const std::string& json_body, std::string& error_msg)
+size_t ValidatorsStore::FindHeaderParam(const char* name, size_t length) const
+{
+    auto slot = header_slots_[HashHeaderName(name, name + length, header_seed_) & (header_slots_.size() - 1)];
+    if (slot && EqualsIgnoreCase(name, length, header_params_[slot - 1].name)) {
+        return slot - 1;
+    }
+    return std::string::npos;
+}
+
+// 64-bit FNV-1a of the lower-cased name, the seed selects a different function of the family
+uint64_t ValidatorsStore::HashHeaderName(const char* beg, const char* const end, uint64_t seed)
+{
+    uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+    for (; beg < end; ++beg) {
+        hash ^= static_cast<unsigned char>(ToLower(*beg));
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ (hash >> 32);
+}
+
+bool ValidatorsStore::EqualsIgnoreCase(const char* lhs, size_t lhs_length, const std::string& lower)
+{
+    if (lhs_length != lower.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs_length; ++i) {
+        if (ToLower(lhs[i]) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ValidationError ValidatorsStore::ValidateBody(const std::string& json_body, BodyParser parser,
+                                              std::string& error_msg) const
+{
+    if (body_validator_) {
+        return body_validator_->Validate(json_body.data(), json_body.size(), parser, error_msg);
+    }
+    return ValidationError::NONE; // No validator, no error
+}
+
+ValidationError ValidatorsStore::ValidateBody(const char* json_body, size_t length, BodyParser parser,
+                                              std::string& error_msg, const ValidationDeadline* deadline) const
+{
+    if (!body_validator_) {
+        return ValidationError::NONE; // No validator, no error
+    }
+    if (BodySamplingMode::ALL == body_sampler_.GetMode()) {
+        return body_validator_->Validate(json_body, length, parser, error_msg, deadline);
+    }
+    if (!body_sampler_.Sample()) {
+        return ValidationError::NONE;
+    }
+    const auto start = BodySampler::Now();
+    const auto err_code = body_validator_->Validate(json_body, length, parser, error_msg, deadline);
+    body_sampler_.Record(static_cast<uint64_t>(BodySampler::Now() - start));
+    return err_code;
+}
+
+ValidationError ValidatorsStore::ValidateBody(const char* json_body, size_t length, BodyParser parser,
+                                              rapidjson::Document& doc, std::string& error_msg,
+                                              const ValidationDeadline* deadline) const
+{
+    if (body_validator_) {
+        return body_validator_->Validate(json_body, length, parser, doc, error_msg, deadline);
+    }
+    doc.SetNull();
+    return ValidationError::NONE; // No validator, no error
+}
+
+ValidationError ValidatorsStore::ValidateBody(const rapidjson::Value& json_body, std::string& error_msg) const
 {
     if (body_validator_) {
         return body_validator_->Validate(json_body, error_msg);
@@ -45,12 +174,12 @@ ValidationError ValidatorsStore::ValidateBody(const std::string& json_body, std:
 }
 
 ValidationError ValidatorsStore::ValidatePathParams(std::unordered_map<size_t, ParamRange>& param_idxs,
-                                                    std::string& error_msg)
+                                                    std::string& error_msg, ParamValues* values) const
 {
-    for (auto& param_validator : path_param_validators_) {
+    for (const auto& param_validator : path_param_validators_) {
         try {
             auto const& range = param_idxs.at(param_validator.idx);
-            auto err_code = param_validator.validator->ValidateParam(range.beg, range.end, error_msg);
+            auto err_code = param_validator.validator->ValidateParam(range.beg, range.end, error_msg, values);
             CHECK_ERROR(err_code)
         } catch (const std::out_of_range&) {
             return param_validator.validator->ErrorOnMissing(error_msg);
@@ -60,7 +189,8 @@ ValidationError ValidatorsStore::ValidatePathParams(std::unordered_map<size_t, P
     return ValidationError::NONE;
 }
 
-ValidationError ValidatorsStore::ValidateQueryParams(const std::string& query, std::string& error_msg)
+ValidationError ValidatorsStore::ValidateQueryParams(const std::string& query, std::string& error_msg,
+                                                     ParamValues* values) const
 {
     std::set<size_t> starts;
     std::unordered_map<std::string, size_t> start_map;
@@ -83,26 +213,29 @@ ValidationError ValidatorsStore::ValidateQueryParams(const std::string& query, s
     }
     starts.emplace(query.length() + 1);
 
-    for (auto& param_validator : query_param_validators_) {
+    for (const auto& param_validator : query_param_validators_) {
         try {
             auto start = start_map.at(param_validator.name);
             auto end = (*std::next(starts.find(start))) - 1;
             auto err_code = param_validator.validator->ValidateParam(query.data() + start, query.data() + end,
-                                                                     error_msg);
+                                                                     error_msg, values);
             CHECK_ERROR(err_code)
         } catch (const std::out_of_range&) {
             if (param_validator.validator->IsRequired()) {
                 return param_validator.validator->ErrorOnMissing(error_msg);
             }
+            if (values) {
+                ParamValuesBuilder::AddMissing(*values, param_validator.name);
+            }
         }
     }
     return ValidationError::NONE;
 }
 
 ValidationError ValidatorsStore::ValidateHeaderParams(const std::unordered_map<std::string, std::string>& headers,
-                                                      std::string& error_msg)
+                                                      std::string& error_msg) const
 {
-    for (auto& header_validator : header_param_validators_) {
+    for (const auto& header_validator : header_param_validators_) {
         try {
             const auto& param = headers.at(header_validator.first);
             auto err_code = header_validator.second->ValidateParam(param.data(), param.data() + param.size(),
@@ -116,12 +249,120 @@ ValidationError ValidatorsStore::ValidateHeaderParams(const std::unordered_map<s
     }
     return ValidationError::NONE;
 }
+
+ValidationError ValidatorsStore::ValidateHeaderParams(const HeaderField* headers, size_t count,
+                                                      std::string& error_msg) const
+{
+    if (header_params_.empty()) {
+        return ValidationError::NONE;
+    }
+
+    uint64_t seen = 0; // Presence of the first 64 declared headers
+    for (size_t i = 0; i < count; ++i) {
+        const auto& header = headers[i];
+        auto idx = FindHeaderParam(header.name, header.name_length);
+        if (std::string::npos == idx) {
+            continue;
+        }
+        auto err_code =
+            header_params_[idx].validator->ValidateParam(header.value, header.value + header.value_length, error_msg);
+        CHECK_ERROR(err_code)
+        if (idx < 64) {
+            seen |= uint64_t(1) << idx;
+        }
+    }
+
+    for (size_t idx = 0; idx < header_params_.size(); ++idx) {
+        const auto& header_param = header_params_[idx];
+        if (!header_param.validator->IsRequired()) {
+            continue;
+        }
+        bool present = false;
+        if (idx < 64) {
+            present = (seen >> idx) & 1;
+        } else {
+            for (size_t i = 0; i < count && !present; ++i) {
+                present = EqualsIgnoreCase(headers[i].name, headers[i].name_length, header_param.name);
+            }
+        }
+        if (!present) {
+            return header_param.validator->ErrorOnMissing(error_msg);
+        }
+    }
+    return ValidationError::NONE;
+}
+
+size_t ValidatorsStore::GetValidatorCount() const
+{
+    return (body_validator_ ? 1 : 0) + path_param_validators_.size() + query_param_validators_.size() +
+           header_param_validators_.size();
+}
+
+void ValidatorsStore::AppendSpecRefs(std::vector<SpecRefTable::Id>& ids) const
+{
+    if (body_validator_) {
+        ids.push_back(body_validator_->GetSpecRef());
+    }
+    for (const auto& param_validator : path_param_validators_) {
+        ids.push_back(param_validator.validator->GetSpecRef());
+    }
+    for (const auto& param_validator : query_param_validators_) {
+        ids.push_back(param_validator.validator->GetSpecRef());
+    }
+    for (const auto& header_param : header_params_) {
+        ids.push_back(header_param.validator->GetSpecRef());
+    }
+}
+
+CheckOrder& ValidatorsStore::GetCheckOrder() const
+{
+    return check_order_;
+}
+
+const BodySampler* ValidatorsStore::GetBodySampler() const
+{
+    return body_validator_ ? &body_sampler_ : nullptr;
+}
+
+size_t ValidatorsStore::GetMemoryUsage(MemoryReport& report) const
+{
+    size_t bytes = sizeof(*this);
+    if (body_validator_) {
+        bytes += sizeof(BodyValidator) + body_validator_->GetMemoryUsage(report);
+    }
+    bytes += path_param_validators_.capacity() * sizeof(PathParamValidatorInfo);
+    for (const auto& param_validator : path_param_validators_) {
+        bytes += sizeof(PathParamValidator) + param_validator.validator->GetMemoryUsage(report);
+    }
+    bytes += query_param_validators_.capacity() * sizeof(QueryParamValidatorInfo);
+    for (const auto& param_validator : query_param_validators_) {
+        bytes += GetHeapSize(param_validator.name) + sizeof(QueryParamValidator) +
+                 param_validator.validator->GetMemoryUsage(report);
+    }
+    bytes += GetHashMapHeapSize(header_param_validators_) +
+             header_params_.capacity() * sizeof(HeaderParamValidatorInfo) + header_slots_.capacity() * sizeof(uint32_t);
+    for (const auto& header_param : header_params_) {
+        bytes += GetHeapSize(header_param.name);
+    }
+    for (const auto& header_validator : header_param_validators_) {
+        bytes += GetHeapSize(header_validator.first) + sizeof(HeaderParamValidator) +
+                 header_validator.second->GetMemoryUsage(report);
+    }
+    return bytes;
+}
+
 ValidatorsStore::~ValidatorsStore()
 {
 #ifndef LUA_OAS_VALIDATOR // LUA manages garbage collection itself
+    for (auto& param_validator : path_param_validators_) {
+        delete param_validator.validator;
+    }
     for (auto& param_validator : query_param_validators_) {
         delete param_validator.validator;
     }
+    for (auto& header_validator : header_param_validators_) {
+        delete header_validator.second;
+    }
     delete body_validator_;
 #endif
 }
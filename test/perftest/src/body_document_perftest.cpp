@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <rapidjson/document.h>
+#include <string>
+
+namespace {
+// What a handler computes from the order
+int64_t Quantity(const rapidjson::Value& order)
+{
+    int64_t quantity = 0;
+    for (const auto& line : order.GetArray()) {
+        quantity += line["quantity"].GetInt64();
+    }
+    return quantity;
+}
+
+void ParsersAndSizes(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"parser", "bytes"});
+    for (auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        for (auto length : {1 << 10, 64 << 10}) {
+            bench->Args({static_cast<int64_t>(parser), length});
+        }
+    }
+}
+
+ValidatorOptions MakeOptions(const benchmark::State& state)
+{
+    ValidatorOptions options;
+    options.body_parser = static_cast<BodyParser>(state.range(0));
+    return options;
+}
+} // namespace
+
+// Validation of the body, followed by the handler parsing it again
+static void BodyValidateThenParse(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs, {}, MakeOptions(state));
+    const auto body = MakeOrder(static_cast<size_t>(state.range(1)));
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateBody("POST", "/orders/42", body, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+        rapidjson::Document order;
+        order.Parse(body.c_str(), body.size());
+        benchmark::DoNotOptimize(Quantity(order));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+
+// Validation handing the parsed body over to the handler
+static void BodyValidateIntoDocument(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs, {}, MakeOptions(state));
+    const auto body = MakeOrder(static_cast<size_t>(state.range(1)));
+    std::string err_msg;
+    for (auto _ : state) {
+        rapidjson::Document order;
+        if (ValidationError::NONE != validator.ValidateBody("POST", "/orders/42", body, order, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(Quantity(order));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+
+// Validation of a body the host already parsed, e.g. by its framework
+static void BodyValidateParsed(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs, {}, MakeOptions(state));
+    const auto body = MakeOrder(static_cast<size_t>(state.range(1)));
+    std::string err_msg;
+    for (auto _ : state) {
+        rapidjson::Document order;
+        order.Parse(body.c_str(), body.size());
+        if (ValidationError::NONE != validator.ValidateBody("POST", "/orders/42", order, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(Quantity(order));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+
+BENCHMARK(BodyValidateThenParse)->Apply(ParsersAndSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BodyValidateIntoDocument)->Apply(ParsersAndSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BodyValidateParsed)->Apply(ParsersAndSizes)->Unit(benchmark::kMicrosecond);
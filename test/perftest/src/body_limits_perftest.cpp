@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+// Any JSON is valid, only the limits stand between a hostile body and the validator
+const std::string kSpecs(
+    R"({"openapi":"3.0.0","paths":{"/any":{"post":{"requestBody":{"content":{"application/json":{"schema":{}}}}}}}})");
+
+std::string MakeDeepArray()
+{
+    const size_t depth = 10000; // Unlimited validation costs grow with the square of the depth
+    return std::string(depth, '[') + std::string(depth, ']');
+}
+
+std::string MakeWideObject()
+{
+    std::string body("{");
+    for (size_t idx = 0; idx < 1000000; ++idx) {
+        body += (idx ? ",\"k" : "\"k") + std::to_string(idx) + "\":0";
+    }
+    return body + "}";
+}
+
+std::string MakeLongArray()
+{
+    std::string body("[0");
+    for (size_t idx = 1; idx < 1000000; ++idx) {
+        body += ",0";
+    }
+    return body + "]";
+}
+
+std::string MakeLongString()
+{
+    return "\"" + std::string(16 * 1024 * 1024, 'x') + "\"";
+}
+
+// The hostile body with the parser of the first argument, limited when the second is 1
+void ValidateHostileBody(benchmark::State& state, const std::string& body)
+{
+    ValidatorOptions options;
+    options.body_parser = static_cast<BodyParser>(state.range(0));
+    if (state.range(1)) {
+        options.body_limits.max_depth = 64;
+        options.body_limits.max_array_items = 1024;
+        options.body_limits.max_object_members = 1024;
+        options.body_limits.max_string_length = 4096;
+    }
+    OASValidator validator(kSpecs, {}, options);
+    const auto expected = state.range(1) ? ValidationError::INVALID_BODY : ValidationError::NONE;
+    std::string err_msg;
+    for (auto _ : state) {
+        if (expected != validator.ValidateBody("POST", "/any", body, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+} // namespace
+
+// 10k nested arrays
+static void LimitsDeepArray(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    static const auto body = MakeDeepArray();
+    ValidateHostileBody(state, body);
+}
+
+// An object of a million members
+static void LimitsWideObject(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    static const auto body = MakeWideObject();
+    ValidateHostileBody(state, body);
+}
+
+// An array of a million items
+static void LimitsLongArray(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    static const auto body = MakeLongArray();
+    ValidateHostileBody(state, body);
+}
+
+// A 16 MiB string
+static void LimitsLongString(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    static const auto body = MakeLongString();
+    ValidateHostileBody(state, body);
+}
+
+BENCHMARK(LimitsDeepArray)
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->ArgNames({"parser", "limited"})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(LimitsWideObject)
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->ArgNames({"parser", "limited"})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(LimitsLongArray)
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->ArgNames({"parser", "limited"})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(LimitsLongString)
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->ArgNames({"parser", "limited"})
+    ->Unit(benchmark::kMicrosecond);
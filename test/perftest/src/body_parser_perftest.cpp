@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+const std::string kBatchSpecs(
+    R"({"openapi":"3.0.0","info":{"title":"Batch","version":"1.0.0"},"paths":{"/batch":{"post":{"requestBody":)"
+    R"({"content":{"application/json":{"schema":{"type":"object","required":["items"],"properties":{)"
+    R"("items":{"type":"array","items":{"type":"object","required":["id","name","price"],"properties":{)"
+    R"("id":{"type":"integer","minimum":1},)"
+    R"("name":{"type":"string","maxLength":64},)"
+    R"("price":{"type":"number","minimum":0},)"
+    R"("active":{"type":"boolean"},)"
+    R"("tags":{"type":"array","items":{"type":"string"}},)"
+    R"("note":{"type":["string","null"]},)"
+    R"("address":{"type":"object","properties":{"city":{"type":"string"},"zip":{"type":"string"}}}}}}}}}}}}}}})");
+
+// Indented like a typical client would send it, at least `length` bytes
+std::string MakeBatch(size_t length)
+{
+    std::string body("{\n  \"items\": [\n");
+    for (size_t id = 1; body.size() < length; ++id) {
+        if (id > 1) {
+            body += ",\n";
+        }
+        body += "    {\n      \"id\": " + std::to_string(id) + ",\n      \"name\": \"Item number " +
+                std::to_string(id) +
+                " with a \\\"quoted\\\" part\",\n"
+                "      \"price\": " +
+                std::to_string(id % 1000) +
+                ".25,\n      \"active\": true,\n      \"tags\": [\"red\", \"large\", \"sale\"],\n"
+                "      \"note\": null,\n      \"address\": {\"city\": \"Springfield\", \"zip\": \"12345\"}\n    }";
+    }
+    body += "\n  ]\n}\n";
+    return body;
+}
+
+void ParsersAndSizes(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"parser", "bytes"});
+    for (auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        for (auto length : {1 << 10, 16 << 10, 256 << 10, 4 << 20, 50 << 20}) {
+            bench->Args({static_cast<int64_t>(parser), length});
+        }
+    }
+}
+} // namespace
+
+// Whole body validation, parser 0 is RapidJSON's reader building a document and 1 the structural index
+static void BodyParserValidate(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ValidatorOptions options;
+    options.body_parser = static_cast<BodyParser>(state.range(0));
+    OASValidator validator(kBatchSpecs, {}, options);
+    const auto body = MakeBatch(static_cast<size_t>(state.range(1)));
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateBody("POST", "/batch", body, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+
+BENCHMARK(BodyParserValidate)->Apply(ParsersAndSizes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+
+// Requests sent back to back, as many as one thread can validate: far more bodies than the budget of the first
+// argument, in milliseconds of validation per second, covers. 0 validates every body, uncounted. `cpu_share` is the
+// validation time per second of wall time, held to the budget, and `checked` the share of the bodies validated.
+static void SamplingOverload(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ValidatorOptions options;
+    if (state.range(0)) {
+        options.body_sampling.mode = BodySamplingMode::CPU_BUDGET;
+        options.body_sampling.budget_ns_per_second = static_cast<uint64_t>(state.range(0)) * 1000000;
+    }
+    OASValidator validator(kOrderSpecs, {}, options);
+    const auto body = MakeOrder(64 << 10);
+    std::string err_msg;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateRequest("POST", "/orders/42", body, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    const auto wall = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    const auto stats = validator.GetBodySamplingStats().at(0);
+    if (state.range(0)) {
+        state.counters["cpu_share"] = static_cast<double>(stats.nanoseconds) / wall;
+        state.counters["checked"] =
+            static_cast<double>(stats.checked) / static_cast<double>(stats.checked + stats.skipped);
+    }
+}
+
+BENCHMARK(SamplingOverload)
+    ->ArgName("budget_ms")
+    ->Arg(0)
+    ->Arg(100)
+    ->Arg(250)
+    ->Unit(benchmark::kMicrosecond);
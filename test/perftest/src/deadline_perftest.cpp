@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+void ParsersSizesAndDeadlines(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"parser", "bytes", "deadline"});
+    for (auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        for (auto length : {1 << 10, 64 << 10}) {
+            for (auto deadline : {0, 1}) {
+                bench->Args({static_cast<int64_t>(parser), length, deadline});
+            }
+        }
+    }
+}
+} // namespace
+
+// A valid order, without a deadline (0) or with one that does not pass (1), for the cost of checking it
+static void DeadlineValidateRequest(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ValidatorOptions options;
+    options.body_parser = static_cast<BodyParser>(state.range(0));
+    OASValidator validator(kOrderSpecs, {}, options);
+    const auto body = MakeOrder(static_cast<size_t>(state.range(1)));
+    const char* const tenant = "X-Tenant";
+    const char* const acme = "acme";
+    const HeaderField headers[] = {HeaderField(tenant, 8, acme, 4)};
+    std::string err_msg;
+    for (auto _ : state) {
+        ValidationError result;
+        if (state.range(2)) {
+            ValidationDeadline deadline;
+            deadline.time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            result = validator.ValidateRequest("POST", "/orders/42", body, headers, 1, deadline, err_msg);
+        } else {
+            result = validator.ValidateRequest("POST", "/orders/42", body, headers, 1, err_msg);
+        }
+        if (ValidationError::NONE != result) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+
+BENCHMARK(DeadlineValidateRequest)->Apply(ParsersSizesAndDeadlines)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+// Every generated resource declares the same page/limit query, X-Request-Id header and body schema
+static void LoadSpecsWithParamReuse(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const std::string specs = GenerateSpecs(static_cast<size_t>(state.range(0)));
+    double heap_bytes = 0;
+    for (auto _ : state) {
+        const double heap_before = HeapInUse();
+        OASValidator validator(specs);
+        heap_bytes = HeapInUse() - heap_before;
+        benchmark::DoNotOptimize(validator);
+    }
+    state.counters["heap_bytes"] = heap_bytes;
+}
+
+BENCHMARK(LoadSpecsWithParamReuse)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+// Headers as received by a proxy: arbitrary casing, undeclared headers mixed with the declared ones
+const std::vector<std::pair<std::string, std::string>> kRawHeaders = {
+    {"Host", "api.example.com"},
+    {"User-Agent", "Mozilla/5.0 (X11; Linux x86_64)"},
+    {"Accept", "application/json"},
+    {"Accept-Encoding", "gzip, deflate, br"},
+    {"ObjectHeader", "field1=0,field2=string"},
+    {"Connection", "keep-alive"},
+    {"Cache-Control", "no-cache"},
+    {"STRINGHEADER", "value"},
+    {"X-Forwarded-For", "203.0.113.7"},
+    {"X-Request-Id", "3f2c1a9e-7c1b-4b8e-9a57-2f5d0c1e8b44"},
+};
+} // namespace
+
+// Proxy lower-cases the names and builds a map on every request
+static void HeadersByMap(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(SPEC_PATH);
+    std::string err_msg;
+    for (auto _ : state) {
+        std::unordered_map<std::string, std::string> headers;
+        for (const auto& raw_header : kRawHeaders) {
+            std::string name(raw_header.first);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            headers.emplace(std::move(name), raw_header.second);
+        }
+        headers["objectHeader"] = headers["objectheader"]; // Spec casing for the case-sensitive lookup
+        headers["stringHeader"] = headers["stringheader"];
+        benchmark::DoNotOptimize(validator.ValidateHeaders("GET", "/test/header_double5", headers, err_msg));
+    }
+}
+
+BENCHMARK(HeadersByMap);
+
+// Views over the received headers, no copies
+static void HeadersByFieldList(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(SPEC_PATH);
+    std::string err_msg;
+    std::vector<HeaderField> headers;
+    for (const auto& raw_header : kRawHeaders) {
+        headers.emplace_back(raw_header.first, raw_header.second);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            validator.ValidateHeaders("GET", "/test/header_double5", headers.data(), headers.size(), err_msg));
+    }
+}
+
+BENCHMARK(HeadersByFieldList);
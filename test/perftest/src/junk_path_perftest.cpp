@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t kResources = 100;
+
+// Paths commonly probed by scanners
+const char* const kJunkPaths[] = {
+    "/wp-admin",
+    "/wp-login.php",
+    "/.env",
+    "/.git/config",
+    "/phpmyadmin/index.php",
+    "/admin/config.php",
+    "/cgi-bin/luci/;stok=/locale",
+    "/resource7/1/../../../etc/passwd",
+    "/resource12/42/.env",
+    "/api/v1/pods",
+    "/vendor/phpunit/phpunit/src/Util/PHP/eval-stdin.php",
+    "/actuator/health",
+};
+} // namespace
+
+// Routing of GET requests where the given percentage are scanner probes, in a fixed random order
+static void MixedTraffic(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const auto junk_percent = static_cast<size_t>(state.range(0));
+    OASValidator validator(GenerateSpecs(kResources));
+    std::vector<std::string> paths;
+    std::vector<bool> valid;
+    std::mt19937 random(42);
+    for (size_t i = 0; i < 1024; ++i) {
+        valid.push_back(random() % 100 >= junk_percent);
+        paths.emplace_back(valid.back() ? "/resource" + std::to_string(random() % kResources) + "/42?page=2"
+                                        : kJunkPaths[random() % (sizeof(kJunkPaths) / sizeof(kJunkPaths[0]))]);
+    }
+    const std::string method("GET");
+    std::string err_msg;
+    size_t i = 0;
+    for (auto _ : state) {
+        const size_t idx = i++ % paths.size();
+        if (valid[idx] != (ValidationError::NONE == validator.ValidateRoute(method, paths[idx], err_msg))) {
+            state.SkipWithError(paths[idx].c_str());
+            break;
+        }
+    }
+}
+
+BENCHMARK(MixedTraffic)->ArgName("junk%")->Arg(0)->Arg(50)->Arg(90)->Arg(100);
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <rapidjson/document.h>
+#include <string>
+
+// Memory footprint of a loaded spec, reported as counters so that it can be tracked between spec versions and
+// releases. The spec is taken from OAS_MEMORY_REPORT_SPEC (default: the example spec) and the full JSON report is
+// written to OAS_MEMORY_REPORT_OUT if set, e.g.
+// OAS_MEMORY_REPORT_SPEC=api.json OAS_MEMORY_REPORT_OUT=out.json oasvalidator-perftests --benchmark_filter=MemoryReport
+static void SetMemoryCounters(benchmark::State& state, const std::string& json_report)
+{
+    rapidjson::Document report;
+    report.Parse(json_report.c_str());
+    if (report.HasParseError()) {
+        state.SkipWithError("Invalid memory report");
+        return;
+    }
+    state.counters["total_bytes"] = static_cast<double>(report["totalBytes"].GetUint64());
+    state.counters["routing_bytes"] = static_cast<double>(report["routing"]["pathTrieBytes"].GetUint64() +
+                                                          report["routing"]["routeMapBytes"].GetUint64());
+    state.counters["trie_nodes"] = static_cast<double>(report["routing"]["pathTrieNodes"].GetUint64());
+    state.counters["routes"] = static_cast<double>(report["routes"]["count"].GetUint64());
+    state.counters["route_bytes"] = static_cast<double>(report["routes"]["bytes"].GetUint64());
+    state.counters["schemas"] = static_cast<double>(report["schemas"]["compiled"].GetUint64());
+    state.counters["schemas_shared"] = static_cast<double>(report["schemas"]["shared"].GetUint64());
+    state.counters["schemas_duplicated"] = static_cast<double>(report["schemas"]["duplicated"].GetUint64());
+    state.counters["schema_bytes"] = static_cast<double>(report["schemas"]["bytes"].GetUint64());
+    state.counters["deserializer_bytes"] = static_cast<double>(report["deserializers"]["bytes"].GetUint64());
+    state.counters["spec_ref_bytes"] = static_cast<double>(report["specRefs"]["bytes"].GetUint64());
+}
+
+static void MemoryReport(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const char* spec_path = std::getenv("OAS_MEMORY_REPORT_SPEC");
+    OASValidator validator(spec_path ? spec_path : SPEC_PATH);
+    std::string json_report;
+    for (auto _ : state) {
+        json_report = validator.GetMemoryReport();
+        benchmark::DoNotOptimize(json_report);
+    }
+    SetMemoryCounters(state, json_report);
+
+    const char* out_path = std::getenv("OAS_MEMORY_REPORT_OUT");
+    if (out_path) {
+        std::ofstream(out_path) << json_report;
+    }
+}
+
+BENCHMARK(MemoryReport)->Unit(benchmark::kMillisecond);
+
+static void MemoryReportGenerated(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(GenerateSpecs(static_cast<size_t>(state.range(0))));
+    std::string json_report;
+    for (auto _ : state) {
+        json_report = validator.GetMemoryReport();
+        benchmark::DoNotOptimize(json_report);
+    }
+    SetMemoryCounters(state, json_report);
+}
+
+BENCHMARK(MemoryReportGenerated)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
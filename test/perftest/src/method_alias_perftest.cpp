@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t kResources = 100;
+
+// Templated GET routes requested as GET, as HEAD mapped to GET, and static POST routes requested with a custom verb
+// whose aliases only define them last
+const char* const kMethods[] = {"GET", "HEAD", "PURGE"};
+} // namespace
+
+static void AliasedRoute(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const auto mode = static_cast<size_t>(state.range(0));
+    OASValidator validator(GenerateSpecs(kResources), {{"HEAD", {"GET"}}, {"PURGE", {"PUT", "DELETE", "POST"}}});
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < kResources; ++i) {
+        paths.push_back("/resource" + std::to_string(i) + (2 == mode ? "" : "/42?page=2"));
+    }
+    const std::string method(kMethods[mode]);
+    std::string err_msg;
+    size_t i = 0;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateRoute(method, paths[i++ % kResources], err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    state.SetLabel(method);
+}
+
+BENCHMARK(AliasedRoute)->ArgName("mode")->DenseRange(0, 2);
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+const char* const kSpecs = R"({
+  "openapi": "3.0.0",
+  "paths": {
+    "/users/{userId}/posts": {
+      "get": {
+        "parameters": [
+          {"name": "userId", "in": "path", "required": true, "schema": {"type": "integer", "minimum": 1}},
+          {"name": "q", "in": "query", "schema": {"type": "string", "maxLength": 64}},
+          {"name": "tags", "in": "query", "explode": false,
+           "schema": {"type": "array", "items": {"type": "string"}, "maxItems": 8}},
+          {"name": "limit", "in": "query", "schema": {"type": "integer", "minimum": 1, "maximum": 100}},
+          {"name": "draft", "in": "query", "schema": {"type": "boolean"}}
+        ]
+      }
+    }
+  }
+})";
+
+const std::string kMethod("GET");
+const std::string kPath("/users/1234/posts?q=hello%20world&tags=news,sport,tech&limit=20&draft=false");
+
+// What a handler gets from the request
+struct Request
+{
+    int64_t user_id = 0;
+    std::string q{};
+    std::vector<std::string> tags{};
+    int64_t limit = 10;
+    bool draft = false;
+};
+
+int HexValue(char c)
+{
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+}
+
+void PercentDecode(const char* beg, const char* end, std::string& out)
+{
+    out.clear();
+    for (; beg < end; ++beg) {
+        if ('%' == *beg && end - beg > 2) {
+            out.push_back(static_cast<char>(HexValue(beg[1]) * 16 + HexValue(beg[2])));
+            beg += 2;
+        } else {
+            out.push_back(*beg);
+        }
+    }
+}
+
+// Parsing of the path and query string by the application, once they are validated
+void ParseRequest(const std::string& path, Request& request)
+{
+    const char* cursor = path.c_str() + sizeof("/users/") - 1;
+    request.user_id = std::strtoll(cursor, nullptr, 10);
+    const char* query = std::strchr(cursor, '?');
+    const char* const end = path.c_str() + path.size();
+    request.tags.clear();
+    for (const char* field = query + 1; field < end;) {
+        const char* field_end = std::find(field, end, '&');
+        const char* equal = std::find(field, field_end, '=');
+        const std::string name(field, equal);
+        const char* value = equal + 1;
+        if ("q" == name) {
+            PercentDecode(value, field_end, request.q);
+        } else if ("tags" == name) {
+            for (const char* item = value; item < field_end;) {
+                const char* item_end = std::find(item, field_end, ',');
+                request.tags.emplace_back();
+                PercentDecode(item, item_end, request.tags.back());
+                item = item_end + 1;
+            }
+        } else if ("limit" == name) {
+            request.limit = std::strtoll(value, nullptr, 10);
+        } else if ("draft" == name) {
+            request.draft = 0 == std::strncmp(value, "true", 4);
+        }
+        field = field_end + 1;
+    }
+}
+} // namespace
+
+// Validation of the path and query parameters only, for reference
+static void ValidateOnly(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateRequest(kMethod, kPath, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+}
+
+// Validation of the path and query parameters, followed by the application parsing them again
+static void ValidateThenParse(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    std::string err_msg;
+    Request request;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateRequest(kMethod, kPath, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+        ParseRequest(kPath, request);
+        benchmark::DoNotOptimize(request);
+    }
+}
+
+// Validation extracting the typed values, read by the application
+static void ValidateAndExtract(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    std::string err_msg;
+    ParamValues values;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateRequest(kMethod, kPath, values, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+        const auto& tags = values.Get(2);
+        int64_t sum = values.Get(0).integer + values.Get(3).integer + static_cast<int64_t>(values.Get(1).length);
+        for (size_t idx = 0; idx < tags.length; ++idx) {
+            sum += static_cast<int64_t>(tags.GetItem(idx).length);
+        }
+        sum += values.Get(4).boolean ? 1 : 0;
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(ValidateOnly);
+BENCHMARK(ValidateThenParse);
+BENCHMARK(ValidateAndExtract);
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t kResources = 100;
+
+enum PathShape
+{
+    CANONICAL = 0, // "/resource7/42"
+    BASE_PATH, // "/test/api/resource7/42"
+    UNNORMALIZED // "/test/api//resource7/./x/../42/"
+};
+
+std::string GetPath(PathShape shape, size_t resource)
+{
+    const std::string path = "/resource" + std::to_string(resource);
+    switch (shape) {
+    case BASE_PATH:
+        return "/test/api" + path + "/42?page=2";
+    case UNNORMALIZED:
+        return "/test/api/" + path + "/./x/../42/?page=2";
+    case CANONICAL:
+    default:
+        return path + "/42?page=2";
+    }
+}
+} // namespace
+
+// Routing of GET requests by path shape, with normalization disabled (0) or fully enabled (1)
+static void NormalizedRouting(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const auto shape = static_cast<PathShape>(state.range(0));
+    ValidatorOptions options;
+    if (0 != state.range(1)) {
+        options.path_normalization.strip_base_paths = true;
+        options.path_normalization.collapse_slashes = true;
+        options.path_normalization.remove_dot_segments = true;
+        options.path_normalization.decode_unreserved = true;
+    }
+    std::string specs = GenerateSpecs(kResources);
+    specs.insert(specs.find("\"paths\""), R"("servers":[{"url":"https://localhost/test/api"}],)");
+    OASValidator validator(specs, {}, options);
+
+    std::vector<std::string> paths;
+    std::mt19937 random(42);
+    for (size_t i = 0; i < 1024; ++i) {
+        paths.push_back(GetPath(shape, random() % kResources));
+    }
+    const std::string method("GET");
+    std::string err_msg;
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& path = paths[i++ % paths.size()];
+        if ((0 != state.range(1) || CANONICAL == shape) !=
+            (ValidationError::NONE == validator.ValidatePathParam(method, path, err_msg))) {
+            state.SkipWithError(path.c_str());
+            break;
+        }
+    }
+}
+
+BENCHMARK(NormalizedRouting)
+    ->ArgNames({"shape", "normalize"})
+    ->Args({CANONICAL, 0})
+    ->Args({CANONICAL, 1})
+    ->Args({BASE_PATH, 1})
+    ->Args({UNNORMALIZED, 1});
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+const std::string kGetRequest("GET /test/header_double5?trace=1 HTTP/1.1\r\n"
+                              "Host: api.example.com\r\n"
+                              "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+                              "Accept: application/json\r\n"
+                              "Accept-Encoding: gzip, deflate, br\r\n"
+                              "objectHeader: field1=0,field2=string\r\n"
+                              "Connection: keep-alive\r\n"
+                              "Cache-Control: no-cache\r\n"
+                              "stringHeader: value\r\n"
+                              "X-Forwarded-For: 203.0.113.7\r\n"
+                              "X-Request-Id: 3f2c1a9e-7c1b-4b8e-9a57-2f5d0c1e8b44\r\n"
+                              "\r\n");
+
+const std::string kPostRequest("POST /test/body_scenario5 HTTP/1.1\r\n"
+                               "Host: api.example.com\r\n"
+                               "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+                               "Accept: application/json\r\n"
+                               "Content-Type: application/json\r\n"
+                               "Content-Length: 36\r\n"
+                               "X-Request-Id: 3f2c1a9e-7c1b-4b8e-9a57-2f5d0c1e8b44\r\n"
+                               "\r\n"
+                               R"({"field1":123,"field2":"some value"})");
+
+// What an edge tier does today: copy the request line and header lines into strings and a map
+ValidationError SplitThenValidate(OASValidator& validator, const std::string& request, std::string& err_msg)
+{
+    auto line_end = request.find("\r\n");
+    const auto method_end = request.find(' ');
+    const auto path_end = request.find(' ', method_end + 1);
+    const std::string method(request.substr(0, method_end));
+    const std::string path(request.substr(method_end + 1, path_end - method_end - 1));
+
+    std::unordered_map<std::string, std::string> headers;
+    auto line = line_end + 2;
+    while ((line_end = request.find("\r\n", line)) != line) {
+        const auto colon = request.find(':', line);
+        auto value = colon + 1;
+        while (' ' == request[value]) {
+            ++value;
+        }
+        headers.emplace(request.substr(line, colon - line), request.substr(value, line_end - value));
+        line = line_end + 2;
+    }
+
+    if (line + 2 < request.size()) {
+        return validator.ValidateRequest(method, path, request.substr(line + 2), headers, err_msg);
+    }
+    return validator.ValidateRequest(method, path, headers, err_msg);
+}
+
+// Header list as delivered by an HTTP/2 library, pseudo-headers first
+struct Http2Request
+{
+    explicit Http2Request(const std::string& request)
+    {
+        const auto method_end = request.find(' ');
+        const auto path_end = request.find(' ', method_end + 1);
+        strings.reserve(64);
+        strings.emplace_back(":method");
+        strings.emplace_back(request.substr(0, method_end));
+        strings.emplace_back(":path");
+        strings.emplace_back(request.substr(method_end + 1, path_end - method_end - 1));
+        auto line = request.find("\r\n") + 2;
+        for (auto line_end = request.find("\r\n", line); line_end != line; line_end = request.find("\r\n", line)) {
+            const auto colon = request.find(':', line);
+            strings.emplace_back(request.substr(line, colon - line));
+            strings.emplace_back(request.substr(colon + 2, line_end - colon - 2));
+            line = line_end + 2;
+        }
+        for (size_t i = 0; i < strings.size(); i += 2) {
+            fields.emplace_back(strings[i], strings[i + 1]);
+        }
+    }
+
+    std::vector<std::string> strings{};
+    std::vector<HeaderField> fields{};
+};
+} // namespace
+
+static void RequestSplitThenValidate(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(SPEC_PATH);
+    const std::string& request = state.range(0) ? kPostRequest : kGetRequest;
+    std::string err_msg;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SplitThenValidate(validator, request, err_msg));
+    }
+}
+
+BENCHMARK(RequestSplitThenValidate)->ArgName("body")->Arg(0)->Arg(1);
+
+static void RequestRawHttp1(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(SPEC_PATH);
+    const std::string& request = state.range(0) ? kPostRequest : kGetRequest;
+    const auto head_length = request.find("\r\n\r\n") + 4;
+    std::string err_msg;
+    for (auto _ : state) {
+        if (head_length < request.size()) {
+            benchmark::DoNotOptimize(validator.ValidateHttp1Request(
+                request.data(), head_length, request.data() + head_length, request.size() - head_length, err_msg));
+        } else {
+            benchmark::DoNotOptimize(validator.ValidateHttp1Request(request.data(), head_length, err_msg));
+        }
+    }
+}
+
+BENCHMARK(RequestRawHttp1)->ArgName("body")->Arg(0)->Arg(1);
+
+static void RequestHttp2Fields(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(SPEC_PATH);
+    const std::string& request = state.range(0) ? kPostRequest : kGetRequest;
+    const auto body = request.find("\r\n\r\n") + 4;
+    const Http2Request http2_request(request);
+    const auto& fields = http2_request.fields;
+    std::string err_msg;
+    for (auto _ : state) {
+        if (body < request.size()) {
+            benchmark::DoNotOptimize(validator.ValidateHttp2Request(
+                fields.data(), fields.size(), request.data() + body, request.size() - body, err_msg));
+        } else {
+            benchmark::DoNotOptimize(validator.ValidateHttp2Request(fields.data(), fields.size(), err_msg));
+        }
+    }
+}
+
+BENCHMARK(RequestHttp2Fields)->ArgName("body")->Arg(0)->Arg(1);
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+
+// Full rebuild versus incremental reload, for a one-operation change in a large spec
+static void FullRebuild(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const auto num_resources = static_cast<size_t>(state.range(0));
+    const std::string specs_v1 = GenerateSpecs(num_resources, 1000);
+    const std::string specs_v2 = GenerateSpecs(num_resources, 2000);
+    bool flip = false;
+    for (auto _ : state) {
+        OASValidator validator(flip ? specs_v1 : specs_v2);
+        benchmark::DoNotOptimize(validator);
+        flip = !flip;
+    }
+    state.SetLabel(std::to_string(2 * num_resources) + " operations");
+}
+
+static void IncrementalReload(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const auto num_resources = static_cast<size_t>(state.range(0));
+    const std::string specs_v1 = GenerateSpecs(num_resources, 1000);
+    const std::string specs_v2 = GenerateSpecs(num_resources, 2000);
+    OASValidator validator(specs_v1);
+    bool flip = false;
+    for (auto _ : state) {
+        validator.ReloadSpecs(flip ? specs_v1 : specs_v2);
+        flip = !flip;
+    }
+    state.SetLabel(std::to_string(2 * num_resources) + " operations");
+}
+
+BENCHMARK(FullRebuild)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
+BENCHMARK(IncrementalReload)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond)->MeasureProcessCPUTime();
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t kResources = 100;
+constexpr size_t kDistinctPaths = 100000; // 1000 ids per resource
+
+// Paths drawn from a Zipfian distribution of exponent `skew` over kDistinctPaths concrete paths, ranked randomly
+std::vector<std::string> GetZipfianPaths(double skew, size_t count)
+{
+    std::vector<double> cumulative(kDistinctPaths);
+    double sum = 0;
+    for (size_t rank = 0; rank < kDistinctPaths; ++rank) {
+        sum += 1.0 / std::pow(static_cast<double>(rank + 1), skew);
+        cumulative[rank] = sum;
+    }
+    std::vector<size_t> path_of_rank(kDistinctPaths);
+    for (size_t i = 0; i < kDistinctPaths; ++i) {
+        path_of_rank[i] = i;
+    }
+    std::mt19937 random(42);
+    std::shuffle(path_of_rank.begin(), path_of_rank.end(), random);
+
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto rank =
+            static_cast<size_t>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) -
+                                cumulative.begin());
+        const size_t path = path_of_rank[std::min(rank, kDistinctPaths - 1)];
+        paths.push_back("/resource" + std::to_string(path % kResources) + "/" + std::to_string(path / kResources) +
+                        "?page=2");
+    }
+    return paths;
+}
+} // namespace
+
+// Routing of GET requests to concrete paths of Zipfian popularity, by route cache capacity. Skew is in hundredths.
+static void ZipfianRouting(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const auto paths = GetZipfianPaths(static_cast<double>(state.range(0)) / 100, 1 << 16);
+    ValidatorOptions options;
+    options.route_cache_capacity = static_cast<size_t>(state.range(1));
+    OASValidator validator(GenerateSpecs(kResources), {}, options);
+    const std::string method("GET");
+    std::string err_msg;
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& path = paths[i++ % paths.size()];
+        if (ValidationError::NONE != validator.ValidatePathParam(method, path, err_msg)) {
+            state.SkipWithError(path.c_str());
+            break;
+        }
+    }
+    const auto stats = validator.GetRouteCacheStats();
+    const auto lookups = static_cast<double>(stats.hits + stats.misses);
+    state.counters["hit%"] = 0 < lookups ? 100.0 * static_cast<double>(stats.hits) / lookups : 0;
+}
+
+BENCHMARK(ZipfianRouting)
+    ->ArgNames({"skew", "capacity"})
+    ->Args({80, 0})
+    ->Args({80, 4096})
+    ->Args({120, 0})
+    ->Args({120, 4096});
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t kResources = 100;
+} // namespace
+
+// Path and query parameters of templated GET routes, mode 0 routes the method and path, mode 1 uses handles resolved
+// beforehand as a framework that already routed the request would
+static void PreRoutedRequest(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const bool use_handles = 0 != state.range(0);
+    OASValidator validator(GenerateSpecs(kResources));
+    std::vector<std::string> paths;
+    std::vector<RouteHandle> routes(kResources);
+    std::string err_msg;
+    for (size_t i = 0; i < kResources; ++i) {
+        paths.push_back("/resource" + std::to_string(i) + "/42?page=2&limit=10");
+        validator.GetRoute("GET", "/resource" + std::to_string(i) + "/{id}", routes[i], err_msg);
+    }
+    const std::string method("GET");
+    size_t i = 0;
+    for (auto _ : state) {
+        const size_t idx = i++ % kResources;
+        auto err_code = use_handles ? validator.ValidateRequest(routes[idx], paths[idx], err_msg)
+                                    : validator.ValidateRequest(method, paths[idx], err_msg);
+        if (ValidationError::NONE != err_code) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    state.SetLabel(use_handles ? "handle" : "method+path");
+}
+
+BENCHMARK(PreRoutedRequest)->ArgName("handle")->DenseRange(0, 1);
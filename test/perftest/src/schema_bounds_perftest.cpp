@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+
+namespace {
+// Every input bounded by its schema: a search term, a tenant and a list of up to 16 scores
+const std::string kSpecs(
+    R"({"openapi":"3.0.0","paths":{"/scores":{"post":{"parameters":[)"
+    R"({"name":"term","in":"query","required":true,"schema":{"type":"string","maxLength":64}},)"
+    R"({"name":"X-Tenant","in":"header","required":true,"schema":{"type":"string","enum":["acme","umbrella"]}}],)"
+    R"("requestBody":{"content":{"application/json":{"schema":{"type":"array","maxItems":16,)"
+    R"("items":{"type":"integer","minimum":0,"maximum":100}}}}}}}}})");
+
+// Numbers are what attackers send: each is cheap to write and costly to parse
+std::string MakeScores(size_t count)
+{
+    std::string body("[");
+    for (size_t idx = 0; idx < count; ++idx) {
+        body += idx ? ", 1e308" : "1e308";
+    }
+    return body + "]";
+}
+} // namespace
+
+// A 64 KiB search term against maxLength 64
+static void BoundsOversizedQuery(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    const std::string path("/scores?term=" + std::string(64 * 1024, 'a'));
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::INVALID_QUERY_PARAM != validator.ValidateQueryParam("POST", path, err_msg)) {
+            state.SkipWithError("Not rejected by its query");
+            break;
+        }
+    }
+}
+
+// A 64 KiB tenant against an enum
+static void BoundsOversizedHeader(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    const std::unordered_map<std::string, std::string> headers{{"X-Tenant", std::string(64 * 1024, 'x')}};
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::INVALID_HEADER_PARAM != validator.ValidateHeaders("POST", "/scores", headers, err_msg)) {
+            state.SkipWithError("Not rejected by its header");
+            break;
+        }
+    }
+}
+
+// A 1 MiB array of numbers against maxItems 16
+static void BoundsOversizedBody(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    const auto body = MakeScores(1024 * 1024 / 7);
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::INVALID_BODY != validator.ValidateBody("POST", "/scores", body, err_msg)) {
+            state.SkipWithError("Not rejected by its body");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+
+// A valid body, for the cost of counting its bytes
+static void BoundsValidBody(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    const std::string body("[0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 90, 80, 70, 60, 50]");
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateBody("POST", "/scores", body, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+}
+
+BENCHMARK(BoundsOversizedQuery);
+BENCHMARK(BoundsOversizedHeader);
+BENCHMARK(BoundsOversizedBody);
+BENCHMARK(BoundsValidBody);
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+// Enqueued requests are for a route the specification lacks, so that the background thread keeps up with them
+const char* const kUnknownPath = "/carts/42";
+
+// Waits, untimed, for the background thread every half queue, so that no request is dropped
+void FlushEveryHalfQueue(benchmark::State& state, ShadowValidator& shadow, size_t& queued)
+{
+    if (++queued == ShadowOptions().queue_capacity / 2) {
+        state.PauseTiming();
+        shadow.Flush();
+        queued = 0;
+        state.ResumeTiming();
+    }
+}
+} // namespace
+
+// Cost on the request thread of copying a request, with a body of the size of the argument, into the queue
+static void ShadowEnqueueCopy(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs);
+    ShadowValidator shadow(validator);
+    const auto body = MakeOrder(static_cast<size_t>(state.range(0)));
+    const HeaderField headers[] = {HeaderField("X-Tenant", 8, "acme", 4), HeaderField("Accept", 6, "*/*", 3)};
+    size_t queued = 0;
+    for (auto _ : state) {
+        if (!shadow.Enqueue("POST", kUnknownPath, body, headers, 2)) {
+            state.SkipWithError("Dropped");
+            break;
+        }
+        FlushEveryHalfQueue(state, shadow, queued);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// Same, handing over the request: its buffers are swapped with those of a slot, the body is not copied. The requests
+// come back empty, they are rebuilt untimed, as the caller would build its next ones, while waiting every half queue.
+static void ShadowEnqueueMove(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs);
+    ShadowValidator shadow(validator);
+    const auto body = MakeOrder(static_cast<size_t>(state.range(0)));
+    std::vector<ShadowRequest> requests(ShadowOptions().queue_capacity / 2);
+    auto build = [&requests, &body]() {
+        for (auto& request : requests) {
+            request.method = "POST";
+            request.http_path = kUnknownPath;
+            request.json_body = body;
+            request.headers.assign({{"X-Tenant", "acme"}, {"Accept", "*/*"}});
+            request.has_body = true;
+        }
+    };
+    build();
+    size_t queued = 0;
+    for (auto _ : state) {
+        if (!shadow.Enqueue(std::move(requests[queued]))) {
+            state.SkipWithError("Dropped");
+            break;
+        }
+        if (++queued == requests.size()) {
+            state.PauseTiming();
+            shadow.Flush();
+            build();
+            queued = 0;
+            state.ResumeTiming();
+        }
+    }
+}
+
+// Cost of dropping a request, the background thread being held by the first one
+static void ShadowEnqueueFull(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs);
+    std::atomic<bool> held{true};
+    ShadowOptions options;
+    options.queue_capacity = 2;
+    ShadowValidator shadow(validator, options, [&held](const ShadowRequest&, ValidationError, const std::string&) {
+        while (held) {
+            std::this_thread::yield();
+        }
+    });
+    const auto body = MakeOrder(1 << 10);
+    for (size_t idx = 0; idx < 2; ++idx) {
+        shadow.Enqueue("POST", "/orders/0", body, nullptr, 0); // Invalid, the first is held in the callback
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shadow.Enqueue("POST", "/orders/42", body, nullptr, 0));
+    }
+    held = false;
+    state.counters["dropped"] = static_cast<double>(shadow.GetStats().dropped);
+}
+
+// Inline validation of the same request, for comparison
+static void ShadowInlineValidation(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kOrderSpecs);
+    const auto body = MakeOrder(static_cast<size_t>(state.range(0)));
+    const HeaderField headers[] = {HeaderField("X-Tenant", 8, "acme", 4), HeaderField("Accept", 6, "*/*", 3)};
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateRequest("POST", "/orders/42", body, headers, 2, err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(ShadowEnqueueCopy)->ArgName("bytes")->Arg(1 << 10)->Arg(64 << 10);
+BENCHMARK(ShadowEnqueueMove)->ArgName("bytes")->Arg(1 << 10)->Arg(64 << 10);
+BENCHMARK(ShadowEnqueueFull);
+BENCHMARK(ShadowInlineValidation)->ArgName("bytes")->Arg(1 << 10)->Arg(64 << 10)->Unit(benchmark::kMicrosecond);
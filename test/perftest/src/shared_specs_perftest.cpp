@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t kWorkers = 64;
+constexpr size_t kResources = 200;
+} // namespace
+
+// 64 worker-local instances copied from one loaded validator, they share the compiled spec
+static void WorkerInstancesByCopy(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(GenerateSpecs(kResources));
+    double heap_bytes = 0;
+    for (auto _ : state) {
+        const double heap_before = HeapInUse();
+        std::vector<OASValidator> workers(kWorkers, validator);
+        heap_bytes = HeapInUse() - heap_before;
+        benchmark::DoNotOptimize(workers.data());
+    }
+    state.counters["heap_bytes"] = heap_bytes;
+    state.counters["heap_bytes_per_worker"] = heap_bytes / kWorkers;
+}
+
+// 64 worker-local instances each compiling its own copy of the spec
+static void WorkerInstancesByLoad(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const std::string specs = GenerateSpecs(kResources);
+    double heap_bytes = 0;
+    for (auto _ : state) {
+        const double heap_before = HeapInUse();
+        std::vector<OASValidator> workers;
+        workers.reserve(kWorkers);
+        for (size_t i = 0; i < kWorkers; ++i) {
+            workers.emplace_back(specs);
+        }
+        heap_bytes = HeapInUse() - heap_before;
+        benchmark::DoNotOptimize(workers.data());
+    }
+    state.counters["heap_bytes"] = heap_bytes;
+    state.counters["heap_bytes_per_worker"] = heap_bytes / kWorkers;
+}
+
+BENCHMARK(WorkerInstancesByCopy)->Unit(benchmark::kMicrosecond);
+BENCHMARK(WorkerInstancesByLoad)->Unit(benchmark::kMillisecond)->Iterations(3);
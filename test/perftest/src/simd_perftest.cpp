@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "utils/simd.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+// Form-encoded words, one escape or '+' every 10 bytes or so
+std::string MakeEncoded(size_t length)
+{
+    static const std::string kText(
+        "order+by+created_at+desc%2Cname%3Bfilter%3Dstatus%3Aactive+cursor%3DeyJpZCI6MTIzfQ");
+    std::string str;
+    while (str.size() < length) {
+        str += kText;
+    }
+    str.resize(length);
+    while ('%' == str.back() || '%' == str[str.size() - 2]) { // Keep the last escape complete
+        str.back() = 'x';
+        str[str.size() - 2] = 'x';
+    }
+    return str;
+}
+
+std::string MakePlain(size_t length)
+{
+    std::string str(length, 'a');
+    for (size_t i = 0; i < length; ++i) {
+        str[i] = static_cast<char>('a' + i % 26);
+    }
+    return str;
+}
+
+// JSON-like text, `multilingual` mixes Latin, Cyrillic, CJK and emoji about half and half with ASCII
+std::string MakeUtf8(size_t length, bool multilingual)
+{
+    static const std::string kAscii("{\"name\": \"Plain ASCII text\", \"count\": 42},\n");
+    static const std::string kMultilingual(
+        "{\"name\": \"Caf\xC3\xA9 \xD0\x9C\xD0\xBE\xD1\x81\xD0\xBA\xD0\xB2\xD0\xB0 "
+        "\xE6\x9D\xB1\xE4\xBA\xAC \xF0\x9F\x98\x80\"},\n");
+    const std::string& text = multilingual ? kMultilingual : kAscii;
+    std::string str;
+    while (str.size() + text.size() <= length) {
+        str += text;
+    }
+    str.append(length - str.size(), ' ');
+    return str;
+}
+
+// OAS_SIMD_LEVEL=scalar|sse2|avx2 forces the kernel variant for every benchmark of the run, e.g. to compare the
+// end-to-end numbers of the variants. The benchmarks below also run once per supported variant.
+SimdLevel GetBaseLevel()
+{
+    static const SimdLevel base_level = []() {
+        const char* forced = std::getenv("OAS_SIMD_LEVEL");
+        for (auto level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+            if (forced && 0 == strcmp(forced, GetSimdLevelName(level))) {
+                SetSimdLevel(level);
+            }
+        }
+        return GetSimdLevel();
+    }();
+    return base_level;
+}
+
+const SimdLevel kBaseLevel = GetBaseLevel();
+
+// Runs the benchmark with the variant given as first argument, if the host supports it
+class ForcedLevel
+{
+public:
+    explicit ForcedLevel(benchmark::State& state)
+    {
+        const auto level = static_cast<SimdLevel>(state.range(0));
+        if (static_cast<int>(level) > static_cast<int>(GetMaxSimdLevel())) {
+            state.SkipWithError("Variant not supported by this host");
+        }
+        SetSimdLevel(level);
+        state.SetLabel(GetSimdLevelName(GetSimdLevel()));
+    }
+
+    ForcedLevel(const ForcedLevel&) = delete;
+    ForcedLevel& operator=(const ForcedLevel&) = delete;
+
+    ~ForcedLevel()
+    {
+        SetSimdLevel(kBaseLevel);
+    }
+};
+
+void LevelsAndLengths(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"isa", "bytes"});
+    for (auto level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        for (auto length : {16, 64, 256, 1024, 4096}) {
+            bench->Args({static_cast<int64_t>(level), length});
+        }
+    }
+}
+
+void LevelsAndTexts(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"isa", "multilingual", "bytes"});
+    for (auto level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        for (auto multilingual : {0, 1}) {
+            for (auto length : {1024, 65536}) {
+                bench->Args({static_cast<int64_t>(level), multilingual, length});
+            }
+        }
+    }
+}
+} // namespace
+
+static void Scan(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ForcedLevel forced_level(state);
+    const auto str = MakePlain(static_cast<size_t>(state.range(1)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FindAnyByte(str.data(), str.data() + str.size(), '%', '+', '&'));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(1));
+}
+
+BENCHMARK(Scan)->Apply(LevelsAndLengths);
+
+static void Decode(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ForcedLevel forced_level(state);
+    const auto str = MakeEncoded(static_cast<size_t>(state.range(1)));
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        const char* cursor = str.data();
+        benchmark::DoNotOptimize(PercentDecode(cursor, str.data() + str.size(), out));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(1));
+}
+
+BENCHMARK(Decode)->Apply(LevelsAndLengths);
+
+// End to end, a long form-encoded string query parameter
+static void LongQueryParam(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ForcedLevel forced_level(state);
+    OASValidator validator(SPEC_PATH);
+    const std::string path("/test/query_string_form_true?param=" + MakeEncoded(static_cast<size_t>(state.range(1))));
+    std::string err_msg;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.ValidateQueryParam("GET", path, err_msg));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(1));
+}
+
+BENCHMARK(LongQueryParam)->Apply(LevelsAndLengths);
+
+static void Utf8Validate(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    ForcedLevel forced_level(state);
+    const auto str = MakeUtf8(static_cast<size_t>(state.range(2)), 0 != state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FindInvalidUtf8(str.data(), str.data() + str.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(2));
+}
+
+BENCHMARK(Utf8Validate)->Apply(LevelsAndTexts);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#ifndef SPEC_GENERATOR_HPP
+#define SPEC_GENERATOR_HPP
+
+#include <string>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#endif
+
+// Generates a synthetic OpenAPI spec with `num_resources` resources, each having a templated GET operation with
+// path, query and header parameters and a POST operation with a JSON body. `changed_maximum` alters the path
+// parameter of the first resource only, to simulate a one-operation change between two spec versions.
+inline std::string GenerateSpecs(size_t num_resources, int changed_maximum = 1000)
+{
+    std::string specs = R"({"openapi":"3.0.0","info":{"title":"Generated","version":"1.0.0"},"paths":{)";
+    for (size_t i = 0; i < num_resources; ++i) {
+        const std::string resource = "/resource" + std::to_string(i);
+        const std::string maximum = std::to_string(0 == i ? changed_maximum : 1000);
+        if (i) {
+            specs += ",";
+        }
+        specs += R"(")" + resource + R"(/{id}":{"get":{"parameters":[)"
+                 R"({"name":"id","in":"path","required":true,"schema":{"type":"integer","maximum":)" +
+                 maximum +
+                 R"(}},)"
+                 R"({"name":"page","in":"query","schema":{"type":"integer","minimum":1}},)"
+                 R"({"name":"limit","in":"query","schema":{"type":"integer","minimum":1,"maximum":100}},)"
+                 R"({"name":"X-Request-Id","in":"header","schema":{"type":"string","maxLength":64}}]}},)";
+        specs += R"(")" + resource + R"(":{"post":{"requestBody":{"content":{"application/json":{"schema":)"
+                                     R"({"type":"object","required":["name","tags"],"properties":{)"
+                                     R"("name":{"type":"string","minLength":1,"maxLength":64},)"
+                                     R"("count":{"type":"integer","minimum":0},)"
+                                     R"("tags":{"type":"array","items":{"type":"string"},"maxItems":16},)"
+                                     R"("meta":{"type":"object","additionalProperties":{"type":"string"}}}}}}}}})";
+    }
+    specs += "}}";
+    return specs;
+}
+
+// A single operation, POST /orders/{id}, with a path parameter, a required X-Tenant header and an array of order
+// lines as the body
+const std::string kOrderSpecs(
+    R"({"openapi":"3.0.0","paths":{"/orders/{id}":{"post":{"parameters":[)"
+    R"({"name":"id","in":"path","required":true,"schema":{"type":"integer","minimum":1}},)"
+    R"({"name":"X-Tenant","in":"header","required":true,"schema":{"type":"string","enum":["acme","umbrella"]}}],)"
+    R"("requestBody":{"content":{"application/json":{"schema":{"type":"array","items":{"type":"object",)"
+    R"("required":["sku","quantity"],"properties":{"sku":{"type":"string","pattern":"^[A-Z]{3}-[0-9]{4}$"},)"
+    R"("quantity":{"type":"integer","minimum":1},"note":{"type":"string","maxLength":64}}}}}}}}}}})");
+
+// Order lines of at least `length` bytes, valid against kOrderSpecs
+inline std::string MakeOrder(size_t length)
+{
+    std::string body("[");
+    for (size_t line = 0; body.size() < length; ++line) {
+        body += line ? "," : "";
+        body += R"({"sku":"ABC-)" + std::to_string(1000 + line % 9000) + R"(","quantity":)" +
+                std::to_string(1 + line % 20) + R"(,"note":"Deliver to the back door"})";
+    }
+    return body + "]";
+}
+
+// Bytes of heap in use, 0 where glibc does not provide mallinfo2()
+inline double HeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return static_cast<double>(mallinfo2().uordblks);
+#else
+    return 0.0;
+#endif
+}
+
+#endif // SPEC_GENERATOR_HPP
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "spec_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+// Heap retained per specification, its spec reference table included
+static void SpecRefFootprint(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    const std::string specs = GenerateSpecs(static_cast<size_t>(state.range(0)));
+    double heap_bytes = 0;
+    for (auto _ : state) {
+        const double heap_before = HeapInUse();
+        OASValidator validator(specs);
+        heap_bytes = HeapInUse() - heap_before;
+        benchmark::DoNotOptimize(validator);
+    }
+    state.counters["heap_bytes"] = heap_bytes;
+}
+
+BENCHMARK(SpecRefFootprint)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+// Error rendering cost, the spec reference is now rendered only on failure
+static void InvalidPathParamError(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(GenerateSpecs(10));
+    std::string error_msg;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validator.ValidatePathParam("GET", "/resource1/abc", error_msg));
+    }
+}
+
+BENCHMARK(InvalidPathParamError);
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+// Eight header parameters with patterns, a body of line items
+const std::string kSpecs(
+    R"({"openapi":"3.0.0","paths":{"/carts/{cartId}":{"put":{"parameters":[)"
+    R"({"name":"cartId","in":"path","required":true,"schema":{"type":"integer"}},)"
+    R"({"name":"X-Tenant","in":"header","required":true,"schema":{"type":"string","pattern":"^[a-z]+-[0-9]+$"}},)"
+    R"({"name":"X-Region","in":"header","required":true,"schema":{"type":"string","pattern":"^[a-z]{2}-[a-z]+$"}},)"
+    R"({"name":"X-Trace","in":"header","required":true,"schema":{"type":"string","pattern":"^[0-9a-f]{32}$"}},)"
+    R"({"name":"X-Span","in":"header","required":true,"schema":{"type":"string","pattern":"^[0-9a-f]{16}$"}},)"
+    R"({"name":"X-Client","in":"header","required":true,"schema":{"type":"string","pattern":"^[a-z]+/[0-9.]+$"}},)"
+    R"({"name":"X-Locale","in":"header","required":true,"schema":{"type":"string","pattern":"^[a-z]{2}_[A-Z]{2}$"}},)"
+    R"({"name":"X-Retry","in":"header","required":true,"schema":{"type":"integer","minimum":0,"maximum":5}},)"
+    R"({"name":"X-Priority","in":"header","required":true,"schema":{"type":"string","enum":["low","high"]}}],)"
+    R"("requestBody":{"content":{"application/json":{"schema":{"type":"object","required":["items"],"properties":{)"
+    R"("items":{"type":"array","items":{"type":"object","required":["sku","quantity"],"properties":{)"
+    R"("sku":{"type":"string"},"quantity":{"type":"integer","minimum":1}}}}}}}}}}}}})");
+
+HeaderField Field(const char* name, const char* value)
+{
+    return {name, std::strlen(name), value, std::strlen(value)};
+}
+
+const std::vector<HeaderField> kHeaders{Field("X-Tenant", "acme-42"),
+                                        Field("X-Region", "eu-west"),
+                                        Field("X-Trace", "4bf92f3577b34da6a3ce929d0e0e4736"),
+                                        Field("X-Span", "00f067aa0ba902b7"),
+                                        Field("X-Client", "ios/17.2"),
+                                        Field("X-Locale", "en_US"),
+                                        Field("X-Retry", "0"),
+                                        Field("X-Priority", "high")};
+
+std::string MakeCart(size_t lines)
+{
+    std::string body(R"({"items": [)");
+    for (size_t idx = 0; idx < lines; ++idx) {
+        body += (idx ? ", " : "") + std::string(R"({"sku": "SKU-)") + std::to_string(idx) + R"(", "quantity": 2})";
+    }
+    return body + "]}";
+}
+
+ValidatorOptions MakeOptions(const benchmark::State& state)
+{
+    ValidatorOptions options;
+    options.validation_order = static_cast<ValidationOrder>(state.range(0));
+    return options;
+}
+} // namespace
+
+// A 64-line cart with an invalid header, rejected before its body is parsed
+static void OrderRejectHeader(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs, {}, MakeOptions(state));
+    const auto body = MakeCart(64);
+    auto headers = kHeaders;
+    headers[6] = Field("X-Retry", "9");
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::INVALID_HEADER_PARAM !=
+            validator.ValidateRequest("PUT", "/carts/1", body, headers.data(), headers.size(), err_msg)) {
+            state.SkipWithError("Not rejected by its headers");
+            break;
+        }
+    }
+}
+
+// Same, with the body validated first as ValidateRequest did before
+static void OrderRejectHeaderBodyFirst(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs);
+    const auto body = MakeCart(64);
+    auto headers = kHeaders;
+    headers[6] = Field("X-Retry", "9");
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE != validator.ValidateBody("PUT", "/carts/1", body, err_msg) ||
+            ValidationError::INVALID_HEADER_PARAM !=
+                validator.ValidateRequest("PUT", "/carts/1", headers.data(), headers.size(), err_msg)) {
+            state.SkipWithError("Not rejected by its headers");
+            break;
+        }
+    }
+}
+
+// Valid headers and a body of the wrong type: ADAPTIVE learns to validate the body first
+static void OrderRejectBody(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs, {}, MakeOptions(state));
+    const std::string body("[]");
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::INVALID_BODY !=
+            validator.ValidateRequest("PUT", "/carts/1", body, kHeaders.data(), kHeaders.size(), err_msg)) {
+            state.SkipWithError("Not rejected by its body");
+            break;
+        }
+    }
+}
+
+// Valid requests, for the cost of sampling
+static void OrderAccept(benchmark::State& state) // NOLINT(cert-err58-cpp)
+{
+    OASValidator validator(kSpecs, {}, MakeOptions(state));
+    const auto body = MakeCart(4);
+    std::string err_msg;
+    for (auto _ : state) {
+        if (ValidationError::NONE !=
+            validator.ValidateRequest("PUT", "/carts/1", body, kHeaders.data(), kHeaders.size(), err_msg)) {
+            state.SkipWithError(err_msg.c_str());
+            break;
+        }
+    }
+}
+
+BENCHMARK(OrderRejectHeader)->ArgName("order")->DenseRange(0, 1);
+BENCHMARK(OrderRejectHeaderBodyFirst);
+BENCHMARK(OrderRejectBody)->ArgName("order")->DenseRange(0, 1);
+BENCHMARK(OrderAccept)->ArgName("order")->DenseRange(0, 1);
@@ -52,11 +52,12 @@ protected:
 };
 TEST_P(ArrayDeserializerTest, Deserialize)
 {
+    std::string result;
     if (expect_throw_) {
-        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size()); },
+        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result); },
                      DeserializationException);
     } else {
-        std::string result = deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size());
+        deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result);
         EXPECT_EQ(result, expected_);
     }
 }
@@ -41,11 +41,12 @@ protected:
 
 TEST_P(ContentDeserializerTest, Deserialize)
 {
+    std::string result;
     if (expect_throw_) {
-        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size()); },
+        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result); },
                      DeserializationException);
     } else {
-        std::string result = deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size());
+        deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result);
         EXPECT_EQ(result, EXPECTED);
     }
 }
@@ -64,4 +65,5 @@ INSTANTIATE_TEST_SUITE_P(
                       std::make_tuple("test%7B%22boolTrue%22%3Atrue%2C%22boolFalse%22%3Afalse%2C%22int%22%3A123%2C%"
                                       "22number%22%3A123.456%2C%22string%22%3A%22abc%"
                                       "20xyz%22%7D&test2=123",
-                                      '\0', true, true)));
\ No newline at end of file
+                                      '\0', true, true),
+                      std::make_tuple("%7B%22string%22%3A%22caf%E9%22%7D", '\0', false, true)));
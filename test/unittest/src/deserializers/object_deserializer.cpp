@@ -55,11 +55,12 @@ protected:
 
 TEST_P(ObjectDeserializerTest, Deserialize)
 {
+    std::string result;
     if (expect_throw_) {
-        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size()); },
+        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result); },
                      DeserializationException);
     } else {
-        std::string result = deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size());
+        deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result);
         EXPECT_EQ(result, EXPECTED);
     }
 }
@@ -97,4 +98,4 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple("test=boolTrue,true,boolFalse,false,int,123,number,123.456,string,abc%20xyz", ';', true, ',',
                         ',', false, true),
         std::make_tuple(";boolTrue,true;boolFalse=false;int=123;number=123.456;string=abc%20xyz", ';', false, '=', ';',
-                        false, true)));
\ No newline at end of file
+                        false, true)));
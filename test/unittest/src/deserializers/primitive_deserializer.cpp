@@ -48,11 +48,12 @@ protected:
 
 TEST_P(PrimitiveDeserializerTest, Deserialize)
 {
+    std::string result;
     if (expect_throw_) {
-        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size()); },
+        EXPECT_THROW({ deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result); },
                      DeserializationException);
     } else {
-        std::string result = deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size());
+        deserializer_->Deserialize(input_.c_str(), input_.c_str() + input_.size(), result);
         EXPECT_EQ(result, expected_);
     }
 }
@@ -78,4 +79,7 @@ INSTANTIATE_TEST_SUITE_P(
                       std::make_tuple("invalid", PrimitiveType::BOOLEAN, "invalid", '\0', false, true),
                       std::make_tuple("invalid", PrimitiveType::INTEGER, "invalid", '\0', false, true),
                       std::make_tuple("invalid", PrimitiveType::NUMBER, "invalid", '\0', false, true),
-                      std::make_tuple("inva%lid", PrimitiveType::STRING, "invalid", '\0', false, true)));
\ No newline at end of file
+                      std::make_tuple("inva%lid", PrimitiveType::STRING, "invalid", '\0', false, true),
+                      std::make_tuple("caf%C3%A9", PrimitiveType::STRING, "\"caf\xC3\xA9\"", '\0', false, false),
+                      std::make_tuple("caf%C3", PrimitiveType::STRING, "invalid", '\0', false, true),
+                      std::make_tuple("%ED%A0%80", PrimitiveType::STRING, "invalid", '\0', false, true)));
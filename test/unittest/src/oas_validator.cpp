@@ -6,7 +6,42 @@
 
 #include "oas_validator.hpp"
 #include "utils/common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <gtest/gtest.h>
+#include <new>
+#include <rapidjson/document.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+// Heap allocations made by the current thread while `counting_allocations` is set
+thread_local bool counting_allocations = false;
+thread_local size_t allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if (counting_allocations) {
+        ++allocations;
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
 
 TEST(OASValidatorImpTest, ValidateRoute)
 {
@@ -40,6 +75,14 @@ TEST_F(OASValidatorTest, ValidateRoute)
               validator_->ValidateRoute("GET", "/test/string_matrix_true/;param=abc%20xyz", err_msg));
     EXPECT_EQ(ValidationError::NONE,
               validator_->ValidateRoute("GET", "/test/string_matrix_true/;param=abc%2xyz", err_msg));
+
+    // Rejected by the route filter, with the same error as by the trie
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator_->ValidateRoute("GET", "/wp-admin/setup.php?step=1", err_msg));
+    EXPECT_EQ(R"({"errorCode":"INVALID_ROUTE","details":{"description": "Invalid HTTP method 'GET' or path: )"
+              R"('/wp-admin/setup.php?step=1'"}})",
+              err_msg);
+    EXPECT_EQ(ValidationError::INVALID_ROUTE,
+              validator_->ValidateRoute("GET", "/test/integer_simple_true/123/extra", err_msg));
 }
 
 TEST_F(OASValidatorTest, ValidatePathParam)
@@ -109,6 +152,164 @@ TEST_F(OASValidatorTest, ValidateHeaders)
               validator_->ValidateHeaders("GET", "/test/header_triple5", headers, err_msg));
 }
 
+TEST_F(OASValidatorTest, ValidateHeaderFields)
+{
+    std::string err_msg;
+    const std::string int_value("123");
+    const std::string bad_value("123str");
+    const std::string object_value("field1=123,field2=abc");
+    const std::string string_value("abc");
+    const std::string accept("Accept"), any("*/*");
+    const std::string int_upper("INTHEADER"), int_lower("intheader"), object_name("ObjectHeader"),
+        string_name("StringHeader");
+
+    // Views only, never of temporaries
+    static_assert(std::is_constructible<HeaderField, const std::string&, const std::string&>::value, "");
+    static_assert(!std::is_constructible<HeaderField, std::string, const std::string&>::value, "");
+    static_assert(!std::is_constructible<HeaderField, const std::string&, std::string>::value, "");
+    static_assert(!std::is_constructible<HeaderField, const char*, const char*>::value, "");
+
+    // Names are case-insensitive, undeclared headers are ignored
+    std::vector<HeaderField> headers{{accept, any}, {int_upper, int_value}};
+    EXPECT_EQ(ValidationError::NONE,
+              validator_->ValidateHeaders("GET", "/test/header_single1", headers.data(), headers.size(), err_msg));
+
+    // Every occurrence of a repeated header is validated
+    headers.emplace_back(int_lower, bad_value);
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateHeaders("GET", "/test/header_single1", headers.data(), headers.size(), err_msg));
+
+    // Missing required header
+    headers = {{accept, any}};
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateHeaders("GET", "/test/header_single1", headers.data(), headers.size(), err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find("Missing required parameter 'intHeader'"));
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateHeaders("GET", "/test/header_single1", nullptr, 0, err_msg));
+
+    headers = {{int_lower, int_value}, {object_name, object_value}, {string_name, string_value}};
+    EXPECT_EQ(ValidationError::NONE,
+              validator_->ValidateHeaders("GET", "/test/header_triple5", headers.data(), headers.size(), err_msg));
+    EXPECT_EQ(ValidationError::NONE,
+              validator_->ValidateRequest("GET", "/test/header_triple5", headers.data(), headers.size(), err_msg));
+    headers.pop_back();
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateRequest("GET", "/test/header_triple5", headers.data(), headers.size(), err_msg));
+
+    // No header parameters declared
+    EXPECT_EQ(ValidationError::NONE,
+              validator_->ValidateHeaders("GET", "/test/dummy", headers.data(), headers.size(), err_msg));
+}
+
+TEST(OASValidatorAllocationTest, ValidatesHeaderFieldsWithoutAllocating)
+{
+#ifdef OASVALIDATOR_UNPATCHED_RAPIDJSON
+    GTEST_SKIP() << "RapidJSON built without thirdparty/patches";
+#endif
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/items": {
+          "get": {
+            "parameters": [
+              {"name": "X-Request-Id", "in": "header", "required": true, "schema": {"type": "string"}},
+              {"name": "X-Tags", "in": "header", "schema": {"type": "array", "items": {"type": "string"}}}
+            ]
+          }
+        }
+      }
+    })";
+    OASValidator validator(specs);
+    const std::string request_id("6f1c2b8e-4d3a-4f5e-9b7c-1a2d3e4f5a6b"), tags("red,green,blue");
+    const HeaderField headers[] = {{"Accept", 6, "*/*", 3},
+                                   {"x-request-id", 12, request_id.data(), request_id.size()},
+                                   {"X-Tags", 6, tags.data(), tags.size()}};
+    std::string err_msg;
+
+    // The first call sizes the buffers the thread reuses
+    ASSERT_EQ(ValidationError::NONE, validator.ValidateHeaders("GET", "/items", headers, 3, err_msg));
+
+    allocations = 0;
+    counting_allocations = true;
+    for (size_t i = 0; i < 64; ++i) {
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateHeaders("GET", "/items", headers, 3, err_msg));
+    }
+    counting_allocations = false;
+    EXPECT_EQ(0U, allocations);
+}
+
+TEST_F(OASValidatorTest, ValidateHttp1Request)
+{
+    std::string err_msg;
+    const std::string head("GET /test/header_triple5 HTTP/1.1\r\nHost: example.com\r\nINTHEADER: 123\r\n"
+                           "ObjectHeader: field1=123,field2=abc\r\nStringHeader: abc\r\n\r\n");
+    EXPECT_EQ(ValidationError::NONE, validator_->ValidateHttp1Request(head.data(), head.size(), err_msg));
+
+    const std::string bad_header("GET /test/header_single1 HTTP/1.1\r\nintHeader: 123str\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateHttp1Request(bad_header.data(), bad_header.size(), err_msg));
+
+    const std::string query("GET /test/query_integer_form_true?param=123 HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(ValidationError::NONE, validator_->ValidateHttp1Request(query.data(), query.size(), err_msg));
+    const std::string bad_query("GET /test/query_integer_form_true?param=abc HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_QUERY_PARAM,
+              validator_->ValidateHttp1Request(bad_query.data(), bad_query.size(), err_msg));
+
+    const std::string path("GET /test/integer_simple_true/abc HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM,
+              validator_->ValidateHttp1Request(path.data(), path.size(), err_msg));
+    const std::string route("GET /test/unknown HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator_->ValidateHttp1Request(route.data(), route.size(), err_msg));
+    const std::string method("FETCH /test/dummy HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_METHOD,
+              validator_->ValidateHttp1Request(method.data(), method.size(), err_msg));
+
+    // The body span need not be null-terminated
+    const std::string request("POST /test/body_scenario1 HTTP/1.1\r\nContent-Length: 3\r\n\r\n1234");
+    const auto body_pos = request.find("\r\n\r\n") + 4;
+    EXPECT_EQ(ValidationError::NONE,
+              validator_->ValidateHttp1Request(request.data(), body_pos, request.data() + body_pos, 3, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              validator_->ValidateHttp1Request(request.data(), body_pos, request.data() + body_pos, 0, err_msg));
+}
+
+TEST_F(OASValidatorTest, ValidateHttp2Request)
+{
+    std::string err_msg;
+    const std::string method_name(":method"), get("GET"), post("post"), path_name(":path"),
+        header_path("/test/header_single1"), body_path("/test/body_scenario1"), int_name("intheader"), int_value("1"),
+        bad_value("x");
+
+    std::vector<HeaderField> fields{{method_name, get}, {path_name, header_path}, {int_name, int_value}};
+    EXPECT_EQ(ValidationError::NONE, validator_->ValidateHttp2Request(fields.data(), fields.size(), err_msg));
+    fields.back() = HeaderField(int_name, bad_value);
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateHttp2Request(fields.data(), fields.size(), err_msg));
+    fields.pop_back();
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_->ValidateHttp2Request(fields.data(), fields.size(), err_msg));
+
+    fields = {{method_name, post}, {path_name, body_path}};
+    const std::string body("123");
+    EXPECT_EQ(ValidationError::NONE,
+              validator_->ValidateHttp2Request(fields.data(), fields.size(), body.data(), body.size(), err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              validator_->ValidateHttp2Request(fields.data(), fields.size(), "abc", 3, err_msg));
+    fields.pop_back();
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator_->ValidateHttp2Request(fields.data(), fields.size(), err_msg));
+}
+
+TEST(OASValidatorHeaderTest, DuplicateHeaderNamesThrow)
+{
+    EXPECT_THROW(
+        {
+            OASValidator validator(R"({"openapi": "3.0.0", "paths": {"/a": {"get": {"parameters": [
+                {"name": "X-Id", "in": "header", "schema": {"type": "string"}},
+                {"name": "x-id", "in": "header", "schema": {"type": "string"}}]}}}})");
+        },
+        ValidatorInitExc);
+}
+
 TEST_F(OASValidatorTest, ValidateBody)
 {
     std::string err_msg;
@@ -123,6 +324,77 @@ TEST_F(OASValidatorTest, ValidateBody)
                                        err_msg));
 }
 
+TEST(OASValidatorMethodMapTest, AnyCasing)
+{
+    OASValidator validator(SPEC_PATH, {{"Head", {"get"}}});
+    std::string err_msg;
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRoute("head", "/test/integer_simple_true/123", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRequest("HEAD", "/test/integer_simple_true/123", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRoute("Get", "/test/integer_simple_true/123", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE,
+              validator.ValidateRoute("DELETE", "/test/integer_simple_true/123", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_METHOD,
+              validator.ValidateRoute("FETCH", "/test/integer_simple_true/123", err_msg));
+}
+
+TEST(OASValidatorMethodMapTest, AliasesAndCustomVerbs)
+{
+    OASValidator loaded(SPEC_PATH, {{"PURGE", {"post", "FETCH"}}, {"HEAD", {"GET"}}, {"NOTHING", {"FETCH"}}});
+    OASValidator validator(loaded);
+    validator.ReloadSpecs(SPEC_PATH); // Aliases are resolved again for the new specification
+    std::string err_msg;
+    const std::string body(R"({"level1":{"level2":{"level3":"abc"}}})");
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("Purge", "/test/body_scenario20", body, err_msg));
+    const std::string invalid_body(R"({"level1":{"level2":{"level3":1}}})");
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              validator.ValidateBody("PURGE", "/test/body_scenario20", invalid_body, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE,
+              validator.ValidateRoute("PURGE", "/test/integer_simple_true/123", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("NOTHING", "/test/body_scenario20", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_METHOD, validator.ValidateRoute("PURGED", "/test/body_scenario20", err_msg));
+
+    // Path parameters are extracted with the templates of the alias
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRequest("HEAD", "/test/integer_simple_true/123", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM,
+              validator.ValidateRequest("HEAD", "/test/integer_simple_true/123str", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("HEAD", "/test/body_scenario20", err_msg));
+}
+
+TEST(OASValidatorOptionsTest, StructuralIndexBodyParser)
+{
+    ValidatorOptions options;
+    options.body_parser = BodyParser::STRUCTURAL_INDEX;
+    OASValidator validator(SPEC_PATH, {}, options);
+    OASValidator default_validator(SPEC_PATH);
+    const std::vector<std::string> bodies = {"123",
+                                             "123str",
+                                             R"({"level1":{"level2":{"level3":"abc"}}})",
+                                             R"({"level1":{"level2":{"level3":123}}})",
+                                             R"({"level1":})",
+                                             "{\"level1\":{\"level2\":{\"level3\":\"\xFF\"}}}"};
+    for (const auto& body : bodies) {
+        std::string err_msg;
+        std::string expected_msg;
+        EXPECT_EQ(default_validator.ValidateBody("POST", "/test/body_scenario20", body, expected_msg),
+                  validator.ValidateBody("POST", "/test/body_scenario20", body, err_msg));
+        EXPECT_EQ(expected_msg, err_msg);
+    }
+
+    // Kept by copies and reloads. Both invalid and malformed, the schema error comes first when parsing and validating
+    // at once.
+    const std::string body(R"({"level1":{"level2":{"level3":123}}} x)");
+    std::string err_msg;
+    OASValidator copy(validator);
+    copy.ReloadSpecs(SPEC_PATH);
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              default_validator.ValidateBody("POST", "/test/body_scenario20", body, err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find("parserError"));
+    EXPECT_EQ(ValidationError::INVALID_BODY, copy.ValidateBody("POST", "/test/body_scenario20", body, err_msg));
+    EXPECT_EQ(std::string::npos, err_msg.find("parserError"));
+    EXPECT_EQ(ValidationError::INVALID_BODY, copy.ValidateRequest("POST", "/test/body_scenario20", body, err_msg));
+    EXPECT_EQ(std::string::npos, err_msg.find("parserError"));
+}
+
 TEST_F(OASValidatorTest, ValidateRequst)
 {
     std::string err_msg;
@@ -206,4 +478,807 @@ TEST_F(OASValidatorTest, ValidateRequst)
                                           "20%22string%22%0A%7D&param7=%7B%0A%20%20%22field1%22%3A%200%2C%0A%20%20%"
                                           "22field2%22%3A%20%22string%22%0A%7D",
                                           err_msg));
-}
\ No newline at end of file
+}
+
+namespace {
+const char* const kReloadSpecs = R"({
+  "openapi": "3.0.0",
+  "paths": {
+    "/items/{id}": {
+      "get": {
+        "parameters": [
+          {"name": "id", "in": "path", "required": true, "schema": {"$ref": "#/components/schemas/Id"}}
+        ]
+      }
+    },
+    "/items": {
+      "post": {
+        "requestBody": {"content": {"application/json": {"schema": {"type": "object", "required": ["name"]}}}}
+      }
+    }
+  },
+  "components": {"schemas": {"Id": {"type": "integer", "maximum": 100}}}
+})";
+} // namespace
+
+TEST(OASValidatorReloadTest, ReloadSpecs)
+{
+    OASValidator validator(kReloadSpecs);
+    std::string err_msg;
+    EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", "/items/50", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", "/items/500", err_msg));
+
+    // Unchanged specs, every operation is reused
+    validator.ReloadSpecs(kReloadSpecs);
+    EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", "/items/50", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/items", "{}", err_msg));
+
+    // Change in a referenced component rebuilds the operation using it
+    std::string specs(kReloadSpecs);
+    specs.replace(specs.find("\"maximum\": 100"), sizeof("\"maximum\": 100") - 1, "\"maximum\": 1000");
+    validator.ReloadSpecs(specs);
+    EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", "/items/500", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/items", "{}", err_msg));
+
+    // Removed operation is no longer routed
+    specs.replace(specs.find("\"post\""), sizeof("\"post\"") - 1, "\"put\"");
+    validator.ReloadSpecs(specs);
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateBody("POST", "/items", "{}", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("PUT", "/items", R"({"name":"abc"})", err_msg));
+}
+
+TEST(OASValidatorReloadTest, ReloadInvalidSpecsKeepsLoaded)
+{
+    OASValidator validator(kReloadSpecs);
+    std::string err_msg;
+    EXPECT_THROW(validator.ReloadSpecs("{invalid json"), ValidatorInitExc);
+    EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", "/items/50", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", "/items/500", err_msg));
+}
+
+TEST(OASValidatorReloadTest, SpecRefsPerSpecification)
+{
+    const auto spec_ref_count = [](const OASValidator& validator) {
+        rapidjson::Document report;
+        report.Parse(validator.GetMemoryReport().c_str());
+        return report["specRefs"]["count"].GetUint64();
+    };
+    OASValidator validator(kReloadSpecs);
+    const auto count = spec_ref_count(validator);
+    EXPECT_GT(count, 0u);
+
+    // Other specifications intern into their own table
+    OASValidator other(R"({"openapi": "3.0.0", "paths": {"/other": {"get": {"parameters": [
+        {"name": "q", "in": "query", "schema": {"type": "integer"}}]}}}})");
+    EXPECT_EQ(1u, spec_ref_count(other));
+    EXPECT_EQ(count, spec_ref_count(validator));
+
+    // Reloads share the table, and reused validators still render their references
+    validator.ReloadSpecs(kReloadSpecs);
+    EXPECT_EQ(count, spec_ref_count(validator));
+    std::string err_msg;
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", "/items/500", err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find(R"("specRef":"#/paths/%2Fitems%2F{id}/get/parameters/id")")) << err_msg;
+}
+
+TEST(OASValidatorReloadTest, SpecRefsStayBounded)
+{
+    const auto spec_ref_count = [](const OASValidator& validator) {
+        rapidjson::Document report;
+        report.Parse(validator.GetMemoryReport().c_str());
+        return report["specRefs"]["count"].GetUint64();
+    };
+    // Every version renames its operations, alternating between two shapes, so none of the references is reused
+    const auto make_specs = [](size_t version) {
+        const std::string path = "/v" + std::to_string(version) + "/items/{id}";
+        std::string params = R"({"name": "id", "in": "path", "required": true, "schema": {"type": "integer"}})";
+        if (version % 2) {
+            params += R"(, {"name": "limit", "in": "query", "schema": {"type": "integer"}})";
+        }
+        return R"({"openapi": "3.0.0", "paths": {")" + path + R"(": {"get": {"parameters": [)" + params + "]}}}}";
+    };
+    OASValidator validator(make_specs(0));
+    // A table holding more dead references than live ones is replaced, before the reload adds its own
+    const auto max_count = 3 * std::max(spec_ref_count(validator), spec_ref_count(OASValidator(make_specs(1))));
+    std::string err_msg;
+    for (size_t version = 1; version <= 50; ++version) {
+        validator.ReloadSpecs(make_specs(version));
+        EXPECT_LE(spec_ref_count(validator), max_count) << version;
+
+        // Errors render the references of the version loaded
+        const std::string path = "/v" + std::to_string(version) + "/items/x";
+        EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", path, err_msg));
+        EXPECT_NE(std::string::npos, err_msg.find("v" + std::to_string(version) + "%2Fitems")) << err_msg;
+    }
+}
+
+namespace {
+const char* const kRouteSpecs = R"({
+  "openapi": "3.0.0",
+  "paths": {
+    "/pets/{petId}": {
+      "get": {
+        "operationId": "getPet",
+        "parameters": [
+          {"name": "petId", "in": "path", "required": true, "schema": {"type": "integer"}},
+          {"name": "details", "in": "query", "schema": {"type": "boolean"}},
+          {"name": "X-Trace", "in": "header", "required": true, "schema": {"type": "string"}}
+        ]
+      }
+    },
+    "/pets": {
+      "post": {
+        "operationId": "addPet",
+        "requestBody": {"content": {"application/json": {"schema": {"type": "object", "required": ["name"]}}}}
+      },
+      "put": {}
+    }
+  }
+})";
+} // namespace
+
+TEST(OASValidatorRouteTest, ResolvesRoutes)
+{
+    OASValidator validator(kRouteSpecs, {{"HEAD", {"GET"}}});
+    std::string err_msg;
+    RouteHandle route;
+    EXPECT_FALSE(route.IsValid());
+    EXPECT_EQ("", route.GetPathTemplate());
+
+    EXPECT_EQ(ValidationError::NONE, validator.GetRouteByOperationId("getPet", route, err_msg));
+    EXPECT_TRUE(route.IsValid());
+    EXPECT_EQ("GET", route.GetMethod());
+    EXPECT_EQ("/pets/{petId}", route.GetPathTemplate());
+    EXPECT_EQ("getPet", route.GetOperationId());
+
+    EXPECT_EQ(ValidationError::NONE, validator.GetRoute("post", "/pets", route, err_msg));
+    EXPECT_EQ("POST", route.GetMethod());
+    EXPECT_EQ("addPet", route.GetOperationId());
+    EXPECT_EQ(ValidationError::NONE, validator.GetRoute("PUT", "/pets", route, err_msg));
+    EXPECT_EQ("", route.GetOperationId());
+    EXPECT_EQ(ValidationError::NONE, validator.GetRoute("head", "/pets/{petId}", route, err_msg));
+    EXPECT_EQ("HEAD", route.GetMethod());
+    EXPECT_EQ("getPet", route.GetOperationId()); // Of the aliased operation
+
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.GetRoute("GET", "/pets/42", route, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_METHOD, validator.GetRoute("FETCH", "/pets", route, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.GetRouteByOperationId("deletePet", route, err_msg));
+    EXPECT_EQ("/pets/{petId}", route.GetPathTemplate()); // Unchanged on error
+
+    std::string specs(kRouteSpecs);
+    specs.replace(specs.find("\"addPet\""), sizeof("\"addPet\"") - 1, "\"getPet\"");
+    EXPECT_THROW(OASValidator duplicate(specs), ValidatorInitExc);
+}
+
+TEST(OASValidatorRouteTest, ValidatesWithRoutes)
+{
+    OASValidator validator(kRouteSpecs);
+    std::string err_msg;
+    RouteHandle get_pet;
+    RouteHandle add_pet;
+    ASSERT_EQ(ValidationError::NONE, validator.GetRoute("GET", "/pets/{petId}", get_pet, err_msg));
+    ASSERT_EQ(ValidationError::NONE, validator.GetRouteByOperationId("addPet", add_pet, err_msg));
+    const std::string trace_name("x-trace");
+    const std::string trace_value("abc");
+    const std::vector<HeaderField> headers = {{trace_name, trace_value}};
+
+    EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam(get_pet, "/pets/42", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam(get_pet, "/pets/abc", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidatePathParam(get_pet, "/pets/42/toys", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidatePathParam(get_pet, "/cats/42", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateQueryParam(get_pet, "/pets/42?details=true", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_QUERY_PARAM,
+              validator.ValidateQueryParam(get_pet, "/pets/42?details=yes", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateHeaders(get_pet, {{"X-Trace", "abc"}}, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM, validator.ValidateHeaders(get_pet, nullptr, 0, err_msg));
+    EXPECT_EQ(ValidationError::NONE,
+              validator.ValidateRequest(get_pet, "/pets/42?details=true", headers.data(), headers.size(), err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM,
+              validator.ValidateRequest(get_pet, "/pets/x?details=true", headers.data(), headers.size(), err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRequest(get_pet, "/pets/42", err_msg));
+
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateBody(add_pet, R"({"name":"Rex"})", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody(add_pet, "{}", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRequest(add_pet, "/pets", R"({"name":"Rex"})", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              validator.ValidateRequest(add_pet, "/pets", "{}", headers.data(), headers.size(), err_msg));
+
+    const RouteHandle invalid;
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateBody(invalid, "{}", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRequest(invalid, "/pets/42", err_msg));
+
+    // A handle keeps the operation it was resolved from
+    std::string specs(kRouteSpecs);
+    specs.replace(specs.find("\"integer\""), sizeof("\"integer\"") - 1, "\"string\"");
+    validator.ReloadSpecs(specs);
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam(get_pet, "/pets/abc", err_msg));
+    ASSERT_EQ(ValidationError::NONE, validator.GetRouteByOperationId("getPet", get_pet, err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam(get_pet, "/pets/abc", err_msg));
+}
+
+TEST(OASValidatorOptionsTest, RouteCache)
+{
+    ValidatorOptions options;
+    options.route_cache_capacity = 1024;
+    OASValidator validator(kRouteSpecs, {{"HEAD", {"GET"}}}, options);
+    OASValidator uncached(kRouteSpecs);
+    EXPECT_EQ(0U, uncached.GetRouteCacheStats().capacity);
+    std::string err_msg;
+
+    // Results are the same once the path is cached, path parameters included
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", "/pets/42?details=true", err_msg));
+        EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", "/pets/abc", err_msg));
+        EXPECT_EQ(ValidationError::INVALID_QUERY_PARAM,
+                  validator.ValidateQueryParam("HEAD", "/pets/42?details=yes", err_msg));
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateRoute("POST", "/pets", err_msg));
+        EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("POST", "/pets/42", err_msg));
+        EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("GET", "/cats/42", err_msg));
+    }
+    auto stats = validator.GetRouteCacheStats();
+    EXPECT_EQ(4U, stats.entries); // Unknown paths are not cached
+    EXPECT_EQ(4U, stats.hits);
+    EXPECT_EQ(8U, stats.misses);
+    EXPECT_GE(stats.capacity, 1024U);
+
+    OASValidator copy(validator);
+    EXPECT_EQ(ValidationError::NONE, copy.ValidateRoute("POST", "/pets", err_msg));
+    EXPECT_EQ(5U, validator.GetRouteCacheStats().hits);
+    copy.ReloadSpecs(kRouteSpecs);
+    stats = copy.GetRouteCacheStats();
+    EXPECT_EQ(0U, stats.entries);
+    EXPECT_EQ(0U, stats.hits);
+    EXPECT_GE(stats.capacity, 1024U);
+}
+
+TEST(OASValidatorOptionsTest, PathNormalization)
+{
+    std::string specs(kRouteSpecs);
+    specs.replace(specs.find("\"paths\""), 0,
+                  R"("servers": [{"url": "https://{host}/{base}/", "variables": {"base": {"default": "v1"}}}, )"
+                  R"({"url": "/test/api"}],)");
+    specs.replace(specs.find("\"/pets\""), sizeof("\"/pets\"") - 1, "\"/Pets\"");
+    ValidatorOptions options;
+    options.path_normalization.strip_base_paths = true;
+    options.path_normalization.collapse_slashes = true;
+    options.path_normalization.remove_dot_segments = true;
+    options.path_normalization.decode_unreserved = true;
+    options.route_cache_capacity = 64;
+    OASValidator validator(specs, {}, options);
+    OASValidator unnormalized(specs);
+    std::string err_msg;
+
+    for (const char* path : {"/pets/42", "/v1/pets/42/", "/test/api//pets/42", "/pets/./toys/../42?details=true",
+                             "/%70ets/42", "/test/api/v1/../pets/42"}) {
+        for (int i = 0; i < 2; ++i) { // Cached the second time
+            EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", path, err_msg)) << path;
+        }
+        EXPECT_EQ(std::string("/pets/42") == path ? ValidationError::NONE : ValidationError::INVALID_ROUTE,
+                  unnormalized.ValidatePathParam("GET", path, err_msg))
+            << path;
+    }
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", "/v1//pets/abc", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam("GET", "/pets/%34%32", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRoute("POST", "/v1/Pets/", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("POST", "/v1/pets", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("GET", "/v2/pets/42", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRoute("GET", "/pets/42/../../../etc/passwd", err_msg));
+
+    // Paths validated with a handle are normalized as they are routed
+    RouteHandle get_pet;
+    ASSERT_EQ(ValidationError::NONE, validator.GetRouteByOperationId("getPet", get_pet, err_msg));
+    for (const char* path : {"/pets/42", "/v1/pets/42/", "/test/api//pets/42", "/pets/./toys/../42?details=true",
+                             "/%70ets/42", "/test/api/v1/../pets/42"}) {
+        EXPECT_EQ(ValidationError::NONE, validator.ValidatePathParam(get_pet, path, err_msg)) << path;
+    }
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidatePathParam(get_pet, "/v1//pets/abc", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidatePathParam(get_pet, "/v2/pets/42", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidatePathParam(get_pet, "/PETS/42", err_msg));
+    ASSERT_EQ(ValidationError::NONE, unnormalized.GetRouteByOperationId("getPet", get_pet, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, unnormalized.ValidatePathParam(get_pet, "/v1/pets/42", err_msg));
+
+    options.path_normalization.ignore_case = true;
+    OASValidator case_insensitive(specs, {}, options);
+    ASSERT_EQ(ValidationError::NONE, case_insensitive.GetRouteByOperationId("getPet", get_pet, err_msg));
+    EXPECT_EQ(ValidationError::NONE, case_insensitive.ValidatePathParam(get_pet, "/TEST/API/%50ETS/42", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, case_insensitive.ValidatePathParam(get_pet, "/V1/PETS/A", err_msg));
+    EXPECT_EQ(ValidationError::NONE, case_insensitive.ValidateRoute("POST", "/V1/pets", err_msg));
+    EXPECT_EQ(ValidationError::NONE, case_insensitive.ValidateRoute("post", "/TEST/API/PETS", err_msg));
+    EXPECT_EQ(ValidationError::NONE, case_insensitive.ValidatePathParam("GET", "/PETS/42", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, case_insensitive.ValidatePathParam("GET", "/PETS/A", err_msg));
+
+    specs.replace(specs.find("\"/Pets\""), 0, R"("/pets": {"post": {}}, )");
+    EXPECT_NO_THROW(OASValidator(specs, {}, ValidatorOptions()));
+    EXPECT_THROW(OASValidator(specs, {}, options), ValidatorInitExc);
+}
+
+TEST(OASValidatorParamValuesTest, ExtractsTypedValues)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/pets/{petId}/toys/{toyName}": {
+          "get": {
+            "parameters": [
+              {"name": "petId", "in": "path", "required": true, "schema": {"type": "integer"}},
+              {"name": "toyName", "in": "path", "required": true, "schema": {"type": "string"}},
+              {"name": "tags", "in": "query", "explode": false,
+               "schema": {"type": "array", "items": {"type": "string"}}},
+              {"name": "size", "in": "query", "explode": false,
+               "schema": {"type": "object", "properties": {"w": {"type": "number"}, "h": {"type": "integer"}}}},
+              {"name": "details", "in": "query", "schema": {"type": "boolean"}},
+              {"name": "limit", "in": "query", "schema": {"type": "integer", "maximum": 100}}
+            ]
+          }
+        }
+      }
+    })";
+    OASValidator validator(specs);
+    std::string err_msg;
+    ParamValues values;
+
+    ASSERT_EQ(ValidationError::NONE,
+              validator.ValidateRequest("GET", "/pets/42/toys/red%20ball?tags=a,b&size=w,1.5,h,2&limit=10", values,
+                                        err_msg));
+    ASSERT_EQ(6U, values.GetCount());
+    EXPECT_EQ(42, values.Get("petId").integer);
+    EXPECT_EQ("red ball", std::string(values.Get(1).string, values.Get(1).length));
+    EXPECT_EQ(ParamType::ARRAY, values.Get("tags").type);
+    EXPECT_EQ("b", std::string(values.Get("tags").GetItem(1).string, values.Get("tags").GetItem(1).length));
+    EXPECT_EQ(1.5, values.Get("size").GetMember("w").number);
+    EXPECT_EQ(2, values.Get("size").GetMember("h").integer);
+    EXPECT_EQ(ParamType::MISSING, values.Get(4).type); // details
+    EXPECT_EQ(10, values.Get("limit").integer);
+
+    ASSERT_EQ(ValidationError::NONE, validator.ValidateQueryParam("GET", "/pets/1/toys/x?details=true", values,
+                                                                  err_msg));
+    EXPECT_EQ(4U, values.GetCount());
+    EXPECT_EQ(ParamType::MISSING, values.Get("petId").type);
+    EXPECT_TRUE(values.Get("details").boolean);
+
+    ASSERT_EQ(ValidationError::NONE, validator.ValidatePathParam("GET", "/pets/7/toys/x?limit=1000", values, err_msg));
+    EXPECT_EQ(2U, values.GetCount());
+    EXPECT_EQ(7, values.Get("petId").integer);
+
+    EXPECT_EQ(ValidationError::INVALID_QUERY_PARAM,
+              validator.ValidateRequest("GET", "/pets/7/toys/x?limit=1000", values, err_msg));
+    EXPECT_EQ(5U, values.GetCount()); // Validated before limit
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRequest("GET", "/cats/7", values, err_msg));
+    EXPECT_EQ(0U, values.GetCount());
+
+    RouteHandle route;
+    ASSERT_EQ(ValidationError::NONE, validator.GetRoute("GET", "/pets/{petId}/toys/{toyName}", route, err_msg));
+    ASSERT_EQ(ValidationError::NONE, validator.ValidateRequest(route, "/pets/3/toys/y?tags=c", values, err_msg));
+    EXPECT_EQ(3, values.Get("petId").integer);
+    EXPECT_EQ(1U, values.Get("tags").length);
+    ASSERT_EQ(ValidationError::NONE, validator.ValidatePathParam(route, "/pets/4/toys/y", values, err_msg));
+    EXPECT_EQ(4, values.Get("petId").integer);
+    ASSERT_EQ(ValidationError::NONE, validator.ValidateQueryParam(route, "/pets/4/toys/y?limit=5", values, err_msg));
+    EXPECT_EQ(5, values.Get("limit").integer);
+}
+
+TEST(OASValidatorBodyDocumentTest, ReturnsAndValidatesDocuments)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/pets": {
+          "post": {
+            "requestBody": {"content": {"application/json": {"schema": {
+              "type": "object", "required": ["name"],
+              "properties": {"name": {"type": "string"}, "age": {"type": "integer", "minimum": 0}}}}}}
+          },
+          "get": {}
+        }
+      }
+    })";
+    for (const auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        ValidatorOptions options;
+        options.body_parser = parser;
+        OASValidator validator(specs, {}, options);
+        std::string err_msg;
+        rapidjson::Document body;
+
+        ASSERT_EQ(ValidationError::NONE,
+                  validator.ValidateBody("POST", "/pets", R"({"name": "Rex", "age": 3})", body, err_msg));
+        ASSERT_TRUE(body.IsObject());
+        EXPECT_STREQ("Rex", body["name"].GetString());
+        EXPECT_EQ(3, body["age"].GetInt());
+        EXPECT_EQ(ValidationError::INVALID_BODY,
+                  validator.ValidateBody("POST", "/pets", R"({"name": "Rex", "age": -1})", body, err_msg));
+        EXPECT_EQ(ValidationError::INVALID_BODY,
+                  validator.ValidateBody("POST", "/pets", R"({"name": )", body, err_msg));
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("GET", "/pets", "ignored", body, err_msg));
+        EXPECT_TRUE(body.IsNull()); // No body schema
+
+        rapidjson::Document parsed;
+        parsed.Parse(R"({"name": "Tom"})");
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/pets", parsed, err_msg));
+        EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/pets", parsed["name"], err_msg));
+        EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateBody("POST", "/cats", parsed, err_msg));
+
+        RouteHandle route;
+        ASSERT_EQ(ValidationError::NONE, validator.GetRoute("POST", "/pets", route, err_msg));
+        ASSERT_EQ(ValidationError::NONE, validator.ValidateBody(route, R"({"name": "Max"})", body, err_msg));
+        EXPECT_STREQ("Max", body["name"].GetString());
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody(route, body, err_msg));
+        EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody(route, body["name"], err_msg));
+        EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateBody(RouteHandle(), body, err_msg));
+    }
+}
+
+TEST(OASValidatorOptionsTest, ValidationOrder)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/pets/{petId}": {
+          "put": {
+            "parameters": [
+              {"name": "petId", "in": "path", "required": true, "schema": {"type": "integer"}},
+              {"name": "X-Request-Id", "in": "header", "required": true, "schema": {"type": "string"}}
+            ],
+            "requestBody": {"content": {"application/json": {"schema": {
+              "type": "object", "required": ["name"], "properties": {"name": {"type": "string"}}}}}}
+          }
+        }
+      }
+    })";
+    const std::string invalid_body = R"({"age": 3})";
+    std::string err_msg;
+
+    OASValidator cheap_first(specs);
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM,
+              cheap_first.ValidateRequest("PUT", "/pets/x", invalid_body, nullptr, 0, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              cheap_first.ValidateRequest("PUT", "/pets/1", invalid_body, nullptr, 0, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              cheap_first.ValidateRequest("PUT", "/pets/1", invalid_body, {{"x-other", "1"}}, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_BODY, cheap_first.ValidateRequest("PUT", "/pets/1", invalid_body, err_msg));
+    ASSERT_EQ(1U, cheap_first.GetValidationOrderStats().size());
+    EXPECT_FALSE(cheap_first.GetValidationOrderStats()[0].learned);
+    EXPECT_EQ(0U, cheap_first.GetValidationOrderStats()[0].samples);
+
+    // The bodies sent are invalid, the headers valid: once learned, the body is validated first
+    ValidatorOptions options;
+    options.validation_order = ValidationOrder::ADAPTIVE;
+    options.adaptive_order_samples = 16;
+    OASValidator adaptive(specs, {}, options);
+    const HeaderField headers[] = {{"X-Request-Id", 12, "abc", 3}};
+    std::string first_error;
+    for (size_t i = 0; i < 16 * 8; ++i) {
+        ASSERT_EQ(ValidationError::INVALID_BODY, adaptive.ValidateRequest("PUT", "/pets/1", invalid_body, headers, 1,
+                                                                          err_msg));
+        if (first_error.empty()) {
+            first_error = err_msg;
+        }
+        EXPECT_EQ(first_error, err_msg); // Same error, sampled or not
+    }
+    auto stats = adaptive.GetValidationOrderStats();
+    ASSERT_EQ(1U, stats.size());
+    EXPECT_EQ("PUT", stats[0].method);
+    EXPECT_EQ("/pets/{petId}", stats[0].path_template);
+    EXPECT_TRUE(stats[0].learned);
+    EXPECT_EQ(16U, stats[0].samples);
+    EXPECT_EQ(RequestCheck::BODY, stats[0].order[0]);
+    const auto& body = stats[0].checks[static_cast<size_t>(RequestCheck::BODY)];
+    EXPECT_EQ(16U, body.runs);
+    EXPECT_EQ(16U, body.failures);
+    const auto& header = stats[0].checks[static_cast<size_t>(RequestCheck::HEADERS)];
+    EXPECT_EQ(16U, header.runs); // Validated despite the invalid body
+    EXPECT_EQ(0U, header.failures);
+
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              adaptive.ValidateRequest("PUT", "/pets/1", invalid_body, nullptr, 0, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              adaptive.ValidateRequest("PUT", "/pets/1", R"({"name": "Rex"})", nullptr, 0, err_msg));
+    EXPECT_EQ(ValidationError::NONE,
+              adaptive.ValidateRequest("PUT", "/pets/1", R"({"name": "Rex"})", headers, 1, err_msg));
+}
+
+TEST(OASValidatorSchemaBoundsTest, RejectsOversizedInputs)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/tags": {
+          "post": {
+            "parameters": [
+              {"name": "q", "in": "query", "schema": {"type": "string", "maxLength": 4}},
+              {"name": "X-Tenant", "in": "header", "schema": {"type": "string", "enum": ["acme", "umbrella"]}}
+            ],
+            "requestBody": {"content": {"application/json": {"schema": {
+              "type": "array", "maxItems": 2, "items": {"type": "string", "maxLength": 4}}}}}
+          }
+        }
+      }
+    })";
+    OASValidator validator(specs);
+    std::string err_msg;
+
+    // Up to the bound, the query parameter, with its name, is validated as usual
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateQueryParam("POST", "/tags?q=%F0%9F%98%80%F0%9F%98%80", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_QUERY_PARAM,
+              validator.ValidateQueryParam("POST", "/tags?q=" + std::string(4 * 12 + 1, 'a'), err_msg));
+    EXPECT_EQ(std::string::npos, err_msg.find("bytes its schema allows"));
+    EXPECT_EQ(ValidationError::INVALID_QUERY_PARAM,
+              validator.ValidateQueryParam("POST", "/tags?q=" + std::string(4 * 12 + 2, 'a'), err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find("Parameter 'q' is longer than the 51 bytes its schema allows"));
+
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateHeaders("POST", "/tags", {{"X-Tenant", "umbrella"}}, err_msg));
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator.ValidateHeaders("POST", "/tags", {{"X-Tenant", std::string(1000, 'x')}}, err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find("is longer than the"));
+
+    // Whitespace is not counted: the array takes up to 2 + 2 * (2 + 12 * 4 + 1) significant bytes
+    const std::string spaced = "[" + std::string(10000, ' ') + R"("ab", "cd"])";
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/tags", spaced, err_msg));
+    const std::string oversized = "[" + std::string(104, '1') + "]";
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/tags", oversized, err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find(R"("code":"sizeError")"));
+    rapidjson::Document doc;
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/tags", oversized, doc, err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find(R"("code":"sizeError")"));
+    EXPECT_EQ(ValidationError::INVALID_BODY,
+              validator.ValidateBody("POST", "/tags", "[" + std::string(100, '1') + "]", err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find(R"("code":"type")"));
+}
+
+TEST(OASValidatorOptionsTest, BodyLimits)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/any": {"post": {"requestBody": {"content": {"application/json": {"schema": {}}}}}},
+        "/uploads": {"post": {"requestBody": {"content": {"application/json": {"schema": {}}}}}},
+        "/trees": {"post": {"requestBody": {"content": {"application/json": {"schema": {}}}}}}
+      }
+    })";
+    const std::vector<std::pair<std::string, std::string>> hostile = {
+        {std::string(100, ' ') + "[]", R"("code":"bytesLimit")"},
+        {"[[[[1]]]]", R"("code":"depthLimit")"},
+        {"[1, 2, 3, 4, 5]", R"("code":"arrayItemsLimit")"},
+        {R"({"a": 1, "b": 2, "c": 3, "d": 4, "e": 5})", R"("code":"objectMembersLimit")"},
+        {R"(["abcdefghijklmnopqrstuvwxyz"])", R"("code":"stringLengthLimit")"}};
+    for (const auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        ValidatorOptions options;
+        options.body_parser = parser;
+        options.body_limits.max_bytes = 64;
+        options.body_limits.max_depth = 3;
+        options.body_limits.max_array_items = 4;
+        options.body_limits.max_object_members = 4;
+        options.body_limits.max_string_length = 16;
+        options.route_body_limits.push_back({"post", "/uploads", BodyLimits()});
+        options.route_body_limits.push_back({"POST", "/trees", BodyLimits()});
+        options.route_body_limits.back().limits.max_depth = 64;
+        OASValidator validator(specs, {}, options);
+        std::string err_msg;
+        rapidjson::Document doc;
+
+        EXPECT_EQ(ValidationError::NONE,
+                  validator.ValidateBody("POST", "/any", R"({"a": [[1, 2, 3, 4]], "b": "0123456789abcdef"})", err_msg));
+        for (const auto& body : hostile) {
+            EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/any", body.first, err_msg));
+            EXPECT_NE(std::string::npos, err_msg.find(body.second)) << err_msg;
+            EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/any", body.first, doc, err_msg));
+            EXPECT_NE(std::string::npos, err_msg.find(body.second)) << err_msg;
+            EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/uploads", body.first, err_msg));
+        }
+
+        // Deep enough to overflow a recursive parse. Unlimited, validation costs grow with the square of the depth.
+        const std::string deep = std::string(100000, '[') + std::string(100000, ']');
+        EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/trees", deep, err_msg));
+        EXPECT_NE(std::string::npos, err_msg.find(R"("code":"depthLimit")"));
+        EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/trees", deep, doc, err_msg));
+        EXPECT_NE(std::string::npos, err_msg.find(R"("code":"depthLimit")"));
+        const std::string nested = std::string(5000, '[') + std::string(5000, ']');
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/uploads", nested, doc, err_msg));
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/uploads", doc, err_msg));
+    }
+
+    ValidatorOptions options;
+    options.route_body_limits.push_back({"POST", "/missing", BodyLimits()});
+    EXPECT_THROW(OASValidator(specs, {}, options), ValidatorInitExc);
+}
+
+TEST(OASValidatorDeadlineTest, StopsAtDeadline)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/items/{id}": {
+          "post": {
+            "parameters": [{"name": "id", "in": "path", "required": true, "schema": {"type": "integer"}}],
+            "requestBody": {"content": {"application/json": {"schema": {
+              "type": "array", "items": {"type": "string", "pattern": "^[a-z]+$"}}}}}
+          }
+        }
+      }
+    })";
+    std::string body("[\"a\"");
+    for (size_t idx = 0; idx < 10000; ++idx) {
+        body += R"(, "abc")";
+    }
+    body += "]";
+    const std::vector<HeaderField> headers;
+    for (const auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        ValidatorOptions options;
+        options.body_parser = parser;
+        OASValidator validator(specs, {}, options);
+        RouteHandle route;
+        std::string err_msg;
+        ASSERT_EQ(ValidationError::NONE, validator.GetRoute("POST", "/items/{id}", route, err_msg));
+
+        ValidationDeadline deadline;
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/items/1", body, deadline, err_msg));
+        EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/items/1", "[1]", deadline, err_msg));
+        EXPECT_EQ(ValidationError::NONE,
+                  validator.ValidateRequest("POST", "/items/1", body, headers.data(), 0, deadline, err_msg));
+
+        // Past its deadline, a body is stopped while it is parsed, a request before its first component
+        deadline.time = std::chrono::steady_clock::now();
+        EXPECT_EQ(ValidationError::TIMEOUT, validator.ValidateBody("POST", "/items/1", body, deadline, err_msg));
+        EXPECT_NE(std::string::npos, err_msg.find(R"({"errorCode":"TIMEOUT","details":{"specRef":")")) << err_msg;
+        EXPECT_EQ(ValidationError::TIMEOUT, validator.ValidateBody(route, body, deadline, err_msg));
+        EXPECT_EQ(ValidationError::TIMEOUT,
+                  validator.ValidateRequest("POST", "/items/x", body, {{"Accept", "*/*"}}, deadline, err_msg));
+        EXPECT_NE(std::string::npos, err_msg.find("Request validation stopped at its deadline")) << err_msg;
+        EXPECT_EQ(ValidationError::TIMEOUT,
+                  validator.ValidateRequest(route, "/items/1", body, headers.data(), 0, deadline, err_msg));
+        EXPECT_EQ(ValidationError::INVALID_ROUTE, // Routing is not stopped
+                  validator.ValidateRequest("POST", "/other", body, headers.data(), 0, deadline, err_msg));
+
+        std::atomic<bool> cancelled{true};
+        ValidationDeadline cancellable;
+        cancellable.cancelled = &cancelled;
+        EXPECT_EQ(ValidationError::TIMEOUT, validator.ValidateBody("POST", "/items/1", body, cancellable, err_msg));
+        cancelled = false;
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/items/1", body, cancellable, err_msg));
+    }
+}
+
+TEST(OASValidatorOptionsTest, BodySampling)
+{
+    const char* const specs = R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/items/{id}": {
+          "post": {
+            "parameters": [{"name": "id", "in": "path", "required": true, "schema": {"type": "integer"}}],
+            "requestBody": {"content": {"application/json": {"schema": {"type": "array"}}}}
+          }
+        },
+        "/notes": {"post": {"requestBody": {"content": {"application/json": {"schema": {"type": "string"}}}}}},
+        "/health": {"get": {}}
+      }
+    })";
+    ValidatorOptions options;
+    options.body_sampling.mode = BodySamplingMode::FIXED_RATE;
+    options.body_sampling.rate = 0;
+    options.route_body_sampling.push_back({"post", "/notes", BodySampling()});
+    options.route_body_sampling.back().sampling.mode = BodySamplingMode::TOKEN_BUCKET;
+    options.route_body_sampling.back().sampling.bodies_per_second = 0.001;
+    options.route_body_sampling.back().sampling.burst = 2;
+    OASValidator validator(specs, {}, options);
+    std::string err_msg;
+
+    // Bodies are skipped, routes and parameters still validated
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/items/1", "{", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRequest("POST", "/items/1", "{", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, validator.ValidateRequest("POST", "/items/x", "[]", err_msg));
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, validator.ValidateRequest("POST", "/other", "[]", err_msg));
+    rapidjson::Document doc; // Documents are always validated
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/items/1", "{}", doc, err_msg));
+
+    // Two bodies in the burst of the route, the others skipped
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator.ValidateBody("POST", "/notes", "1", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/notes", R"("a")", err_msg));
+    for (size_t idx = 0; idx < 10; ++idx) {
+        EXPECT_EQ(ValidationError::NONE, validator.ValidateBody("POST", "/notes", "1", err_msg));
+    }
+
+    const auto stats = validator.GetBodySamplingStats();
+    ASSERT_EQ(2U, stats.size()); // Only operations with a body
+    EXPECT_EQ("POST", stats[0].method);
+    EXPECT_EQ("/items/{id}", stats[0].path_template);
+    EXPECT_EQ(BodySamplingMode::FIXED_RATE, stats[0].mode);
+    EXPECT_EQ(0U, stats[0].checked);
+    EXPECT_EQ(2U, stats[0].skipped);
+    EXPECT_EQ("/notes", stats[1].path_template);
+    EXPECT_EQ(BodySamplingMode::TOKEN_BUCKET, stats[1].mode);
+    EXPECT_EQ(2U, stats[1].checked);
+    EXPECT_EQ(10U, stats[1].skipped);
+
+    OASValidator all(specs);
+    EXPECT_EQ(ValidationError::INVALID_BODY, all.ValidateBody("POST", "/items/1", "{", err_msg));
+    for (const auto& route : all.GetBodySamplingStats()) {
+        EXPECT_EQ(BodySamplingMode::ALL, route.mode);
+        EXPECT_EQ(0U, route.checked + route.skipped);
+    }
+
+    ValidatorOptions invalid;
+    invalid.body_sampling.mode = BodySamplingMode::FIXED_RATE;
+    invalid.body_sampling.rate = 1.5;
+    EXPECT_THROW(OASValidator(specs, {}, invalid), ValidatorInitExc);
+    invalid.body_sampling.mode = BodySamplingMode::TOKEN_BUCKET;
+    EXPECT_THROW(OASValidator(specs, {}, invalid), ValidatorInitExc);
+    invalid.body_sampling.mode = BodySamplingMode::CPU_BUDGET;
+    EXPECT_THROW(OASValidator(specs, {}, invalid), ValidatorInitExc);
+    invalid.body_sampling.budget_ns_per_second = 1000000;
+    EXPECT_NO_THROW(OASValidator(specs, {}, invalid));
+    invalid.route_body_sampling.push_back({"POST", "/missing", BodySampling()});
+    EXPECT_THROW(OASValidator(specs, {}, invalid), ValidatorInitExc);
+}
+
+TEST(OASValidatorCopyTest, CopiesShareSpecsAcrossThreads)
+{
+    OASValidator validator(SPEC_PATH);
+    std::vector<OASValidator> workers(8, validator);
+    std::vector<std::thread> threads;
+    std::atomic<int> failures{0};
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, &failures]() {
+            std::string err_msg;
+            for (int i = 0; i < 200; ++i) {
+                if (ValidationError::NONE != worker.ValidatePathParam("GET", "/test/integer_simple_true/123", err_msg) ||
+                    ValidationError::INVALID_BODY !=
+                        worker.ValidateBody("POST", "/test/body_scenario20", R"({"level1":{"level2":{"level3":1}}})",
+                                            err_msg)) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, failures.load());
+
+    // Reload switches only the reloaded object
+    OASValidator reloaded(validator);
+    reloaded.ReloadSpecs(kReloadSpecs);
+    std::string err_msg;
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, reloaded.ValidateRoute("GET", "/test/dummy", err_msg));
+    EXPECT_EQ(ValidationError::NONE, validator.ValidateRoute("GET", "/test/dummy", err_msg));
+    EXPECT_EQ(ValidationError::NONE, workers.front().ValidateRoute("GET", "/test/dummy", err_msg));
+}
+
+TEST(OASValidatorMemoryTest, ReportsFootprint)
+{
+    OASValidator validator(R"({
+      "openapi": "3.0.0",
+      "paths": {
+        "/a/{id}": {"get": {"parameters": [{"$ref": "#/components/parameters/Id"}]}},
+        "/b/{id}": {"get": {"parameters": [{"$ref": "#/components/parameters/Id"}]}},
+        "/c": {"post": {"requestBody": {"content": {"application/json": {"schema": {"type": "object"}}}}}}
+      },
+      "components": {
+        "parameters": {"Id": {"name": "id", "in": "path", "required": true, "schema": {"type": "integer"}}}
+      }
+    })");
+
+    rapidjson::Document report;
+    report.Parse(validator.GetMemoryReport().c_str());
+    ASSERT_FALSE(report.HasParseError());
+    EXPECT_GT(report["totalBytes"].GetUint64(), 0u);
+    EXPECT_GT(report["routing"]["pathTrieNodes"].GetUint64(), 0u);
+    EXPECT_EQ(3u, report["routes"]["count"].GetUint64());
+    EXPECT_EQ(3u, report["routes"]["items"].Size());
+
+    // Both path parameters share one compiled schema and one deserializer
+    EXPECT_EQ(2u, report["schemas"]["compiled"].GetUint64());
+    EXPECT_EQ(3u, report["schemas"]["references"].GetUint64());
+    EXPECT_EQ(1u, report["schemas"]["shared"].GetUint64());
+    EXPECT_EQ(0u, report["schemas"]["duplicated"].GetUint64());
+    EXPECT_GT(report["schemas"]["bytes"].GetUint64(), 0u);
+    EXPECT_EQ(1u, report["deserializers"]["compiled"].GetUint64());
+    EXPECT_EQ(2u, report["deserializers"]["references"].GetUint64());
+    EXPECT_GT(report["specRefs"]["count"].GetUint64(), 0u);
+
+    for (const auto& route : report["routes"]["items"].GetArray()) {
+        EXPECT_EQ(std::string("/c") == route["path"].GetString() ? "POST" : "GET",
+                  std::string(route["method"].GetString()));
+        EXPECT_EQ(1u, route["validators"].GetUint64());
+        EXPECT_GT(route["schemaBytes"].GetUint64(), 0u);
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "oas_validator.hpp"
+#include "utils/common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+const char* const kSpecs = R"({
+  "openapi": "3.0.0",
+  "paths": {
+    "/items/{id}": {
+      "post": {
+        "parameters": [
+          {"name": "id", "in": "path", "required": true, "schema": {"type": "integer"}},
+          {"name": "X-Tenant", "in": "header", "required": true, "schema": {"type": "string", "enum": ["acme"]}}
+        ],
+        "requestBody": {"content": {"application/json": {"schema": {"type": "array"}}}}
+      }
+    }
+  }
+})";
+
+struct Failure
+{
+    std::string http_path;
+    ValidationError error;
+};
+} // namespace
+
+TEST(ShadowValidatorTest, ValidatesInTheBackground)
+{
+    OASValidator validator(kSpecs);
+    std::mutex mutex;
+    std::vector<Failure> failures;
+    ShadowOptions options;
+    options.threads = 2;
+    ShadowValidator shadow(validator, options,
+                           [&](const ShadowRequest& request, ValidationError error, const std::string& error_msg) {
+                               EXPECT_FALSE(error_msg.empty());
+                               std::lock_guard<std::mutex> lock(mutex);
+                               failures.push_back({request.http_path, error});
+                           });
+    const HeaderField acme[] = {{"x-tenant", 8, "acme", 4}};
+    const HeaderField other[] = {{"X-Tenant", 8, "other", 5}};
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/1", "[1]", acme, 1));
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/2", "{}", acme, 1));
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/3", "[]", other, 1));
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/4", acme, 1)); // No body
+    EXPECT_TRUE(shadow.Enqueue("GET", "/items/5", "[]", acme, 1));
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/6", "", acme, 1)); // Empty body
+
+    ShadowRequest request;
+    request.method = "post";
+    request.http_path = "/items/x";
+    request.json_body = "[]";
+    request.headers.emplace_back("X-Tenant", "acme");
+    request.has_body = true;
+    EXPECT_TRUE(shadow.Enqueue(std::move(request)));
+    request.method = "POST";
+    request.http_path = "/items/7";
+    request.headers.emplace_back("X-Tenant", "acme");
+    request.has_body = true;
+    EXPECT_TRUE(shadow.Enqueue(std::move(request))); // Empty body
+
+    shadow.Flush();
+    const auto stats = shadow.GetStats();
+    EXPECT_EQ(8U, stats.enqueued);
+    EXPECT_EQ(0U, stats.dropped);
+    EXPECT_EQ(8U, stats.validated);
+    EXPECT_EQ(6U, stats.failed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::sort(failures.begin(), failures.end(),
+              [](const Failure& lhs, const Failure& rhs) { return lhs.http_path < rhs.http_path; });
+    ASSERT_EQ(6U, failures.size());
+    EXPECT_EQ("/items/2", failures[0].http_path);
+    EXPECT_EQ(ValidationError::INVALID_BODY, failures[0].error);
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM, failures[1].error);
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, failures[2].error);
+    EXPECT_EQ("/items/6", failures[3].http_path);
+    EXPECT_EQ(ValidationError::INVALID_BODY, failures[3].error);
+    EXPECT_EQ("/items/7", failures[4].http_path);
+    EXPECT_EQ(ValidationError::INVALID_BODY, failures[4].error);
+    EXPECT_EQ("/items/x", failures[5].http_path);
+    EXPECT_EQ(ValidationError::INVALID_PATH_PARAM, failures[5].error);
+}
+
+TEST(ShadowValidatorTest, HandsBackClearedRequests)
+{
+    OASValidator validator(kSpecs);
+    ShadowOptions options;
+    options.queue_capacity = 2;
+    ShadowValidator shadow(validator, options);
+    for (size_t idx = 0; idx < 4; ++idx) {
+        ShadowRequest request;
+        request.method = "POST";
+        request.http_path = "/items/" + std::to_string(idx);
+        request.json_body = "[]";
+        request.headers.emplace_back("Authorization", "Bearer secret");
+        request.has_body = true;
+        shadow.Flush(); // From the third request on, the slot has held a validated one
+        EXPECT_TRUE(shadow.Enqueue(std::move(request)));
+        EXPECT_TRUE(request.method.empty());
+        EXPECT_TRUE(request.http_path.empty());
+        EXPECT_TRUE(request.json_body.empty());
+        EXPECT_TRUE(request.headers.empty());
+        EXPECT_FALSE(request.has_body);
+    }
+}
+
+TEST(ShadowValidatorTest, DropsWhenFull)
+{
+    OASValidator validator(kSpecs);
+    std::atomic<bool> blocked{true};
+    ShadowOptions options;
+    options.queue_capacity = 2;
+    ShadowValidator shadow(validator, options, [&blocked](const ShadowRequest&, ValidationError, const std::string&) {
+        while (blocked) {
+            std::this_thread::yield();
+        }
+    });
+    // The slot of a request is freed once it is validated, the callback holds the first one
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/x", "[]", nullptr, 0));
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/x", "[]", nullptr, 0));
+    EXPECT_FALSE(shadow.Enqueue("POST", "/items/x", "[]", nullptr, 0));
+    ShadowRequest request;
+    request.http_path = "/items/1";
+    EXPECT_FALSE(shadow.Enqueue(std::move(request)));
+    EXPECT_EQ("/items/1", request.http_path); // Left unchanged
+    blocked = false;
+    shadow.Flush();
+    const auto stats = shadow.GetStats();
+    EXPECT_EQ(2U, stats.enqueued);
+    EXPECT_EQ(2U, stats.dropped);
+    EXPECT_EQ(2U, stats.validated);
+    EXPECT_TRUE(shadow.Enqueue("POST", "/items/x", "[]", nullptr, 0));
+}
+
+TEST(ShadowValidatorTest, ValidatesQueuedRequestsWhenDestroyed)
+{
+    OASValidator validator(kSpecs);
+    std::atomic<size_t> failures{0};
+    {
+        ShadowOptions options;
+        options.threads = 3;
+        options.queue_capacity = 256;
+        ShadowValidator shadow(validator, options,
+                               [&failures](const ShadowRequest&, ValidationError, const std::string&) { ++failures; });
+        std::vector<std::thread> producers;
+        for (size_t idx = 0; idx < 4; ++idx) {
+            producers.emplace_back([&shadow]() {
+                for (size_t count = 0; count < 50;) {
+                    count += shadow.Enqueue("POST", "/items/1", "{}", nullptr, 0) ? 1 : 0;
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+    }
+    EXPECT_EQ(200U, failures.load());
+}
+
+TEST(ShadowValidatorTest, InvalidOptions)
+{
+    OASValidator validator(kSpecs);
+    ShadowOptions options;
+    options.threads = 0;
+    EXPECT_THROW(ShadowValidator(validator, options), ValidatorInitExc);
+    options.threads = 1;
+    options.queue_capacity = 0;
+    EXPECT_THROW(ShadowValidator(validator, options), ValidatorInitExc);
+}
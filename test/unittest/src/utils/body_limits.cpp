@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/body_limits.hpp"
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace {
+// Parses `json` through the limiter, the limit it exceeded if any
+BodyLimit Parse(const std::string& json, const BodyLimits& limits, const ValidationDeadline* deadline = nullptr)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    BodyLimiter<rapidjson::Writer<rapidjson::StringBuffer>> limiter(writer, limits, deadline);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(json.c_str());
+    const bool parsed = !reader.Parse<rapidjson::kParseIterativeFlag>(stream, limiter).IsError();
+    EXPECT_EQ(parsed, BodyLimit::NONE == limiter.GetExceeded());
+    return limiter.GetExceeded();
+}
+
+std::string Write(const rapidjson::Document& doc)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    EXPECT_TRUE(AcceptIteratively(doc, writer));
+    return buffer.GetString();
+}
+} // namespace
+
+TEST(BodyLimiterTest, Depth)
+{
+    BodyLimits limits;
+    limits.max_depth = 2;
+    EXPECT_EQ(BodyLimit::NONE, Parse(R"([1, {"a": 2, "b": "c"}, []])", limits));
+    EXPECT_EQ(BodyLimit::DEPTH, Parse(R"([1, {"a": []}])", limits));
+    EXPECT_EQ(BodyLimit::NONE, Parse(R"("scalar")", limits));
+    EXPECT_EQ(BodyLimit::NONE, Parse(std::string(100, '[') + std::string(100, ']'), BodyLimits()));
+}
+
+TEST(BodyLimiterTest, ItemsAndMembersPerContainer)
+{
+    BodyLimits limits;
+    limits.max_array_items = 2;
+    limits.max_object_members = 2;
+    EXPECT_EQ(BodyLimit::NONE, Parse(R"([[1, 2], {"a": [3, 4], "b": 5}])", limits));
+    EXPECT_EQ(BodyLimit::ARRAY_ITEMS, Parse(R"([[1, 2], [3, 4, 5]])", limits));
+    EXPECT_EQ(BodyLimit::ARRAY_ITEMS, Parse(R"([{}, [], null])", limits));
+    EXPECT_EQ(BodyLimit::OBJECT_MEMBERS, Parse(R"({"a": {"x": 1, "y": 2}, "b": [], "c": 3})", limits));
+    EXPECT_EQ(BodyLimit::OBJECT_MEMBERS, Parse(R"([{"x": 1, "y": 2, "z": 3}])", limits));
+}
+
+TEST(BodyLimiterTest, StringLength)
+{
+    BodyLimits limits;
+    limits.max_string_length = 3;
+    EXPECT_EQ(BodyLimit::NONE, Parse(R"({"abc": "xyz"})", limits));
+    EXPECT_EQ(BodyLimit::STRING_LENGTH, Parse(R"({"abc": "wxyz"})", limits));
+    EXPECT_EQ(BodyLimit::STRING_LENGTH, Parse(R"({"abcd": 1})", limits));
+    EXPECT_EQ(BodyLimit::NONE, Parse(R"(["\u00e9"])", limits)); // Bytes once decoded, not of the escapes
+}
+
+TEST(BodyLimiterTest, HasParseLimits)
+{
+    BodyLimits limits;
+    limits.max_bytes = 10;
+    EXPECT_FALSE(HasParseLimits(limits));
+    limits.max_string_length = 10;
+    EXPECT_TRUE(HasParseLimits(limits));
+}
+
+TEST(BodyLimiterTest, Deadline)
+{
+    std::string json = "[0";
+    for (size_t idx = 1; idx < 10 * BodyLimiter<rapidjson::Document>::kDeadlineInterval; ++idx) {
+        json += ",0";
+    }
+    json += "]";
+    ValidationDeadline deadline;
+    EXPECT_EQ(BodyLimit::NONE, Parse(json, BodyLimits(), &deadline));
+
+    std::atomic<bool> cancelled{true};
+    deadline.cancelled = &cancelled;
+    EXPECT_EQ(BodyLimit::DEADLINE, Parse(json, BodyLimits(), &deadline));
+    cancelled = false;
+    EXPECT_EQ(BodyLimit::NONE, Parse(json, BodyLimits(), &deadline));
+
+    deadline.time = std::chrono::steady_clock::now();
+    EXPECT_EQ(BodyLimit::DEADLINE, Parse("1", BodyLimits(), &deadline)); // Checked from the first value
+    EXPECT_EQ(BodyLimit::DEADLINE, Parse(json, BodyLimits(), &deadline));
+}
+
+TEST(AcceptIterativelyTest, SameEventsAsAccept)
+{
+    const std::string json =
+        R"({"a":[1,-2,3.5,4294967295,-9007199254740993,true,false,null],"b":{},"c":[[],{"d":"e"}]})";
+    rapidjson::Document doc;
+    doc.Parse(json.c_str());
+    EXPECT_EQ(json, Write(doc));
+
+    doc.Parse("[]");
+    EXPECT_EQ("[]", Write(doc));
+    doc.Parse("12");
+    EXPECT_EQ("12", Write(doc));
+}
+
+TEST(AcceptIterativelyTest, DeepDocuments)
+{
+    const size_t depth = 100000;
+    const std::string json = std::string(depth, '[') + "1" + std::string(depth, ']');
+    rapidjson::Document doc;
+    doc.Parse<rapidjson::kParseIterativeFlag>(json.c_str());
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_EQ(json, Write(doc));
+}
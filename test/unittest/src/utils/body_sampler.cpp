@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/body_sampler.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+// Bodies of `count` sampled, each recorded as validated in `nanoseconds`
+size_t Validate(BodySampler& sampler, size_t count, uint64_t nanoseconds = 1000)
+{
+    size_t checked = 0;
+    for (size_t idx = 0; idx < count; ++idx) {
+        if (sampler.Sample()) {
+            sampler.Record(nanoseconds);
+            ++checked;
+        }
+    }
+    return checked;
+}
+
+BodySamplingStats GetStats(const BodySampler& sampler)
+{
+    BodySamplingStats stats;
+    sampler.GetStats(stats);
+    return stats;
+}
+} // namespace
+
+TEST(BodySamplerTest, All)
+{
+    BodySampler sampler;
+    for (size_t idx = 0; idx < 100; ++idx) {
+        EXPECT_TRUE(sampler.Sample());
+    }
+    const auto stats = GetStats(sampler);
+    EXPECT_EQ(BodySamplingMode::ALL, stats.mode);
+    EXPECT_EQ(0U, stats.checked + stats.skipped); // Not counted
+}
+
+TEST(BodySamplerTest, FixedRate)
+{
+    BodySampling sampling;
+    sampling.mode = BodySamplingMode::FIXED_RATE;
+    sampling.rate = 0.25;
+    BodySampler sampler(sampling);
+    const auto checked = Validate(sampler, 100000);
+    EXPECT_NEAR(25000, static_cast<double>(checked), 1000);
+    const auto stats = GetStats(sampler);
+    EXPECT_EQ(checked, stats.checked);
+    EXPECT_EQ(100000 - checked, stats.skipped);
+    EXPECT_EQ(1000 * checked, stats.nanoseconds);
+
+    sampling.rate = 0;
+    BodySampler none(sampling);
+    EXPECT_EQ(0U, Validate(none, 1000));
+    sampling.rate = 1;
+    BodySampler every(sampling);
+    EXPECT_EQ(1000U, Validate(every, 1000));
+}
+
+TEST(BodySamplerTest, TokenBucket)
+{
+    BodySampling sampling;
+    sampling.mode = BodySamplingMode::TOKEN_BUCKET;
+    sampling.bodies_per_second = 0.001; // A body every 1000 s, after the burst
+    sampling.burst = 3;
+    BodySampler sampler(sampling);
+    EXPECT_EQ(3U, Validate(sampler, 100));
+    EXPECT_EQ(97U, GetStats(sampler).skipped);
+
+    sampling.bodies_per_second = 1e9; // A body per nanosecond, faster than they are sampled
+    BodySampler unlimited(sampling);
+    EXPECT_EQ(1000U, Validate(unlimited, 1000));
+}
+
+TEST(BodySamplerTest, TokenBucketAcrossThreads)
+{
+    BodySampling sampling;
+    sampling.mode = BodySamplingMode::TOKEN_BUCKET;
+    sampling.bodies_per_second = 0.001;
+    sampling.burst = 50;
+    BodySampler sampler(sampling);
+    std::vector<std::thread> threads;
+    for (size_t idx = 0; idx < 4; ++idx) {
+        threads.emplace_back([&sampler]() { Validate(sampler, 10000); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto stats = GetStats(sampler);
+    EXPECT_EQ(50U, stats.checked);
+    EXPECT_EQ(4 * 10000U - 50, stats.skipped);
+}
+
+TEST(BodySamplerTest, CpuBudget)
+{
+    BodySampling sampling;
+    sampling.mode = BodySamplingMode::CPU_BUDGET;
+    sampling.budget_ns_per_second = 1000000; // 1 ms per second
+    BodySampler sampler(sampling);
+    // 100 us bodies are worth 100 ms of the budget each, bodies are skipped once two are validated
+    EXPECT_EQ(2U, Validate(sampler, 100, 100000));
+    EXPECT_EQ(200000U, GetStats(sampler).nanoseconds);
+
+    sampling.budget_ns_per_second = 1000000000; // A core
+    BodySampler core(sampling);
+    EXPECT_EQ(100U, Validate(core, 100, 100000)); // 10 ms of validation, within the window
+}
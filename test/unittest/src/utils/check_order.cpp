@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/check_order.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+std::array<RequestCheck, CheckOrder::kChecks> GetOrder(const CheckOrder& check_order)
+{
+    RequestCheck order[CheckOrder::kChecks];
+    check_order.GetOrder(order);
+    return {{order[0], order[1], order[2], order[3]}};
+}
+
+const std::array<RequestCheck, CheckOrder::kChecks> kCheapFirst{
+    {RequestCheck::PATH_PARAMS, RequestCheck::QUERY_PARAMS, RequestCheck::HEADERS, RequestCheck::BODY}};
+} // namespace
+
+TEST(CheckOrderTest, SamplesUntilLearned)
+{
+    CheckOrder check_order;
+    EXPECT_EQ(kCheapFirst, GetOrder(check_order));
+    size_t sampled = 0;
+    for (size_t i = 0; i < 10 * CheckOrder::kSampleInterval; ++i) {
+        sampled += check_order.Sample() ? 1 : 0;
+    }
+    EXPECT_EQ(10U, sampled);
+
+    for (int i = 0; i < 3; ++i) {
+        check_order.Record(RequestCheck::PATH_PARAMS, 10, false);
+        check_order.EndSample(3);
+    }
+    ValidationOrderStats stats;
+    check_order.GetStats(stats);
+    EXPECT_TRUE(stats.learned);
+    EXPECT_EQ(3U, stats.samples);
+    EXPECT_EQ(3U, stats.checks[0].runs);
+    EXPECT_EQ(30U, stats.checks[0].nanoseconds);
+    for (size_t i = 0; i < 10 * CheckOrder::kSampleInterval; ++i) {
+        EXPECT_FALSE(check_order.Sample());
+    }
+}
+
+TEST(CheckOrderTest, OrdersByTimePerFailure)
+{
+    CheckOrder check_order;
+    for (int i = 0; i < 100; ++i) {
+        check_order.Record(RequestCheck::PATH_PARAMS, 50, false); // Never fails, cheapest
+        check_order.Record(RequestCheck::QUERY_PARAMS, 100, false); // Never fails
+        check_order.Record(RequestCheck::HEADERS, 200, 0 == i % 10); // 2000 ns per failure
+        check_order.Record(RequestCheck::BODY, 1000, 0 == i % 2); // 2000 ns per failure, ties keep headers first
+        check_order.EndSample(100);
+    }
+    const std::array<RequestCheck, CheckOrder::kChecks> expected{
+        {RequestCheck::HEADERS, RequestCheck::BODY, RequestCheck::PATH_PARAMS, RequestCheck::QUERY_PARAMS}};
+    EXPECT_EQ(expected, GetOrder(check_order));
+
+    ValidationOrderStats stats;
+    check_order.GetStats(stats);
+    EXPECT_EQ(expected, stats.order);
+    EXPECT_EQ(50U, stats.checks[static_cast<size_t>(RequestCheck::BODY)].failures);
+    EXPECT_EQ(100000U, stats.checks[static_cast<size_t>(RequestCheck::BODY)].nanoseconds);
+
+    check_order.Record(RequestCheck::PATH_PARAMS, 1, true); // The order no longer changes
+    check_order.EndSample(100);
+    EXPECT_EQ(expected, GetOrder(check_order));
+}
+
+TEST(CheckOrderTest, NeverValidatedLast)
+{
+    CheckOrder check_order;
+    check_order.Record(RequestCheck::PATH_PARAMS, 10, false);
+    check_order.Record(RequestCheck::QUERY_PARAMS, 10, true);
+    check_order.EndSample(1);
+    const std::array<RequestCheck, CheckOrder::kChecks> expected{
+        {RequestCheck::QUERY_PARAMS, RequestCheck::PATH_PARAMS, RequestCheck::HEADERS, RequestCheck::BODY}};
+    EXPECT_EQ(expected, GetOrder(check_order));
+}
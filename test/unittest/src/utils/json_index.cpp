@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/json_index.hpp"
+#include "utils/simd.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+// Records the SAX events as text, so that both readers can be compared
+struct EventRecorder: public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, EventRecorder>
+{
+    std::string events{};
+    size_t stop_after = SIZE_MAX; // Event count after which the handler stops the parse
+
+    bool Record(const std::string& event)
+    {
+        events += event + ";";
+        return 0 != stop_after--;
+    }
+
+    bool Null()
+    {
+        return Record("null");
+    }
+
+    bool Bool(bool b)
+    {
+        return Record(b ? "true" : "false");
+    }
+
+    bool Int(int i)
+    {
+        return Record("int:" + std::to_string(i));
+    }
+
+    bool Uint(unsigned u)
+    {
+        return Record("uint:" + std::to_string(u));
+    }
+
+    bool Int64(int64_t i)
+    {
+        return Record("int64:" + std::to_string(i));
+    }
+
+    bool Uint64(uint64_t u)
+    {
+        return Record("uint64:" + std::to_string(u));
+    }
+
+    bool Double(double d)
+    {
+        char str[32];
+        snprintf(str, sizeof(str), "%a", d); // Exact
+        return Record(std::string("double:") + str);
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool)
+    {
+        EXPECT_EQ('\0', str[length]); // Patterns are matched on the null-terminated string
+        return Record("string:" + std::string(str, length));
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool)
+    {
+        EXPECT_EQ('\0', str[length]);
+        return Record("key:" + std::string(str, length));
+    }
+
+    bool StartObject()
+    {
+        return Record("{");
+    }
+
+    bool EndObject(rapidjson::SizeType count)
+    {
+        return Record("}" + std::to_string(count));
+    }
+
+    bool StartArray()
+    {
+        return Record("[");
+    }
+
+    bool EndArray(rapidjson::SizeType count)
+    {
+        return Record("]" + std::to_string(count));
+    }
+};
+} // namespace
+
+// Every test runs once per kernel variant the host supports
+class JsonIndexTest: public ::testing::TestWithParam<SimdLevel>
+{
+protected:
+    void SetUp() override
+    {
+        if (static_cast<int>(GetParam()) > static_cast<int>(GetMaxSimdLevel())) {
+            GTEST_SKIP() << GetSimdLevelName(GetParam()) << " is not supported by this host";
+        }
+        SetSimdLevel(GetParam());
+    }
+
+    void TearDown() override
+    {
+        SetSimdLevel(GetMaxSimdLevel());
+    }
+
+    // Not null-terminated, so that reads past the end are caught by sanitizers
+    static void ExpectSameAsRapidJson(const std::string& json)
+    {
+        const std::unique_ptr<char[]> copy(new char[json.size()]);
+        std::copy(json.begin(), json.end(), copy.get());
+        JsonIndexReader reader;
+        EventRecorder indexed;
+        const bool indexed_ok = reader.Parse(copy.get(), json.size(), indexed);
+
+        rapidjson::Reader expected_reader;
+        rapidjson::StringStream stream(json.c_str());
+        EventRecorder expected;
+        const bool expected_ok = !expected_reader.Parse(stream, expected).IsError();
+
+        EXPECT_EQ(expected_ok, indexed_ok) << json;
+        EXPECT_EQ(expected_ok, !reader.HasParseError()) << json;
+        if (expected_ok) {
+            EXPECT_EQ(expected.events, indexed.events) << json;
+        }
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(Levels, JsonIndexTest,
+                         ::testing::Values(SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2),
+                         [](const ::testing::TestParamInfo<SimdLevel>& info) {
+                             return std::string(GetSimdLevelName(info.param));
+                         });
+
+TEST_P(JsonIndexTest, SameEventsAsRapidJson)
+{
+    const std::vector<std::string> documents = {
+        "{}",
+        "[]",
+        "  {\"a\" : [1, 2.5, -3, true, false, null, \"x\"], \"b\":{\"c\":{}} , \"d\":[[],[{}]]}\r\n",
+        "\"root string\"",
+        "42",
+        "-0",
+        "null",
+        "[0, 4294967295, 4294967296, 18446744073709551615, 18446744073709551616]",
+        "[-2147483648, -2147483649, -9223372036854775808, -9223372036854775809]",
+        "[0.1, 1e10, 1E-5, -2.5e+3, 123456789012345678901234567890, 2.2250738585072014e-308]",
+        R"(["\"\\\/\b\f\n\r\t", "\u0041\u00e9\u4e2d", "\ud83d\ude00", "a\\\"b\\\\"])",
+        "[\"caf\xC3\xA9\", \"\xE4\xB8\xAD\xE6\x96\x87\", \"\xF0\x9F\x98\x80\"]",
+        R"({"key with spaces":"value","":"","nested":{"deep":[[[[["end"]]]]]}})",
+    };
+    for (const auto& json : documents) {
+        ExpectSameAsRapidJson(json);
+    }
+}
+
+TEST_P(JsonIndexTest, EscapesAcrossBlocks)
+{
+    // Backslash runs and quotes at every offset around the 64 byte block boundaries
+    std::mt19937 random(42);
+    const char* pieces[] = {"a", "\\\\", "\\\"", "\\\\\\\"", "\\n", " ", "{", ":", ","};
+    for (int i = 0; i < 500; ++i) {
+        std::string json = "[" + std::string(random() % 70, ' ');
+        const size_t strings = 1 + random() % 6;
+        for (size_t j = 0; j < strings; ++j) {
+            json += j ? ",\"" : "\"";
+            const size_t length = random() % 80;
+            for (size_t k = 0; k < length; ++k) {
+                json += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+            }
+            json += "\"";
+        }
+        json += "]";
+        ExpectSameAsRapidJson(json);
+    }
+}
+
+TEST_P(JsonIndexTest, MalformedDocuments)
+{
+    const std::vector<std::pair<std::string, rapidjson::ParseErrorCode>> documents = {
+        {"", rapidjson::kParseErrorDocumentEmpty},
+        {"  \n ", rapidjson::kParseErrorDocumentEmpty},
+        {"{} {}", rapidjson::kParseErrorDocumentRootNotSingular},
+        {"12x", rapidjson::kParseErrorDocumentRootNotSingular},
+        {"{\"a\" 1}", rapidjson::kParseErrorObjectMissColon},
+        {"{1:1}", rapidjson::kParseErrorObjectMissName},
+        {"{\"a\":1,}", rapidjson::kParseErrorObjectMissName},
+        {"{\"a\":1 \"b\":2}", rapidjson::kParseErrorObjectMissCommaOrCurlyBracket},
+        {"{\"a\":1]", rapidjson::kParseErrorObjectMissCommaOrCurlyBracket},
+        {"[1 2]", rapidjson::kParseErrorArrayMissCommaOrSquareBracket},
+        {"[1,]", rapidjson::kParseErrorValueInvalid},
+        {"[1", rapidjson::kParseErrorArrayMissCommaOrSquareBracket},
+        {"[tru]", rapidjson::kParseErrorValueInvalid},
+        {"[nulls]", rapidjson::kParseErrorArrayMissCommaOrSquareBracket},
+        {"[-]", rapidjson::kParseErrorValueInvalid},
+        {"[1.]", rapidjson::kParseErrorNumberMissFraction},
+        {"[1e+]", rapidjson::kParseErrorNumberMissExponent},
+        {"[1e400]", rapidjson::kParseErrorNumberTooBig},
+        {"[\"abc]", rapidjson::kParseErrorStringMissQuotationMark},
+        {"[\"a\\x\"]", rapidjson::kParseErrorStringEscapeInvalid},
+        {"[\"\\u12G4\"]", rapidjson::kParseErrorStringUnicodeEscapeInvalidHex},
+        {"[\"\\ud83d\"]", rapidjson::kParseErrorStringUnicodeSurrogateInvalid},
+        {"[\"\\ude00\"]", rapidjson::kParseErrorStringUnicodeSurrogateInvalid},
+        {"[\"tab\there\"]", rapidjson::kParseErrorStringInvalidEncoding},
+    };
+    for (const auto& document : documents) {
+        JsonIndexReader reader;
+        EventRecorder recorder;
+        EXPECT_FALSE(reader.Parse(document.first.data(), document.first.size(), recorder)) << document.first;
+        EXPECT_EQ(document.second, reader.GetParseErrorCode()) << document.first;
+        ExpectSameAsRapidJson(document.first);
+    }
+}
+
+TEST_P(JsonIndexTest, InvalidUtf8)
+{
+    const std::vector<std::pair<std::string, size_t>> documents = {
+        {"[\"\xC3\"]", 2}, // Truncated
+        {"[\"\xC0\xAF\"]", 2}, // Overlong
+        {"[\"\xED\xA0\x80\"]", 2}, // Surrogate
+        {"[\"\xF4\x90\x80\x80\"]", 2}, // Above U+10FFFF
+        {"[\"" + std::string(100, 'a') + "\xFF\"]", 102},
+    };
+    for (const auto& document : documents) {
+        JsonIndexReader reader;
+        EventRecorder recorder;
+        EXPECT_FALSE(reader.Parse(document.first.data(), document.first.size(), recorder));
+        EXPECT_EQ(rapidjson::kParseErrorStringInvalidEncoding, reader.GetParseErrorCode());
+        EXPECT_EQ(document.second, reader.GetErrorOffset());
+    }
+}
+
+TEST_P(JsonIndexTest, HandlerStopsParse)
+{
+    const std::string json(R"({"a":[1,2,3],"b":"c"})");
+    JsonIndexReader reader;
+    EventRecorder recorder;
+    recorder.stop_after = 3;
+    EXPECT_FALSE(reader.Parse(json.data(), json.size(), recorder));
+    EXPECT_EQ(rapidjson::kParseErrorTermination, reader.GetParseErrorCode());
+    EXPECT_EQ("{;key:a;[;uint:1;", recorder.events);
+}
+
+TEST_P(JsonIndexTest, AcrossChunks)
+{
+    // Text is indexed 4 KiB at a time, strings, numbers and UTF-8 sequences are cut at every offset around the end
+    // of the first chunk
+    const std::vector<std::string> values = {"\"\xE4\xB8\xAD\xF0\x9F\x98\x80 text\"", "\"esc\\\"aped\\\\\"",
+                                             "12345678", "-2.5e10", "true", "null", "[{\"k\":\"v\"}]"};
+    for (const auto& value : values) {
+        for (size_t padding = 4070; padding < 4100; ++padding) {
+            ExpectSameAsRapidJson("[" + std::string(padding, ' ') + value + "]");
+        }
+    }
+    // Long string spanning several chunks
+    ExpectSameAsRapidJson("{\"long\":\"" + std::string(10000, 'x') + "\xC3\xA9\",\"after\":[1,2]}");
+
+    const std::string invalid = "[\"" + std::string(4093, 'a') + "\xE4\xB8\"]";
+    JsonIndexReader reader;
+    EventRecorder recorder;
+    EXPECT_FALSE(reader.Parse(invalid.data(), invalid.size(), recorder));
+    EXPECT_EQ(rapidjson::kParseErrorStringInvalidEncoding, reader.GetParseErrorCode());
+    EXPECT_EQ(4095, reader.GetErrorOffset());
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/param_values.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+void Add(ParamValues& values, const std::string& name, const char* json)
+{
+    rapidjson::Document doc;
+    doc.Parse(json);
+    ASSERT_FALSE(doc.HasParseError()) << json;
+    ParamValuesBuilder::Add(values, name, doc);
+}
+} // namespace
+
+TEST(ParamValuesTest, ConvertsTypes)
+{
+    ParamValues values;
+    Add(values, "flag", "true");
+    Add(values, "id", "-42");
+    Add(values, "ratio", "0.5");
+    Add(values, "big", "18446744073709551615");
+    Add(values, "name", R"("a\u0000b")");
+    Add(values, "none", "null");
+    ParamValuesBuilder::AddMissing(values, "page");
+
+    ASSERT_EQ(7U, values.GetCount());
+    EXPECT_EQ(ParamType::BOOLEAN, values.Get("flag").type);
+    EXPECT_TRUE(values.Get("flag").boolean);
+    EXPECT_EQ(ParamType::INTEGER, values.Get(1).type);
+    EXPECT_EQ(-42, values.Get(1).integer);
+    EXPECT_EQ(-42.0, values.Get(1).number);
+    EXPECT_EQ(ParamType::NUMBER, values.Get("ratio").type);
+    EXPECT_EQ(0.5, values.Get("ratio").number);
+    EXPECT_EQ(ParamType::NUMBER, values.Get("big").type); // Beyond int64_t
+    EXPECT_EQ(ParamType::STRING, values.Get("name").type);
+    EXPECT_EQ(std::string("a\0b", 3), std::string(values.Get("name").string, values.Get("name").length));
+    EXPECT_EQ(ParamType::NULL_VALUE, values.Get("none").type);
+    EXPECT_EQ(ParamType::MISSING, values.Get("page").type);
+    EXPECT_EQ("page", std::string(values.Get(6).name, values.Get(6).name_length));
+
+    EXPECT_EQ(ParamType::MISSING, values.Get("other").type);
+    EXPECT_EQ(ParamType::MISSING, values.Get(7).type);
+}
+
+TEST(ParamValuesTest, ConvertsArraysAndObjects)
+{
+    ParamValues values;
+    Add(values, "tags", R"(["a", "bc", "def"])");
+    Add(values, "point", R"({"x": 1, "y": 2.5, "label": "p", "nested": {"z": [true]}})");
+    Add(values, "empty", "[]");
+
+    const auto& tags = values.Get("tags");
+    ASSERT_EQ(ParamType::ARRAY, tags.type);
+    ASSERT_EQ(3U, tags.length);
+    EXPECT_EQ("bc", std::string(tags.GetItem(1).string, tags.GetItem(1).length));
+    EXPECT_EQ(ParamType::MISSING, tags.GetItem(3).type);
+    EXPECT_EQ(ParamType::MISSING, tags.GetMember("a").type);
+
+    const auto& point = values.Get("point");
+    ASSERT_EQ(ParamType::OBJECT, point.type);
+    EXPECT_EQ(4U, point.length);
+    EXPECT_EQ(1, point.GetMember("x").integer);
+    EXPECT_EQ(2.5, point.GetMember("y").number);
+    EXPECT_EQ("label", std::string(point.GetItem(2).name, point.GetItem(2).name_length));
+    EXPECT_TRUE(point.GetMember("nested").GetMember("z").GetItem(0).boolean);
+    EXPECT_EQ(ParamType::MISSING, point.GetMember("w").type);
+
+    EXPECT_EQ(ParamType::ARRAY, values.Get("empty").type);
+    EXPECT_EQ(0U, values.Get("empty").length);
+}
+
+TEST(ParamValuesTest, ClearKeepsMemory)
+{
+    ParamValues values;
+    EXPECT_EQ(0U, values.GetMemoryUsage());
+    const std::string long_string = "\"" + std::string(10000, 'x') + "\"";
+    Add(values, "short", R"("abc")");
+    Add(values, "long", long_string.c_str()); // Larger than a block
+    EXPECT_EQ(10000U, values.Get("long").length);
+    const size_t bytes = values.GetMemoryUsage();
+
+    for (int i = 0; i < 3; ++i) {
+        values.Clear();
+        EXPECT_EQ(0U, values.GetCount());
+        Add(values, "short", R"("abc")");
+        Add(values, "long", long_string.c_str());
+        EXPECT_EQ("abc", std::string(values.Get("short").string, values.Get("short").length));
+        EXPECT_EQ(bytes, values.GetMemoryUsage());
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/path_normalizer.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class PathNormalizerTest: public ::testing::Test
+{
+protected:
+    std::string request_path_; // Segments point into it
+    NormalizedPath path_;
+
+    // Keys of the segments joined by '/', "!" for a path that cannot be normalized
+    std::string Normalize(const PathNormalizer& normalizer, const std::string& request_path)
+    {
+        request_path_ = request_path;
+        if (!normalizer.Normalize(request_path_.c_str(), request_path_.c_str() + request_path_.size(), path_)) {
+            return "!";
+        }
+        std::string joined;
+        std::string key;
+        for (size_t idx = 0; idx < path_.GetSegmentCount(); ++idx) {
+            path_.GetKey(idx, key);
+            joined += (0 == idx ? "" : "/") + key;
+        }
+        return joined;
+    }
+
+    // Range routed as is, "-" for a path that has to be normalized
+    std::string GetCanonical(const PathNormalizer& normalizer) const
+    {
+        const char* beg;
+        const char* end;
+        return normalizer.GetCanonicalRange(request_path_.c_str(), request_path_.c_str() + request_path_.size(), beg,
+                                            end)
+                   ? std::string(beg, end)
+                   : "-";
+    }
+};
+
+TEST_F(PathNormalizerTest, CollapsesSlashesAndDotSegments)
+{
+    PathNormalization options;
+    options.collapse_slashes = true;
+    options.remove_dot_segments = true;
+    const PathNormalizer normalizer(options, {});
+    EXPECT_TRUE(normalizer.IsEnabled());
+
+    EXPECT_EQ("/pets/42", Normalize(normalizer, "/pets/42"));
+    EXPECT_EQ("/pets/42", GetCanonical(normalizer));
+    EXPECT_EQ("/pets/42", Normalize(normalizer, "/pets/42/"));
+    EXPECT_EQ("/pets/42", GetCanonical(normalizer)); // Without the trailing slash
+    EXPECT_EQ("/pets/42", Normalize(normalizer, "//pets///42"));
+    EXPECT_EQ("-", GetCanonical(normalizer));
+    EXPECT_EQ("/pets/42", Normalize(normalizer, "/pets/./toys/../42"));
+    EXPECT_EQ("-", GetCanonical(normalizer));
+    EXPECT_EQ("/etc/passwd", Normalize(normalizer, "/pets/../../../etc/passwd"));
+    EXPECT_EQ("", Normalize(normalizer, "/pets/.."));
+    EXPECT_EQ("", Normalize(normalizer, "/"));
+    EXPECT_EQ("/", GetCanonical(normalizer));
+    EXPECT_EQ("/pets/.../x", Normalize(normalizer, "/pets/.../x"));
+
+    const PathNormalizer disabled(PathNormalization(), {});
+    EXPECT_FALSE(disabled.IsEnabled());
+    EXPECT_EQ("//pets/./42", Normalize(disabled, "//pets/./42/"));
+    EXPECT_EQ("//pets/./42/", GetCanonical(disabled));
+}
+
+TEST_F(PathNormalizerTest, DecodesUnreservedEscapes)
+{
+    PathNormalization options;
+    options.decode_unreserved = true;
+    const PathNormalizer normalizer(options, {});
+    EXPECT_EQ("/pets/~42", Normalize(normalizer, "/%70ets/%7e42"));
+    EXPECT_EQ("-", GetCanonical(normalizer));
+    EXPECT_EQ("%7e42", std::string(path_.GetSegment(2).beg, path_.GetSegment(2).end)); // As sent
+    EXPECT_EQ("/files/a%20b/%2F/%zz/%4", Normalize(normalizer, "/files/a%20b/%2F/%zz/%4"));
+    EXPECT_EQ("/files/a%20b/%2F/%zz/%4", GetCanonical(normalizer)); // Escapes of reserved characters are kept
+    EXPECT_EQ("/%", Normalize(normalizer, "/%"));
+}
+
+TEST_F(PathNormalizerTest, IgnoresCase)
+{
+    PathNormalization options;
+    options.ignore_case = true;
+    options.decode_unreserved = true;
+    const PathNormalizer normalizer(options, {});
+    EXPECT_TRUE(normalizer.IgnoresCase());
+    EXPECT_EQ("/pets/{petid}", normalizer.GetKey("/Pets/{petId}"));
+    EXPECT_EQ("/pets/abc", Normalize(normalizer, "/PETS/%41bc"));
+}
+
+TEST_F(PathNormalizerTest, StripsBasePaths)
+{
+    PathNormalization options;
+    options.strip_base_paths = true;
+    const PathNormalizer normalizer(options, {"/test", "/test/api", "/v1/"});
+
+    EXPECT_EQ("/pets/42", Normalize(normalizer, "/test/api/pets/42"));
+    EXPECT_EQ("/pets/42", GetCanonical(normalizer));
+    EXPECT_EQ("/api2/pets", Normalize(normalizer, "/test/api2/pets"));
+    EXPECT_EQ("/api2/pets", GetCanonical(normalizer));
+    EXPECT_EQ("/pets", Normalize(normalizer, "/v1/pets"));
+    EXPECT_EQ("/v10/pets", Normalize(normalizer, "/v10/pets"));
+    EXPECT_EQ("/v10/pets", GetCanonical(normalizer));
+    EXPECT_EQ("", Normalize(normalizer, "/test/api"));
+    EXPECT_EQ("-", GetCanonical(normalizer)); // Routed as "/"
+    EXPECT_EQ("/pets", Normalize(normalizer, "/pets"));
+    EXPECT_EQ("/pets", GetCanonical(normalizer));
+}
+
+TEST_F(PathNormalizerTest, TooManySegments)
+{
+    PathNormalization options;
+    options.collapse_slashes = true;
+    const PathNormalizer normalizer(options, {});
+    std::string request_path;
+    for (size_t i = 1; i < NormalizedPath::kMaxSegments; ++i) {
+        request_path += "/a";
+    }
+    EXPECT_NE("!", Normalize(normalizer, request_path));
+    EXPECT_EQ("!", Normalize(normalizer, request_path + "/a"));
+}
@@ -65,3 +65,41 @@ TEST_F(PathTrieTest, InsertAndSearchMultiParamPath)
     EXPECT_EQ(std::string(param_idxs[3].beg, param_idxs[3].end), "123");
     EXPECT_EQ(std::string(param_idxs[5].beg, param_idxs[5].end), "update");
 }
+
+// Test node count and memory usage grow with inserted paths
+TEST_F(PathTrieTest, NodeCountAndMemoryUsage)
+{
+    auto empty_bytes = trie_.GetMemoryUsage();
+    EXPECT_EQ(1u, trie_.GetNodeCount());
+    trie_.Insert("/api/data/{id}");
+    trie_.Insert("/api/data/{id}/edit");
+    EXPECT_EQ(6u, trie_.GetNodeCount()); // Root, leading empty segment, api, data, {id}, edit
+    EXPECT_GT(trie_.GetMemoryUsage(), empty_bytes);
+}
+
+// Test searching the segments of a normalized path, static paths sharing nodes with parameters
+TEST_F(PathTrieTest, SearchNormalizedPath)
+{
+    PathNormalization options;
+    options.collapse_slashes = true;
+    options.ignore_case = true;
+    const PathNormalizer normalizer(options, {});
+    for (const std::string path : {"/", "/pets/count", "/pets/{petId}/toys", "/pets/{petId}"}) {
+        trie_.Insert(normalizer.GetKey(path));
+    }
+
+    const std::string request_path("//PETS/Rex/toys/");
+    NormalizedPath normalized;
+    ASSERT_TRUE(normalizer.Normalize(request_path.c_str(), request_path.c_str() + request_path.size(), normalized));
+    std::string oas_path;
+    std::unordered_map<size_t, ParamRange> param_idxs;
+    EXPECT_TRUE(trie_.Search(normalized, oas_path, &param_idxs));
+    EXPECT_EQ("/pets/{petid}/toys", oas_path);
+    ASSERT_EQ(1U, param_idxs.size());
+    EXPECT_EQ("Rex", std::string(param_idxs[2].beg, param_idxs[2].end));
+
+    const std::string root("//");
+    ASSERT_TRUE(normalizer.Normalize(root.c_str(), root.c_str() + root.size(), normalized));
+    EXPECT_TRUE(trie_.Search(normalized, oas_path, nullptr));
+    EXPECT_EQ("/", oas_path);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/raw_request.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+std::string Name(const HeaderField& field)
+{
+    return std::string(field.name, field.name_length);
+}
+
+std::string Value(const HeaderField& field)
+{
+    return std::string(field.value, field.value_length);
+}
+} // namespace
+
+TEST(RawRequestTest, ParseHttp1)
+{
+    const std::string head("GET /a/b?x=1 HTTP/1.1\r\nHost: example.com\r\nX-Long-Header-Name:\t padded value  \r\n"
+                           "Empty:\r\n\r\n{\"ignored\":true}");
+    RawRequest request;
+    std::string err_msg;
+    ASSERT_EQ(ValidationError::NONE, request.ParseHttp1(head.data(), head.size(), err_msg));
+    EXPECT_EQ("GET", request.GetMethod());
+    EXPECT_EQ("/a/b?x=1", request.GetPath());
+    ASSERT_EQ(3u, request.GetHeaderCount());
+    EXPECT_EQ("Host", Name(request.GetHeaders()[0]));
+    EXPECT_EQ("example.com", Value(request.GetHeaders()[0]));
+    EXPECT_EQ("X-Long-Header-Name", Name(request.GetHeaders()[1]));
+    EXPECT_EQ("padded value", Value(request.GetHeaders()[1]));
+    EXPECT_EQ("Empty", Name(request.GetHeaders()[2]));
+    EXPECT_EQ("", Value(request.GetHeaders()[2]));
+}
+
+TEST(RawRequestTest, ParseHttp1LenientForms)
+{
+    RawRequest request;
+    std::string err_msg;
+
+    // Bare LF line endings and no trailing empty line
+    const std::string bare_lf("post /items HTTP/1.0\nContent-Type: application/json\n");
+    ASSERT_EQ(ValidationError::NONE, request.ParseHttp1(bare_lf.data(), bare_lf.size(), err_msg));
+    EXPECT_EQ("post", request.GetMethod());
+    ASSERT_EQ(1u, request.GetHeaderCount());
+    EXPECT_EQ("application/json", Value(request.GetHeaders()[0]));
+
+    // Absolute-form target is routed on its path
+    const std::string absolute("GET http://example.com:8080/items?id=1 HTTP/1.1\r\n\r\n");
+    ASSERT_EQ(ValidationError::NONE, request.ParseHttp1(absolute.data(), absolute.size(), err_msg));
+    EXPECT_EQ("/items?id=1", request.GetPath());
+    EXPECT_EQ(0u, request.GetHeaderCount());
+}
+
+TEST(RawRequestTest, ParseHttp1Malformed)
+{
+    RawRequest request;
+    std::string err_msg;
+    const std::string no_target("GET\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_METHOD, request.ParseHttp1(no_target.data(), no_target.size(), err_msg));
+    EXPECT_EQ(R"({"errorCode":"INVALID_METHOD","details":{"description": "Malformed request line"}})", err_msg);
+
+    const std::string no_version("GET /a\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, request.ParseHttp1(no_version.data(), no_version.size(), err_msg));
+    const std::string bad_version("GET /a FTP/1.1\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, request.ParseHttp1(bad_version.data(), bad_version.size(), err_msg));
+
+    const std::string no_colon("GET /a HTTP/1.1\r\nHost example.com\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM, request.ParseHttp1(no_colon.data(), no_colon.size(), err_msg));
+    const std::string space_before_colon("GET /a HTTP/1.1\r\nHost : example.com\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              request.ParseHttp1(space_before_colon.data(), space_before_colon.size(), err_msg));
+    const std::string folded("GET /a HTTP/1.1\r\nX-A: 1\r\n 2\r\n\r\n");
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM, request.ParseHttp1(folded.data(), folded.size(), err_msg));
+
+    std::string too_many("GET /a HTTP/1.1\r\n");
+    for (size_t i = 0; i <= RawRequest::kMaxHeaders; ++i) {
+        too_many += "X-A: 1\r\n";
+    }
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM, request.ParseHttp1(too_many.data(), too_many.size(), err_msg));
+    EXPECT_NE(std::string::npos, err_msg.find("Too many header fields"));
+}
+
+TEST(RawRequestTest, ParseHttp2)
+{
+    const std::string method_name(":method"), method("GET"), path_name(":path"), path("/a?x=1"),
+        scheme_name(":scheme"), scheme("https"), host_name("host"), host("example.com");
+    std::vector<HeaderField> fields{{method_name, method}, {scheme_name, scheme}, {path_name, path}, {host_name, host}};
+
+    RawRequest request;
+    std::string err_msg;
+    ASSERT_EQ(ValidationError::NONE, request.ParseHttp2(fields.data(), fields.size(), err_msg));
+    EXPECT_EQ("GET", request.GetMethod());
+    EXPECT_EQ("/a?x=1", request.GetPath());
+    EXPECT_EQ(fields.data(), request.GetHeaders());
+    EXPECT_EQ(fields.size(), request.GetHeaderCount());
+
+    // Pseudo-headers after a regular field are not considered
+    std::vector<HeaderField> late_path{{method_name, method}, {host_name, host}, {path_name, path}};
+    EXPECT_EQ(ValidationError::INVALID_ROUTE, request.ParseHttp2(late_path.data(), late_path.size(), err_msg));
+    EXPECT_EQ(ValidationError::INVALID_METHOD, request.ParseHttp2(nullptr, 0, err_msg));
+}
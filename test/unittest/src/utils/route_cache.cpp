@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/route_cache.hpp"
+#include "validators/validators_store.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+class RouteCacheTest: public ::testing::Test
+{
+protected:
+    ValidatorsStore pets_;
+    ValidatorsStore users_;
+
+    static bool Find(const RouteCache& cache, size_t slot, const std::string& path, const ValidatorsStore*& validators,
+                     std::unordered_map<size_t, ParamRange>* param_idxs = nullptr)
+    {
+        return cache.Find(slot, path.c_str(), path.c_str() + path.size(), validators, param_idxs);
+    }
+
+    static void Insert(RouteCache& cache, size_t slot, const std::string& path, const ValidatorsStore* validators,
+                       const std::unordered_map<size_t, ParamRange>& param_idxs = {})
+    {
+        cache.Insert(slot, path.c_str(), path.c_str() + path.size(), validators, param_idxs);
+    }
+};
+
+TEST_F(RouteCacheTest, FindsInsertedPaths)
+{
+    RouteCache cache(64);
+    const ValidatorsStore* validators = nullptr;
+    EXPECT_FALSE(Find(cache, 0, "/pets", validators));
+    Insert(cache, 0, "/pets", &pets_);
+    Insert(cache, 0, "/users", &users_);
+    ASSERT_TRUE(Find(cache, 0, "/pets", validators));
+    EXPECT_EQ(&pets_, validators);
+    ASSERT_TRUE(Find(cache, 0, "/users", validators));
+    EXPECT_EQ(&users_, validators);
+    EXPECT_FALSE(Find(cache, 1, "/pets", validators)); // Other slot
+    EXPECT_FALSE(Find(cache, 0, "/pet", validators));
+    EXPECT_FALSE(Find(cache, 0, "/pets/", validators));
+
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(2U, stats.hits);
+    EXPECT_EQ(4U, stats.misses);
+    EXPECT_EQ(2U, stats.entries);
+    EXPECT_EQ(0U, stats.evictions);
+    EXPECT_EQ(64U, stats.capacity);
+}
+
+TEST_F(RouteCacheTest, RestoresPathParams)
+{
+    RouteCache cache(64);
+    std::string path("/pets/42/toys/7");
+    std::unordered_map<size_t, ParamRange> param_idxs{{2, {path.c_str() + 6, path.c_str() + 8}},
+                                                      {4, {path.c_str() + 14, path.c_str() + 15}}};
+    Insert(cache, 0, path, &pets_, param_idxs);
+
+    const std::string other(path); // Ranges are within the path looked up
+    const ValidatorsStore* validators = nullptr;
+    std::unordered_map<size_t, ParamRange> found;
+    ASSERT_TRUE(Find(cache, 0, other, validators, &found));
+    ASSERT_EQ(2U, found.size());
+    EXPECT_EQ("42", std::string(found.at(2).beg, found.at(2).end));
+    EXPECT_EQ("7", std::string(found.at(4).beg, found.at(4).end));
+    EXPECT_EQ(other.c_str() + 6, found.at(2).beg);
+}
+
+TEST_F(RouteCacheTest, SkipsUncacheablePaths)
+{
+    RouteCache cache(64);
+    const std::string long_path("/" + std::string(RouteCache::kMaxPathLength, 'a'));
+    Insert(cache, 0, long_path, &pets_);
+    const std::string path("/a/b/c/d/e");
+    std::unordered_map<size_t, ParamRange> param_idxs;
+    for (size_t i = 0; i <= RouteCache::kMaxParams; ++i) {
+        param_idxs.emplace(i + 1, ParamRange{path.c_str() + 2 * i + 1, path.c_str() + 2 * i + 2});
+    }
+    Insert(cache, 0, path, &pets_, param_idxs);
+
+    const ValidatorsStore* validators = nullptr;
+    EXPECT_FALSE(Find(cache, 0, long_path, validators));
+    EXPECT_FALSE(Find(cache, 0, path, validators));
+    EXPECT_EQ(0U, cache.GetStats().entries);
+}
+
+TEST_F(RouteCacheTest, ResistsScans)
+{
+    RouteCache cache(64);
+    std::vector<std::string> hot;
+    for (size_t i = 0; i < 32; ++i) {
+        hot.push_back("/pets/" + std::to_string(i));
+    }
+    const ValidatorsStore* validators = nullptr;
+    for (int round = 0; round < 4; ++round) {
+        for (const auto& path : hot) {
+            if (!Find(cache, 0, path, validators)) {
+                Insert(cache, 0, path, &pets_);
+            }
+        }
+    }
+    size_t cached = 0;
+    for (const auto& path : hot) {
+        cached += Find(cache, 0, path, validators) ? 1 : 0;
+    }
+
+    // Paths requested once each, far more than the capacity
+    for (size_t i = 0; i < 10000; ++i) {
+        const std::string path("/users/" + std::to_string(i));
+        if (!Find(cache, 0, path, validators)) {
+            Insert(cache, 0, path, &users_);
+        }
+    }
+    size_t kept = 0;
+    for (const auto& path : hot) {
+        kept += Find(cache, 0, path, validators) && &pets_ == validators ? 1 : 0;
+    }
+    EXPECT_GE(cached, 24U);
+    EXPECT_GE(kept, cached * 3 / 4);
+    EXPECT_GT(cache.GetStats().evictions, 0U);
+    EXPECT_LE(cache.GetStats().entries, 64U);
+}
+
+TEST_F(RouteCacheTest, ConcurrentReadersAndWriters)
+{
+    RouteCache cache(16);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 256; ++i) {
+        paths.push_back("/pets/" + std::to_string(i));
+    }
+    std::vector<std::thread> threads;
+    std::vector<size_t> wrong(4, 0);
+    for (size_t t = 0; t < wrong.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < 20000; ++i) {
+                const auto& path = paths[(i * 7 + t) % paths.size()];
+                const ValidatorsStore* expected = 0 == path.size() % 2 ? &pets_ : &users_;
+                const ValidatorsStore* validators = nullptr;
+                std::unordered_map<size_t, ParamRange> param_idxs;
+                if (Find(cache, 0, path, validators, &param_idxs)) {
+                    wrong[t] += expected != validators || 1 != param_idxs.size() ||
+                                        path.substr(6) != std::string(param_idxs[2].beg, param_idxs[2].end)
+                                    ? 1
+                                    : 0;
+                } else {
+                    Insert(cache, 0, path, expected, {{2, {path.c_str() + 6, path.c_str() + path.size()}}});
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto count : wrong) {
+        EXPECT_EQ(0U, count);
+    }
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(wrong.size() * 20000, stats.hits + stats.misses);
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/route_filter.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+class RouteFilterTest: public ::testing::Test
+{
+protected:
+    RouteFilter filter_;
+
+    bool MayMatch(const std::string& path) const
+    {
+        return filter_.MayMatch(path.c_str(), path.c_str() + path.size());
+    }
+};
+
+TEST_F(RouteFilterTest, RejectsUnknownFirstSegments)
+{
+    filter_.Build({"/pets", "/pets/{petId}", "/store/inventory", "/user/login"});
+    EXPECT_TRUE(MayMatch("/pets"));
+    EXPECT_TRUE(MayMatch("/pets/42"));
+    EXPECT_TRUE(MayMatch("/store/inventory"));
+    EXPECT_FALSE(MayMatch("/wp-admin"));
+    EXPECT_FALSE(MayMatch("/.env"));
+    EXPECT_FALSE(MayMatch("/pet"));
+    EXPECT_FALSE(MayMatch("/petsx/42"));
+    EXPECT_FALSE(MayMatch(""));
+}
+
+TEST_F(RouteFilterTest, RejectsSegmentCountsOutOfBounds)
+{
+    filter_.Build({"/a/{b}", "/a/{b}/c/d"});
+    EXPECT_TRUE(MayMatch("/a/1"));
+    EXPECT_TRUE(MayMatch("/a/1/"));
+    EXPECT_TRUE(MayMatch("/a/1/c/d"));
+    EXPECT_FALSE(MayMatch("/a"));
+    EXPECT_FALSE(MayMatch("/a/1/c/d/e"));
+    EXPECT_FALSE(MayMatch("/a/1/c/d/../../../etc/passwd"));
+}
+
+TEST_F(RouteFilterTest, RejectsUnknownLiteralPrefixes)
+{
+    filter_.Build({"/api/v1/users/{id}", "/api/v1/orders/{id}", "/api/v2/users"});
+    EXPECT_TRUE(MayMatch("/api/v1/users/42"));
+    EXPECT_TRUE(MayMatch("/api/v1/orders/7"));
+    EXPECT_TRUE(MayMatch("/api/v2/users"));
+    EXPECT_FALSE(MayMatch("/api/v3/users"));
+    EXPECT_FALSE(MayMatch("/api/.git/config"));
+    EXPECT_FALSE(MayMatch("/api/v1/.env"));
+
+    // Only the prefix literal in every route of the first segment is checked
+    filter_.Build({"/api/v1/users/{id}", "/api/{version}/status"});
+    EXPECT_TRUE(MayMatch("/api/v9/status"));
+    EXPECT_TRUE(MayMatch("/api/v1/anything"));
+}
+
+TEST_F(RouteFilterTest, ParameterFirstSegment)
+{
+    filter_.Build({"/{tenant}/items", "/health"});
+    EXPECT_TRUE(MayMatch("/acme/items"));
+    EXPECT_TRUE(MayMatch("/wp-admin"));
+    EXPECT_FALSE(MayMatch("/acme/items/1"));
+}
+
+TEST_F(RouteFilterTest, NoRoutes)
+{
+    filter_.Build({});
+    EXPECT_FALSE(MayMatch("/"));
+    EXPECT_FALSE(MayMatch("/a"));
+    EXPECT_FALSE(MayMatch(""));
+}
+
+TEST_F(RouteFilterTest, NeverRejectsMatchingPaths)
+{
+    std::vector<std::string> templates;
+    for (int i = 0; i < 200; ++i) {
+        const std::string base = "/svc" + std::to_string(i % 7) + "/v" + std::to_string(i % 3);
+        templates.push_back(base + "/res" + std::to_string(i));
+        templates.push_back(base + "/res" + std::to_string(i) + "/{id}");
+        templates.push_back(base + "/res" + std::to_string(i) + "/{id}/sub/{sub_id}");
+    }
+    templates.emplace_back("/");
+    filter_.Build(templates);
+
+    std::mt19937 random(7);
+    for (const auto& path_template : templates) {
+        for (int i = 0; i < 5; ++i) {
+            std::string path;
+            for (size_t pos = 0; pos < path_template.size();) {
+                if ('{' == path_template[pos]) {
+                    path += std::to_string(random() % 100000);
+                    pos = path_template.find('}', pos) + 1;
+                } else {
+                    path += path_template[pos++];
+                }
+            }
+            EXPECT_TRUE(MayMatch(path)) << path;
+            EXPECT_TRUE("/" == path || MayMatch(path + "/")) << path; // Routed as the path without the slash
+        }
+    }
+}
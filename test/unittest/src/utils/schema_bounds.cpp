@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/schema_bounds.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+size_t GetJsonBytes(const char* schema)
+{
+    rapidjson::Document doc;
+    doc.Parse(schema);
+    return SchemaBounds::GetJsonBytes(doc);
+}
+
+size_t GetParamBytes(const char* param)
+{
+    rapidjson::Document doc;
+    doc.Parse(param);
+    return SchemaBounds::GetParamBytes(doc);
+}
+} // namespace
+
+TEST(SchemaBoundsTest, Primitives)
+{
+    EXPECT_EQ(4U, GetJsonBytes(R"({"type":"null"})"));
+    EXPECT_EQ(5U, GetJsonBytes(R"({"type":"boolean"})"));
+    EXPECT_EQ(2U + 12 * 8, GetJsonBytes(R"({"type":"string","maxLength":8})"));
+    EXPECT_EQ(3U, GetJsonBytes(R"({"type":"integer","minimum":-10,"maximum":99})")); // A sign and two digits
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"integer","minimum":0})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"number","minimum":0,"maximum":1})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"string"})"));
+    EXPECT_EQ(2U + 6 * 4, GetJsonBytes(R"({"type":"string","enum":["low","high"]})"));
+    EXPECT_EQ(2U + 6 * 2, GetJsonBytes(R"({"const":"ok"})"));
+    EXPECT_EQ(2U + 12 * 8, GetJsonBytes(R"({"type":["string","null"],"maxLength":8})"));
+    EXPECT_EQ(4U, GetJsonBytes(R"({"type":"boolean","enum":[true],"nullable":true})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"$ref":"#/x","type":"boolean"})"));
+}
+
+TEST(SchemaBoundsTest, Containers)
+{
+    const size_t tag = 2 + 12 * 8;
+    EXPECT_EQ(2U + 3 * (tag + 1),
+              GetJsonBytes(R"({"type":"array","maxItems":3,"items":{"type":"string","maxLength":8}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"array","items":{"type":"boolean"}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"array","maxItems":3,"items":{"type":"number"}})"));
+
+    // The largest member, quoted and escaped name with a colon and a comma, times maxProperties
+    const size_t member = 2 + 6 * 3 + 2 + tag;
+    EXPECT_EQ(2U + 2 * member, GetJsonBytes(R"({"type":"object","additionalProperties":false,"maxProperties":2,)"
+                                            R"("properties":{"ok":{"type":"boolean"},)"
+                                            R"("tag":{"type":"string","maxLength":8}}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"object","maxProperties":2,)"
+                                                     R"("properties":{"ok":{"type":"boolean"}}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"type":"object","additionalProperties":false,)"
+                                                     R"("properties":{"ok":{"type":"boolean"}}})"));
+}
+
+TEST(SchemaBoundsTest, Combinators)
+{
+    EXPECT_EQ(5U, GetJsonBytes(R"({"allOf":[{"type":"string","maxLength":8},{"type":"boolean"}]})"));
+    EXPECT_EQ(2U + 12 * 8, GetJsonBytes(R"({"anyOf":[{"type":"string","maxLength":8},{"type":"boolean"}]})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetJsonBytes(R"({"oneOf":[{"type":"string"},{"type":"boolean"}]})"));
+    EXPECT_EQ(5U, GetJsonBytes(R"({"type":"boolean","oneOf":[{"type":"string"},{"type":"boolean"}]})"));
+}
+
+TEST(SchemaBoundsTest, Params)
+{
+    // Name with its start character and '=', and the percent-encoded value
+    EXPECT_EQ(6U + 12 * 64, GetParamBytes(R"({"name":"name","in":"query","schema":{"type":"string","maxLength":64}})"));
+    EXPECT_EQ(6U + 3 * 4 + 2, GetParamBytes(R"({"name":"sort","in":"query","schema":{"enum":["asc","desc"]}})"));
+    EXPECT_EQ(4U + 4,
+              GetParamBytes(R"({"name":"id","in":"path","schema":{"type":"integer","minimum":1,"maximum":999}})"));
+    EXPECT_EQ(5U + 5, GetParamBytes(R"({"name":"all","in":"query","schema":{"type":"boolean"}})"));
+    EXPECT_EQ(5U + 2 * (4 + 5 + 3),
+              GetParamBytes(R"({"name":"ids","in":"query","schema":{"type":"array","maxItems":2,)"
+                            R"("items":{"type":"integer","minimum":0,"maximum":999}}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded, GetParamBytes(R"({"name":"q","in":"query","schema":{"type":"string"}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded,
+              GetParamBytes(R"({"name":"f","in":"query","schema":{"type":"object","properties":{}}})"));
+    EXPECT_EQ(SchemaBounds::kUnbounded,
+              GetParamBytes(R"({"name":"c","in":"query","content":{"application/json":{"schema":{"type":"null"}}}})"));
+}
+
+TEST(SchemaBoundsTest, CountSignificantBytes)
+{
+    const std::string json = " { \"a\" :\n\t[ 1 , 2 ] }\r\n";
+    EXPECT_EQ(11U, SchemaBounds::CountSignificantBytes(json.data(), json.size(), 100));
+    EXPECT_EQ(4U, SchemaBounds::CountSignificantBytes(json.data(), json.size(), 3)); // Stops past the limit
+    EXPECT_EQ(0U, SchemaBounds::CountSignificantBytes(json.data(), 0, 0));
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/shadow_queue.hpp"
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+bool Push(ShadowQueue& queue, const std::string& path)
+{
+    return queue.Push([&path](ShadowRequest& slot) { slot.http_path = path; });
+}
+
+// Path of the head request, empty when the queue is
+std::string Pop(ShadowQueue& queue)
+{
+    std::string path;
+    queue.Pop([&path](ShadowRequest& request) { path = request.http_path; });
+    return path;
+}
+} // namespace
+
+TEST(ShadowQueueTest, FirstInFirstOut)
+{
+    ShadowQueue queue(3); // Rounded up to 4
+    EXPECT_EQ("", Pop(queue));
+    for (size_t lap = 0; lap < 3; ++lap) {
+        for (const char* path : {"/a", "/b", "/c", "/d"}) {
+            EXPECT_TRUE(Push(queue, path));
+        }
+        EXPECT_FALSE(Push(queue, "/e"));
+        EXPECT_EQ("/a", Pop(queue));
+        EXPECT_TRUE(Push(queue, "/f"));
+        for (const char* path : {"/b", "/c", "/d", "/f"}) {
+            EXPECT_EQ(path, Pop(queue));
+        }
+        EXPECT_EQ("", Pop(queue));
+    }
+    EXPECT_EQ(15U, queue.GetPushed());
+    EXPECT_EQ(15U, queue.GetPopped());
+    EXPECT_EQ(3U, queue.GetDropped());
+
+    ShadowQueue single(1); // Rounded up to 2
+    EXPECT_TRUE(Push(single, "/a"));
+    EXPECT_TRUE(Push(single, "/b"));
+    EXPECT_FALSE(Push(single, "/c"));
+}
+
+TEST(ShadowQueueTest, ClearsConsumedSlots)
+{
+    ShadowQueue queue(2);
+    const std::string body(100, 'x');
+    for (size_t idx = 0; idx < 2; ++idx) {
+        EXPECT_TRUE(queue.Push([&body](ShadowRequest& slot) {
+            slot.method = "POST";
+            slot.http_path = "/a";
+            slot.json_body = body;
+            slot.headers.emplace_back("Authorization", "secret");
+            slot.has_body = true;
+        }));
+        EXPECT_TRUE(queue.Pop([](ShadowRequest&) {}));
+    }
+    // Only the buffers are kept for the next lap
+    for (size_t idx = 0; idx < 2; ++idx) {
+        EXPECT_TRUE(queue.Push([&body](ShadowRequest& slot) {
+            EXPECT_TRUE(slot.method.empty());
+            EXPECT_TRUE(slot.http_path.empty());
+            EXPECT_TRUE(slot.json_body.empty());
+            EXPECT_LE(body.size(), slot.json_body.capacity());
+            EXPECT_TRUE(slot.headers.empty());
+            EXPECT_FALSE(slot.has_body);
+        }));
+    }
+}
+
+TEST(ShadowQueueTest, ManyProducers)
+{
+    const size_t producers = 4;
+    const size_t per_producer = 20000;
+    ShadowQueue queue(64);
+    std::vector<std::thread> threads;
+    for (size_t producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&queue, producer]() {
+            for (size_t idx = 0; idx < per_producer;) {
+                idx += Push(queue, std::to_string(producer * per_producer + idx)) ? 1 : 0;
+            }
+        });
+    }
+    std::set<std::string> popped;
+    std::vector<size_t> last(producers, 0);
+    while (popped.size() < producers * per_producer) {
+        const auto path = Pop(queue);
+        if (path.empty()) {
+            continue;
+        }
+        const auto value = std::stoul(path);
+        EXPECT_LE(last[value / per_producer], value % per_producer + 1); // In order per producer
+        last[value / per_producer] = value % per_producer + 1;
+        EXPECT_TRUE(popped.insert(path).second);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ("", Pop(queue));
+    EXPECT_EQ(producers * per_producer, queue.GetPushed());
+}
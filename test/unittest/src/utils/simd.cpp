@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/simd.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+// Every test runs once per kernel variant the host supports
+class SimdTest: public ::testing::TestWithParam<SimdLevel>
+{
+protected:
+    void SetUp() override
+    {
+        if (static_cast<int>(GetParam()) > static_cast<int>(GetMaxSimdLevel())) {
+            GTEST_SKIP() << GetSimdLevelName(GetParam()) << " is not supported by this host";
+        }
+        SetSimdLevel(GetParam());
+    }
+
+    void TearDown() override
+    {
+        SetSimdLevel(GetMaxSimdLevel());
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(Levels, SimdTest, ::testing::Values(SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2),
+                         [](const ::testing::TestParamInfo<SimdLevel>& info) {
+                             return std::string(GetSimdLevelName(info.param));
+                         });
+
+TEST(SimdLevelTest, DefaultsToBestSupported)
+{
+    EXPECT_EQ(GetMaxSimdLevel(), GetSimdLevel());
+    SetSimdLevel(SimdLevel::SCALAR);
+    EXPECT_EQ(SimdLevel::SCALAR, GetSimdLevel());
+    SetSimdLevel(SimdLevel::AVX2); // Clamped on hosts without AVX2
+    EXPECT_EQ(GetMaxSimdLevel(), GetSimdLevel());
+}
+
+TEST_P(SimdTest, FindAtEveryOffset)
+{
+    // Covers the vector body and the scalar tail for every position of the needle
+    for (size_t length = 0; length < 100; ++length) {
+        std::string str(length, 'a');
+        EXPECT_EQ(str.data() + length, FindByte(str.data(), str.data() + length, '/'));
+        EXPECT_EQ(str.data() + length, FindAnyByte(str.data(), str.data() + length, '%', '+', '&'));
+        for (size_t pos = 0; pos < length; ++pos) {
+            str.assign(length, 'a');
+            str[pos] = '&';
+            if (pos + 1 < length) {
+                str[pos + 1] = '/';
+            }
+            EXPECT_EQ(str.data() + pos, FindByte(str.data(), str.data() + length, '&'));
+            EXPECT_EQ(str.data() + pos, FindEitherByte(str.data(), str.data() + length, '/', '&'));
+            EXPECT_EQ(str.data() + pos, FindAnyByte(str.data(), str.data() + length, '%', '+', '&'));
+        }
+    }
+}
+
+TEST_P(SimdTest, FindStopsAtEnd)
+{
+    const std::string str("abcdefghijklmnopqrstuvwxyz0123456789/abcdefghijklmnopqrstuvwxyz");
+    const char* slash = str.data() + str.find('/');
+    EXPECT_EQ(slash, FindByte(str.data(), slash, '/'));
+    EXPECT_EQ(slash, FindByte(str.data(), str.data() + str.size(), '/'));
+    const char* nul_end = str.data() + 10;
+    EXPECT_EQ(nul_end, FindEitherByte(str.data(), nul_end, 'z', '\0'));
+}
+
+TEST_P(SimdTest, PercentDecode)
+{
+    const std::string encoded("caf%C3%A9+au+lait%2C%20long%20enough%20to%20span%20several%20vectors&next=1");
+    const char* cursor = encoded.data();
+    std::string decoded;
+    EXPECT_EQ(PercentDecodeResult::OK, PercentDecode(cursor, encoded.data() + encoded.size(), '&', decoded));
+    EXPECT_EQ("caf\xC3\xA9 au lait, long enough to span several vectors", decoded);
+    EXPECT_EQ('&', *cursor);
+
+    cursor = encoded.data();
+    decoded.clear();
+    EXPECT_EQ(PercentDecodeResult::OK, PercentDecode(cursor, encoded.data() + encoded.size(), decoded));
+    EXPECT_EQ(encoded.data() + encoded.size(), cursor);
+    EXPECT_EQ("caf\xC3\xA9 au lait, long enough to span several vectors&next=1", decoded);
+}
+
+TEST_P(SimdTest, PercentDecodeErrors)
+{
+    std::string decoded;
+    const std::string incomplete("abc%4");
+    const char* cursor = incomplete.data();
+    EXPECT_EQ(PercentDecodeResult::INCOMPLETE, PercentDecode(cursor, incomplete.data() + incomplete.size(), decoded));
+
+    const std::string invalid("abc%4G");
+    cursor = invalid.data();
+    EXPECT_EQ(PercentDecodeResult::INVALID_HEX, PercentDecode(cursor, invalid.data() + invalid.size(), decoded));
+
+    // An escape is complete as long as its two characters are within the range
+    const std::string last("%41");
+    cursor = last.data();
+    decoded.clear();
+    EXPECT_EQ(PercentDecodeResult::OK, PercentDecode(cursor, last.data() + last.size(), ',', decoded));
+    EXPECT_EQ("A", decoded);
+}
+
+TEST_P(SimdTest, FindInvalidUtf8AtEveryOffset)
+{
+    const std::vector<std::string> invalid = {
+        "\x80", // Continuation without lead
+        "\xC3", // Truncated
+        "\xC3\x28", // Lead followed by ASCII
+        "\xC0\xAF", // Overlong
+        "\xE0\x9F\xBF", // Overlong
+        "\xED\xA0\x80", // Surrogate
+        "\xF0\x8F\xBF\xBF", // Overlong
+        "\xF4\x90\x80\x80", // Above U+10FFFF
+        "\xF5\x80\x80\x80",
+        "\xFF",
+    };
+    const std::string valid("\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80\xEF\xBF\xBF\xF4\x8F\xBF\xBF");
+    for (size_t pos = 0; pos < 70; ++pos) {
+        for (const auto& sequence : invalid) {
+            const std::string str = std::string(pos, 'a') + sequence + std::string(40, 'b');
+            EXPECT_EQ(str.data() + pos, FindInvalidUtf8(str.data(), str.data() + str.size())) << pos;
+            const std::string tail = std::string(pos, 'a') + sequence;
+            EXPECT_EQ(tail.data() + pos, FindInvalidUtf8(tail.data(), tail.data() + tail.size())) << pos;
+        }
+        const std::string str = std::string(pos, 'a') + valid + valid + std::string(pos % 7, 'b');
+        EXPECT_EQ(str.data() + str.size(), FindInvalidUtf8(str.data(), str.data() + str.size())) << pos;
+    }
+}
+
+TEST_P(SimdTest, FindInvalidUtf8SameAsScalar)
+{
+    // Multilingual text with a byte corrupted now and then, checked against the sequence by sequence reference
+    const char* pieces[] = {"a", " ", "\xC3\xA9", "\xD0\x96", "\xE4\xB8\xAD", "\xED\x9F\xBF", "\xF0\x9F\x98\x80"};
+    std::mt19937 random(7);
+    for (int i = 0; i < 2000; ++i) {
+        std::string str;
+        const size_t count = random() % 120;
+        for (size_t j = 0; j < count; ++j) {
+            str += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+        }
+        if (!str.empty() && 0 != random() % 3) {
+            str[random() % str.size()] = static_cast<char>(0x80 + random() % 0x80);
+        }
+        SetSimdLevel(SimdLevel::SCALAR);
+        const char* expected = FindInvalidUtf8(str.data(), str.data() + str.size());
+        SetSimdLevel(GetParam());
+        EXPECT_EQ(expected, FindInvalidUtf8(str.data(), str.data() + str.size()));
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "utils/spec_ref_table.hpp"
+#include <gtest/gtest.h>
+
+TEST(SpecRefTableTest, InternIsIdempotent)
+{
+    SpecRefTable table;
+    auto id = table.Intern("#/paths/%2Fspec-ref-table/get/parameters/id");
+    auto count = table.GetCount();
+    EXPECT_EQ(id, table.Intern(std::string("#/paths/%2Fspec-ref-table/get/parameters/id")));
+    EXPECT_EQ(count, table.GetCount());
+    EXPECT_NE(id, table.Intern("#/paths/%2Fspec-ref-table/get/parameters/name"));
+    EXPECT_EQ(count + 1, table.GetCount());
+}
+
+TEST(SpecRefTableTest, RenderInterned)
+{
+    SpecRefTable table;
+    auto id = table.Intern("#/paths/%2Fspec-ref-table/post/requestBody");
+    EXPECT_EQ("#/paths/%2Fspec-ref-table/post/requestBody", table.Get(id));
+
+    std::string out("specRef:");
+    table.Append(id, out);
+    EXPECT_EQ("specRef:#/paths/%2Fspec-ref-table/post/requestBody", out);
+}
+
+TEST(SpecRefTableTest, IdsStayValidAcrossBlocks)
+{
+    SpecRefTable table;
+    const std::string long_ref(100 * 1024, 'x'); // Larger than one block
+    auto first = table.Intern("#/spec-ref-table/first");
+    auto long_id = table.Intern(long_ref);
+    std::vector<SpecRefTable::Id> ids;
+    for (int i = 0; i < 5000; ++i) { // Spans more than one page
+        ids.push_back(table.Intern("#/spec-ref-table/" + std::to_string(i)));
+    }
+    EXPECT_EQ("#/spec-ref-table/first", table.Get(first));
+    EXPECT_EQ(long_ref, table.Get(long_id));
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ("#/spec-ref-table/" + std::to_string(i), table.Get(ids[static_cast<size_t>(i)]));
+    }
+}
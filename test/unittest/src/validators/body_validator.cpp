@@ -447,4 +447,55 @@ TEST_F(TestBodyValidator, InvalidEnum)
     EXPECT_EQ(std::string(doc["errorCode"].GetString()), "INVALID_BODY");
     EXPECT_EQ(std::string(doc["details"]["code"].GetString()), "enum");
     EXPECT_EQ(std::string(doc["details"]["instance"].GetString()), "#/subscriptionType");
-}
\ No newline at end of file
+}
+
+TEST_F(TestBodyValidator, StructuralIndexSameResults)
+{
+    const std::string valid = R"({"userId": 12345, "username": "johndoe_2023", "email": "john.doe@example.com",
+            "createdAt": "2023-04-05T08:00:00Z", "S_example": "This is a pattern property",
+            "preferences": {"newsletter": true, "themes": ["dark", "light"]}})";
+    const std::vector<std::string> bodies = {
+        valid,
+        R"({"userId": 12345 "username": "johndoe_2023"})", // Parser error
+        R"({"userId": 12345, "username": tru})", // Parser error reported at another offset
+        R"({"userId": "not-an-integer", "username": "johndoe_2023", "email": "a@b.c", "createdAt": "x"})",
+        R"({"userId": 0, "username": "johndoe_2023", "email": "a@b.c", "createdAt": "2023-04-05T08:00:00Z"})",
+        R"({"userId": 1, "username": "j!", "email": "a@b.c", "createdAt": "2023-04-05T08:00:00Z"})",
+        R"({"userId": 1, "username": "john", "email": "a@b.c", "createdAt": "2023-04-05T08:00:00Z", "S_": "x"})",
+        R"({"userId": 1.5, "username": "john", "preferences": {"themes": ["dark", "dark"]}})",
+        "",
+    };
+    for (const auto& body : bodies) {
+        std::string expected_msg;
+        std::string error_msg;
+        const auto expected = validator_->Validate(body, expected_msg);
+        EXPECT_EQ(expected, validator_->Validate(body.data(), body.size(), BodyParser::STRUCTURAL_INDEX, error_msg))
+            << body;
+        if (ValidationError::NONE == expected) {
+            continue;
+        }
+        // Both parsers reject a malformed body, but may not agree on the error code and offset
+        static const std::string parser_error = R"("code":"parserError")";
+        if (std::string::npos != expected_msg.find(parser_error)) {
+            EXPECT_NE(std::string::npos, error_msg.find(parser_error)) << body;
+        } else {
+            EXPECT_EQ(expected_msg, error_msg) << body;
+        }
+    }
+}
+
+TEST_F(TestBodyValidator, RejectsInvalidUtf8)
+{
+    const std::string json_str =
+        "{\"userId\": 1, \"username\": \"caf\xC3\", \"email\": \"a@b.c\", \"createdAt\": \"x\"}";
+    for (auto parser : {BodyParser::RAPIDJSON, BodyParser::STRUCTURAL_INDEX}) {
+        std::string error_msg;
+        EXPECT_EQ(ValidationError::INVALID_BODY,
+                  validator_->Validate(json_str.data(), json_str.size(), parser, error_msg));
+        rapidjson::Document doc;
+        doc.Parse(error_msg.c_str());
+        EXPECT_FALSE(doc.HasParseError());
+        EXPECT_EQ(std::string(doc["details"]["code"].GetString()), "parserError");
+        EXPECT_EQ(doc["details"]["offset"].GetInt(), 30);
+    }
+}
@@ -50,4 +50,35 @@ TEST(MethodValidatorTest, Negative)
     EXPECT_EQ(validator.Validate("TRACET", err_msg), ValidationError::INVALID_METHOD);
     EXPECT_EQ(validator.Validate("CONNECTT", err_msg), ValidationError::INVALID_METHOD);
     EXPECT_EQ(validator.Validate("PATCHT", err_msg), ValidationError::INVALID_METHOD);
-}
\ No newline at end of file
+}
+
+TEST(MethodValidatorTest, AnyCasing)
+{
+    MethodValidator validator;
+    std::string err_msg;
+    HttpMethod parsed;
+
+    EXPECT_EQ(validator.Validate("Get", parsed, err_msg), ValidationError::NONE);
+    EXPECT_EQ(HttpMethod::GET, parsed);
+    EXPECT_EQ(validator.Validate("pOsT", parsed, err_msg), ValidationError::NONE);
+    EXPECT_EQ(HttpMethod::POST, parsed);
+    EXPECT_EQ(validator.Validate("Options", parsed, err_msg), ValidationError::NONE);
+    EXPECT_EQ(HttpMethod::OPTIONS, parsed);
+    EXPECT_EQ(validator.Validate("cONNECT", parsed, err_msg), ValidationError::NONE);
+    EXPECT_EQ(HttpMethod::CONNECT, parsed);
+
+    // Same length and first letter as a method, or differing only in bit 0x20 outside letters
+    EXPECT_EQ(validator.Validate("GOT", parsed, err_msg), ValidationError::INVALID_METHOD);
+    EXPECT_EQ(validator.Validate("PUSH", parsed, err_msg), ValidationError::INVALID_METHOD);
+    EXPECT_EQ(validator.Validate("G\x05T", parsed, err_msg), ValidationError::INVALID_METHOD);
+    EXPECT_EQ(validator.Validate("", parsed, err_msg), ValidationError::INVALID_METHOD);
+    EXPECT_EQ(HttpMethod::COUNT, parsed);
+}
+
+TEST(MethodValidatorTest, NamesRoundTrip)
+{
+    for (size_t i = 0; i < static_cast<size_t>(HttpMethod::COUNT); ++i) {
+        const auto method = static_cast<HttpMethod>(i);
+        EXPECT_EQ(method, ParseHttpMethod(GetHttpMethodName(method)));
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Muhammad Nawaz
+ * Licensed under the MIT License. See LICENSE file for more information.
+ */
+// [ END OF LICENSE c6bd0f49d040fca8d8a9cb05868e66aa63f0e2e0 ]
+
+#include "validators/validators_cache.hpp"
+#include "validators/body_validator.hpp"
+#include "validators/param_validators.hpp"
+#include <gtest/gtest.h>
+
+class ValidatorsCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        doc_.Parse(R"({
+            "a": {"name": "id", "in": "header", "required": true, "schema": {"type": "integer", "maximum": 10}},
+            "b": {"name": "id", "in": "header", "required": true, "schema": {"type": "integer", "maximum": 10}},
+            "c": {"name": "id", "in": "header", "required": true, "schema": {"type": "integer", "maximum": 20}}
+        })");
+    }
+
+    rapidjson::Document doc_;
+    ValidatorsCache cache_;
+    std::string error_msg_;
+};
+
+TEST_F(ValidatorsCacheTest, IdenticalSchemasAreShared)
+{
+    auto schema_a = cache_.GetSchema(doc_["a"]["schema"]);
+    auto schema_b = cache_.GetSchema(doc_["b"]["schema"]);
+    auto schema_c = cache_.GetSchema(doc_["c"]["schema"]);
+    EXPECT_EQ(schema_a.get(), schema_b.get());
+    EXPECT_NE(schema_a.get(), schema_c.get());
+}
+
+TEST_F(ValidatorsCacheTest, ExpiredSchemaIsRecompiled)
+{
+    auto schema_a = cache_.GetSchema(doc_["a"]["schema"]);
+    schema_a.reset();
+    EXPECT_NE(nullptr, cache_.GetSchema(doc_["b"]["schema"]));
+}
+
+TEST_F(ValidatorsCacheTest, IdenticalDeserializersAreShared)
+{
+    auto key_a = ValidatorsCache::GetKey(doc_["a"]);
+    EXPECT_EQ(nullptr, cache_.FindDeserializer(key_a));
+
+    HeaderParamValidator validator_a(doc_["a"], {"paths", "%2Fa", "get", "parameters", "id"}, &cache_);
+    EXPECT_NE(nullptr, cache_.FindDeserializer(key_a));
+    EXPECT_EQ(cache_.FindDeserializer(key_a), cache_.FindDeserializer(ValidatorsCache::GetKey(doc_["b"])));
+    EXPECT_NE(cache_.FindDeserializer(key_a), cache_.FindDeserializer(ValidatorsCache::GetKey(doc_["c"])));
+}
+
+TEST_F(ValidatorsCacheTest, DigestCollisionsAreNotShared)
+{
+    HeaderParamValidator validator_a(doc_["a"], {"paths", "%2Fa", "get", "parameters", "id"}, &cache_);
+    auto key = ValidatorsCache::GetKey(doc_["a"]);
+    ASSERT_NE(nullptr, cache_.FindDeserializer(key));
+
+    // Same digest, other definition
+    key.source = ValidatorsCache::GetKey(doc_["c"]).source;
+    EXPECT_EQ(nullptr, cache_.FindDeserializer(key));
+}
+
+TEST_F(ValidatorsCacheTest, SharedValidatorsKeepOwnSpecRef)
+{
+    HeaderParamValidator validator_a(doc_["a"], {"paths", "%2Fa", "get", "parameters", "id"}, &cache_);
+    HeaderParamValidator validator_b(doc_["b"], {"paths", "%2Fb", "get", "parameters", "id"}, &cache_);
+
+    const std::string value("11");
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_a.ValidateParam(value.data(), value.data() + value.size(), error_msg_));
+    EXPECT_NE(std::string::npos, error_msg_.find(R"("specRef":"#/paths/%2Fa/get/parameters/id")"));
+
+    error_msg_.clear();
+    EXPECT_EQ(ValidationError::INVALID_HEADER_PARAM,
+              validator_b.ValidateParam(value.data(), value.data() + value.size(), error_msg_));
+    EXPECT_NE(std::string::npos, error_msg_.find(R"("specRef":"#/paths/%2Fb/get/parameters/id")"));
+}
+
+TEST_F(ValidatorsCacheTest, SharedBodySchemaKeepsOwnSpecRef)
+{
+    BodyValidator validator_a(cache_.GetSchema(doc_["a"]["schema"]), {"paths", "%2Fa", "post", "requestBody"});
+    BodyValidator validator_b(cache_.GetSchema(doc_["b"]["schema"]), {"paths", "%2Fb", "post", "requestBody"});
+
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator_a.Validate("11", error_msg_));
+    EXPECT_NE(std::string::npos, error_msg_.find(R"("specRef":"#/paths/%2Fa/post/requestBody")"));
+
+    error_msg_.clear();
+    EXPECT_EQ(ValidationError::INVALID_BODY, validator_b.Validate("11", error_msg_));
+    EXPECT_NE(std::string::npos, error_msg_.find(R"("specRef":"#/paths/%2Fb/post/requestBody")"));
+}